@@ -129,6 +129,8 @@ AssemblyMainWindow::AssemblyMainWindow(const QString& outputdir_path, const QStr
       1000
     );
 
+    motion_model_->setFastMotionUpdateInterval(config->getDefaultValue<int>("main", "LStepExpressModel_fastMotionUpdateInterval", 50));
+
     motion_manager_ = new LStepExpressMotionManager(motion_model_);
     connect(motion_manager_->model(), SIGNAL(emergencyStop_request()), motion_manager_, SLOT(clear_motion_queue()));
 
@@ -0,0 +1,253 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2017 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <AssemblyFramePool.h>
+#include <nqlogger.h>
+
+#include <algorithm>
+
+AssemblyFramePool* AssemblyFramePool::instance()
+{
+  static AssemblyFramePool pool;
+
+  return &pool;
+}
+
+AssemblyFramePool::AssemblyFramePool(const unsigned int max_frames) :
+  next_slot_(0),
+  max_frames_(std::max(1u, max_frames)),
+  metrics_()
+{
+  NQLog("AssemblyFramePool", NQLog::Debug) << "constructed (max_frames=" << max_frames_ << ")";
+}
+
+AssemblyFramePool::Slot& AssemblyFramePool::acquire(const int rows, const int cols, const int type)
+{
+  ++metrics_.frames;
+
+  // a frame only referenced by the pool is not used by any consumer anymore
+  Slot* free_slot(nullptr);
+
+  for(auto& slot : slots_)
+  {
+    if(slot.frame.u->refcount != 1){ continue; }
+
+    if(slot.frame.rows == rows && slot.frame.cols == cols && slot.frame.type() == type)
+    {
+      slot.color     = cv::Mat();
+      slot.gray      = cv::Mat();
+      slot.thumbnail = cv::Mat();
+
+      ++metrics_.reuses;
+
+      return slot;
+    }
+
+    if(free_slot == nullptr){ free_slot = &slot; }
+  }
+
+  if(free_slot == nullptr)
+  {
+    if(slots_.size() < max_frames_)
+    {
+      slots_.emplace_back();
+
+      free_slot = &slots_.back();
+    }
+    else
+    {
+      // all frames still in use: the pool drops its reference to the
+      // oldest one, the consumers holding it keep their copy alive
+      free_slot = &slots_.at(next_slot_);
+
+      next_slot_ = (next_slot_ + 1) % slots_.size();
+
+      NQLog("AssemblyFramePool", NQLog::Spam) << "acquire"
+         << ": all " << slots_.size() << " frames in use, replacing one";
+    }
+  }
+
+  free_slot->frame          = cv::Mat(rows, cols, type);
+  free_slot->color          = cv::Mat();
+  free_slot->gray           = cv::Mat();
+  free_slot->thumbnail      = cv::Mat();
+  free_slot->thumbnail_size = 0;
+
+  ++metrics_.allocations;
+
+  return *free_slot;
+}
+
+AssemblyFramePool::Slot* AssemblyFramePool::slot_of(const cv::Mat& img)
+{
+  if(img.empty() || img.u == nullptr){ return nullptr; }
+
+  for(auto& slot : slots_)
+  {
+    if((img.u == slot.frame.u && img.data == slot.frame.data && img.size() == slot.frame.size())
+    || (img.u == slot.color.u && img.data == slot.color.data && img.size() == slot.color.size()))
+    {
+      return &slot;
+    }
+  }
+
+  return nullptr;
+}
+
+cv::Mat AssemblyFramePool::frame(const cv::Mat& img)
+{
+  return this->frame(img.data, img.rows, img.cols, img.type(), img.step);
+}
+
+cv::Mat AssemblyFramePool::frame(const void* data, const int rows, const int cols, const int type, const size_t step)
+{
+  QMutexLocker ml(&mutex_);
+
+  Slot& slot = this->acquire(rows, cols, type);
+
+  cv::Mat(rows, cols, type, const_cast<void*>(data), step).copyTo(slot.frame);
+
+  ++metrics_.copies;
+
+  return slot.frame;
+}
+
+cv::Mat AssemblyFramePool::color(const cv::Mat& img)
+{
+  if(img.channels() > 1){ return img; }
+
+  QMutexLocker ml(&mutex_);
+
+  Slot* slot = this->slot_of(img);
+
+  if(slot && (slot->color.empty() == false))
+  {
+    ++metrics_.cache_hits;
+
+    return slot->color;
+  }
+
+  cv::Mat img_color;
+  cv::cvtColor(img, img_color, cv::COLOR_GRAY2BGR);
+
+  ++metrics_.conversions;
+
+  if(slot){ slot->color = img_color; }
+
+  return img_color;
+}
+
+cv::Mat AssemblyFramePool::gray(const cv::Mat& img)
+{
+  if(img.channels() == 1){ return img; }
+
+  QMutexLocker ml(&mutex_);
+
+  Slot* slot = this->slot_of(img);
+
+  if(slot)
+  {
+    // colour product of a grayscale frame
+    if(slot->frame.channels() == 1)
+    {
+      ++metrics_.cache_hits;
+
+      return slot->frame;
+    }
+
+    if(slot->gray.empty() == false)
+    {
+      ++metrics_.cache_hits;
+
+      return slot->gray;
+    }
+  }
+
+  cv::Mat img_gray;
+  cv::cvtColor(img, img_gray, cv::COLOR_BGR2GRAY);
+
+  ++metrics_.conversions;
+
+  if(slot){ slot->gray = img_gray; }
+
+  return img_gray;
+}
+
+cv::Mat AssemblyFramePool::thumbnail(const cv::Mat& img, const int max_size)
+{
+  if(img.empty() || max_size <= 0){ return cv::Mat(); }
+
+  const double scale = double(max_size) / std::max(img.cols, img.rows);
+
+  if(scale >= 1.){ return img; }
+
+  QMutexLocker ml(&mutex_);
+
+  Slot* slot = this->slot_of(img);
+
+  // thumbnails are kept per frame, not per colour product
+  if(slot && (img.data != slot->frame.data)){ slot = nullptr; }
+
+  if(slot && (slot->thumbnail.empty() == false) && (slot->thumbnail_size == max_size))
+  {
+    ++metrics_.cache_hits;
+
+    return slot->thumbnail;
+  }
+
+  cv::Mat img_thumb;
+  cv::resize(img, img_thumb, cv::Size(), scale, scale, cv::INTER_AREA);
+
+  ++metrics_.conversions;
+
+  if(slot)
+  {
+    slot->thumbnail      = img_thumb;
+    slot->thumbnail_size = max_size;
+  }
+
+  return img_thumb;
+}
+
+AssemblyFramePool::Metrics AssemblyFramePool::metrics() const
+{
+  QMutexLocker ml(&mutex_);
+
+  return metrics_;
+}
+
+void AssemblyFramePool::reset_metrics()
+{
+  QMutexLocker ml(&mutex_);
+
+  metrics_ = Metrics();
+}
+
+void AssemblyFramePool::set_max_frames(const unsigned int max_frames)
+{
+  QMutexLocker ml(&mutex_);
+
+  max_frames_ = std::max(1u, max_frames);
+
+  if(slots_.size() > max_frames_){ slots_.resize(max_frames_); }
+
+  next_slot_ = 0;
+}
+
+void AssemblyFramePool::clear()
+{
+  QMutexLocker ml(&mutex_);
+
+  slots_.clear();
+
+  next_slot_ = 0;
+}
@@ -0,0 +1,96 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2017 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ASSEMBLYFRAMEPOOL_H
+#define ASSEMBLYFRAMEPOOL_H
+
+/*  Description:
+ *   Pool of recycled camera frames
+ *
+ *   The camera copies every new image once into a frame of the pool
+ *   and emits it; all consumers share this frame by reference (cv::Mat
+ *   reference counting) and must treat it as read-only. A frame is
+ *   recycled for a later image as soon as no consumer holds it anymore.
+ *
+ *   Derived products of a frame (colour, grayscale, thumbnail) are
+ *   computed at most once per frame and shared by all consumers asking
+ *   for them; they are dropped when the frame is recycled.
+ */
+
+#include <QMutex>
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+class AssemblyFramePool
+{
+ public:
+
+  struct Metrics
+  {
+    unsigned long frames;       // frames handed out to the cameras
+    unsigned long allocations;  // frame buffers allocated
+    unsigned long reuses;       // frame buffers recycled
+    unsigned long copies;       // images copied into frames
+    unsigned long conversions;  // derived products computed
+    unsigned long cache_hits;   // derived products taken from a frame
+  };
+
+  static AssemblyFramePool* instance();
+
+  cv::Mat frame(const cv::Mat& img);
+  cv::Mat frame(const void* data, const int rows, const int cols, const int type, const size_t step=cv::Mat::AUTO_STEP);
+
+  cv::Mat color    (const cv::Mat& img);
+  cv::Mat gray     (const cv::Mat& img);
+  cv::Mat thumbnail(const cv::Mat& img, const int max_size);
+
+  Metrics metrics() const;
+  void reset_metrics();
+
+  void set_max_frames(const unsigned int);
+  unsigned int max_frames() const { return max_frames_; }
+
+  void clear();
+
+ protected:
+
+  explicit AssemblyFramePool(const unsigned int max_frames=16);
+
+  struct Slot
+  {
+    cv::Mat frame;
+    cv::Mat color;
+    cv::Mat gray;
+    cv::Mat thumbnail;
+    int     thumbnail_size;
+  };
+
+  Slot& acquire(const int rows, const int cols, const int type);
+  Slot* slot_of(const cv::Mat& img);
+
+  std::vector<Slot> slots_;
+  unsigned int      next_slot_;
+  unsigned int      max_frames_;
+
+  Metrics metrics_;
+
+ private:
+
+  mutable QMutex mutex_;
+
+  AssemblyFramePool(const AssemblyFramePool&) = delete;
+  AssemblyFramePool& operator=(const AssemblyFramePool&) = delete;
+};
+
+#endif // ASSEMBLYFRAMEPOOL_H
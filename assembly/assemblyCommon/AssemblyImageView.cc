@@ -15,6 +15,7 @@
 
 #include <AssemblyImageView.h>
 #include <AssemblyUtilities.h>
+#include <AssemblyFramePool.h>
 
 #include <sstream>
 
@@ -221,21 +222,12 @@ AssemblyImageView::AssemblyImageView(QWidget* parent) :
 
 void AssemblyImageView::update_image(const cv::Mat& img, const bool update_image_raw)
 {
-  if(img.channels() == 1)
-  {
-    cv::Mat img_color;
-    cv::cvtColor(img, img_color, cv::COLOR_GRAY2BGR);
-
-    image_ = img_color.clone();
-  }
-  else
-  {
-    image_ = img.clone();
-  }
+  // shared, read-only: drawing is done on copies
+  image_ = AssemblyFramePool::instance()->color(img);
 
   if(update_image_raw)
   {
-    image_raw_ = image_.clone();
+    image_raw_ = image_;
 
     image_modified_ = false;
   }
@@ -577,7 +569,7 @@ void AssemblyImageView::mouseDoubleClickEvent(QMouseEvent* event)
     // if(countNonZero(image_) < 1) {return;} //No action if image not yet loaded
     if(image_.empty()) {return;} //No action if image not yet loaded
 
-    cv::Mat img_original = image_.clone(); //Save image before modification
+    const cv::Mat img_original = image_; //Save image before modification
     cv::Mat img_modif = image_.clone(); //Image copy to be modified
 
     //Get height and width of displayed image (QT coordinates -- based on screen pixels ?)
@@ -14,9 +14,12 @@
 
 #include <AssemblyObjectFinderPatRec.h>
 #include <AssemblyUtilities.h>
+#include <AssemblyFramePool.h>
 
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <cmath>
 
 #include <QFile>
 #include <QTextStream>
@@ -203,17 +206,7 @@ void AssemblyObjectFinderPatRec::update_image_master(const cv::Mat& img)
 {
   QMutexLocker ml(&mutex_);
 
-  if(img.channels() > 1)
-  {
-    img_master_ = img;
-  }
-  else
-  {
-    cv::Mat img_color;
-    cv::cvtColor(img, img_color, cv::COLOR_GRAY2BGR);
-
-    img_master_ = img_color.clone();
-  }
+  img_master_ = AssemblyFramePool::instance()->color(img);
 
   if(!updated_img_master_){ updated_img_master_ = true; }
 
@@ -423,28 +416,7 @@ void AssemblyObjectFinderPatRec::template_matching(const AssemblyObjectFinderPat
 
   NQLog("AssemblyObjectFinderPatRec", NQLog::Spam) << "template_matching" << ": initiated matching routine with angular scan";
 
-  // First, get angle-prescan angle: best guess of central value for finer angular scan
-  double angle_prescan(-9999.);
-
-  if(prescan_angles.size() > 0)
-  {
-    double best_FOM(0.);
-
-    for(unsigned int i=0; i<prescan_angles.size(); ++i)
-    {
-      const double i_angle = prescan_angles.at(i);
-
-      double i_FOM(0.);
-      cv::Point i_matchLoc;
-
-      this->PatRec(i_FOM, i_matchLoc, img_master_PatRec, img_templa_PatRec_gs, i_angle, match_method);
-
-      const bool update = (i==0) || (use_minFOM ? (i_FOM < best_FOM) : (i_FOM > best_FOM));
-
-      if(update){ best_FOM = i_FOM; angle_prescan = i_angle; }
-    }
-  }
-  else
+  if(prescan_angles.size() == 0)
   {
     NQLog("AssemblyObjectFinderPatRec", NQLog::Critical) << "template_matching"
        << ": empty list of pre-scan angles, stopping Pattern Recognition";
@@ -452,12 +424,6 @@ void AssemblyObjectFinderPatRec::template_matching(const AssemblyObjectFinderPat
     return;
   }
 
-  NQLog("AssemblyObjectFinderPatRec", NQLog::Message) << "template_matching" << ": pre-scan estimate of best-angle yields best-angle=" << angle_prescan;
-  // ----------------
-
-  NQLog("AssemblyObjectFinderPatRec", NQLog::Message) << "template_matching" << ": angular scan parameters"
-     << "(min="<< angle_prescan+angle_fine_min << ", max=" << angle_prescan+angle_fine_max << ", step=" << angle_fine_step << ")";
-
   if(angle_fine_step == 0.)
   {
     NQLog("AssemblyObjectFinderPatRec", NQLog::Critical) << "template_matching"
@@ -471,39 +437,152 @@ void AssemblyObjectFinderPatRec::template_matching(const AssemblyObjectFinderPat
     return;
   }
 
-  const int N_rotations = (2 * int((angle_fine_max-angle_fine_min) / angle_fine_step));
+  //
+  // coarse-to-fine strategy:
+  //   - the pre-scan and the fine angular scan are first done on downscaled images
+  //     (image pyramid, up to 1/4 of the original size), giving the best-match angle and position
+  //   - the fine angular scan is then repeated at full resolution, but the rotation
+  //     and the template matching are restricted to a region around the coarse best-match position
+  //   - the best-match position and angle are refined below pixel and step size
+  //     with a parabola through the FOM values next to the best match
+  //
+  // the angles of each scan are independent of each other,
+  // and are evaluated in parallel (cv::parallel_for_)
+  //
+  cv::Mat img_master_coarse = img_master_PatRec;
+  cv::Mat img_templa_coarse = img_templa_PatRec_gs;
 
-  std::vector<std::pair<double, double> > vec_angleNfom;
-  vec_angleNfom.reserve(N_rotations);
+  int pyramid_scale(1);
+  while((pyramid_scale < 4) && (std::min(img_templa_coarse.cols, img_templa_coarse.rows) >= 32))
+  {
+    cv::pyrDown(img_master_coarse, img_master_coarse);
+    cv::pyrDown(img_templa_coarse, img_templa_coarse);
+
+    pyramid_scale *= 2;
+  }
+
+  NQLog("AssemblyObjectFinderPatRec", NQLog::Spam) << "template_matching"
+     << ": coarse angular scan on images downscaled by a factor " << pyramid_scale;
+
+  const cv::Scalar avgPixelIntensity        = cv::mean(img_master_PatRec);
+  const cv::Scalar avgPixelIntensity_coarse = cv::mean(img_master_coarse);
+
+  // pre-scan (coarse): best guess of central value for finer angular scan
+  std::vector<double>      prescan_FOMs(prescan_angles.size());
+  std::vector<cv::Point2d> prescan_matchLocs(prescan_angles.size());
+
+  cv::parallel_for_(cv::Range(0, int(prescan_angles.size())), [&](const cv::Range& range)
+  {
+    for(int i=range.start; i<range.end; ++i)
+    {
+      this->PatRec(prescan_FOMs.at(i), prescan_matchLocs.at(i), img_master_coarse, img_templa_coarse, prescan_angles.at(i), match_method, cv::Rect(), avgPixelIntensity_coarse);
+    }
+  });
+
+  const unsigned int idx_prescan = this->best_FOM_index(prescan_FOMs, use_minFOM);
+  const double angle_prescan = prescan_angles.at(idx_prescan);
+
+  NQLog("AssemblyObjectFinderPatRec", NQLog::Message) << "template_matching" << ": pre-scan estimate of best-angle yields best-angle=" << angle_prescan;
+  // ----------------
 
-  double    best_FOM  (0.);
-  double    best_angle(0.);
-  cv::Point best_matchLoc;
+  NQLog("AssemblyObjectFinderPatRec", NQLog::Message) << "template_matching" << ": angular scan parameters"
+     << "(min="<< angle_prescan+angle_fine_min << ", max=" << angle_prescan+angle_fine_max << ", step=" << angle_fine_step << ")";
 
+  std::vector<double> fine_angles;
   for(double angle_fine=angle_fine_min; angle_fine<=angle_fine_max; angle_fine += angle_fine_step)
   {
-    const unsigned int scan_counter = vec_angleNfom.size();
+    fine_angles.emplace_back(angle_prescan + angle_fine);
+  }
 
-    const double i_angle = angle_prescan + angle_fine;
+  // fine angular scan (coarse)
+  std::vector<double>      coarse_FOMs(fine_angles.size());
+  std::vector<cv::Point2d> coarse_matchLocs(fine_angles.size());
 
-    double i_FOM(0.);
-    cv::Point i_matchLoc;
+  cv::parallel_for_(cv::Range(0, int(fine_angles.size())), [&](const cv::Range& range)
+  {
+    for(int i=range.start; i<range.end; ++i)
+    {
+      this->PatRec(coarse_FOMs.at(i), coarse_matchLocs.at(i), img_master_coarse, img_templa_coarse, fine_angles.at(i), match_method, cv::Rect(), avgPixelIntensity_coarse);
+    }
+  });
 
-    this->PatRec(i_FOM, i_matchLoc, img_master_PatRec, img_templa_PatRec_gs, i_angle, match_method, output_subdir);
+  const unsigned int idx_coarse = this->best_FOM_index(coarse_FOMs, use_minFOM);
 
-    const bool update = (scan_counter == 0) || (use_minFOM ? (i_FOM < best_FOM) : (i_FOM > best_FOM));
+  // coarse best-match position in pixel-coordinates of the full-resolution master image
+  const cv::Point2d coarse_matchLoc = coarse_matchLocs.at(idx_coarse) * double(pyramid_scale);
 
-    if(update)
+  NQLog("AssemblyObjectFinderPatRec", NQLog::Spam) << "template_matching"
+     << ": coarse angular scan: best_angle=" << fine_angles.at(idx_coarse)
+     << ", best matching position in pixels x = " << coarse_matchLoc.x << ", y = " << coarse_matchLoc.y;
+
+  //
+  // search region of the full-resolution scan:
+  // the template corner moves with the angle by at most (template diagonal x angle difference),
+  // on top of the precision of the coarse position
+  //
+  const double templa_diag = std::hypot(img_templa_PatRec_gs.cols, img_templa_PatRec_gs.rows);
+  const int search_margin = 2 * pyramid_scale + 2 + int(std::ceil(templa_diag * std::sin(2. * angle_fine_max * (M_PI/180.))));
+
+  const cv::Point2f src_center(img_master_PatRec.cols/2.0F, img_master_PatRec.rows/2.0F);
+
+  // fine angular scan (full resolution)
+  std::vector<double>      fine_FOMs(fine_angles.size());
+  std::vector<cv::Point2d> fine_matchLocs(fine_angles.size());
+
+  auto search_region = [&](const double angle)
+  {
+    // expected position of the template corner in the master image rotated by -angle
+    const cv::Point2f loc_rot = this->RotatePoint(src_center, coarse_matchLoc, angle);
+
+    const cv::Rect roi(int(loc_rot.x) - search_margin, int(loc_rot.y) - search_margin,
+                       img_templa_PatRec_gs.cols + 2 * search_margin, img_templa_PatRec_gs.rows + 2 * search_margin);
+
+    return roi;
+  };
+
+  cv::parallel_for_(cv::Range(0, int(fine_angles.size())), [&](const cv::Range& range)
+  {
+    for(int i=range.start; i<range.end; ++i)
     {
-      best_FOM      = i_FOM;
-      best_angle    = i_angle;
-      best_matchLoc = i_matchLoc;
+      this->PatRec(fine_FOMs.at(i), fine_matchLocs.at(i), img_master_PatRec, img_templa_PatRec_gs, fine_angles.at(i), match_method, search_region(fine_angles.at(i)), avgPixelIntensity, output_subdir);
     }
+  });
 
-    vec_angleNfom.emplace_back(std::make_pair(i_angle, i_FOM));
+  std::vector<std::pair<double, double> > vec_angleNfom;
+  vec_angleNfom.reserve(fine_angles.size());
+
+  for(unsigned int i=0; i<fine_angles.size(); ++i)
+  {
+    vec_angleNfom.emplace_back(std::make_pair(fine_angles.at(i), fine_FOMs.at(i)));
 
     NQLog("AssemblyObjectFinderPatRec", NQLog::Spam) << "template_matching"
-       << ": angular scan: [" << scan_counter << "] angle=" << i_angle << ", FOM=" << i_FOM;
+       << ": angular scan: [" << i << "] angle=" << fine_angles.at(i) << ", FOM=" << fine_FOMs.at(i);
+  }
+
+  const unsigned int idx_fine = this->best_FOM_index(fine_FOMs, use_minFOM);
+
+  double      best_FOM     (fine_FOMs     .at(idx_fine));
+  double      best_angle   (fine_angles   .at(idx_fine));
+  cv::Point2d best_matchLoc(fine_matchLocs.at(idx_fine));
+
+  // refinement of the best-match angle below the step size of the angular scan
+  if((idx_fine > 0) && (idx_fine+1 < fine_angles.size()))
+  {
+    const double refined_angle = best_angle + angle_fine_step * assembly::ParabolaVertexOffset(fine_FOMs.at(idx_fine-1), best_FOM, fine_FOMs.at(idx_fine+1));
+
+    double      refined_FOM(0.);
+    cv::Point2d refined_matchLoc;
+
+    this->PatRec(refined_FOM, refined_matchLoc, img_master_PatRec, img_templa_PatRec_gs, refined_angle, match_method, search_region(refined_angle), avgPixelIntensity);
+
+    const bool update = (use_minFOM ? (refined_FOM <= best_FOM) : (refined_FOM >= best_FOM));
+
+    if(update)
+    {
+      best_FOM      = refined_FOM;
+      best_angle    = refined_angle;
+      best_matchLoc = refined_matchLoc;
+    }
   }
 
   NQLog("AssemblyObjectFinderPatRec", NQLog::Message) << "template_matching"
@@ -660,7 +739,14 @@ void AssemblyObjectFinderPatRec::template_matching(const AssemblyObjectFinderPat
   return;
 }
 
-void AssemblyObjectFinderPatRec::PatRec(double& fom, cv::Point& match_loc, const cv::Mat& img_master_PatRec, const cv::Mat& img_templa_PatRec, const double angle, const int match_method, const std::string& out_dir) const
+//
+// template matching of the template image on the master image rotated by -angle:
+//   - the rotation and the matching can be restricted to a region (roi) of the rotated master image,
+//     the full rotated master image is used if the region is empty or does not contain the template
+//   - the best-match position is refined below pixel size with a parabola through the neighbouring FOM values,
+//     and returned in pixel-coordinates of the (unrotated) master image
+//
+void AssemblyObjectFinderPatRec::PatRec(double& fom, cv::Point2d& match_loc, const cv::Mat& img_master_PatRec, const cv::Mat& img_templa_PatRec, const double angle, const int match_method, const cv::Rect& roi, const cv::Scalar& border_value, const std::string& out_dir) const
 {
   // rotated master image
   cv::Mat img_master_PatRec_rot;
@@ -675,11 +761,21 @@ void AssemblyObjectFinderPatRec::PatRec(double& fom, cv::Point& match_loc, const
   //
   const double angle_master = (-1.0 * angle);
 
-  const cv::Mat rot_mat = cv::getRotationMatrix2D(src_center, angle_master, 1.0);
+  cv::Mat rot_mat = cv::getRotationMatrix2D(src_center, angle_master, 1.0);
+
+  // region of the rotated master image
+  cv::Rect region = roi & cv::Rect(0, 0, img_master_PatRec.cols, img_master_PatRec.rows);
+
+  if((region.width < img_templa_PatRec.cols) || (region.height < img_templa_PatRec.rows))
+  {
+    region = cv::Rect(0, 0, img_master_PatRec.cols, img_master_PatRec.rows);
+  }
 
-  const cv::Scalar avgPixelIntensity = cv::mean(img_master_PatRec);
+  // shift the rotation, so that the output image starts at the corner of the region
+  rot_mat.at<double>(0, 2) -= region.x;
+  rot_mat.at<double>(1, 2) -= region.y;
 
-  warpAffine(img_master_PatRec, img_master_PatRec_rot, rot_mat, img_master_PatRec.size(), cv::INTER_NEAREST, cv::BORDER_CONSTANT, avgPixelIntensity);
+  warpAffine(img_master_PatRec, img_master_PatRec_rot, rot_mat, region.size(), cv::INTER_NEAREST, cv::BORDER_CONSTANT, border_value);
 
   if(out_dir != "")
   {
@@ -694,7 +790,7 @@ void AssemblyObjectFinderPatRec::PatRec(double& fom, cv::Point& match_loc, const
 
   // matrix with PatRec Figure-Of-Merit values
   cv::Mat result_mat;
-  result_mat.create((img_master_PatRec.rows-img_templa_PatRec.rows+1), (img_master_PatRec.cols-img_templa_PatRec.cols+1), CV_32FC1);
+  result_mat.create((img_master_PatRec_rot.rows-img_templa_PatRec.rows+1), (img_master_PatRec_rot.cols-img_templa_PatRec.cols+1), CV_32FC1);
 
   matchTemplate(img_master_PatRec_rot, img_templa_PatRec, result_mat, match_method);
 
@@ -705,17 +801,48 @@ void AssemblyObjectFinderPatRec::PatRec(double& fom, cv::Point& match_loc, const
 
   const bool use_minFOM = ((match_method  == cv::TM_SQDIFF) || (match_method == cv::TM_SQDIFF_NORMED));
 
-  if(use_minFOM){ match_loc = minLoc; fom = minVal; }
-  else          { match_loc = maxLoc; fom = maxVal; }
+  cv::Point best_loc;
+
+  if(use_minFOM){ best_loc = minLoc; fom = minVal; }
+  else          { best_loc = maxLoc; fom = maxVal; }
+
+  // sub-pixel position of the best match
+  match_loc = cv::Point2d(best_loc.x, best_loc.y);
+
+  if((best_loc.x > 0) && (best_loc.x+1 < result_mat.cols))
+  {
+    match_loc.x += assembly::ParabolaVertexOffset(result_mat.at<float>(best_loc.y, best_loc.x-1), result_mat.at<float>(best_loc), result_mat.at<float>(best_loc.y, best_loc.x+1));
+  }
+
+  if((best_loc.y > 0) && (best_loc.y+1 < result_mat.rows))
+  {
+    match_loc.y += assembly::ParabolaVertexOffset(result_mat.at<float>(best_loc.y-1, best_loc.x), result_mat.at<float>(best_loc), result_mat.at<float>(best_loc.y+1, best_loc.x));
+  }
   // -----------
 
   // convert match-loc val of rotated  master image
   // to pixel-coordinates  in original master image
-  match_loc = this->RotatePoint(src_center, match_loc, angle_master);
+  const cv::Point2f match_loc_rot(match_loc.x + region.x, match_loc.y + region.y);
+
+  const cv::Point2f match_loc_master = this->RotatePoint(src_center, match_loc_rot, angle_master);
+
+  match_loc = cv::Point2d(match_loc_master.x, match_loc_master.y);
 
   return;
 }
 
+unsigned int AssemblyObjectFinderPatRec::best_FOM_index(const std::vector<double>& foms, const bool use_minFOM) const
+{
+  unsigned int best_idx(0);
+
+  for(unsigned int i=1; i<foms.size(); ++i)
+  {
+    if(use_minFOM ? (foms.at(i) < foms.at(best_idx)) : (foms.at(i) > foms.at(best_idx))){ best_idx = i; }
+  }
+
+  return best_idx;
+}
+
 cv::Point2f AssemblyObjectFinderPatRec::RotatePoint(const cv::Point2f& p, const double deg) const
 {
   const double rad = deg * (M_PI/180.);
@@ -91,7 +91,9 @@ class AssemblyObjectFinderPatRec : public QObject
   bool updated_img_master_;
   bool updated_img_master_PatRec_;
 
-  void PatRec(double&, cv::Point&, const cv::Mat&, const cv::Mat&, const double, const int, const std::string& out_dir="") const;
+  void PatRec(double&, cv::Point2d&, const cv::Mat&, const cv::Mat&, const double, const int, const cv::Rect&, const cv::Scalar&, const std::string& out_dir="") const;
+
+  unsigned int best_FOM_index(const std::vector<double>&, const bool) const;
 
   cv::Point2f RotatePoint(const cv::Point2f&, const double) const;
   cv::Point2f RotatePoint(const cv::Point2f&, const cv::Point2f&, const double) const;
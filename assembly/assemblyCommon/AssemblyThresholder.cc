@@ -13,6 +13,7 @@
 #include <nqlogger.h>
 
 #include <AssemblyThresholder.h>
+#include <AssemblyFramePool.h>
 
 AssemblyThresholder::AssemblyThresholder(QObject* parent) :
   QObject(parent),
@@ -34,17 +35,7 @@ void AssemblyThresholder::update_image_raw(const cv::Mat& img)
 {
 //  mutex_.lock();
 
-  if(img.channels() > 1)
-  {
-    img_raw_ = img;
-  }
-  else
-  {
-    cv::Mat img_color;
-    cv::cvtColor(img, img_color, cv::COLOR_GRAY2BGR);
-
-    img_raw_ = img_color.clone();
-  }
+  img_raw_ = AssemblyFramePool::instance()->color(img);
 
   if(updated_img_raw_ == false){ updated_img_raw_ = true ; }
   if(updated_img_bin_ == true ){ updated_img_bin_ = false; }
@@ -99,18 +90,8 @@ void AssemblyThresholder::update_image_binary_threshold(const int threshold_valu
 
 cv::Mat AssemblyThresholder::get_image_binary_threshold(const cv::Mat& img, const int threshold) const
 {
-  // greyscale image
-  cv::Mat img_gs(img.size(), img.type());
-
-  if(img.channels() > 1)
-  {
-    // convert color to GS
-    cv::cvtColor(img, img_gs, cv::COLOR_BGR2GRAY);
-  }
-  else
-  {
-    img_gs = img.clone();
-  }
+  // greyscale image (shared with the camera frame, if any)
+  const cv::Mat img_gs = AssemblyFramePool::instance()->gray(img);
 
   // binary image
   cv::Mat img_bin(img_gs.size(), img_gs.type());
@@ -164,18 +145,8 @@ void AssemblyThresholder::update_image_binary_adaptiveThreshold(const int blocks
 
 cv::Mat AssemblyThresholder::get_image_binary_adaptiveThreshold(const cv::Mat& img, const int blocksize) const
 {
-  // greyscale image
-  cv::Mat img_gs(img.size(), img.type());
-
-  if(img.channels() > 1)
-  {
-    // convert color to GS
-    cv::cvtColor(img, img_gs, cv::COLOR_BGR2GRAY);
-  }
-  else
-  {
-    img_gs = img.clone();
-  }
+  // greyscale image (shared with the camera frame, if any)
+  const cv::Mat img_gs = AssemblyFramePool::instance()->gray(img);
 
   // binary image
   cv::Mat img_bin(img_gs.size(), img_gs.type());
@@ -15,6 +15,7 @@
 
 #include <AssemblyThresholderView.h>
 #include <AssemblyUtilities.h>
+#include <AssemblyFramePool.h>
 
 #include <QFileDialog>
 #include <QGridLayout>
@@ -200,17 +201,7 @@ AssemblyThresholderView::AssemblyThresholderView(QWidget* parent) :
 
 void AssemblyThresholderView::update_image_raw(const cv::Mat& img)
 {
-  if(img.channels() == 1)
-  {
-    cv::Mat img_color;
-    cv::cvtColor(img, img_color, cv::COLOR_GRAY2BGR);
-
-    imgraw_ = img_color.clone();
-  }
-  else
-  {
-    imgraw_ = img.clone();
-  }
+  imgraw_ = AssemblyFramePool::instance()->color(img);
 
   NQLog("AssemblyThresholderView", NQLog::Spam) << "update_image_raw"
      << ": emitting signal \"image_raw_updated\"";
@@ -221,17 +212,7 @@ void AssemblyThresholderView::update_image_raw(const cv::Mat& img)
 
 void AssemblyThresholderView::update_image_binary(const cv::Mat& img)
 {
-  if(img.channels() == 1)
-  {
-    cv::Mat img_color;
-    cv::cvtColor(img, img_color, cv::COLOR_GRAY2BGR);
-
-    imgbin_ = img_color.clone();
-  }
-  else
-  {
-    imgbin_ = img.clone();
-  }
+  imgbin_ = AssemblyFramePool::instance()->color(img);
 
   NQLog("AssemblyThresholderView", NQLog::Spam) << "update_image_binary"
      << ": emitting signal \"image_binary_updated\"";
@@ -11,6 +11,7 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <AssemblyUEyeCamera.h>
+#include <AssemblyFramePool.h>
 #include <nqlogger.h>
 
 AssemblyUEyeCameraEventThread::AssemblyUEyeCameraEventThread() :
@@ -501,14 +502,16 @@ void AssemblyUEyeCamera::eventHappend()
     nNum = getImageNumber(lastBuffer_);
     ret = is_LockSeqBuf(cameraHandle_, nNum, lastBuffer_);
 
-    memcpy(image_.ptr(), (uchar*)lastBuffer_, bufferProps_.width * bufferProps_.height * 1);
+    // single copy out of the sequence buffer into a recycled frame,
+    // shared read-only by all consumers of the signal
+    const cv::Mat image = AssemblyFramePool::instance()->frame(lastBuffer_, bufferProps_.height, bufferProps_.width, bufferProps_.cvimgformat);
 
     is_UnlockSeqBuf(cameraHandle_, nNum, lastBuffer_);
 
     NQLog("AssemblyUEyeCamera", NQLog::Debug) << "eventHappend"
        << ": emitting signal \"imageAcquired\"";
 
-    emit imageAcquired(image_);
+    emit imageAcquired(image);
 }
 
 void AssemblyUEyeCamera::acquireImage()
@@ -618,8 +621,6 @@ void AssemblyUEyeCamera::setupCapture()
             break;
         }
 
-        image_.create(bufferProps_.height, bufferProps_.width, bufferProps_.cvimgformat);
-
         allocImages();
     }
 }
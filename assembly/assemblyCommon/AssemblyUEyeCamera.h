@@ -122,8 +122,6 @@ class AssemblyUEyeCamera : public AssemblyVUEyeCamera
 
     char *lastBuffer_;
     UEYE_IMAGE images_[5];
-
-    cv::Mat image_;
 };
 
 #endif // ASSEMBLYUEYECAMERA_H
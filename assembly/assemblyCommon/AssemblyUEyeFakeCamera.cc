@@ -11,6 +11,7 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <AssemblyUEyeFakeCamera.h>
+#include <AssemblyFramePool.h>
 #include <ApplicationConfig.h>
 #include <nqlogger.h>
 
@@ -221,12 +222,23 @@ void AssemblyUEyeFakeCamera::acquireImage()
 {
     if(cameraState_ != State::READY){ return; }
 
-    image_ = cv::imread(imageFilenames_[imageIndex_++], cv::IMREAD_GRAYSCALE);
+    // files are decoded once, each image is then copied into a frame
+    // of the pool like the sequence buffers of the real camera
+    const std::string& filename = imageFilenames_[imageIndex_++];
+
+    cv::Mat& image_file = images_[filename];
+
+    if(image_file.empty())
+    {
+        image_file = cv::imread(filename, cv::IMREAD_GRAYSCALE);
+    }
+
+    const cv::Mat image = image_file.empty() ? image_file : AssemblyFramePool::instance()->frame(image_file);
 
     NQLog("AssemblyUEyeFakeCamera", NQLog::Debug) << "acquireImage"
        << ": emitting signal \"imageAcquired\"";
 
-    emit imageAcquired(image_);
+    emit imageAcquired(image);
 
     if(imageIndex_ == imageFilenames_.size()){ imageIndex_ = 0; }
 }
@@ -47,7 +47,7 @@ class AssemblyUEyeFakeCamera : public AssemblyVUEyeCamera
 
  protected:
 
-  cv::Mat image_;
+  std::map<std::string, cv::Mat> images_;
   std::vector<std::string> imageFilenames_;
   size_t imageIndex_;
 
@@ -11,6 +11,7 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <AssemblyUEyeView.h>
+#include <AssemblyFramePool.h>
 
 #include <QPainter>
 
@@ -35,19 +36,11 @@ void AssemblyUEyeView::setImage(const cv::Mat& newImage)
 {
     QMutexLocker lock(&mutex_);
 
-    if(newImage.channels() == 1)
-    {
-        cv::Mat temp;
-        cvtColor(newImage, temp, cv::COLOR_GRAY2RGB);
+    // colour product of a grayscale frame is shared with the other views
+    const cv::Mat temp = AssemblyFramePool::instance()->color(newImage);
 
-        image_ = QImage((const uchar *) temp.data, temp.cols, temp.rows, temp.step, QImage::Format_RGB888);
-        image_.bits();
-    }
-    else
-    {
-        image_ = QImage((const uchar *) newImage.data, newImage.cols, newImage.rows, newImage.step, QImage::Format_RGB888);
-        image_.bits();
-    }
+    image_ = QImage((const uchar *) temp.data, temp.cols, temp.rows, temp.step, QImage::Format_RGB888);
+    image_.bits();
 
     lock.unlock();
 
@@ -159,3 +159,33 @@ void assembly::rotation2D_deg(double& X_1, double& Y_1, const double angle_deg,
 
   return;
 }
+
+//
+// position of the vertex of the parabola through (-1, f_m), (0, f_0) and (+1, f_p),
+// relative to the central point; used to refine the position of a minimum (or maximum)
+// of a sampled function below the sampling step. The offset is restricted to [-1, +1].
+//
+double assembly::ParabolaVertexOffset(const double f_m, const double f_0, const double f_p)
+{
+  const double den = (f_m - 2.0 * f_0 + f_p);
+
+  if(den == 0.){ return 0.; }
+
+  const double offset = 0.5 * (f_m - f_p) / den;
+
+  return std::max(-1.0, std::min(+1.0, offset));
+}
+
+//
+// abscissa of the vertex of the parabola through (x_1, f_1), (x_2, f_2) and (x_3, f_3),
+// for points at arbitrary distances; returns x_2 if the points do not define a parabola
+//
+double assembly::ParabolaVertex(const double x_1, const double f_1, const double x_2, const double f_2, const double x_3, const double f_3)
+{
+  const double num = (x_2 - x_1) * (x_2 - x_1) * (f_2 - f_3) - (x_2 - x_3) * (x_2 - x_3) * (f_2 - f_1);
+  const double den = (x_2 - x_1) * (f_2 - f_3) - (x_2 - x_3) * (f_2 - f_1);
+
+  if(den == 0.){ return x_2; }
+
+  return x_2 - 0.5 * num / den;
+}
@@ -54,6 +54,10 @@ namespace assembly {
   // geometry helpers
   void rotation2D_deg(double&, double&, const double, const double, const double);
 
+  // numerical helpers
+  double ParabolaVertexOffset(const double, const double, const double);
+  double ParabolaVertex(const double, const double, const double, const double, const double, const double);
+
 }
 
 template <class T>
@@ -22,7 +22,12 @@
 #include <sstream>
 #include <vector>
 #include <cstdio>
+#include <cmath>
 #include <memory>
+#include <algorithm>
+
+#include <QRunnable>
+#include <QTimer>
 
 #include <TCanvas.h>
 #include <TGraph.h>
@@ -30,6 +35,21 @@
 
 int AssemblyZFocusFinder::exe_counter_ = -1;
 
+// writes one image to disk, executed on the image-writer thread of AssemblyZFocusFinder
+class AssemblyZFocusFinderImageWriter : public QRunnable
+{
+ public:
+
+  AssemblyZFocusFinderImageWriter(const cv::Mat& img, const std::string& path) : img_(img), path_(path) {}
+
+  void run() override { cv::imwrite(path_, img_); }
+
+ protected:
+
+  const cv::Mat     img_;
+  const std::string path_;
+};
+
 AssemblyZFocusFinder::AssemblyZFocusFinder(const QString& output_dir_prepath, const AssemblyVUEyeCamera* camera, const LStepExpressMotionManager* motion_manager, QObject* parent)
  : QObject(parent)
 
@@ -46,6 +66,21 @@ AssemblyZFocusFinder::AssemblyZFocusFinder(const QString& output_dir_prepath, co
 
  , zrelm_index_(0)
 
+ , focus_mode_(GridScan)
+
+ , focus_motions_(0)
+
+ , sweep_started_(false)
+ , sweep_moving_(false)
+ , sweep_images_pending_(0)
+ , sweep_first_image_(0)
+ , sweep_zstart_(0.)
+ , sweep_zend_(0.)
+ , sweep_tstart_(0)
+ , sweep_tend_(0)
+ , sweep_velocity_init_(0.)
+ , sweep_velocity_checks_(0)
+
  , output_dir_("")
 {
   // initialization
@@ -66,6 +101,32 @@ AssemblyZFocusFinder::AssemblyZFocusFinder(const QString& output_dir_prepath, co
 
   focus_stepsize_min_ = config->getDefaultValue<double>("main", "AssemblyZFocusFinder_stepsize_min", 0.005);
 
+  const std::string focus_mode = config->getDefaultValue<std::string>("main", "AssemblyZFocusFinder_mode", "grid");
+
+  if     (focus_mode == "grid")    { focus_mode_ = GridScan; }
+  else if(focus_mode == "adaptive"){ focus_mode_ = AdaptiveScan; }
+  else if(focus_mode == "sweep")   { focus_mode_ = ContinuousSweep; }
+  else
+  {
+    NQLog("AssemblyZFocusFinder", NQLog::Warning) << "initialization"
+       << ": invalid value for AssemblyZFocusFinder_mode (" << focus_mode << "), using \"grid\"";
+
+    focus_mode_ = GridScan;
+  }
+
+  focus_pointN_coarse_  = config->getDefaultValue<int>   ("main", "AssemblyZFocusFinder_pointN_coarse"  , 5);
+  focus_sweep_velocity_ = config->getDefaultValue<double>("main", "AssemblyZFocusFinder_sweep_velocity", 0.1);
+
+  focus_metric_scale_ = std::max(1, config->getDefaultValue<int>("main", "AssemblyZFocusFinder_metric_scale", 2));
+  focus_metric_roi_   = std::min(1.0, std::max(0.1, config->getDefaultValue<double>("main", "AssemblyZFocusFinder_metric_roi", 0.5)));
+
+  save_images_ = config->getDefaultValue<bool>("main", "AssemblyZFocusFinder_save_images", true);
+
+  // images are written to disk by a single background thread
+  image_writer_.setMaxThreadCount(1);
+
+  golden_.active = false;
+
   v_zrelm_vals_.clear();
   v_focus_vals_.clear();
   // --------------
@@ -105,6 +166,8 @@ void AssemblyZFocusFinder::enable_motion()
 
       connect(camera_manager_, SIGNAL(imageAcquired(cv::Mat)), this, SLOT(process_image(cv::Mat)));
 
+      connect(this, SIGNAL(acquire_image_request()), camera_manager_, SLOT(acquireImage()));
+
       motion_enabled_ = true;
 
       NQLog("AssemblyZFocusFinder", NQLog::Spam) << "enable_motion"
@@ -124,6 +187,8 @@ void AssemblyZFocusFinder::disable_motion()
 
       disconnect(camera_manager_, SIGNAL(imageAcquired(cv::Mat)), this, SLOT(process_image(cv::Mat)));
 
+      disconnect(this, SIGNAL(acquire_image_request()), camera_manager_, SLOT(acquireImage()));
+
       motion_enabled_ = false;
 
       NQLog("AssemblyZFocusFinder", NQLog::Spam) << "disable_motion"
@@ -207,7 +272,10 @@ void AssemblyZFocusFinder::acquire_image()
       return;
     }
 
-    const double step_size = (2. * focus_zrange_ / double(focus_pointN_ - 1));
+    // number of stop-and-go points: all points for GridScan, the coarse points for AdaptiveScan
+    const int scan_pointN = (focus_mode_ == AdaptiveScan) ? std::max(3, std::min(focus_pointN_coarse_, focus_pointN_)) : focus_pointN_;
+
+    const double step_size = (2. * focus_zrange_ / double(scan_pointN - 1));
 
     if(step_size < focus_stepsize_min_)
     {
@@ -260,16 +328,29 @@ void AssemblyZFocusFinder::acquire_image()
 
     v_zrelm_vals_.emplace_back(zmax - zposi_init_);
 
-    for(int i=1; i<focus_pointN_; ++i)
+    // ContinuousSweep: only the motion to the start of the sweep is stop-and-go
+    if(focus_mode_ != ContinuousSweep)
     {
-      v_zrelm_vals_.emplace_back(-1.0 * step_size);
+      for(int i=1; i<scan_pointN; ++i)
+      {
+        v_zrelm_vals_.emplace_back(-1.0 * step_size);
+      }
     }
 
     zrelm_index_ = -1;
 
+    golden_.active = false;
+
+    sweep_started_ = false;
+    sweep_moving_  = false;
+    sweep_images_pending_ = 0;
+
+    focus_motions_ = 0;
+    focus_timer_.start();
+
     NQLog("AssemblyZFocusFinder", NQLog::Message) << "acquire_image"
        << ": initialized auto-focusing"
-       << " (z-min=" << zmin << ", z-max=" << zmax << ", steps=" << focus_pointN_ << ")";
+       << " (mode=" << focus_mode_ << ", z-min=" << zmin << ", z-max=" << zmax << ", steps=" << v_zrelm_vals_.size() << ")";
 
     NQLog("AssemblyZFocusFinder", NQLog::Spam) << "acquire_image"
        << ": emitting signal \"next_zpoint\"";
@@ -281,6 +362,8 @@ void AssemblyZFocusFinder::test_focus()
 {
   ++zrelm_index_;
 
+  double zposi_next(0.);
+
   if(zrelm_index_ < 0)
   {
     NQLog("AssemblyZFocusFinder", NQLog::Fatal) << "test_focus"
@@ -294,13 +377,20 @@ void AssemblyZFocusFinder::test_focus()
   {
     const double dz = v_zrelm_vals_.at(zrelm_index_);
 
-    NQLog("AssemblyZFocusFinder", NQLog::Spam) << "test_focus"
-       << ": emitting signal \"focus(0, 0, " << dz << ", 0)\"";
-
-    emit focus(0., 0., dz, 0.);
+    this->request_motion(dz);
 
     emit sig_update_progBar(int(zrelm_index_*100./v_zrelm_vals_.size())); //Update progress bar display
   }
+  else if((focus_mode_ == AdaptiveScan) && this->golden_section_step(zposi_next))
+  {
+    const double dz = (zposi_next - motion_manager_->get_position_Z());
+
+    this->request_motion(dz);
+  }
+  else if((focus_mode_ == ContinuousSweep) && (sweep_started_ == false))
+  {
+    this->start_sweep();
+  }
   else
   {
     // Find best position
@@ -316,17 +406,26 @@ void AssemblyZFocusFinder::test_focus()
       zscan_gra->SetMarkerStyle(20);
       zscan_gra->SetMarkerSize(1.25);
 
+      // graph ordered in z, the adaptive search does not visit the z-positions in order
+      std::vector<focus_info> v_focus_vals_sorted(v_focus_vals_);
+      std::sort(v_focus_vals_sorted.begin(), v_focus_vals_sorted.end(), [](const focus_info& a, const focus_info& b){ return a.z_position < b.z_position; });
+
       double focus_best(-1.);
-      for(unsigned int i=0; i<v_focus_vals_.size(); ++i)
+      for(unsigned int i=0; i<v_focus_vals_sorted.size(); ++i)
       {
-        const double i_zposi = v_focus_vals_.at(i).z_position;
-        const double i_focus = v_focus_vals_.at(i).focus_disc;
+        const double i_zposi = v_focus_vals_sorted.at(i).z_position;
+        const double i_focus = v_focus_vals_sorted.at(i).focus_disc;
 
         zscan_gra->SetPoint(i, i_zposi, i_focus);
 
         if((i == 0) || (i_focus > focus_best)){ focus_best = i_focus; zposi_best = i_zposi; }
       }
 
+      if(focus_mode_ != GridScan)
+      {
+        zposi_best = this->best_focus_position();
+      }
+
       std::unique_ptr<TCanvas> zscan_can(new TCanvas());
       zscan_can->SetName("zfocus_plot");
       zscan_can->cd();
@@ -359,11 +458,11 @@ void AssemblyZFocusFinder::test_focus()
     std::ofstream txtfile(output_dir_+"/values.txt");
     if(txtfile.is_open())
     {
-      txtfile << "# index z-position focus_discriminant\n";
+      txtfile << "# index z-position focus_discriminant time[ms]\n";
 
       for(unsigned int i=0; i<v_focus_vals_.size(); ++i)
       {
-        txtfile << i << " " << v_focus_vals_.at(i).z_position << " " << v_focus_vals_.at(i).focus_disc << std::endl;
+        txtfile << i << " " << v_focus_vals_.at(i).z_position << " " << v_focus_vals_.at(i).focus_disc << " " << v_focus_vals_.at(i).time << std::endl;
       }
 
       txtfile.close();
@@ -380,10 +479,7 @@ void AssemblyZFocusFinder::test_focus()
 
     const double dz = (zposi_best-zposi_now);
 
-    NQLog("AssemblyZFocusFinder", NQLog::Spam) << "test_focus"
-       << ": emitting signal \"focus(0, 0, " << dz << ", 0)\"";
-
-    emit focus(0., 0., dz, 0.);
+    this->request_motion(dz);
 
     emit sig_update_progBar(int(100)); //Update progress bar display
     // ------------------
@@ -399,6 +495,8 @@ void AssemblyZFocusFinder::emergencyStop()
 
   this->disable_motion();
 
+  if(sweep_moving_){ this->finish_sweep(); }
+
   v_zrelm_vals_.clear();
 
   v_focus_vals_.clear();
@@ -407,6 +505,10 @@ void AssemblyZFocusFinder::emergencyStop()
 
   zrelm_index_ = -1;
 
+  golden_.active = false;
+
+  sweep_started_ = false;
+
   NQLog("AssemblyZFocusFinder", NQLog::Message) << "emergencyStop"
      << ": emitting signal \"emergencyStopped\"";
 
@@ -421,6 +523,12 @@ void AssemblyZFocusFinder::process_image(const cv::Mat& img)
 
   if(focus_completed_)
   {
+    NQLog("AssemblyZFocusFinder", NQLog::Message) << "process_image"
+       << ": auto-focus completed (mode=" << focus_mode_ << ")"
+       << " in " << focus_timer_.elapsed() << " ms"
+       << ", " << focus_motions_ << " motions"
+       << ", " << v_focus_vals_.size() << " images";
+
     // disconnect z-focus-finder and motion-manager
     this->disable_motion();
 
@@ -433,28 +541,90 @@ void AssemblyZFocusFinder::process_image(const cv::Mat& img)
 
     zrelm_index_ = -1;
 
+    golden_.active = false;
+
+    sweep_started_ = false;
+
     // save best-focus image
     const std::string img_outpath = output_dir_+"/AssemblyZFocusFinder_best.png";
 
-    cv::imwrite(img_outpath, img);
+    this->save_image(img, img_outpath);
 
     NQLog("AssemblyZFocusFinder", NQLog::Spam) << "process_image"
        << ": emitting signal \"image_acquired\"";
 
     emit image_acquired(img);
   }
+  else if(sweep_started_)
+  {
+    // --- image of continuous sweep ---
+    --sweep_images_pending_;
+
+    if(save_images_)
+    {
+      const std::string img_outpath = output_dir_+"/AssemblyZFocusFinder_"+std::to_string(v_focus_vals_.size())+".png";
+
+      this->save_image(img, img_outpath);
+    }
+
+    // z-position is assigned at the end of the sweep
+    AssemblyZFocusFinder::focus_info this_focus;
+    this_focus.focus_disc = this->image_focus_value(img);
+    this_focus.z_position = sweep_zstart_;
+    this_focus.time       = focus_timer_.elapsed();
+
+    v_focus_vals_.emplace_back(this_focus);
+
+    if(sweep_moving_)
+    {
+      // next image, as long as the z-axis is moving
+      ++sweep_images_pending_;
+
+      emit acquire_image_request();
+    }
+    else if(sweep_images_pending_ <= 0)
+    {
+      //
+      // z-position of the sweep images:
+      // linear interpolation between start and end of the motion,
+      // based on the time of arrival of the images
+      // (the latency of the camera shifts all images by the same amount)
+      //
+      const double sweep_duration = std::max(qint64(1), sweep_tend_ - sweep_tstart_);
+
+      for(size_t i=sweep_first_image_; i<v_focus_vals_.size(); ++i)
+      {
+        const double frac = std::min(1.0, std::max(0.0, (v_focus_vals_.at(i).time - sweep_tstart_) / sweep_duration));
+
+        v_focus_vals_.at(i).z_position = sweep_zstart_ + frac * (sweep_zend_ - sweep_zstart_);
+      }
+
+      NQLog("AssemblyZFocusFinder", NQLog::Spam) << "process_image"
+         << ": continuous sweep completed with " << (v_focus_vals_.size() - sweep_first_image_) << " images";
+
+      NQLog("AssemblyZFocusFinder", NQLog::Spam) << "process_image"
+         << ": emitting signal \"next_zpoint\"";
+
+      emit next_zpoint();
+    }
+  }
   else
   {
     // --- generic z-focus step ---
 
     // save image
-    const std::string img_outpath = output_dir_+"/AssemblyZFocusFinder_"+std::to_string(v_focus_vals_.size())+".png";
-    cv::imwrite(img_outpath, img);
+    if(save_images_)
+    {
+      const std::string img_outpath = output_dir_+"/AssemblyZFocusFinder_"+std::to_string(v_focus_vals_.size())+".png";
+
+      this->save_image(img, img_outpath);
+    }
 
     // save z-focus info
     AssemblyZFocusFinder::focus_info this_focus;
     this_focus.focus_disc = this->image_focus_value(img);
     this_focus.z_position = motion_manager_->get_position_Z();
+    this_focus.time       = focus_timer_.elapsed();
 
     if((fabs(this_focus.z_position - zposi_init_) - focus_zrange_) > focus_stepsize_min_)
     {
@@ -505,29 +675,254 @@ void AssemblyZFocusFinder::process_image(const cv::Mat& img)
 
 // \Brief Image-focus discriminant based on Laplacian method in OpenCV
 //        REF: https://docs.opencv.org/2.4/doc/tutorials/imgproc/imgtrans/laplace_operator/laplace_operator.html
+//
+//        The discriminant is evaluated on a central region of interest of the image
+//        (fraction focus_metric_roi_ of width and height), downscaled by focus_metric_scale_.
 double AssemblyZFocusFinder::image_focus_value(const cv::Mat& img)
 {
-//  // Remove noise by blurring with a Gaussian filter
-//  cv::Mat img_gaus;
-//  cv::GaussianBlur(img, img_gaus, cv::Size(img.cols, img.rows), 0, 0, cv::BORDER_DEFAULT);
-//
-//  // Convert the image to grayscale
-//  cv::Mat img_gray;
-//  cv::cvtColor(img_gaus, img_gray, cv::COLOR_BGR2GRAY);
+  // central region of interest
+  const int roi_cols = std::max(1, int(img.cols * focus_metric_roi_));
+  const int roi_rows = std::max(1, int(img.rows * focus_metric_roi_));
 
-  // Apply laplacian function to GS image
-  cv::Mat img_lap;
-  cv::Laplacian(img, img_lap, CV_64F);
+  const cv::Mat img_roi = img(cv::Rect((img.cols - roi_cols) / 2, (img.rows - roi_rows) / 2, roi_cols, roi_rows));
 
-  cv::Mat img_lap_abs;
-//  cv::convertScaleAbs(img_lap, img_lap_abs);
-  img_lap_abs = img_lap.clone();
+  // Convert the image to grayscale
+  cv::Mat img_gray;
+  if(img_roi.channels() > 1)
+  {
+    cv::cvtColor(img_roi, img_gray, cv::COLOR_BGR2GRAY);
+  }
+  else
+  {
+    img_gray = img_roi;
+  }
+
+  cv::Mat img_small;
+  if(focus_metric_scale_ > 1)
+  {
+    cv::resize(img_gray, img_small, cv::Size(), 1. / focus_metric_scale_, 1. / focus_metric_scale_, cv::INTER_AREA);
+  }
+  else
+  {
+    img_small = img_gray;
+  }
+
+  // Apply laplacian function to GS image (exact in 16-bit integers for 8-bit images)
+  cv::Mat img_lap;
+  cv::Laplacian(img_small, img_lap, (img_small.depth() == CV_8U) ? CV_16S : CV_32F);
 
   // Calculate standard deviation of laplace image
   cv::Scalar mean, std_dev;
-  cv::meanStdDev(img_lap_abs, mean, std_dev);
+  cv::meanStdDev(img_lap, mean, std_dev);
 
-  const float value = (std_dev.val[0] * std_dev.val[0]);
+  const double value = (std_dev.val[0] * std_dev.val[0]);
 
   return value;
 }
+
+void AssemblyZFocusFinder::request_motion(const double dz)
+{
+  ++focus_motions_;
+
+  NQLog("AssemblyZFocusFinder", NQLog::Spam) << "request_motion"
+     << ": emitting signal \"focus(0, 0, " << dz << ", 0)\"";
+
+  emit focus(0., 0., dz, 0.);
+}
+
+void AssemblyZFocusFinder::save_image(const cv::Mat& img, const std::string& img_outpath)
+{
+  image_writer_.start(new AssemblyZFocusFinderImageWriter(img, img_outpath));
+}
+
+//
+// one step of the golden-section search for the maximum of the focus discriminant (AdaptiveScan):
+//   - the first call defines the search interval [a, b] around the best position of the coarse scan
+//   - every further call takes the focus discriminant of the last image (at the pending point c or d)
+//     and shrinks the interval, until it is smaller than the minimal step size
+// returns false when the search is completed, otherwise the next z-position to be tested
+//
+bool AssemblyZFocusFinder::golden_section_step(double& z_next)
+{
+  const double ratio = 0.5 * (std::sqrt(5.) - 1.);
+
+  if(golden_.active == false)
+  {
+    if(v_focus_vals_.size() < 2 || v_zrelm_vals_.size() < 2){ return false; }
+
+    const double step_size = (2. * focus_zrange_ / double(v_zrelm_vals_.size() - 1));
+
+    double zposi_best(zposi_init_), focus_best(-1.);
+    for(unsigned int i=0; i<v_focus_vals_.size(); ++i)
+    {
+      if((i == 0) || (v_focus_vals_.at(i).focus_disc > focus_best))
+      {
+        focus_best = v_focus_vals_.at(i).focus_disc;
+        zposi_best = v_focus_vals_.at(i).z_position;
+      }
+    }
+
+    golden_.a = std::max(zposi_best - step_size, zposi_init_ - focus_zrange_);
+    golden_.b = std::min(zposi_best + step_size, zposi_init_ + focus_zrange_);
+    golden_.c = golden_.b - ratio * (golden_.b - golden_.a);
+    golden_.d = golden_.a + ratio * (golden_.b - golden_.a);
+
+    golden_.has_c = false;
+    golden_.has_d = false;
+
+    golden_.pending_c = true;
+    golden_.active = true;
+
+    NQLog("AssemblyZFocusFinder", NQLog::Spam) << "golden_section_step"
+       << ": coarse scan yields best z-position " << zposi_best
+       << ", search interval [" << golden_.a << ", " << golden_.b << "]";
+
+    z_next = golden_.c;
+
+    return true;
+  }
+
+  const double focus_last = v_focus_vals_.back().focus_disc;
+
+  if(golden_.pending_c){ golden_.f_c = focus_last; golden_.has_c = true; }
+  else                 { golden_.f_d = focus_last; golden_.has_d = true; }
+
+  if(golden_.has_d == false)
+  {
+    golden_.pending_c = false;
+
+    z_next = golden_.d;
+
+    return true;
+  }
+
+  if((golden_.b - golden_.a) < focus_stepsize_min_){ return false; }
+
+  if(golden_.f_c > golden_.f_d)
+  {
+    golden_.b   = golden_.d;
+    golden_.d   = golden_.c;
+    golden_.f_d = golden_.f_c;
+    golden_.c   = golden_.b - ratio * (golden_.b - golden_.a);
+
+    golden_.pending_c = true;
+
+    z_next = golden_.c;
+  }
+  else
+  {
+    golden_.a   = golden_.c;
+    golden_.c   = golden_.d;
+    golden_.f_c = golden_.f_d;
+    golden_.d   = golden_.a + ratio * (golden_.b - golden_.a);
+
+    golden_.pending_c = false;
+
+    z_next = golden_.d;
+  }
+
+  return true;
+}
+
+void AssemblyZFocusFinder::start_sweep()
+{
+  sweep_started_ = true;
+  sweep_moving_  = true;
+
+  // reduced velocity of the z-axis during the sweep
+  sweep_velocity_init_ = motion_manager_->get_velocity_Z();
+
+  motion_manager_->set_velocity_Z(focus_sweep_velocity_);
+
+  sweep_velocity_checks_ = 0;
+
+  this->start_sweep_motion();
+}
+
+void AssemblyZFocusFinder::start_sweep_motion()
+{
+  // stopped while waiting for the velocity
+  if(sweep_moving_ == false){ return; }
+
+  // the motion starts once the reduced velocity is in place,
+  // checked again by a timer so the event loop keeps running
+  if((motion_manager_->get_velocity_Z() != focus_sweep_velocity_) && (++sweep_velocity_checks_ < 100))
+  {
+    QTimer::singleShot(10, this, SLOT(start_sweep_motion()));
+
+    return;
+  }
+
+  connect(motion_manager_, SIGNAL(motion_finished()), this, SLOT(sweep_motion_finished()));
+
+  sweep_first_image_ = v_focus_vals_.size();
+  sweep_zstart_ = motion_manager_->get_position_Z();
+  sweep_tstart_ = focus_timer_.elapsed();
+
+  const double zposi_end = (zposi_init_ - focus_zrange_);
+
+  NQLog("AssemblyZFocusFinder", NQLog::Spam) << "start_sweep_motion"
+     << ": continuous sweep from z=" << sweep_zstart_ << " to z=" << zposi_end
+     << " at velocity " << focus_sweep_velocity_ << " mm/s";
+
+  this->request_motion(zposi_end - sweep_zstart_);
+
+  // images are requested one after the other while the z-axis is moving
+  ++sweep_images_pending_;
+
+  emit acquire_image_request();
+}
+
+void AssemblyZFocusFinder::sweep_motion_finished()
+{
+  sweep_tend_ = focus_timer_.elapsed();
+  sweep_zend_ = motion_manager_->get_position_Z();
+
+  this->finish_sweep();
+
+  // motion_finished() also triggers the acquisition of one image
+  ++sweep_images_pending_;
+}
+
+void AssemblyZFocusFinder::finish_sweep()
+{
+  disconnect(motion_manager_, SIGNAL(motion_finished()), this, SLOT(sweep_motion_finished()));
+
+  sweep_moving_ = false;
+
+  // no need to wait: the velocity reaches the controller
+  // before the motion to the best-focus position
+  motion_manager_->set_velocity_Z(sweep_velocity_init_);
+}
+
+//
+// best-focus z-position of the AdaptiveScan and ContinuousSweep modes:
+// vertex of the parabola through the best point and its neighbours in z
+//
+double AssemblyZFocusFinder::best_focus_position() const
+{
+  if(v_focus_vals_.empty()){ return zposi_init_; }
+
+  std::vector<focus_info> v_sorted(v_focus_vals_);
+  std::sort(v_sorted.begin(), v_sorted.end(), [](const focus_info& a, const focus_info& b){ return a.z_position < b.z_position; });
+
+  unsigned int idx_best(0);
+  for(unsigned int i=1; i<v_sorted.size(); ++i)
+  {
+    if(v_sorted.at(i).focus_disc > v_sorted.at(idx_best).focus_disc){ idx_best = i; }
+  }
+
+  double zposi_best = v_sorted.at(idx_best).z_position;
+
+  if((idx_best > 0) && (idx_best+1 < v_sorted.size()))
+  {
+    const focus_info& m = v_sorted.at(idx_best-1);
+    const focus_info& p = v_sorted.at(idx_best+1);
+
+    const double zposi_vertex = assembly::ParabolaVertex(m.z_position, m.focus_disc, zposi_best, v_sorted.at(idx_best).focus_disc, p.z_position, p.focus_disc);
+
+    if((zposi_vertex > m.z_position) && (zposi_vertex < p.z_position)){ zposi_best = zposi_vertex; }
+  }
+
+  return zposi_best;
+}
@@ -18,6 +18,8 @@
 
 #include <QObject>
 #include <QString>
+#include <QThreadPool>
+#include <QElapsedTimer>
 
 #include <vector>
 #include <string>
@@ -38,10 +40,24 @@ class AssemblyZFocusFinder : public QObject
     double zrange() const { return focus_zrange_; }
     int    points() const { return focus_pointN_; }
 
+    //
+    // auto-focus modes:
+    //   - GridScan       : stop-and-go scan of focus_pointN_ equidistant z-positions
+    //   - AdaptiveScan   : coarse stop-and-go scan, followed by a golden-section search
+    //                      around the best coarse position and a parabolic interpolation
+    //   - ContinuousSweep: one continuous motion through the z-range at reduced velocity,
+    //                      images are acquired during the motion and tagged with
+    //                      the z-position interpolated from their time of arrival
+    //
+    enum FocusMode { GridScan, AdaptiveScan, ContinuousSweep };
+
+    FocusMode mode() const { return focus_mode_; }
+
     struct focus_info
     {
       double z_position;
       double focus_disc;
+      qint64 time; // [ms] since start of auto-focus
     };
 
   protected:
@@ -66,6 +82,56 @@ class AssemblyZFocusFinder : public QObject
 
     int zrelm_index_;
 
+    FocusMode focus_mode_;
+
+    int    focus_pointN_coarse_;
+    double focus_sweep_velocity_;
+
+    int    focus_metric_scale_;
+    double focus_metric_roi_;
+
+    bool save_images_;
+
+    QThreadPool image_writer_;
+
+    QElapsedTimer focus_timer_;
+    int focus_motions_;
+
+    // golden-section search (AdaptiveScan)
+    struct golden_section
+    {
+      bool   active;
+      double a, b, c, d;
+      double f_c, f_d;
+      bool   has_c, has_d;
+      bool   pending_c;
+    };
+
+    golden_section golden_;
+
+    bool golden_section_step(double&);
+
+    // continuous sweep (ContinuousSweep)
+    bool   sweep_started_;
+    bool   sweep_moving_;
+    int    sweep_images_pending_;
+    size_t sweep_first_image_;
+    double sweep_zstart_;
+    double sweep_zend_;
+    qint64 sweep_tstart_;
+    qint64 sweep_tend_;
+    double sweep_velocity_init_;
+    int    sweep_velocity_checks_;
+
+    void start_sweep();
+    void finish_sweep();
+
+    void request_motion(const double);
+
+    void save_image(const cv::Mat&, const std::string&);
+
+    double best_focus_position() const;
+
     std::string output_dir_;
 
     std::vector<double>     v_zrelm_vals_;
@@ -88,6 +154,11 @@ class AssemblyZFocusFinder : public QObject
 
     void emergencyStop();
 
+  protected slots:
+
+    void start_sweep_motion();
+    void sweep_motion_finished();
+
   signals:
 
     void next_zpoint();
@@ -99,6 +170,8 @@ class AssemblyZFocusFinder : public QObject
 
     void image_acquired(const cv::Mat&);
 
+    void acquire_image_request();
+
     void show_zscan(const QString&);
 
     void text_update_request(const double);
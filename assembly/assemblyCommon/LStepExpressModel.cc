@@ -16,6 +16,10 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QStringList>
+#include <QDateTime>
+#include <QMetaObject>
+
+#include <algorithm>
 
 LStepExpressModel::LStepExpressModel(
   const std::string& port,
@@ -31,7 +35,8 @@ LStepExpressModel::LStepExpressModel(
  , lstep_iver_(lstep_iver.c_str())
  , updateInterval_(updateInterval)
  , motionUpdateInterval_(motionUpdateInterval)
- , updateCount_(0)
+ , fastMotionUpdateInterval_(std::min(50, motionUpdateInterval))
+ , pollStatistics_()
 {
     const std::vector<int> allZerosI{ 0, 0, 0, 0 };
     const std::vector<double> allZerosD{ 0.0, 0.0, 0.0, 0.0 };
@@ -57,6 +62,13 @@ LStepExpressModel::LStepExpressModel(
     isPaused_ = false;
     finishedCalibrating_ = false;
 
+    motionSnapshot_.axisStatus = axisStatus_;
+    motionSnapshot_.powerAmplifierStatus = allZerosI;
+    motionSnapshot_.axisEnabled = allZerosI;
+    motionSnapshot_.position = allZerosD;
+    motionSnapshot_.inMotion = false;
+    motionSnapshot_.time = 0;
+
     timer_ = new QTimer(this);
     timer_->setInterval(motionUpdateInterval_);
     connect(timer_, SIGNAL(timeout()), this, SLOT(updateMotionInformationFromTimer()));
@@ -617,7 +629,7 @@ void LStepExpressModel::moveRelative(const std::vector<double>& values)
 
     controller_->MoveRelative(values);
 
-    inMotion_ = true;
+    this->setInMotion(true);
 
     NQLog("LStepExpressModel", NQLog::Spam) << "moveRelative"
        << ": emitting signal \"motionStarted\"";
@@ -654,7 +666,7 @@ void LStepExpressModel::moveRelative(const unsigned int axis, const double value
 
     controller_->MoveRelative((VLStepExpress::Axis)axis, value);
 
-    inMotion_ = true;
+    this->setInMotion(true);
 
     NQLog("LStepExpressModel", NQLog::Spam) << "moveRelative"
        << ": emitting signal \"motionStarted\"";
@@ -697,7 +709,7 @@ void LStepExpressModel::moveAbsolute(const std::vector<double>& values)
 
     controller_->MoveAbsolute(values);
 
-    inMotion_ = true;
+    this->setInMotion(true);
 
     NQLog("LStepExpressModel", NQLog::Spam) << "moveAbsolute"
        << ": emitting signal \"motionStarted\"";
@@ -734,7 +746,7 @@ void LStepExpressModel::moveAbsolute(const unsigned int axis, const double value
 
     controller_->MoveAbsolute((VLStepExpress::Axis) axis, value);
 
-    inMotion_ = true;
+    this->setInMotion(true);
 
     NQLog("LStepExpressModel", NQLog::Spam) << "moveAbsolute"
        << ": emitting signal \"motionStarted\"";
@@ -772,7 +784,7 @@ void LStepExpressModel::calibrate()
 
     controller_->Calibrate();
 
-    inMotion_ = true;
+    this->setInMotion(true);
 
     finishedCalibrating_ = true;
 
@@ -796,7 +808,7 @@ void LStepExpressModel::emergencyStop()
 
     controller_->EmergencyStop();
 
-    inMotion_ = false;
+    this->setInMotion(false);
 
     finishedCalibrating_ = false;
 
@@ -1117,71 +1129,68 @@ void LStepExpressModel::updateInformation()
       }
     */
 
+    // all settings in one batch of queries
+    LStepExpress_t::Configuration configuration;
+
+    if(controller_->GetConfiguration(configuration) == false)
+    {
+      NQLog("LStepExpressModel", NQLog::Warning) << "updateInformation"
+         << ": incomplete response of the controller, no action taken";
+
+      return;
+    }
+
     bool changed = false;
     bool positionChanged = false;
 
-    std::vector<int> ivalues;
-    std::vector<double> dvalues;
-
-    controller_->GetAxisEnabled(ivalues);
-    if (ivalues!=axis_) {
-        axis_ = ivalues;
+    if (configuration.axisEnabled!=axis_) {
+        axis_ = configuration.axisEnabled;
         changed = true;
     }
 
-    controller_->GetDimension(ivalues);
-    if (ivalues!=dim_) {
-        dim_ = ivalues;
+    if (configuration.dimension!=dim_) {
+        dim_ = configuration.dimension;
         changed = true;
     }
 
-    controller_->GetAcceleration(dvalues);
-    if (dvalues!=acceleration_) {
-      acceleration_ = dvalues;
+    if (configuration.acceleration!=acceleration_) {
+      acceleration_ = configuration.acceleration;
       changed = true;
     }
 
-    controller_->GetDeceleration(dvalues);
-    if (dvalues!=deceleration_) {
-      deceleration_ = dvalues;
+    if (configuration.deceleration!=deceleration_) {
+      deceleration_ = configuration.deceleration;
       changed = true;
     }
 
-    controller_->GetAccelerationJerk(dvalues);
-    if (dvalues!=accelerationJerk_) {
-      accelerationJerk_ = dvalues;
+    if (configuration.accelerationJerk!=accelerationJerk_) {
+      accelerationJerk_ = configuration.accelerationJerk;
       changed = true;
     }
 
-    controller_->GetDecelerationJerk(dvalues);
-    if (dvalues!=decelerationJerk_) {
-      decelerationJerk_ = dvalues;
+    if (configuration.decelerationJerk!=decelerationJerk_) {
+      decelerationJerk_ = configuration.decelerationJerk;
       changed = true;
     }
 
-    controller_->GetVelocity(dvalues);
-    if (dvalues!=velocity_) {
-      velocity_ = dvalues;
+    if (configuration.velocity!=velocity_) {
+      velocity_ = configuration.velocity;
       changed = true;
     }
 
-    controller_->GetPosition(dvalues);
-    if (dvalues!=position_) {
-      position_ = dvalues;
+    if (configuration.position!=position_) {
+      position_ = configuration.position;
       positionChanged = true;
     }
 
-    int joystick = controller_->GetJoystickEnabled();
-    // int joystick_model = this->getJoystickEnabled();
-    if (joystick!=joystickEnabled_) {
-        joystickEnabled_ = joystick;
+    if (configuration.joystickEnabled!=joystickEnabled_) {
+        joystickEnabled_ = configuration.joystickEnabled;
         changed = true;
     }
 
     if(joystickEnabled_){
-      controller_->GetJoystickAxisEnabled(ivalues);
-      if (ivalues!=joystickAxisEnabled_) {
-        joystickAxisEnabled_ = ivalues;
+      if (configuration.joystickAxisEnabled!=joystickAxisEnabled_) {
+        joystickAxisEnabled_ = configuration.joystickAxisEnabled;
         changed = true;
       }
     }
@@ -1215,95 +1224,11 @@ void LStepExpressModel::updateMotionInformation()
 
     NQLog("LStepExpressModel", NQLog::Debug) << "updateMotionInformation";
 
-    static const int nUpdates = updateInterval_/motionUpdateInterval_;
-
-    if ( state_ == READY && !isPaused_) {
-
+    if((state_ == READY) && (isPaused_ == false))
+    {
       isUpdating_ = true;
 
-      updateCount_++;
-      if (updateCount_==nUpdates) {
-        updateInformation();
-        updateCount_ = 0;
-      }
-
-      /*
-        if (thread()==QApplication::instance()->thread()) {
-        NQLog("LStepExpressModel"<< " running in main application thread";
-        } else {
-        NQLog("LStepExpressModel"<< " running in dedicated thread";
-        }
-      */
-
-      bool changed = false;
-
-      std::vector<int> ivalues;
-      std::vector<int> pavalues;
-      std::vector<int> evalues;
-      std::vector<double> dvalues;
-
-      controller_->GetAxisStatus(ivalues);
-      controller_->GetPowerAmplifierStatus(pavalues);
-      controller_->GetAxisEnabled(evalues);
-
-      if (ivalues!=axisStatus_) {
-        axisStatus_ = ivalues;
-        changed = true;
-      }
-
-      if (inMotion_) {
-        bool temp = true;
-        for(int i = 0; i < 4; i++){
-          bool ifaxisenabledandready = ( (ivalues)[i] == LStepExpress_t::AXISSTANDSANDREADY || (ivalues)[i] == LStepExpress_t::AXISACKAFTERCALIBRATION) && (axis_)[i] == 1;
-          bool ifaxisnotenabled = (axis_)[i] == 0;
-          temp *= ifaxisenabledandready || ifaxisnotenabled;
-          //	    NQLog("LStepExpressModel", NQLog::Spam) <<" axis status =  "<<(ivalues)[i]<<" axis enabled = "<<(axis_)[i]<<" temp = "<<temp;
-        }
-        if(temp)
-        {
-          inMotion_ = false;
-
-          NQLog("LStepExpressModel", NQLog::Debug) << "updateMotionInformation"
-              << ": emitting signal \"motionFinished\"";
-
-          emit motionFinished();
-        }
-
-          /*
-	if (std::all_of(ivalues.begin(), ivalues.end(),
-	[](int i){	  NQLog("LStepExpressModel", NQLog::Spam)<< "updateMotionInformation() axis status =  "<<i; bool temp = (i==LStepExpress_t::AXISSTANDSANDREADY || i==LStepExpress_t::AXISACKAFTERCALIBRATION) && (axis_)[i]==1; return temp;})) {
-	NQLog("LStepExpressModel", NQLog::Spam)<< "updateMotionInformation() finished moving inMotion_ = false";
-	inMotion_ = false;
-	emit motionFinished();
-	}*/
-      }
-
-      if( (axis_)[0] || (axis_)[1] || (axis_)[2] || (axis_)[3]){
-        controller_->GetPosition(dvalues);
-        if (dvalues!=position_) {
-          //NQLog("LStepExpressModel", NQLog::Spam)<< "updateMotionInformation() new position values"  ;
-          position_ = dvalues;
-          changed = true;
-        }
-      }
-
-      //      NQLog("LStepExpressModel", NQLog::Spam)<< "updateMotionInformation() finishedCalibrating_ =  "<<finishedCalibrating_<<" in motion =  "<<inMotion_  ;
-      if(!inMotion_ && finishedCalibrating_){
-        //  NQLog("LStepExpressModel", NQLog::Spam)<< "updateMotionInformation() after calibration, setting position values to zero"  ;
-        std::vector<double> posvalues{0.0, 0.0, 0.0, 0.0};
-        controller_->SetPosition(posvalues);
-        position_ = posvalues;
-        changed = true;
-        finishedCalibrating_ = false;
-      }
-
-      if(changed)
-      {
-        NQLog("LStepExpressModel", NQLog::Debug) << "updateMotionInformation"
-            << ": emitting signal \"motionInformationChanged\"";
-
-        emit motionInformationChanged();
-      }
+      this->pollMotionInformation();
 
       isUpdating_ = false;
     }
@@ -1321,68 +1246,69 @@ void LStepExpressModel::updateMotionInformationFromTimer()
 
     NQLog("LStepExpressModel", NQLog::Debug) << "updateMotionInformationFromTimer";
 
-    static const int nUpdates = updateInterval_/motionUpdateInterval_;
-
     if((state_ == READY) && (isPaused_ == false))
     {
       isUpdating_ = true;
 
-      updateCount_++;
-      if (updateCount_==nUpdates) {
-        updateInformation();
-        updateCount_ = 0;
-      }
+      this->pollMotionInformation();
 
-      /*
-        if (thread()==QApplication::instance()->thread()) {
-        NQLog("LStepExpressModel"<< " running in main application thread";
-        } else {
-        NQLog("LStepExpressModel"<< " running in dedicated thread";
-        }
-      */
+      isUpdating_ = false;
+    }
+}
 
-      bool changed = false;
+/*
+  One poll of the controller: the status of all axes is read in a
+  single batch of queries and published as one snapshot; the settings
+  are refreshed every updateInterval_ while the stage does not move.
+*/
+void LStepExpressModel::pollMotionInformation()
+{
+    const unsigned long queries   = controller_->GetQueryCount();
+    const unsigned long transfers = controller_->GetTransferCount();
 
-      std::vector<int> ivalues;
-      std::vector<int> pavalues;
-      std::vector<int> evalues;
-      std::vector<double> dvalues;
+    if((inMotion_ == false) && ((informationTimer_.isValid() == false) || informationTimer_.hasExpired(updateInterval_)))
+    {
+      informationTimer_.start();
 
-      controller_->GetAxisStatus(ivalues);
-      controller_->GetPowerAmplifierStatus(pavalues);
-      controller_->GetAxisEnabled(evalues);
+      this->updateInformation();
+    }
 
-      if (ivalues!=axisStatus_) {
-        axisStatus_ = ivalues;
+    LStepExpress_t::MotionStatus status;
+
+    const bool valid = controller_->GetMotionStatus(status);
+
+    bool changed = false;
+    bool finished = false;
+
+    if(valid)
+    {
+      if (status.axisStatus!=axisStatus_) {
+        axisStatus_ = status.axisStatus;
         changed = true;
       }
 
+      if((axis_)[0] || (axis_)[1] || (axis_)[2] || (axis_)[3])
+      {
+        if (status.position!=position_) {
+          position_ = status.position;
+          changed = true;
+        }
+      }
+
       if(inMotion_)
       {
         bool temp = true;
         for(int i = 0; i < 4; i++)
         {
-          bool ifaxisenabled = ( (ivalues)[i] == LStepExpress_t::AXISSTANDSANDREADY || (ivalues)[i] == LStepExpress_t::AXISACKAFTERCALIBRATION) && (axis_)[i] == 1;
+          bool ifaxisenabled = ( (axisStatus_)[i] == LStepExpress_t::AXISSTANDSANDREADY || (axisStatus_)[i] == LStepExpress_t::AXISACKAFTERCALIBRATION) && (axis_)[i] == 1;
           bool ifaxisnotenabled = (axis_)[i] == 0;
           temp *= (ifaxisenabled || ifaxisnotenabled);
         }
         if(temp)
         {
-          inMotion_ = false;
-
-          NQLog("LStepExpressModel", NQLog::Debug) << "updateMotionInformationFromTimer"
-              << ": emitting signal \"motionFinished\"";
+          this->setInMotion(false);
 
-          emit motionFinished();
-        }
-      }
-
-      if((axis_)[0] || (axis_)[1] || (axis_)[2] || (axis_)[3])
-      {
-        controller_->GetPosition(dvalues);
-        if (dvalues!=position_) {
-          position_ = dvalues;
-          changed = true;
+          finished = true;
         }
       }
 
@@ -1395,16 +1321,97 @@ void LStepExpressModel::updateMotionInformationFromTimer()
         finishedCalibrating_ = false;
       }
 
-      if(changed)
-      {
-        NQLog("LStepExpressModel", NQLog::Debug) << "updateMotionInformationFromTimer"
-            << ": emitting signal \"motionInformationChanged\"";
+      QMutexLocker locker(&snapshotMutex_);
 
-        emit motionInformationChanged();
-      }
+      motionSnapshot_.axisStatus = axisStatus_;
+      motionSnapshot_.powerAmplifierStatus = status.powerAmplifierStatus;
+      motionSnapshot_.axisEnabled = status.axisEnabled;
+      motionSnapshot_.position = position_;
+      motionSnapshot_.inMotion = inMotion_;
+      motionSnapshot_.time = QDateTime::currentMSecsSinceEpoch();
+    }
+    else
+    {
+      NQLog("LStepExpressModel", NQLog::Warning) << "pollMotionInformation"
+         << ": incomplete response of the controller, motion status not updated";
+    }
 
-      isUpdating_ = false;
+    {
+      QMutexLocker locker(&snapshotMutex_);
+
+      pollStatistics_.lastQueries   = controller_->GetQueryCount()    - queries;
+      pollStatistics_.lastTransfers = controller_->GetTransferCount() - transfers;
+
+      ++pollStatistics_.updates;
+      pollStatistics_.queries   += pollStatistics_.lastQueries;
+      pollStatistics_.transfers += pollStatistics_.lastTransfers;
+
+      NQLog("LStepExpressModel", NQLog::Spam) << "pollMotionInformation"
+         << ": " << pollStatistics_.lastQueries << " queries in "
+         << pollStatistics_.lastTransfers << " transfers";
     }
+
+    if(changed)
+    {
+      NQLog("LStepExpressModel", NQLog::Debug) << "pollMotionInformation"
+          << ": emitting signal \"motionInformationChanged\"";
+
+      emit motionInformationChanged();
+    }
+
+    // after the final position has been published
+    if(finished)
+    {
+      NQLog("LStepExpressModel", NQLog::Debug) << "pollMotionInformation"
+          << ": emitting signal \"motionFinished\"";
+
+      emit motionFinished();
+    }
+}
+
+/*
+  The motion status is polled every fastMotionUpdateInterval_ while the
+  stage moves, so that the end of a motion is seen early, and every
+  motionUpdateInterval_ otherwise.
+
+  Motions are started from the GUI thread while the timer lives in the
+  thread of the model, so the interval is changed by a queued call.
+*/
+void LStepExpressModel::setInMotion(const bool inMotion)
+{
+    inMotion_ = inMotion;
+
+    QMetaObject::invokeMethod(this, "updateTimerInterval", Qt::QueuedConnection);
+}
+
+void LStepExpressModel::setFastMotionUpdateInterval(const int interval)
+{
+    NQLog("LStepExpressModel", NQLog::Debug) << "setFastMotionUpdateInterval(" << interval << ")";
+
+    fastMotionUpdateInterval_ = std::max(1, std::min(interval, motionUpdateInterval_));
+
+    QMetaObject::invokeMethod(this, "updateTimerInterval", Qt::QueuedConnection);
+}
+
+void LStepExpressModel::updateTimerInterval()
+{
+    const int interval = inMotion_ ? fastMotionUpdateInterval_ : motionUpdateInterval_;
+
+    if(timer_->interval() != interval){ timer_->setInterval(interval); }
+}
+
+LStepExpressModel::MotionSnapshot LStepExpressModel::getMotionSnapshot() const
+{
+    QMutexLocker locker(&snapshotMutex_);
+
+    return motionSnapshot_;
+}
+
+LStepExpressModel::PollStatistics LStepExpressModel::getPollStatistics() const
+{
+    QMutexLocker locker(&snapshotMutex_);
+
+    return pollStatistics_;
 }
 
 void LStepExpressModel::setDeviceEnabled(bool enabled)
@@ -18,6 +18,7 @@
 
 #include <QString>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QMutexLocker>
 
@@ -41,6 +42,30 @@ class LStepExpressModel : public QObject, public AbstractDeviceModel<LStepExpres
     explicit LStepExpressModel(const std::string& port, const std::string& lstep_ver, const std::string& lstep_iver, const int updateInterval=1000, const int motionUpdateInterval=100, QObject* parent=nullptr);
     virtual ~LStepExpressModel();
 
+    /// Status of all axes as read in one poll of the controller
+    struct MotionSnapshot
+    {
+      std::vector<int>    axisStatus;
+      std::vector<int>    powerAmplifierStatus;
+      std::vector<int>    axisEnabled;
+      std::vector<double> position;
+      bool                inMotion;
+      qint64              time;      // ms since epoch
+    };
+
+    /// Cost of the polling of the controller
+    struct PollStatistics
+    {
+      unsigned long updates;
+      unsigned long queries;
+      unsigned long transfers;
+      unsigned int  lastQueries;
+      unsigned int  lastTransfers;
+    };
+
+    MotionSnapshot getMotionSnapshot() const;
+    PollStatistics getPollStatistics() const;
+
     bool isUpdating() const { return isUpdating_; }
     void pauseUpdate();
     void continueUpdate();
@@ -81,8 +106,11 @@ class LStepExpressModel : public QObject, public AbstractDeviceModel<LStepExpres
     void saveConfig();
     void reset();
 
-    int       updateInterval() const { return       updateInterval_; }
-    int motionUpdateInterval() const { return motionUpdateInterval_; }
+    int           updateInterval() const { return           updateInterval_; }
+    int     motionUpdateInterval() const { return     motionUpdateInterval_; }
+    int fastMotionUpdateInterval() const { return fastMotionUpdateInterval_; }
+
+    void setFastMotionUpdateInterval(const int);
 
   public slots:
 
@@ -141,9 +169,18 @@ class LStepExpressModel : public QObject, public AbstractDeviceModel<LStepExpres
 
     /// Time interval between cache refreshes; in milliseconds.
     const int updateInterval_;
+    /// Time interval between polls of the motion status while idle and in motion; in milliseconds.
     const int motionUpdateInterval_;
+    int fastMotionUpdateInterval_;
     QTimer* timer_;
-    int updateCount_;
+    QElapsedTimer informationTimer_;
+
+    void setInMotion(const bool);
+    void pollMotionInformation();
+
+    MotionSnapshot motionSnapshot_;
+    PollStatistics pollStatistics_;
+    mutable QMutex snapshotMutex_;
 
     void setDeviceState( State state ) override;
 
@@ -172,6 +209,7 @@ class LStepExpressModel : public QObject, public AbstractDeviceModel<LStepExpres
     void updateInformation();
     void updateMotionInformation();
     void updateMotionInformationFromTimer();
+    void updateTimerInterval();
 
   signals:
 
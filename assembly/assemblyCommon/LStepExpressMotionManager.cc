@@ -18,11 +18,58 @@
 
 #include <unistd.h>
 
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+  // below the resolution of the motion stage, absorbs rounding of merged motions
+  const double motion_tolerance = 1e-6;
+
+  bool is_zero(const double value){ return (std::fabs(value) <= motion_tolerance); }
+
+  // relative motions which can be merged with each other: along Z only, or in XYA only
+  enum class MotionKind { None, Z, XYA, Other };
+
+  MotionKind motion_kind(const LStepExpressMotion& motion)
+  {
+    if(motion.getMode()){ return MotionKind::Other; }
+
+    const bool move_xya = !(is_zero(motion.getX()) && is_zero(motion.getY()) && is_zero(motion.getA()));
+    const bool move_z   = !is_zero(motion.getZ());
+
+    if(move_xya && move_z){ return MotionKind::Other; }
+    else if(move_z)       { return MotionKind::Z; }
+    else if(move_xya)     { return MotionKind::XYA; }
+
+    return MotionKind::None;
+  }
+
+  // XYA motions along the same line (either direction): the merged motion
+  // covers part of the path of the original ones
+  bool is_collinear(const LStepExpressMotion& m1, const LStepExpressMotion& m2)
+  {
+    const double cx = m1.getY() * m2.getA() - m1.getA() * m2.getY();
+    const double cy = m1.getA() * m2.getX() - m1.getX() * m2.getA();
+    const double ca = m1.getX() * m2.getY() - m1.getY() * m2.getX();
+
+    const double n1 = std::sqrt(m1.getX()*m1.getX() + m1.getY()*m1.getY() + m1.getA()*m1.getA());
+    const double n2 = std::sqrt(m2.getX()*m2.getX() + m2.getY()*m2.getY() + m2.getA()*m2.getA());
+
+    return (std::sqrt(cx*cx + cy*cy + ca*ca) <= motion_tolerance * n1 * n2);
+  }
+}
+
 LStepExpressMotionManager::LStepExpressMotionManager(LStepExpressModel* model, QObject* parent)
  : QObject(parent)
  , model_(model)
  , model_connected_(false)
  , inMotion_(false)
+ , sequence_depth_(0)
+ , sequence_direct_xya_paths_(false)
+ , optimize_motions_(true)
+ , dry_run_(false)
+ , optimizer_statistics_()
 {
   qRegisterMetaType<LStepExpressMotion>("LStepExpressMotion");
   qRegisterMetaType<QQueue<LStepExpressMotion> >("QQueue<LStepExpressMotion>");
@@ -45,6 +92,9 @@ LStepExpressMotionManager::LStepExpressMotionManager(LStepExpressModel* model, Q
   a_lowerBound_ = config->getDefaultValue<double>("main", "MotionStageLowerBound_A", -180.);
   a_upperBound_ = config->getDefaultValue<double>("main", "MotionStageUpperBound_A",  180.);
 
+  optimize_motions_ = config->getDefaultValue<bool>("main", "LStepExpressMotionManager_optimizeMotions", true);
+  dry_run_          = config->getDefaultValue<bool>("main", "LStepExpressMotionManager_dryRun"        , false);
+
   if(model_ == nullptr)
   {
     NQLog("LStepExpressMotionManager", NQLog::Fatal) << "initialization error"
@@ -124,6 +174,8 @@ void LStepExpressMotionManager::run()
 
     if(motions_.empty())
     {
+      if(dry_run_){ this->report_dry_run(); }
+
       NQLog("LStepExpressMotionManager", NQLog::Spam) << "run"
          << ": emitting signal \"motion_finished\"";
 
@@ -141,6 +193,8 @@ void LStepExpressMotionManager::run()
 
     LStepExpressMotion motion = motions_.dequeue(); //Returns first (head) movement from the queue
 
+    if(dry_run_){ executed_motions_.enqueue(motion); }
+
     inMotion_ = true;
 
     if(motion.getMode() == true)
@@ -174,6 +228,244 @@ void LStepExpressMotionManager::run()
     return;
 }
 
+QQueue<LStepExpressMotion> LStepExpressMotionManager::optimized_motions(const QQueue<LStepExpressMotion>& motions, const bool direct_xya_paths)
+{
+  //
+  // consecutive Z motions are collinear, so the merged motion covers part of
+  // the original path only. Consecutive XYA motions run at constant height;
+  // they are merged if they are collinear, or if the caller marked the
+  // direct path between them as safe. Z and XYA motions are never merged
+  // with each other, which keeps the Z-up-first, Z-down-last ordering of
+  // set_movements_priorities_XYZA.
+  //
+  // a merge into a no-op motion removes it, and the motions before and
+  // after it are checked again (e.g. XYA, Z down, Z up, XYA -> XYA)
+  //
+  QQueue<LStepExpressMotion> optimized;
+
+  for(const auto& i_mot : motions)
+  {
+    const MotionKind kind = motion_kind(i_mot);
+
+    if(kind == MotionKind::None){ continue; }
+
+    bool merge = (optimized.empty() == false) && (kind != MotionKind::Other) && (motion_kind(optimized.back()) == kind);
+
+    if(merge && (kind == MotionKind::XYA) && (direct_xya_paths == false))
+    {
+      merge = is_collinear(optimized.back(), i_mot);
+    }
+
+    if(merge)
+    {
+      const LStepExpressMotion& last = optimized.back();
+
+      const LStepExpressMotion merged(last.getX() + i_mot.getX(), last.getY() + i_mot.getY(),
+                                      last.getZ() + i_mot.getZ(), last.getA() + i_mot.getA(), false);
+
+      optimized.pop_back();
+
+      if(motion_kind(merged) != MotionKind::None){ optimized.enqueue(merged); }
+    }
+    else
+    {
+      optimized.enqueue(i_mot);
+    }
+  }
+
+  return optimized;
+}
+
+bool LStepExpressMotionManager::within_bounds(const QQueue<LStepExpressMotion>& motions, const std::vector<double>& start,
+                                              const std::vector<double>& lower, const std::vector<double>& upper)
+{
+  if((start.size() != 4) || (lower.size() != 4) || (upper.size() != 4)){ return false; }
+
+  std::vector<double> position(start);
+
+  for(const auto& i_mot : motions)
+  {
+    const double values[4] = { i_mot.getX(), i_mot.getY(), i_mot.getZ(), i_mot.getA() };
+
+    for(unsigned int i_axis=0; i_axis<4; ++i_axis)
+    {
+      position[i_axis] = i_mot.getMode() ? values[i_axis] : (position[i_axis] + values[i_axis]);
+
+      // every motion is a straight line inside the box of the stage bounds
+      // as long as both of its end points are
+      if((position[i_axis] < lower[i_axis]) || (position[i_axis] > upper[i_axis])){ return false; }
+    }
+  }
+
+  return true;
+}
+
+double LStepExpressMotionManager::estimate_duration(const QQueue<LStepExpressMotion>& motions, const std::vector<double>& velocities, const double hop_overhead)
+{
+  double duration(0.);
+
+  for(const auto& i_mot : motions)
+  {
+    duration += hop_overhead;
+
+    // absolute motions are never changed by the optimizer, their travel time cancels
+    if(i_mot.getMode() || (velocities.size() != 4)){ continue; }
+
+    // all axes of a motion start together, the slowest one determines its duration
+    const double distances[4] = { i_mot.getX(), i_mot.getY(), i_mot.getZ(), i_mot.getA() };
+
+    double travel(0.);
+
+    for(unsigned int i_axis=0; i_axis<4; ++i_axis)
+    {
+      if(velocities[i_axis] > 0.){ travel = std::max(travel, 1000. * std::fabs(distances[i_axis]) / velocities[i_axis]); }
+    }
+
+    duration += travel;
+  }
+
+  return duration;
+}
+
+double LStepExpressMotionManager::estimate_duration(const QQueue<LStepExpressMotion>& motions) const
+{
+  std::vector<double> velocities;
+
+  for(unsigned int i_axis=0; i_axis<4; ++i_axis){ velocities.emplace_back(model_->getVelocity(i_axis)); }
+
+  // the end of a motion is noticed after half a status poll on average
+  const double hop_overhead = 0.5 * model_->fastMotionUpdateInterval();
+
+  return LStepExpressMotionManager::estimate_duration(motions, velocities, hop_overhead);
+}
+
+QQueue<LStepExpressMotion> LStepExpressMotionManager::optimize_motion_sequence(const QQueue<LStepExpressMotion>& motions, const bool direct_xya_paths)
+{
+  if(motions.size() < 2){ return motions; }
+
+  const QQueue<LStepExpressMotion> optimized = LStepExpressMotionManager::optimized_motions(motions, direct_xya_paths);
+
+  // the optimizer only ever removes motions
+  if(optimized.size() == motions.size()){ return motions; }
+
+  // the sequence starts where the motions queued before it end
+  const std::vector<double> lower{ x_lowerBound_, y_lowerBound_, z_lowerBound_, a_lowerBound_ };
+  const std::vector<double> upper{ x_upperBound_, y_upperBound_, z_upperBound_, a_upperBound_ };
+
+  if(LStepExpressMotionManager::within_bounds(optimized, this->planned_positions(false), lower, upper) == false)
+  {
+    NQLog("LStepExpressMotionManager", NQLog::Warning) << "optimize_motion_sequence"
+       << ": merged motions would exceed the boundaries of the motion stage, executing the " << motions.size() << " motions as requested";
+
+    return motions;
+  }
+
+  const double time_saved = this->estimate_duration(motions) - this->estimate_duration(optimized);
+
+  NQLog("LStepExpressMotionManager", NQLog::Spam) << "optimize_motion_sequence"
+     << ": merged " << motions.size() << " motions into " << optimized.size()
+     << " (estimated time saved: " << time_saved << " ms)";
+
+  optimizer_statistics_.motions_removed += (motions.size() - optimized.size());
+  optimizer_statistics_.time_saved      += time_saved;
+
+  return optimized;
+}
+
+std::vector<double> LStepExpressMotionManager::planned_positions(const bool include_sequence) const
+{
+  std::vector<double> positions{ this->get_position_X(), this->get_position_Y(), this->get_position_Z(), this->get_position_A() };
+
+  QQueue<LStepExpressMotion> motions(motions_);
+  if(include_sequence){ motions.append(sequence_motions_); }
+
+  for(const auto& i_mot : motions)
+  {
+    const double values[4] = { i_mot.getX(), i_mot.getY(), i_mot.getZ(), i_mot.getA() };
+
+    for(unsigned int i_axis=0; i_axis<4; ++i_axis)
+    {
+      positions[i_axis] = i_mot.getMode() ? values[i_axis] : (positions[i_axis] + values[i_axis]);
+    }
+  }
+
+  return positions;
+}
+
+double LStepExpressMotionManager::reference_position(const int axis) const
+{
+  // inside a motion sequence, motions start where the queued ones end
+  if(sequence_depth_ > 0){ return this->planned_positions(true).at(axis); }
+
+  return this->get_position(axis);
+}
+
+QQueue<LStepExpressMotion>& LStepExpressMotionManager::pending_motions()
+{
+  return (sequence_depth_ > 0) ? sequence_motions_ : motions_;
+}
+
+void LStepExpressMotionManager::begin_motion_sequence(const bool direct_xya_paths)
+{
+  if(sequence_depth_ == 0){ sequence_direct_xya_paths_ = direct_xya_paths; }
+  else                    { sequence_direct_xya_paths_ = sequence_direct_xya_paths_ && direct_xya_paths; }
+
+  ++sequence_depth_;
+
+  NQLog("LStepExpressMotionManager", NQLog::Spam) << "begin_motion_sequence"
+     << ": holding motions until the sequence is complete (depth " << sequence_depth_ << ")";
+}
+
+void LStepExpressMotionManager::end_motion_sequence()
+{
+  if(sequence_depth_ == 0)
+  {
+    NQLog("LStepExpressMotionManager", NQLog::Warning) << "end_motion_sequence"
+       << ": no motion sequence started, no action taken";
+
+    return;
+  }
+
+  if(--sequence_depth_ > 0){ return; }
+
+  QQueue<LStepExpressMotion> motions = sequence_motions_;
+  sequence_motions_.clear();
+
+  if(optimize_motions_ && (dry_run_ == false))
+  {
+    motions = this->optimize_motion_sequence(motions, sequence_direct_xya_paths_);
+  }
+
+  motions_.append(motions);
+
+  this->run();
+}
+
+void LStepExpressMotionManager::report_dry_run()
+{
+  if(executed_motions_.empty()){ return; }
+
+  const QQueue<LStepExpressMotion> optimized = LStepExpressMotionManager::optimized_motions(executed_motions_);
+
+  const double time_saved = this->estimate_duration(executed_motions_) - this->estimate_duration(optimized);
+
+  optimizer_statistics_.motions_removed += (executed_motions_.size() - optimized.size());
+  optimizer_statistics_.time_saved      += time_saved;
+
+  NQLog("LStepExpressMotionManager", NQLog::Message) << "report_dry_run"
+     << ": executed " << executed_motions_.size() << " motions, optimizer would send " << optimized.size()
+     << " (estimated time saved: " << time_saved << " ms, total: " << optimizer_statistics_.time_saved << " ms)";
+
+  executed_motions_.clear();
+
+  return;
+}
+
+void LStepExpressMotionManager::reset_optimizer_statistics()
+{
+  optimizer_statistics_ = OptimizerStatistics();
+}
+
 bool LStepExpressMotionManager::AxisIsReady(const int axis) const
 {
   const bool axis_ready = (model_->getAxisStatusText(axis) == "@");
@@ -190,14 +482,16 @@ bool LStepExpressMotionManager::AxisIsReady(const int axis) const
 
 void LStepExpressMotionManager::appendMotion(const LStepExpressMotion& motion)
 {
-    motions_.enqueue(motion);
+    this->pending_motions().enqueue(motion);
     this->run();
 }
 
 void LStepExpressMotionManager::appendMotions(const QQueue<LStepExpressMotion>& motions)
 {
-    motions_.append(motions);
-    this->run();
+    //-- A batch of motions is one sequence, only collinear XYA motions are merged
+    this->begin_motion_sequence(false);
+    sequence_motions_.append(motions);
+    this->end_motion_sequence();
 }
 
 void LStepExpressMotionManager::moveRelative(const std::vector<double>& values)
@@ -208,25 +502,25 @@ void LStepExpressMotionManager::moveRelative(const std::vector<double>& values)
     }
 
     //Checks on MS boundaries
-    const double x1(this->get_position_X() + values[0]);
+    const double x1(this->reference_position(0) + values[0]);
     if(x1 < x_lowerBound_ || x1 > x_upperBound_){
       NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in X:" << x1;
       return;
     }
 
-    const double y1(this->get_position_Y() + values[1]);
+    const double y1(this->reference_position(1) + values[1]);
     if(y1 < y_lowerBound_ || y1 > y_upperBound_){
       NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in Y:" << y1;
       return;
     }
 
-    const double z1(this->get_position_Z() + values[2]);
+    const double z1(this->reference_position(2) + values[2]);
     if(z1 < z_lowerBound_ || z1 > z_upperBound_){
       NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in Z:" << z1;
       return;
     }
 
-    const double a1(this->get_position_A() + values[3]);
+    const double a1(this->reference_position(3) + values[3]);
     if(a1 < a_lowerBound_ || a1 > a_upperBound_){
       NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in A:" << a1;
       return;
@@ -244,25 +538,25 @@ void LStepExpressMotionManager::moveRelative(const std::vector<double>& values)
 void LStepExpressMotionManager::moveRelative(const double dx, const double dy, const double dz, const double da)
 {
     //Checks on MS boundaries
-    const double x1(this->get_position_X() + dx);
+    const double x1(this->reference_position(0) + dx);
     if(x1 < x_lowerBound_ || x1 > x_upperBound_){
       NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in X:" << x1;
       return;
     }
 
-    const double y1(this->get_position_Y() + dy);
+    const double y1(this->reference_position(1) + dy);
     if(y1 < y_lowerBound_ || y1 > y_upperBound_){
       NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in Y:" << y1;
       return;
     }
 
-    const double z1(this->get_position_Z() + dz);
+    const double z1(this->reference_position(2) + dz);
     if(z1 < z_lowerBound_ || z1 > z_upperBound_){
       NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in Z:" << z1;
       return;
     }
 
-    const double a1(this->get_position_A() + da);
+    const double a1(this->reference_position(3) + da);
     if(a1 < a_lowerBound_ || a1 > a_upperBound_){
       NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in A:" << a1;
       return;
@@ -281,28 +575,28 @@ void LStepExpressMotionManager::moveRelative(const unsigned int axis, const doub
 {
     //Checks on MS boundaries
     if(axis == 0){
-      const double x1(this->get_position_X() + value);
+      const double x1(this->reference_position(0) + value);
       if(x1 < x_lowerBound_ || x1 > x_upperBound_){
         NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in X:" << x1;
         return;
       }
     }
     else if(axis == 1){
-      const double y1(this->get_position_Y() + value);
+      const double y1(this->reference_position(1) + value);
       if(y1 < y_lowerBound_ || y1 > y_upperBound_){
         NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in Y:" << y1;
         return;
       }
     }
     else if(axis == 2){
-      const double z1(this->get_position_Z() + value);
+      const double z1(this->reference_position(2) + value);
       if(z1 < z_lowerBound_ || z1 > z_upperBound_){
         NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in Z:" << z1;
         return;
       }
     }
     else if(axis == 3){
-      const double a1(this->get_position_A() + value);
+      const double a1(this->reference_position(3) + value);
       if(a1 < a_lowerBound_ || a1 > a_upperBound_){
         NQLog("LStepExpressMotionManager", NQLog::Warning) << "ERROR ! Relative movement not executed, Motion Stage would exceed its boundary in A:" << a1;
         return;
@@ -314,7 +608,7 @@ void LStepExpressMotionManager::moveRelative(const unsigned int axis, const doub
     }
 
     //Queue movement
-    motions_.enqueue(LStepExpressMotion(axis, value, false));
+    this->pending_motions().enqueue(LStepExpressMotion(axis, value, false));
     this->run();
 }
 
@@ -424,7 +718,7 @@ void LStepExpressMotionManager::moveAbsolute(const unsigned int axis, const doub
     }
 
     //Queue movement
-    motions_.enqueue(LStepExpressMotion(axis, value, true));
+    this->pending_motions().enqueue(LStepExpressMotion(axis, value, true));
     this->run();
 }
 
@@ -481,9 +775,11 @@ void LStepExpressMotionManager::clear_motion_queue()
     return;
   }
 
-  const auto mots = motions_;
+  auto mots = motions_;
+  mots.append(sequence_motions_);
 
   motions_.clear();
+  sequence_motions_.clear();
 
   for(const auto& i_mot : mots)
   {
@@ -604,10 +900,10 @@ void LStepExpressMotionManager::set_movements_priorities_XYZA(const double x, co
     else if(is_absolute_movements)
     {
 	//-- Convert absolute to relative movements //Simpler to use a single convention (because e.g. moving to "0" has different meaning in abs/rel)
-        dx = (x - this->get_position_X());
-        dy = (y - this->get_position_Y());
-        dz = (z - this->get_position_Z());
-        da = (a - this->get_position_A());
+        dx = (x - this->reference_position(0));
+        dy = (y - this->reference_position(1));
+        dz = (z - this->reference_position(2));
+        da = (a - this->reference_position(3));
     }
 
     const bool move_xya = ((std::fabs(dx) > std::numeric_limits<double>::epsilon()) || (std::fabs(dy) > std::numeric_limits<double>::epsilon()) || (std::fabs(da) > std::numeric_limits<double>::epsilon()));
@@ -617,17 +913,17 @@ void LStepExpressMotionManager::set_movements_priorities_XYZA(const double x, co
         
     
     if(!move_xya && !move_z) {return;} //No movement
-    else if(move_xya && !move_z) {motions_.enqueue(LStepExpressMotion(dx, dy, 0, da, false));} //Only XYA movement
-    else if(!move_xya && move_z) {motions_.enqueue(LStepExpressMotion(0, 0, dz, 0, false));} //Only Z movement
+    else if(move_xya && !move_z) {this->pending_motions().enqueue(LStepExpressMotion(dx, dy, 0, da, false));} //Only XYA movement
+    else if(!move_xya && move_z) {this->pending_motions().enqueue(LStepExpressMotion(0, 0, dz, 0, false));} //Only Z movement
     else if(dz > 0.) //Positive z-movement <-> apply first
     {
-      motions_.enqueue(LStepExpressMotion(0, 0, dz, 0, false));
-      motions_.enqueue(LStepExpressMotion(dx, dy, 0, da, false));
+      this->pending_motions().enqueue(LStepExpressMotion(0, 0, dz, 0, false));
+      this->pending_motions().enqueue(LStepExpressMotion(dx, dy, 0, da, false));
     }
     else if(dz < 0.) //Negative z-movement <-> apply second
     {
-      motions_.enqueue(LStepExpressMotion(dx, dy, 0, da, false));
-      motions_.enqueue(LStepExpressMotion(0, 0, dz, 0, false));
+      this->pending_motions().enqueue(LStepExpressMotion(dx, dy, 0, da, false));
+      this->pending_motions().enqueue(LStepExpressMotion(0, 0, dz, 0, false));
     }
 
     return;
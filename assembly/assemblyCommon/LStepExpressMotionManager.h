@@ -46,10 +46,54 @@ class LStepExpressMotionManager : public QObject
 
     void myMoveToThread(QThread*);
 
+    struct OptimizerStatistics
+    {
+      unsigned long motions_removed; // motions merged into others or dropped as no-op
+      double        time_saved;      // estimated time saved [ms]
+    };
+
+    // merges consecutive relative Z motions and consecutive relative XYA
+    // motions which are collinear (any XYA motions if direct_xya_paths),
+    // drops no-op motions; absolute motions, mixed XYA+Z motions and the
+    // order of Z and XYA motions are kept unchanged
+    static QQueue<LStepExpressMotion> optimized_motions(const QQueue<LStepExpressMotion>&, const bool direct_xya_paths=false);
+
+    // true if all motions, starting from the given X/Y/Z/A position, end inside the bounds
+    static bool within_bounds(const QQueue<LStepExpressMotion>&, const std::vector<double>& start,
+                              const std::vector<double>& lower, const std::vector<double>& upper);
+
+    // travel time of the relative motions at the given velocities plus a
+    // fixed overhead per motion sent to the controller [ms]
+    static double estimate_duration(const QQueue<LStepExpressMotion>&, const std::vector<double>& velocities, const double hop_overhead);
+
+    // only the motions of a sequence (begin/end_motion_sequence, appendMotions)
+    // are merged, single requests are sent as they come; merged motions which
+    // would leave the stage bounds are sent as requested instead;
+    // dry run: the motions are executed as requested, and the motions and the
+    // time the optimizer would have saved are reported when the queue runs empty
+    bool optimize_motions() const { return optimize_motions_; }
+    bool dry_run() const { return dry_run_; }
+
+    void set_optimize_motions(const bool value) { optimize_motions_ = value; }
+    void set_dry_run(const bool value) { dry_run_ = value; }
+
+    OptimizerStatistics optimizer_statistics() const { return optimizer_statistics_; }
+    void reset_optimizer_statistics();
+
   protected:
 
     void run();
 
+    QQueue<LStepExpressMotion> optimize_motion_sequence(const QQueue<LStepExpressMotion>&, const bool);
+    void report_dry_run();
+
+    std::vector<double> planned_positions(const bool include_sequence) const;
+    double reference_position(const int) const;
+
+    QQueue<LStepExpressMotion>& pending_motions();
+
+    double estimate_duration(const QQueue<LStepExpressMotion>&) const;
+
     bool AxisIsReady(const int) const;
 
     LStepExpressModel* model_;
@@ -60,6 +104,18 @@ class LStepExpressMotionManager : public QObject
 
     QQueue<LStepExpressMotion> motions_;
 
+    // motions held back until the current sequence is complete
+    int sequence_depth_;
+    bool sequence_direct_xya_paths_;
+    QQueue<LStepExpressMotion> sequence_motions_;
+
+    bool optimize_motions_;
+    bool dry_run_;
+
+    QQueue<LStepExpressMotion> executed_motions_;
+
+    OptimizerStatistics optimizer_statistics_;
+
     //Bounds to the motion stage movements
     double x_lowerBound_;
     double x_upperBound_;
@@ -75,6 +131,13 @@ class LStepExpressMotionManager : public QObject
     void connect_model();
     void disconnect_model();
 
+    // motions requested between begin and end of a sequence are held back
+    // and sent, merged where possible, when the (outermost) sequence ends;
+    // direct_xya_paths: the direct path between the XYA motions of the
+    // sequence is free, so they may be merged even if not collinear
+    void begin_motion_sequence(const bool direct_xya_paths=false);
+    void end_motion_sequence();
+
     void appendMotion(const LStepExpressMotion& motion);
     void appendMotions(const QQueue<LStepExpressMotion>& motions);
 
@@ -64,21 +64,31 @@ void AgilentTwisTorr304Model::initialize()
 
 const std::string AgilentTwisTorr304Model::getPumpStatusText() const
 {
-  return controller_->GetPumpStatusText(static_cast<VAgilentTwisTorr304::StatusCode>(pumpStatus_));
+  QMutexLocker locker(&mutex_);
+  const unsigned int pumpStatus = pumpStatus_;
+  locker.unlock();
+
+  return controller_->GetPumpStatusText(static_cast<VAgilentTwisTorr304::StatusCode>(pumpStatus));
 }
 
 void AgilentTwisTorr304Model::switchPumpOn()
 {
+  if (queueInModelThread(this, "switchPumpOn")) return;
+
   controller_->SwitchPumpOn();
 }
 
 void AgilentTwisTorr304Model::switchPumpOff()
 {
+  if (queueInModelThread(this, "switchPumpOff")) return;
+
   controller_->SwitchPumpOff();
 }
 
 void AgilentTwisTorr304Model::setDeviceEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setDeviceEnabled", Q_ARG(bool, enabled))) return;
+
   // Trivial reimplementation as slot.
   AbstractDeviceModel<AgilentTwisTorr304_t>::setDeviceEnabled(enabled);
 
@@ -128,9 +138,11 @@ void AgilentTwisTorr304Model::updateInformation()
         newPumpStatus != pumpStatus_ ||
         newErrorCode != errorCode_) {
 
+      QMutexLocker locker(&mutex_);
       pumpState_ = newPumpState;
       pumpStatus_ = newPumpStatus;
       errorCode_ = newErrorCode;
+      locker.unlock();
 
       NQLog("AgilentTwisTorr304Model", NQLog::Spam) << "information changed";
 
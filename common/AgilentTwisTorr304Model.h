@@ -19,6 +19,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QMutex>
 #include <QTimer>
 
 #include "DeviceState.h"
@@ -51,13 +52,15 @@ public:
                                    QObject *parent = 0);
 
 
+  // Setters called from another thread return before the value is applied,
+  // see queueInModelThread().
 public slots:
 
   const std::string getPumpStatusText() const;
-  unsigned int getPumpStatus() const { return pumpStatus_; }
-  unsigned int getErrorCode() const { return errorCode_; }
+  unsigned int getPumpStatus() const { QMutexLocker locker(&mutex_); return pumpStatus_; }
+  unsigned int getErrorCode() const { QMutexLocker locker(&mutex_); return errorCode_; }
 
-  bool getPumpState() const { return pumpState_; }
+  bool getPumpState() const { QMutexLocker locker(&mutex_); return pumpState_; }
   void switchPumpOn();
   void switchPumpOff();
 
@@ -75,6 +78,9 @@ protected:
 
   void setDeviceState( State state );
 
+  /// Guards the cached values, which are read from other threads.
+  mutable QMutex mutex_;
+
   bool pumpState_;
   unsigned int pumpStatus_;
   unsigned int errorCode_;
@@ -0,0 +1,339 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <algorithm>
+
+#include <QEvent>
+#include <QMetaObject>
+#include <QElapsedTimer>
+
+#include <nqlogger.h>
+
+#include "DeviceModelExecutor.h"
+
+/*
+  Watches the poll timer of a device model. It lives in the thread of the
+  device and sees the timer event before the timer emits timeout(), and
+  its timeout() connection is made after the one of the model, so it is
+  called once the update of the model has returned.
+  */
+class DeviceModelExecutor::Monitor : public QObject
+{
+public:
+
+  Monitor(DeviceModelExecutor* executor, const QString& name, QTimer* timer)
+    : executor_(executor),
+      name_(name),
+      timer_(timer),
+      timerId_(-1),
+      lastPoll_(-1),
+      interval_(-1),
+      begin_(-1)
+  {
+    clock_.start();
+  }
+
+  bool eventFilter(QObject* watched, QEvent* event)
+  {
+    if (watched==timer_ && event->type()==QEvent::Timer) {
+      const qint64 now = clock_.nsecsElapsed();
+
+      // a restarted timer has a new id, the pause is not a poll interval
+      if (lastPoll_>=0 && timer_->timerId()==timerId_) {
+        interval_ = now - lastPoll_;
+      } else {
+        interval_ = -1;
+      }
+
+      timerId_ = timer_->timerId();
+      lastPoll_ = now;
+      begin_ = now;
+    }
+
+    return false;
+  }
+
+  void pollFinished()
+  {
+    if (begin_<0) return;
+
+    const qint64 now = clock_.nsecsElapsed();
+    executor_->record(name_, timer_->interval(),
+                      interval_<0 ? -1. : 1.e-6 * interval_,
+                      1.e-6 * (now - begin_));
+    begin_ = -1;
+  }
+
+protected:
+
+  DeviceModelExecutor* executor_;
+  const QString name_;
+  QTimer* timer_;
+  QElapsedTimer clock_;
+  int timerId_;
+  qint64 lastPoll_;
+  qint64 interval_;
+  qint64 begin_;
+};
+
+DeviceModelExecutor::DeviceModelExecutor(QObject *parent)
+  : QObject(parent)
+{
+  logTimer_ = new QTimer(this);
+  connect(logTimer_, SIGNAL(timeout()), this, SLOT(logStatistics()));
+}
+
+DeviceModelExecutor::~DeviceModelExecutor()
+{
+  stop();
+
+  for (QMap<QString,Device>::iterator it = devices_.begin(); it != devices_.end(); ++it) {
+    delete it.value().model;
+  }
+}
+
+void DeviceModelExecutor::clearStatistics(Device& device)
+{
+  device.statistics.polls = 0;
+  device.statistics.meanInterval = 0;
+  device.statistics.rmsJitter = 0;
+  device.statistics.maxJitter = 0;
+  device.statistics.meanDuration = 0;
+  device.statistics.maxDuration = 0;
+  device.intervals = 0;
+  device.sumInterval = 0;
+  device.sumJitter2 = 0;
+  device.sumDuration = 0;
+}
+
+/**
+  Moves the device model to the thread of the given name, or to a thread
+  of its own if no name is given, and starts the thread. The model must
+  not have a parent and has to be added from the thread it lives in. The
+  executor takes ownership of the model and deletes it once the threads
+  are stopped.
+  */
+bool DeviceModelExecutor::addDevice(const QString& name, QObject* model,
+                                    const QString& threadName)
+{
+  if (!model) return false;
+
+  if (model->parent()) {
+    NQLogWarning("DeviceModelExecutor") << "addDevice: " << name.toStdString()
+                                        << " has a parent and cannot be moved";
+    return false;
+  }
+
+  if (model->thread()!=QThread::currentThread()) {
+    NQLogWarning("DeviceModelExecutor") << "addDevice: " << name.toStdString()
+                                        << " lives in another thread";
+    return false;
+  }
+
+  const QString thread = threadName.isEmpty() ? name : threadName;
+
+  QMutexLocker locker(&mutex_);
+
+  if (devices_.contains(name)) {
+    NQLogWarning("DeviceModelExecutor") << "addDevice: " << name.toStdString()
+                                        << " already added";
+    return false;
+  }
+
+  Device device;
+  device.model = model;
+  device.thread = threads_.value(thread, 0);
+  device.timer = 0;
+  device.monitor = 0;
+  device.statistics.thread = thread;
+  device.statistics.interval = 0;
+  clearStatistics(device);
+
+  if (!device.thread) {
+    device.thread = new QThread(this);
+    device.thread->setObjectName(thread);
+    threads_[thread] = device.thread;
+  }
+
+  QTimer* timer = 0;
+  QList<QTimer*> timers = model->findChildren<QTimer*>(QString(), Qt::FindDirectChildrenOnly);
+  for (QList<QTimer*>::iterator it = timers.begin(); it != timers.end(); ++it) {
+    if (!(*it)->isSingleShot()) {
+      timer = *it;
+      break;
+    }
+  }
+
+  // active timers are restarted in the new thread
+  model->moveToThread(device.thread);
+
+  if (timer) {
+    Monitor* monitor = new Monitor(this, name, timer);
+    monitor->moveToThread(device.thread);
+    timer->installEventFilter(monitor);
+    connect(timer, &QTimer::timeout, monitor, [monitor] { monitor->pollFinished(); });
+
+    device.timer = timer;
+    device.monitor = monitor;
+    device.statistics.interval = timer->interval();
+  } else {
+    NQLogMessage("DeviceModelExecutor") << "addDevice: " << name.toStdString()
+                                        << " has no poll timer";
+  }
+
+  names_ << name;
+  devices_[name] = device;
+
+  if (!device.thread->isRunning()) device.thread->start();
+
+  NQLogMessage("DeviceModelExecutor") << name.toStdString() << " runs in thread "
+                                      << thread.toStdString();
+
+  return true;
+}
+
+/**
+  Stops the poll timers and all threads after the updates that are running
+  have returned. The models stay in the stopped threads.
+  */
+void DeviceModelExecutor::stop()
+{
+  logTimer_->stop();
+
+  // timers can only be stopped from their own thread; the lock is not
+  // held while waiting, as the end of a poll records its statistics
+  QList<Device> devices;
+  {
+    QMutexLocker locker(&mutex_);
+    devices = devices_.values();
+  }
+  for (QList<Device>::iterator it = devices.begin(); it != devices.end(); ++it) {
+    if (it->timer && it->thread->isRunning()) {
+      QMetaObject::invokeMethod(it->timer, "stop", Qt::BlockingQueuedConnection);
+    }
+  }
+
+  for (QMap<QString,QThread*>::iterator it = threads_.begin(); it != threads_.end(); ++it) {
+    it.value()->quit();
+  }
+  for (QMap<QString,QThread*>::iterator it = threads_.begin(); it != threads_.end(); ++it) {
+    it.value()->wait();
+  }
+
+  QMutexLocker locker(&mutex_);
+
+  for (QMap<QString,Device>::iterator it = devices_.begin(); it != devices_.end(); ++it) {
+    delete it.value().monitor;
+    it.value().monitor = 0;
+  }
+}
+
+QStringList DeviceModelExecutor::getDevices() const
+{
+  QMutexLocker locker(&mutex_);
+  return names_;
+}
+
+QThread* DeviceModelExecutor::getThread(const QString& name) const
+{
+  QMutexLocker locker(&mutex_);
+
+  QMap<QString,Device>::const_iterator it = devices_.constFind(name);
+  if (it==devices_.constEnd()) return 0;
+
+  return it.value().thread;
+}
+
+DeviceModelExecutor::Statistics DeviceModelExecutor::getStatistics(const QString& name) const
+{
+  QMutexLocker locker(&mutex_);
+
+  QMap<QString,Device>::const_iterator it = devices_.constFind(name);
+  if (it==devices_.constEnd()) {
+    Device device;
+    device.statistics.interval = 0;
+    clearStatistics(device);
+    return device.statistics;
+  }
+
+  return it.value().statistics;
+}
+
+void DeviceModelExecutor::resetStatistics()
+{
+  QMutexLocker locker(&mutex_);
+
+  for (QMap<QString,Device>::iterator it = devices_.begin(); it != devices_.end(); ++it) {
+    clearStatistics(it.value());
+  }
+}
+
+/// Called from the device threads at the end of every poll.
+void DeviceModelExecutor::record(const QString& name, int interval,
+                                 double actualInterval, double duration)
+{
+  QMutexLocker locker(&mutex_);
+
+  QMap<QString,Device>::iterator it = devices_.find(name);
+  if (it==devices_.end()) return;
+
+  Device& device = it.value();
+  Statistics& statistics = device.statistics;
+
+  statistics.polls++;
+  statistics.interval = interval;
+
+  device.sumDuration += duration;
+  statistics.meanDuration = device.sumDuration / statistics.polls;
+  statistics.maxDuration = std::max(statistics.maxDuration, duration);
+
+  if (actualInterval>=0) {
+    const double jitter = actualInterval - interval;
+
+    device.intervals++;
+    device.sumInterval += actualInterval;
+    device.sumJitter2 += jitter * jitter;
+
+    statistics.meanInterval = device.sumInterval / device.intervals;
+    statistics.rmsJitter = std::sqrt(device.sumJitter2 / device.intervals);
+    statistics.maxJitter = std::max(statistics.maxJitter, std::fabs(jitter));
+  }
+}
+
+/// Logs the statistics of all devices every given number of seconds; 0 turns it off.
+void DeviceModelExecutor::setLogInterval(int seconds)
+{
+  if (seconds>0) {
+    logTimer_->start(seconds * 1000);
+  } else {
+    logTimer_->stop();
+  }
+}
+
+void DeviceModelExecutor::logStatistics()
+{
+  QStringList names = getDevices();
+
+  for (QStringList::const_iterator it = names.constBegin(); it != names.constEnd(); ++it) {
+    Statistics s = getStatistics(*it);
+
+    NQLogMessage("DeviceModelExecutor") << it->toStdString()
+                                        << ": " << s.polls << " polls every "
+                                        << s.interval << " ms, mean interval "
+                                        << s.meanInterval << " ms, jitter rms "
+                                        << s.rmsJitter << " ms max "
+                                        << s.maxJitter << " ms, update mean "
+                                        << s.meanDuration << " ms max "
+                                        << s.maxDuration << " ms";
+  }
+}
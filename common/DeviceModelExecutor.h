@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEVICEMODELEXECUTOR_H
+#define DEVICEMODELEXECUTOR_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+
+/** @addtogroup common
+ *  @{
+ */
+
+/**
+  Runs device models in I/O threads of their own, so that a device that
+  is slow to answer only delays its own updates and neither the other
+  devices nor the GUI.
+
+  A device model is moved to its thread together with its poll timer and
+  keeps polling at its own update interval. Signals from and to the
+  model become queued connections, i.e. slots like setters run in the
+  thread of the device, one after the other. Devices added with the same
+  thread name share a thread.
+
+  For every device the poll timer is watched and the interval between
+  polls, its deviation from the configured interval (jitter) and the
+  duration of the updates are accumulated. getStatistics() returns a
+  consistent copy of them from any thread.
+  */
+class DeviceModelExecutor : public QObject
+{
+  Q_OBJECT
+public:
+
+  struct Statistics
+  {
+    QString thread;         ///< name of the thread the device runs in
+    unsigned long polls;    ///< number of updates started by the poll timer
+    double interval;        ///< configured poll interval in ms
+    double meanInterval;    ///< mean time between polls in ms
+    double rmsJitter;       ///< RMS deviation from the configured interval in ms
+    double maxJitter;       ///< largest deviation from the configured interval in ms
+    double meanDuration;    ///< mean duration of an update in ms
+    double maxDuration;     ///< longest update in ms
+  };
+
+  explicit DeviceModelExecutor(QObject *parent = 0);
+  ~DeviceModelExecutor();
+
+  bool addDevice(const QString& name, QObject* model,
+                 const QString& threadName = QString());
+  void stop();
+
+  QStringList getDevices() const;
+  QThread* getThread(const QString& name) const;
+  Statistics getStatistics(const QString& name) const;
+  void resetStatistics();
+
+  void setLogInterval(int seconds);
+
+public slots:
+
+  void logStatistics();
+
+protected:
+
+  class Monitor;
+
+  struct Device
+  {
+    QObject* model;
+    QThread* thread;
+    QTimer* timer;
+    Monitor* monitor;
+    Statistics statistics;
+    unsigned long intervals;
+    double sumInterval;
+    double sumJitter2;
+    double sumDuration;
+  };
+
+  void record(const QString& name, int interval,
+              double actualInterval, double duration);
+  static void clearStatistics(Device& device);
+
+  mutable QMutex mutex_;
+  QStringList names_;
+  QMap<QString,Device> devices_;
+  QMap<QString,QThread*> threads_;
+
+  QTimer* logTimer_;
+};
+
+/** @} */
+
+#endif // DEVICEMODELEXECUTOR_H
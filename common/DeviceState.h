@@ -14,7 +14,10 @@
 #define DEVICESTATE_H
 
 #include <QObject>
+#include <QThread>
+#include <QMetaObject>
 #include <iostream>
+#include <atomic>
 
 /** @addtogroup common
  *  @{
@@ -47,7 +50,7 @@ template <class Controller> class AbstractDeviceModel
       destroyController(); }
 
   /// Returns the current (cached) state of the device.
-  const State& getDeviceState() const { 
+  State getDeviceState() const { 
       return state_; }
 
   /// Attempts to enable/disable the (communication with) the device.
@@ -98,7 +101,7 @@ protected:
     }
   }
 
-  State state_; ///< Cached device state.
+  std::atomic<State> state_; ///< Cached device state, read from other threads.
   /**
     \brief Sets the current device state.
     To be implemented as a slot and emit a deviceStateChanged signal on changes.
@@ -109,6 +112,25 @@ protected:
 
 };
 
+/**
+  \brief Queues the call of the slot \a member of \a model in the thread of
+  the model if called from any other thread.
+  Returns true if the call was queued; the calling setter then has to return
+  right away. Queued setters return before the value is applied, so the
+  getters of the model keep returning the previous value until the event
+  loop of the model thread has executed the call.
+  \code
+  if (queueInModelThread(this, "setVoltage", Q_ARG(int, channel), Q_ARG(float, voltage))) return;
+  \endcode
+  */
+template <typename... Args>
+bool queueInModelThread(QObject* model, const char* member, Args... args)
+{
+  if (model->thread()==QThread::currentThread()) return false;
+  QMetaObject::invokeMethod(model, member, Qt::QueuedConnection, args...);
+  return true;
+}
+
 /** @} */
 
 #endif // DEVICESTATE_H
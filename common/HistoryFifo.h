@@ -16,6 +16,7 @@
 #include <iostream>
 #include <cmath>
 #include <utility>
+#include <stdexcept>
 
 #include <QVector>
 #include <QDateTime>
@@ -24,6 +25,20 @@
  *  @{
  */
 
+/*
+  Fixed size ring buffer of time stamped values. Position 0 is the most
+  recent entry, position fillLevel()-1 the oldest one.
+
+  The time stamps are kept as milliseconds since the epoch and are
+  expected to increase monotonically, so that indexInPast() can do a
+  binary search. For every entry the buffer also keeps the running sums
+  of the values and of their squares since the last rebase, taken
+  relative to an offset close to the data. The sums and means over any
+  window of positions are therefore differences of two running sums.
+  Once per turn of the ring the running sums are recalculated from the
+  stored values with a new offset, which keeps the rounding errors
+  bounded independent of how long the buffer is in use.
+*/
 template <class T> class HistoryFifo
 {
 public:
@@ -34,274 +49,190 @@ public:
 
   explicit HistoryFifo(size_type n = 1, const value_type& value = value_type())
   {
-    size_ = n;
-    buffer_.resize(size_);
-    for (size_t i=0;i<size_;++i) {
-      buffer_[i] = storage_type(QDateTime::currentDateTime(), value);
-    }
-    currentIdx_ = size_-1;
-    fillLevel_ = 0;
+    initialize(n, value);
   }
 
   void resize(size_type n, const value_type& value = value_type())
   {
-    buffer_.resize(n);
-    for (size_t i=size_;i<n;++i) {
-      buffer_[i] = storage_type(QDateTime::currentDateTime(), value);
+    if (n==size_) return;
+
+    size_type keep = fillLevel_;
+    if (keep>n) keep = n;
+
+    QVector<qint64> times(keep);
+    QVector<value_type> values(keep);
+    for (size_type pos=0;pos<keep;++pos) {
+      times[pos] = times_[index(pos)];
+      values[pos] = values_[index(pos)];
+    }
+
+    initialize(n, value);
+
+    for (size_type pos=keep;pos>0;--pos) {
+      push_back(times[pos-1], values[pos-1]);
     }
-    size_ = n;
   }
 
-  size_type size()
+  size_type size() const
   {
     return size_;
   }
 
-  size_type fillLevel()
+  size_type fillLevel() const
   {
     return fillLevel_;
   }
 
-  virtual void push_back(const value_type& value)
+  void push_back(const value_type& value)
   {
-    push_back(QDateTime::currentDateTime(), value);
+    push_back(QDateTime::currentMSecsSinceEpoch(), value);
   }
 
-  virtual void push_back(const QDateTime& dt, const value_type& value)
+  void push_back(const QDateTime& dt, const value_type& value)
   {
-    currentIdx_++;
-    if (currentIdx_>=size_) currentIdx_ = 0;
-    buffer_[currentIdx_] = storage_type(dt, value);
-    if (fillLevel_<size_) fillLevel_++;
+    push_back(dt.toMSecsSinceEpoch(), value);
   }
 
-  virtual storage_type& at(size_type pos)
+  void push_back(qint64 msecs, const value_type& value)
   {
-    if (pos>=size_) throw std::out_of_range("HistoryFifo index out of range.");
+    size_type previousIdx = currentIdx_;
 
-    size_type thePos = pos;
-    if (thePos>=fillLevel_) thePos = fillLevel_-1;
-    if (currentIdx_>=thePos) {
-      thePos = currentIdx_ - thePos;
+    currentIdx_++;
+    if (currentIdx_>=size_) currentIdx_ = 0;
+    times_[currentIdx_] = msecs;
+    values_[currentIdx_] = value;
+
+    value_type d = value - offset_;
+    if (fillLevel_>0) {
+      sums_[currentIdx_] = sums_[previousIdx] + d;
+      squares_[currentIdx_] = squares_[previousIdx] + d * d;
     } else {
-      thePos = size_ + currentIdx_ - thePos;
+      sums_[currentIdx_] = d;
+      squares_[currentIdx_] = d * d;
     }
-    
-    return buffer_[thePos];
-  }
 
-  virtual const storage_type& at(size_type pos) const
-  {
-    if (pos>=size_) throw std::out_of_range("HistoryFifo index out of range.");
+    if (fillLevel_<size_) fillLevel_++;
 
-    size_type thePos = pos;
-    if (thePos>=fillLevel_) thePos = fillLevel_-1;
-    if (currentIdx_>=thePos) {
-      thePos = currentIdx_ - thePos;
-    } else {
-      thePos = size_ + currentIdx_ - thePos;
-    }
-    
-    return buffer_[thePos];
+    if (++pushesSinceRebase_>=size_) rebase();
   }
 
-  virtual QDateTime & timeAt(size_type pos)
+  storage_type at(size_type pos) const
   {
     if (pos>=size_) throw std::out_of_range("HistoryFifo index out of range.");
 
-    size_type thePos = pos;
-    if (thePos>=fillLevel_) thePos = fillLevel_-1;
-    if (currentIdx_>=thePos) {
-      thePos = currentIdx_ - thePos;
-    } else {
-      thePos = size_ + currentIdx_ - thePos;
-    }
-    
-    return buffer_[thePos].first;
+    size_type thePos = index(pos);
+    return storage_type(QDateTime::fromMSecsSinceEpoch(times_[thePos]), values_[thePos]);
   }
 
-  virtual const QDateTime & timeAt(size_type pos) const
+  QDateTime timeAt(size_type pos) const
   {
-    if (pos>=size_) throw std::out_of_range("HistoryFifo index out of range.");
-
-    size_type thePos = pos;
-    if (thePos>=fillLevel_) thePos = fillLevel_-1;
-    if (currentIdx_>=thePos) {
-      thePos = currentIdx_ - thePos;
-    } else {
-      thePos = size_ + currentIdx_ - thePos;
-    }
-    
-    return buffer_[thePos].first;
+    return QDateTime::fromMSecsSinceEpoch(msecsAt(pos));
   }
 
-  virtual value_type& valueAt(size_type pos)
+  qint64 msecsAt(size_type pos) const
   {
     if (pos>=size_) throw std::out_of_range("HistoryFifo index out of range.");
 
-    size_type thePos = pos;
-    if (thePos>=fillLevel_) thePos = fillLevel_-1;
-    if (currentIdx_>=thePos) {
-      thePos = currentIdx_ - thePos;
-    } else {
-      thePos = size_ + currentIdx_ - thePos;
-    }
-
-    return buffer_[thePos].second;
+    return times_[index(pos)];
   }
 
-  virtual const value_type& valueAt(size_type pos) const
+  const value_type& valueAt(size_type pos) const
   {
     if (pos>=size_) throw std::out_of_range("HistoryFifo index out of range.");
 
-    size_type thePos = pos;
-    if (thePos>=fillLevel_) thePos = fillLevel_-1;
-    if (currentIdx_>=thePos) {
-      thePos = currentIdx_ - thePos;
-    } else {
-      thePos = size_ + currentIdx_ - thePos;
-    }
-
-    return buffer_[thePos].second;
+    return values_[index(pos)];
   }
 
-  virtual storage_type& front()
+  storage_type front() const
   {
     return at(0);
   }
 
-  virtual const storage_type& front() const
-  {
-    return at(0);
-  }
-
-  virtual storage_type& back()
-  {
-    return at(fillLevel_-1);
-  }
-
-  virtual const storage_type& back() const
+  storage_type back() const
   {
-    return at(fillLevel_-1);
-  }
-
-  QDateTime & timeFront()
-  {
-    return timeAt(0);
+    return at(lastPos());
   }
 
-  const QDateTime & timeFront() const
+  QDateTime timeFront() const
   {
     return timeAt(0);
   }
 
-  QDateTime & timeBack() {
-    return timeAt(fillLevel_-1);
-  }
-
-  const QDateTime & timeBack() const
-  {
-    return timeAt(fillLevel_-1);
-  }
-  
-  virtual value_type& valueFront()
+  QDateTime timeBack() const
   {
-    return valueAt(0);
+    return timeAt(lastPos());
   }
 
-  virtual const value_type& valueFront() const
+  const value_type& valueFront() const
   {
     return valueAt(0);
   }
 
-  virtual value_type& valueBack()
+  const value_type& valueBack() const
   {
-    return valueAt(fillLevel_-1);
+    return valueAt(lastPos());
   }
 
-  virtual const value_type& valueBack() const
+  size_type indexInPast(const qint64& seconds) const
   {
-    return valueAt(fillLevel_-1);
-  }
+    if (fillLevel_==0) return 0;
 
-  virtual const size_type indexInPast(const qint64& seconds) const
-  {
-    const QDateTime & f = timeAt(0);
-    for (size_type pos = 0;pos<fillLevel_;pos++) {
-      const QDateTime & l = timeAt(pos);
-      if (l.secsTo(f)>=seconds) return pos;
+    const qint64 f = times_[index(0)];
+    size_type lo = 0;
+    size_type hi = fillLevel_-1;
+    while (lo<hi) {
+      size_type mid = lo + (hi - lo) / 2;
+      if ((f - times_[index(mid)]) / 1000 >= seconds) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
     }
 
-    return fillLevel_-1;
+    return lo;
   }
 
-  const qint64 deltaTime() const
+  qint64 deltaTime() const
   {
-    const QDateTime & f = timeFront();
-    const QDateTime & l = timeBack();
-    
-    return f.secsTo(l);
+    return deltaTime(0, lastPos());
   }
   
-  const qint64 deltaTime(size_type i) const
+  qint64 deltaTime(size_type i) const
   {
-    const QDateTime & f = timeFront();
-    const QDateTime & l = timeAt(i);
-
-    return f.secsTo(l);
+    return deltaTime(0, i);
   }
 
-  const qint64 deltaTime(size_type i, size_type j) const
+  qint64 deltaTime(size_type i, size_type j) const
   {
-    const QDateTime & f = timeAt(i);
-    const QDateTime & l = timeAt(j);
-    
-    return f.secsTo(l);
+    return (msecsAt(j) - msecsAt(i)) / 1000;
   }
 
-  const value_type delta() const
+  value_type delta() const
   {
-    const value_type & f = valueFront();
-    const value_type & l = valueBack();
-    
-    return l - f;
+    return delta(0, lastPos());
   }
 
-  const value_type delta(size_type i) const
+  value_type delta(size_type i) const
   {
-    const value_type & f = valueFront();
-    const value_type & l = valueAt(i);
-
-    return l - f;
+    return delta(0, i);
   }
 
-  const value_type delta(size_type i, size_type j) const
+  value_type delta(size_type i, size_type j) const
   {
-    const value_type & f = valueAt(i);
-    const value_type & l = valueAt(j);
-    
-    return l - f;
+    return valueAt(j) - valueAt(i);
   }
   
-  const value_type gradient() const
+  value_type gradient() const
   {
-    value_type d = delta();
-    double dt = deltaTime();
-    
-    if (dt!=0.) d /= dt;
-    return d;
+    return gradient(0, lastPos());
   }
 
-  const value_type gradient(size_type i) const
+  value_type gradient(size_type i) const
   {
-    value_type d = delta(i);
-    double dt = deltaTime(i);
-
-    if (dt!=0.) d /= dt;
-    return d;
+    return gradient(0, i);
   }
 
-  const value_type gradient(size_type i, size_type j) const
+  value_type gradient(size_type i, size_type j) const
   {
     value_type d = delta(i, j);
     double dt = deltaTime(i, j);
@@ -310,105 +241,54 @@ public:
     return d;
   }
 
-  const value_type mean() const
+  value_type mean() const
   {
-    value_type temp = 0;
-    size_type count = 0;
-
-    for (size_type pos=0;pos<fillLevel_;++pos) {
-      temp += valueAt(pos);
-      count++;
-    }
-
-    if (count>0) temp/= count;
-
-    return temp;
+    return mean(0, lastPos());
   }
 
-  const value_type mean(size_type i) const
+  value_type mean(size_type i) const
   {
-    value_type temp = 0;
-    size_type count = 0;
-    size_type max = i;
-    if (max>=fillLevel_) max = fillLevel_-1;
-
-    for (size_type pos=0;pos<=max;++pos) {
-      temp += valueAt(pos);
-      count++;
-    }
-
-    if (count>0) temp/= count;
-
-    return temp;
+    return mean(0, i);
   }
 
-  const value_type mean(size_type i, size_type j) const
+  value_type mean(size_type i, size_type j) const
   {
-    value_type temp = 0;
-    size_type count = 0;
-    size_type max = j;
-    if (max>=fillLevel_) max = fillLevel_-1;
-
-    for (size_type pos=i;pos<=max;++pos) {
-      temp += valueAt(pos);
-      count++;
-    }
-
-    if (count>0) temp/= count;
-
-    return temp;
+    return stats(i, j).first;
   }
 
-  const std::pair<value_type,value_type> stats() const
+  std::pair<value_type,value_type> stats() const
   {
-    value_type m = mean();
-    value_type temp = 0;
-    size_type count = 0;
-
-    for (size_type pos=0;pos<fillLevel_;++pos) {
-      temp += std::pow(valueAt(pos)-m , 2);
-      count++;
-    }
-
-    if (count>0) temp /= count;
-
-    return std::pair<value_type,value_type>(m, temp);
+    return stats(0, lastPos());
   }
 
-  const std::pair<value_type,value_type> stats(size_type i) const
+  std::pair<value_type,value_type> stats(size_type i) const
   {
-    value_type m = mean(i);
-    value_type temp = 0;
-    size_type count = 0;
-    size_type max = i;
-    if (max>=fillLevel_) max = fillLevel_-1;
-
-    for (size_type pos=0;pos<=max;++pos) {
-      temp += std::pow(valueAt(pos)-m , 2);
-      count++;
-    }
-
-    if (count>0) temp /= count;
-
-    return std::pair<value_type,value_type>(m, temp);
+    return stats(0, i);
   }
 
-  const std::pair<value_type,value_type> stats(size_type i, size_type j) const
+  /*
+    Mean and (population) variance of the values at the positions i to j.
+    Positions beyond the fill level are ignored.
+  */
+  std::pair<value_type,value_type> stats(size_type i, size_type j) const
   {
-    value_type m = mean(i, j);
-    value_type temp = 0;
-    size_type count = 0;
+    if (fillLevel_==0) return std::pair<value_type,value_type>(0, 0);
+
     size_type max = j;
     if (max>=fillLevel_) max = fillLevel_-1;
+    if (i>max) return std::pair<value_type,value_type>(0, 0);
 
-    for (size_type pos=i;pos<=max;++pos) {
-      temp += std::pow(valueAt(pos)-m , 2);
-      count++;
-    }
+    size_type newest = index(i);
+    size_type oldest = index(max);
+    value_type first = values_[oldest] - offset_;
+    value_type sum = sums_[newest] - sums_[oldest] + first;
+    value_type squares = squares_[newest] - squares_[oldest] + first * first;
+    size_type count = max - i + 1;
 
-    if (count>0) temp /= count;
+    value_type variance = (squares - sum * sum / count) / count;
+    if (variance<0) variance = 0;
 
-    return std::pair<value_type,value_type>(m, temp);
+    return std::pair<value_type,value_type>(offset_ + sum / count, variance);
   }
 
   class iterator
@@ -417,7 +297,7 @@ public:
 
     typedef size_t size_type;
 
-    iterator(size_type position, HistoryFifo& fifo)
+    iterator(size_type position, const HistoryFifo& fifo)
       : position_(position), fifo_(fifo) { }
 
     iterator& operator++(int)
@@ -432,7 +312,7 @@ public:
       return *this;
     }
 
-    storage_type& operator*()
+    storage_type operator*() const
     {
       return fifo_.at(position_);
     }
@@ -445,86 +325,97 @@ public:
   private:
 
     size_type position_;
-    HistoryFifo<T>& fifo_;
+    const HistoryFifo<T>& fifo_;
   };
 
-  iterator begin()
+  typedef iterator const_iterator;
+
+  iterator begin() const
   {
     return iterator(0, *this);
   }
 
-  iterator past(const qint64& seconds)
+  iterator past(const qint64& seconds) const
   {
     size_type pos = indexInPast(seconds) + 1;
     if (pos>fillLevel_) pos = fillLevel_;
     return iterator(pos, *this);
   }
 
-  iterator end()
+  iterator end() const
   {
     return iterator(fillLevel_, *this);
   }
 
-  class const_iterator
+  const_iterator cbegin() const
   {
-  public:
-
-    typedef size_t size_type;
-
-    const_iterator(size_type position, const HistoryFifo& fifo)
-      : position_(position), fifo_(fifo) { }
-
-    const_iterator& operator++(int)
-    {
-      position_++;
-      return *this;
-    }
-
-    const_iterator& operator++()
-    {
-      ++position_;
-      return *this;
-    }
-
-    const storage_type& operator*() const
-    {
-      return fifo_.at(position_);
-    }
+    return begin();
+  }
 
-    bool operator!=(const iterator& other) const
-    {
-      return (position_ != other.position_);
-    }
+  const_iterator cpast(const qint64& seconds) const
+  {
+    return past(seconds);
+  }
 
-  private:
+  const_iterator cend() const
+  {
+    return end();
+  }
 
-    size_type position_;
-    const HistoryFifo<T>& fifo_;
-  };
+protected:
 
-  const const_iterator cbegin() const
+  void initialize(size_type n, const value_type& value)
   {
-    return const_iterator(0, *this);
+    size_ = n;
+    times_.fill(QDateTime::currentMSecsSinceEpoch(), size_);
+    values_.fill(value, size_);
+    sums_.fill(value_type(), size_);
+    squares_.fill(value_type(), size_);
+    offset_ = value;
+    currentIdx_ = size_-1;
+    fillLevel_ = 0;
+    pushesSinceRebase_ = 0;
   }
 
-  const const_iterator cpast(const qint64& seconds) const
+  size_type lastPos() const
   {
-    size_type pos = indexInPast(seconds) + 1;
-    if (pos>fillLevel_) pos = fillLevel_;
-    return iterator(pos, *this);
+    return fillLevel_>0 ? fillLevel_-1 : 0;
   }
 
-  const const_iterator cend() const
+  size_type index(size_type pos) const
   {
-    return const_iterator(fillLevel_, *this);
+    if (pos>=fillLevel_) pos = lastPos();
+    if (currentIdx_>=pos) return currentIdx_ - pos;
+    return size_ + currentIdx_ - pos;
   }
 
-protected:
+  void rebase()
+  {
+    offset_ = values_[currentIdx_];
+
+    value_type sum = 0;
+    value_type squares = 0;
+    for (size_type pos=fillLevel_;pos>0;--pos) {
+      size_type idx = index(pos-1);
+      value_type d = values_[idx] - offset_;
+      sum += d;
+      squares += d * d;
+      sums_[idx] = sum;
+      squares_[idx] = squares;
+    }
+
+    pushesSinceRebase_ = 0;
+  }
 
   size_type size_;
   size_type currentIdx_;
   size_type fillLevel_;
-  QVector<std::pair<QDateTime,value_type> > buffer_;
+  size_type pushesSinceRebase_;
+  QVector<qint64> times_;
+  QVector<value_type> values_;
+  QVector<value_type> sums_;
+  QVector<value_type> squares_;
+  value_type offset_;
 };
 
 /** @} */
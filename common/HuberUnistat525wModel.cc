@@ -39,17 +39,22 @@ HuberUnistat525wModel::HuberUnistat525wModel(const char* port,
 
 double HuberUnistat525wModel::getTemperatureSetPoint() const
 {
+  QMutexLocker locker(&mutex_);
   return temperatureSetPoint_;
 }
 
 void HuberUnistat525wModel::setTemperatureSetPoint(double temperature)
 {
+  if (queueInModelThread(this, "setTemperatureSetPoint", Q_ARG(double, temperature))) return;
+
   if (state_ == READY) {
 
     if (temperatureSetPoint_!=temperature) {
 
       if (controller_->SetTemperatureSetPoint(temperature)) {
+        QMutexLocker locker(&mutex_);
         temperatureSetPoint_ = temperature;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -58,17 +63,22 @@ void HuberUnistat525wModel::setTemperatureSetPoint(double temperature)
 
 bool HuberUnistat525wModel::getTemperatureControlMode() const
 {
+  QMutexLocker locker(&mutex_);
   return temperatureControlMode_;
 }
 
 void HuberUnistat525wModel::setTemperatureControlMode(bool process)
 {
+  if (queueInModelThread(this, "setTemperatureControlMode", Q_ARG(bool, process))) return;
+
   if (state_ == READY) {
 
     if (temperatureControlMode_!=process) {
 
       if (controller_->SetTemperatureControlMode(process)) {
+        QMutexLocker locker(&mutex_);
         temperatureControlMode_ = process;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -76,17 +86,22 @@ void HuberUnistat525wModel::setTemperatureControlMode(bool process)
 }
 bool HuberUnistat525wModel::getTemperatureControlEnabled() const
 {
+  QMutexLocker locker(&mutex_);
   return temperatureControlEnabled_;
 }
 
 void HuberUnistat525wModel::setTemperatureControlEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setTemperatureControlEnabled", Q_ARG(bool, enabled))) return;
+
   if (state_ == READY) {
 
     if (temperatureControlEnabled_!=enabled) {
 
       if (controller_->SetTemperatureControlEnabled(enabled)) {
+        QMutexLocker locker(&mutex_);
         temperatureControlEnabled_ = enabled;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -95,17 +110,22 @@ void HuberUnistat525wModel::setTemperatureControlEnabled(bool enabled)
 
 bool HuberUnistat525wModel::getCirculatorEnabled() const
 {
+  QMutexLocker locker(&mutex_);
   return circulatorEnabled_;
 }
 
 void HuberUnistat525wModel::setCirculatorEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setCirculatorEnabled", Q_ARG(bool, enabled))) return;
+
   if (state_ == READY) {
 
     if (circulatorEnabled_!=enabled) {
 
       if (controller_->SetCirculatorEnabled(enabled)) {
+        QMutexLocker locker(&mutex_);
         circulatorEnabled_ = enabled;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -114,52 +134,64 @@ void HuberUnistat525wModel::setCirculatorEnabled(bool enabled)
 
 double HuberUnistat525wModel::getInternalTemperature() const
 {
+  QMutexLocker locker(&mutex_);
   return internalTemperature_;
 }
 
 double HuberUnistat525wModel::getProcessTemperature() const
 {
+  QMutexLocker locker(&mutex_);
   return processTemperature_;
 }
 
 double HuberUnistat525wModel::getReturnTemperature() const
 {
+  QMutexLocker locker(&mutex_);
   return returnTemperature_;
 }
 
 double HuberUnistat525wModel::getPumpPressure() const
 {
+  QMutexLocker locker(&mutex_);
   return pumpPressure_;
 }
 
 int HuberUnistat525wModel::getPower() const
 {
+  QMutexLocker locker(&mutex_);
   return power_;
 }
 
 double HuberUnistat525wModel::getCoolingWaterInletTemperature() const
 {
+  QMutexLocker locker(&mutex_);
   return cwInletTemperature_;
 }
 
 double HuberUnistat525wModel::getCoolingWaterOutletTemperature() const
 {
+  QMutexLocker locker(&mutex_);
   return cwOutletTemperature_;
 }
 
 bool HuberUnistat525wModel::getAutoPID() const
 {
+  QMutexLocker locker(&mutex_);
   return autoPID_;
 }
 
 void HuberUnistat525wModel::setAutoPID(bool autoPID)
 {
+  if (queueInModelThread(this, "setAutoPID", Q_ARG(bool, autoPID))) return;
+
   if (state_ == READY) {
 
     if (autoPID_!=autoPID) {
 
       if (controller_->SetAutoPID(autoPID)) {
+        QMutexLocker locker(&mutex_);
         autoPID_ = autoPID;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -168,17 +200,22 @@ void HuberUnistat525wModel::setAutoPID(bool autoPID)
 
 int HuberUnistat525wModel::getKpInternal() const
 {
+  QMutexLocker locker(&mutex_);
   return KpInternal_;
 }
 
 void HuberUnistat525wModel::setKpInternal(int Kp)
 {
+  if (queueInModelThread(this, "setKpInternal", Q_ARG(int, Kp))) return;
+
   if (state_ == READY) {
 
     if (KpInternal_!=Kp) {
 
       if (controller_->SetKpInternal(Kp)) {
+        QMutexLocker locker(&mutex_);
         KpInternal_ = Kp;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -187,17 +224,22 @@ void HuberUnistat525wModel::setKpInternal(int Kp)
 
 double HuberUnistat525wModel::getTnInternal() const
 {
+  QMutexLocker locker(&mutex_);
   return TnInternal_;
 }
 
 void HuberUnistat525wModel::setTnInternal(double Tn)
 {
+  if (queueInModelThread(this, "setTnInternal", Q_ARG(double, Tn))) return;
+
   if (state_ == READY) {
 
     if (TnInternal_!=Tn) {
 
       if (controller_->SetTnInternal(Tn)) {
+        QMutexLocker locker(&mutex_);
         TnInternal_ = Tn;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -206,17 +248,22 @@ void HuberUnistat525wModel::setTnInternal(double Tn)
 
 double HuberUnistat525wModel::getTvInternal() const
 {
+  QMutexLocker locker(&mutex_);
   return TvInternal_;
 }
 
 void HuberUnistat525wModel::setTvInternal(double Tv)
 {
+  if (queueInModelThread(this, "setTvInternal", Q_ARG(double, Tv))) return;
+
   if (state_ == READY) {
 
     if (TvInternal_!=Tv) {
 
       if (controller_->SetTvInternal(Tv)) {
+        QMutexLocker locker(&mutex_);
         TvInternal_ = Tv;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -225,17 +272,22 @@ void HuberUnistat525wModel::setTvInternal(double Tv)
 
 int HuberUnistat525wModel::getKpJacket() const
 {
+  QMutexLocker locker(&mutex_);
   return KpJacket_;
 }
 
 void HuberUnistat525wModel::setKpJacket(int Kp)
 {
+  if (queueInModelThread(this, "setKpJacket", Q_ARG(int, Kp))) return;
+
   if (state_ == READY) {
 
     if (KpJacket_!=Kp) {
 
       if (controller_->SetKpJacket(Kp)) {
+        QMutexLocker locker(&mutex_);
         KpJacket_ = Kp;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -244,17 +296,22 @@ void HuberUnistat525wModel::setKpJacket(int Kp)
 
 double HuberUnistat525wModel::getTnJacket() const
 {
+  QMutexLocker locker(&mutex_);
   return TnJacket_;
 }
 
 void HuberUnistat525wModel::setTnJacket(double Tn)
 {
+  if (queueInModelThread(this, "setTnJacket", Q_ARG(double, Tn))) return;
+
   if (state_ == READY) {
 
     if (TnJacket_!=Tn) {
 
       if (controller_->SetTnJacket(Tn)) {
+        QMutexLocker locker(&mutex_);
         TnJacket_ = Tn;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -263,17 +320,22 @@ void HuberUnistat525wModel::setTnJacket(double Tn)
 
 double HuberUnistat525wModel::getTvJacket() const
 {
+  QMutexLocker locker(&mutex_);
   return TvJacket_;
 }
 
 void HuberUnistat525wModel::setTvJacket(double Tv)
 {
+  if (queueInModelThread(this, "setTvJacket", Q_ARG(double, Tv))) return;
+
   if (state_ == READY) {
 
     if (TvJacket_!=Tv) {
 
       if (controller_->SetTvJacket(Tv)) {
+        QMutexLocker locker(&mutex_);
         TvJacket_ = Tv;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -282,17 +344,22 @@ void HuberUnistat525wModel::setTvJacket(double Tv)
 
 int HuberUnistat525wModel::getKpProcess() const
 {
+  QMutexLocker locker(&mutex_);
   return KpProcess_;
 }
 
 void HuberUnistat525wModel::setKpProcess(int Kp)
 {
+  if (queueInModelThread(this, "setKpProcess", Q_ARG(int, Kp))) return;
+
   if (state_ == READY) {
 
     if (KpProcess_!=Kp) {
 
       if (controller_->SetKpProcess(Kp)) {
+        QMutexLocker locker(&mutex_);
         KpProcess_ = Kp;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -301,17 +368,22 @@ void HuberUnistat525wModel::setKpProcess(int Kp)
 
 double HuberUnistat525wModel::getTnProcess() const
 {
+  QMutexLocker locker(&mutex_);
   return TnProcess_;
 }
 
 void HuberUnistat525wModel::setTnProcess(double Tn)
 {
+  if (queueInModelThread(this, "setTnProcess", Q_ARG(double, Tn))) return;
+
   if (state_ == READY) {
 
     if (TnProcess_!=Tn) {
 
       if (controller_->SetTnProcess(Tn)) {
+        QMutexLocker locker(&mutex_);
         TnProcess_ = Tn;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -320,17 +392,22 @@ void HuberUnistat525wModel::setTnProcess(double Tn)
 
 double HuberUnistat525wModel::getTvProcess() const
 {
+  QMutexLocker locker(&mutex_);
   return TvProcess_;
 }
 
 void HuberUnistat525wModel::setTvProcess(double Tv)
 {
+  if (queueInModelThread(this, "setTvProcess", Q_ARG(double, Tv))) return;
+
   if (state_ == READY) {
 
     if (TvProcess_!=Tv) {
 
       if (controller_->SetTvProcess(Tv)) {
+        QMutexLocker locker(&mutex_);
         TvProcess_ = Tv;
+        locker.unlock();
         emit informationChanged();
       }
     }
@@ -339,12 +416,14 @@ void HuberUnistat525wModel::setTvProcess(double Tv)
 
 int HuberUnistat525wModel::getKp() const
 {
+  QMutexLocker locker(&mutex_);
+
   if (autoPID_) return 0;
 
   if (!temperatureControlMode_) {
-    return getKpInternal();
+    return KpInternal_;
   } else {
-    return getKpProcess();
+    return KpProcess_;
   }
 
   return 0;
@@ -352,6 +431,8 @@ int HuberUnistat525wModel::getKp() const
 
 void HuberUnistat525wModel::setKp(int Kp)
 {
+  if (queueInModelThread(this, "setKp", Q_ARG(int, Kp))) return;
+
   if (autoPID_) return;
 
   if (!temperatureControlMode_) {
@@ -363,12 +444,14 @@ void HuberUnistat525wModel::setKp(int Kp)
 
 double HuberUnistat525wModel::getTn() const
 {
+  QMutexLocker locker(&mutex_);
+
   if (autoPID_) return 0;
 
   if (!temperatureControlMode_) {
-    return getTnInternal();
+    return TnInternal_;
   } else {
-    return getTnProcess();
+    return TnProcess_;
   }
 
   return 0;
@@ -376,6 +459,8 @@ double HuberUnistat525wModel::getTn() const
 
 void HuberUnistat525wModel::setTn(double Tn)
 {
+  if (queueInModelThread(this, "setTn", Q_ARG(double, Tn))) return;
+
   if (autoPID_) return;
 
   if (!temperatureControlMode_) {
@@ -387,12 +472,14 @@ void HuberUnistat525wModel::setTn(double Tn)
 
 double HuberUnistat525wModel::getTv() const
 {
+  QMutexLocker locker(&mutex_);
+
   if (autoPID_) return 0;
 
   if (!temperatureControlMode_) {
-    return getTvInternal();
+    return TvInternal_;
   } else {
-    return getTvProcess();
+    return TvProcess_;
   }
 
   return 0;
@@ -400,6 +487,8 @@ double HuberUnistat525wModel::getTv() const
 
 void HuberUnistat525wModel::setTv(double Tv)
 {
+  if (queueInModelThread(this, "setTv", Q_ARG(double, Tv))) return;
+
   if (autoPID_) return;
 
   if (!temperatureControlMode_) {
@@ -411,6 +500,8 @@ void HuberUnistat525wModel::setTv(double Tv)
 
 void HuberUnistat525wModel::setPID(int Kp, double Tn, double Tv)
 {
+  if (queueInModelThread(this, "setPID", Q_ARG(int, Kp), Q_ARG(double, Tn), Q_ARG(double, Tv))) return;
+
   if (autoPID_) return;
 
   if (!temperatureControlMode_) {
@@ -543,6 +634,8 @@ void HuberUnistat525wModel::updateInformation()
         newTnProcess != TnProcess_ ||
         newTvProcess != TvProcess_) {
 
+      QMutexLocker locker(&mutex_);
+
       temperatureSetPoint_ = newTemperatureSetPoint;
       temperatureControlMode_ = newTemperatureControlMode;
       temperatureControlEnabled_ = newTemperatureControlEnabled;
@@ -566,6 +659,8 @@ void HuberUnistat525wModel::updateInformation()
       TnProcess_ = newTnProcess ;
       TvProcess_ = newTvProcess ;
 
+      locker.unlock();
+
       NQLog("HuberUnistat525wModel", NQLog::Spam) << "information changed";
 
       emit informationChanged();
@@ -575,6 +670,8 @@ void HuberUnistat525wModel::updateInformation()
 
 void HuberUnistat525wModel::setDeviceEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setDeviceEnabled", Q_ARG(bool, enabled))) return;
+
   AbstractDeviceModel<HuberPilotOne_t>::setDeviceEnabled(enabled);
 }
 
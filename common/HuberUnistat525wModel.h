@@ -16,6 +16,7 @@
 #include <cmath>
 
 #include <QString>
+#include <QMutex>
 #include <QTimer>
 
 #include "DeviceState.h"
@@ -73,6 +74,8 @@ public:
 
   void statusMessage(const QString & text);
 
+  // Setters called from another thread return before the value is applied,
+  // see queueInModelThread().
 public slots:
 
   void setDeviceEnabled(bool enabled);
@@ -114,6 +117,9 @@ protected:
 
   void setDeviceState( State state );
 
+  /// Guards the cached values, which are read from other threads.
+  mutable QMutex mutex_;
+
   double temperatureSetPoint_;
   bool temperatureControlMode_;
   bool temperatureControlEnabled_;
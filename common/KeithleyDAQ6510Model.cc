@@ -24,9 +24,13 @@ KeithleyDAQ6510Model::KeithleyDAQ6510Model(const char* port,
   port_(port),
   updateInterval_(updateInterval)
 {
+  // sensor modes are passed to queued slots and to signals in other threads
+  qRegisterMetaType<VKeithleyDAQ6510::ChannelMode_t>("VKeithleyDAQ6510::ChannelMode_t");
+
   for (int card=0;card<2;++card) {
     for (int channel=0;channel<10;++channel) {
       sensorStates_[card][channel] = OFF;
+      sensorModes_[card][channel] = VKeithleyDAQ6510::FourWireRTD_PT100;
       temperatures_[card][channel] = 0.0;
     }
   }
@@ -58,6 +62,15 @@ void KeithleyDAQ6510Model::initialize()
 
     setDeviceState(READY);
 
+    {
+      QMutexLocker locker(&mutex_);
+      for (unsigned int card=0;card<2;++card) {
+        for (unsigned int channel=0;channel<10;++channel) {
+          sensorModes_[card][channel] = controller_->GetChannelMode(card+1, channel+1);
+        }
+      }
+    }
+
     // Set empty string to disable all channels
     // controller_->SetActiveChannels("0-9");
 
@@ -79,6 +92,8 @@ void KeithleyDAQ6510Model::initialize()
 
 void KeithleyDAQ6510Model::setDeviceEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setDeviceEnabled", Q_ARG(bool, enabled))) return;
+
   // Trivial reimplementation as slot.
   AbstractDeviceModel<KeithleyDAQ6510_t>::setDeviceEnabled(enabled);
 
@@ -87,6 +102,8 @@ void KeithleyDAQ6510Model::setDeviceEnabled(bool enabled)
 
 void KeithleyDAQ6510Model::setScanEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setScanEnabled", Q_ARG(bool, enabled))) return;
+
   if ( state_ == READY ) {
     if (scanState_==enabled) return;
 
@@ -96,7 +113,9 @@ void KeithleyDAQ6510Model::setScanEnabled(bool enabled)
       timer_->stop();
     }
     
+    QMutexLocker locker(&mutex_);
     scanState_ = enabled;
+    locker.unlock();
 
     emit scanStateChanged(enabled);
 
@@ -111,7 +130,9 @@ void KeithleyDAQ6510Model::setDeviceState(State state)
 
     if ( state != READY && scanState_) {
       timer_->stop();
+      QMutexLocker locker(&mutex_);
       scanState_ = false;
+      locker.unlock();
       emit scanStateChanged(scanState_);
     }
 
@@ -131,7 +152,9 @@ void KeithleyDAQ6510Model::setSensorState(unsigned int sensor, State state)
   unsigned int channel = sensor % 100 - 1;
 
   if (sensorStates_[card][channel] != state) {
+    QMutexLocker locker(&mutex_);
     sensorStates_[card][channel] = state;
+    locker.unlock();
     emit sensorStateChanged(sensor, state);
   }
 }
@@ -139,6 +162,8 @@ void KeithleyDAQ6510Model::setSensorState(unsigned int sensor, State state)
 /// Attempts to enable a sensor.
 void KeithleyDAQ6510Model::setSensorEnabled(unsigned int sensor, bool enabled)
 {
+  if (queueInModelThread(this, "setSensorEnabled", Q_ARG(unsigned int, sensor), Q_ARG(bool, enabled))) return;
+
   unsigned int card = sensor / 100 - 1;
   unsigned int channel = sensor % 100 - 1;
 
@@ -159,13 +184,20 @@ void KeithleyDAQ6510Model::setSensorEnabled(unsigned int sensor, bool enabled)
 
 void KeithleyDAQ6510Model::setSensorMode(unsigned int sensor, KeithleyDAQ6510_t::ChannelMode_t mode)
 {
+  if (queueInModelThread(this, "setSensorMode", Q_ARG(unsigned int, sensor), Q_ARG(VKeithleyDAQ6510::ChannelMode_t, mode))) return;
+
   unsigned int card = sensor / 100;
   unsigned int channel = sensor % 100;
 
-  if (controller_->GetChannelMode(card, channel)==mode) return;
+  if (card<1 || card>2 || channel<1 || channel>10) return;
+
+  if (sensorModes_[card-1][channel-1]==mode) return;
 
   // if (sensorStates_[card][channel] == READY) {
     controller_->SetChannelMode(card, channel, mode);
+    QMutexLocker locker(&mutex_);
+    sensorModes_[card-1][channel-1] = mode;
+    locker.unlock();
     emit sensorModeChanged(sensor, mode);
   //}
 }
@@ -177,17 +209,22 @@ void KeithleyDAQ6510Model::setControlsEnabled(bool enabled)
 
 void KeithleyDAQ6510Model::setUpdateInterval(int updateInterval)
 {
+  if (queueInModelThread(this, "setUpdateInterval", Q_ARG(int, updateInterval))) return;
+
   if (updateInterval<10) return;
+  QMutexLocker locker(&mutex_);
   updateInterval_ = updateInterval;
+  locker.unlock();
   timer_->setInterval(updateInterval_ * 1000);
 }
 
 /// Returns the current cached state of the requested sensor.
-const State & KeithleyDAQ6510Model::getSensorState(unsigned int sensor) const
+State KeithleyDAQ6510Model::getSensorState(unsigned int sensor) const
 {
   unsigned int card = sensor / 100 - 1;
   unsigned int channel = sensor % 100 - 1;
 
+  QMutexLocker locker(&mutex_);
   return sensorStates_[card][channel];
 }
 
@@ -196,7 +233,10 @@ VKeithleyDAQ6510::ChannelMode_t KeithleyDAQ6510Model::getSensorMode(unsigned int
   unsigned int card = sensor / 100;
   unsigned int channel = sensor % 100;
 
-  return controller_->GetChannelMode(card, channel);
+  if (card<1 || card>2 || channel<1 || channel>10) return VKeithleyDAQ6510::UnknownMode;
+
+  QMutexLocker locker(&mutex_);
+  return sensorModes_[card-1][channel-1];
 }
 
 const std::map<VKeithleyDAQ6510::ChannelMode_t,std::string>& KeithleyDAQ6510Model::getSensorModeNames() const
@@ -210,6 +250,7 @@ double KeithleyDAQ6510Model::getTemperature(unsigned int sensor) const
   unsigned int card = sensor / 100 - 1;
   unsigned int channel = sensor % 100 - 1;
 
+  QMutexLocker locker(&mutex_);
   return temperatures_[card][channel];
 }
 
@@ -252,7 +293,9 @@ void KeithleyDAQ6510Model::scanComplete()
     NQLogDebug("KeithleyDAQ6510Model") << "data: " << sensor << " " << temperature << " " << relativeTime;
 
     if (temperatures_[card][channel] != temperature) {
+      QMutexLocker locker(&mutex_);
       temperatures_[card][channel] = temperature;
+      locker.unlock();
       emit temperatureChanged(sensor, temperature);
       changed = true;
     }
@@ -19,6 +19,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QMutex>
 #include <QTimer>
 
 #include "DeviceState.h"
@@ -44,16 +45,18 @@ public:
                                 int updateInterval = 60,
                                 QObject *parent = 0);
 
-  const State& getSensorState(unsigned int sensor) const;
-  bool getScanState() const { return scanState_; }
+  State getSensorState(unsigned int sensor) const;
+  bool getScanState() const { QMutexLocker locker(&mutex_); return scanState_; }
   VKeithleyDAQ6510::ChannelMode_t getSensorMode(unsigned int sensor) const;
   const std::map<VKeithleyDAQ6510::ChannelMode_t,std::string>& getSensorModeNames() const;
 
   double getTemperature(unsigned int sensor) const;
-  int getUpdateInterval() const { return updateInterval_; }
+  int getUpdateInterval() const { QMutexLocker locker(&mutex_); return updateInterval_; }
 
   void statusMessage(const QString & text);
 
+  // Setters called from another thread return before the value is applied,
+  // see queueInModelThread().
 public slots:
 
   void setDeviceEnabled(bool enabled);
@@ -74,8 +77,12 @@ protected:
   bool scanState_;
   unsigned int scanDuration_;
 
+  /// Guards the cached values, which are read from other threads.
+  mutable QMutex mutex_;
+
   // cached config information
   std::array<std::array<State,10>,2> sensorStates_;
+  std::array<std::array<VKeithleyDAQ6510::ChannelMode_t,10>,2> sensorModes_;
   std::array<std::array<double,10>,2> temperatures_;
 
   void setDeviceState( State state );
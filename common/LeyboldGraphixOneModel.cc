@@ -69,6 +69,7 @@ void LeyboldGraphixOneModel::setSensorName(const std::string& name)
 
 LeyboldGraphixOne_t::SensorStatus LeyboldGraphixOneModel::getSensorStatus() const
 {
+  QMutexLocker locker(&mutex_);
   return status_;
 }
 
@@ -79,11 +80,13 @@ const std::string LeyboldGraphixOneModel::getSensorStatusText(LeyboldGraphixOne_
 
 double LeyboldGraphixOneModel::getPressure() const
 {
+  QMutexLocker locker(&mutex_);
   return pressure_;
 }
 
 LeyboldGraphixOne_t::DisplayUnit LeyboldGraphixOneModel::getDisplayUnit() const
 {
+  QMutexLocker locker(&mutex_);
   return displayUnit_;
 }
 
@@ -91,7 +94,9 @@ void LeyboldGraphixOneModel::setDisplayUnit(LeyboldGraphixOne_t::DisplayUnit uni
 {
   if (displayUnit_ != unit) {
     controller_->SetDisplayUnit(unit);
+    QMutexLocker locker(&mutex_);
     displayUnit_ = unit;
+    locker.unlock();
     emit informationChanged();
   }
 }
@@ -180,10 +185,11 @@ void LeyboldGraphixOneModel::updateInformation()
         pressure != pressure_ ||
         displayUnit != displayUnit_) {
 
+      QMutexLocker locker(&mutex_);
       status_ = status;
       pressure_ = pressure;
-
       displayUnit_ = displayUnit;
+      locker.unlock();
 
       NQLog("LeyboldGraphixOneModel", NQLog::Spam) << "information changed";
 
@@ -195,6 +201,8 @@ void LeyboldGraphixOneModel::updateInformation()
 /// Attempts to enable/disable the (communication with) the LeyboldGraphixOne controller.
 void LeyboldGraphixOneModel::setDeviceEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setDeviceEnabled", Q_ARG(bool, enabled))) return;
+
   AbstractDeviceModel<LeyboldGraphixOne_t>::setDeviceEnabled(enabled);
 }
 
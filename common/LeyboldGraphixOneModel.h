@@ -18,6 +18,7 @@
 #include <array>
 
 #include <QString>
+#include <QMutex>
 #include <QTimer>
 #include <QDateTime>
 
@@ -34,6 +35,9 @@ typedef LeyboldGraphixOne LeyboldGraphixOne_t;
 
 /**
   Command and control model of the Leybold vacuum controller.
+
+  The sensor configuration and the date and time accessors talk to the
+  controller directly and may only be called from the thread of the model.
   */
 class LeyboldGraphixOneModel : public QObject, public AbstractDeviceModel<LeyboldGraphixOne_t>
 {
@@ -66,6 +70,8 @@ public:
 
   void statusMessage(const QString & text);
 
+  // Setters called from another thread return before the value is applied,
+  // see queueInModelThread().
 public slots:
 
   void setDeviceEnabled(bool enabled);
@@ -85,6 +91,9 @@ protected:
 
   void setDeviceState(State state);
 
+  /// Guards the cached values, which are read from other threads.
+  mutable QMutex mutex_;
+
   LeyboldGraphixOne_t::SensorStatus status_;
   double pressure_;
   LeyboldGraphixOne_t::DisplayUnit displayUnit_;
@@ -51,26 +51,31 @@ MartaModel::~MartaModel()
 uint16_t MartaModel::getAlarms(int idx) const
 {
   if (idx<0 || idx>3) return 0x0000;
+  QMutexLocker locker(&mutex_);
   return Alarms_[idx];
 }
 
-const QStringList& MartaModel::getCurrentAlarms() const
+QStringList MartaModel::getCurrentAlarms() const
 {
+  QMutexLocker locker(&mutex_);
   return CurrentAlarmTexts_;
 }
 
 bool MartaModel::getChillerOn() const
 {
+  QMutexLocker locker(&mutex_);
   return Status_&0x0001;
 }
 
 bool MartaModel::getCO2On() const
 {
+  QMutexLocker locker(&mutex_);
   return Status_&0x0002;
 }
 
 bool MartaModel::getPumpFixedFlow() const
 {
+  QMutexLocker locker(&mutex_);
   return Status_&0x0004;
 }
 
@@ -124,8 +129,14 @@ void MartaModel::updateInformation()
     bool changed = false;
     bool alarmChanged = false;
     uint16_t tab_reg[74];
+    uint16_t alarm_reg[5];
+    uint16_t status_reg[7];
     
     controller_->ReadRegisters(0, 72, tab_reg);
+    controller_->ReadRegisters(80, 5, alarm_reg);
+    controller_->ReadRegisters(100, 7, status_reg);
+
+    QMutexLocker locker(&mutex_);
     
     changed |= valueChanged(PT03_, controller_->ToFloatBADC(&tab_reg[0]), 3);
     changed |= valueChanged(PT05_, controller_->ToFloatBADC(&tab_reg[2]), 3);
@@ -203,13 +214,11 @@ void MartaModel::updateInformation()
     printf("TempSetpoint:    %f\n", TemperatureSetpoint_);
     */
     
-    controller_->ReadRegisters(80, 5, tab_reg);
-    
-    alarmChanged |= valueChanged(Alarms_[0], tab_reg[0]);
-    alarmChanged |= valueChanged(Alarms_[1], tab_reg[1]);
-    alarmChanged |= valueChanged(Alarms_[2], tab_reg[2]);
-    alarmChanged |= valueChanged(Alarms_[3], tab_reg[3]);
-    alarmChanged |= valueChanged(AlarmStatus_, tab_reg[4]);
+    alarmChanged |= valueChanged(Alarms_[0], alarm_reg[0]);
+    alarmChanged |= valueChanged(Alarms_[1], alarm_reg[1]);
+    alarmChanged |= valueChanged(Alarms_[2], alarm_reg[2]);
+    alarmChanged |= valueChanged(Alarms_[3], alarm_reg[3]);
+    alarmChanged |= valueChanged(AlarmStatus_, alarm_reg[4]);
 
     /*
     printf("Alarm 1:     0x%04x\n", Alarms_[0]);
@@ -219,12 +228,10 @@ void MartaModel::updateInformation()
     printf("AlarmStatus:   %d\n", AlarmStatus_);
     */
     
-    controller_->ReadRegisters(100, 7, tab_reg);
-    
-    changed |= valueChanged(Status_, tab_reg[0]);
-    changed |= valueChanged(TemperatureSetpoint2_, controller_->ToFloatBADC(&tab_reg[1]), 3);
-    changed |= valueChanged(SpeedSetpoint2_, controller_->ToFloatBADC(&tab_reg[3]), 3);
-    changed |= valueChanged(FlowSetpoint2_, controller_->ToFloatBADC(&tab_reg[5]), 3);
+    changed |= valueChanged(Status_, status_reg[0]);
+    changed |= valueChanged(TemperatureSetpoint2_, controller_->ToFloatBADC(&status_reg[1]), 3);
+    changed |= valueChanged(SpeedSetpoint2_, controller_->ToFloatBADC(&status_reg[3]), 3);
+    changed |= valueChanged(FlowSetpoint2_, controller_->ToFloatBADC(&status_reg[5]), 3);
 
     /*
     printf("Status:        0x%04x\n", Status_);
@@ -251,10 +258,12 @@ void MartaModel::updateInformation()
           bit <<= 1;
         }
       }
-
-      emit alarmsChanged();
     }
 
+    locker.unlock();
+
+    if (alarmChanged) emit alarmsChanged();
+
     if (changed || alarmChanged) {
       NQLog("MartaModel", NQLog::Spam) << "information changed";
       emit informationChanged();
@@ -264,6 +273,8 @@ void MartaModel::updateInformation()
 
 void MartaModel::setDeviceEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setDeviceEnabled", Q_ARG(bool, enabled))) return;
+
   AbstractDeviceModel<Marta_t>::setDeviceEnabled(enabled);
 }
 
@@ -279,6 +290,8 @@ void MartaModel::statusMessage(const QString & text)
 
 void MartaModel::setStartChiller(bool value)
 {
+  if (queueInModelThread(this, "setStartChiller", Q_ARG(bool, value))) return;
+
   if (state_!=READY) return;
 
   bool stateChiller = getChillerOn();
@@ -299,6 +312,8 @@ void MartaModel::setStartChiller(bool value)
 
 void MartaModel::setStartCO2(bool value)
 {
+  if (queueInModelThread(this, "setStartCO2", Q_ARG(bool, value))) return;
+
   if (state_!=READY) return;
 
   bool stateChiller = getChillerOn();
@@ -322,6 +337,8 @@ void MartaModel::setStartCO2(bool value)
 
 void MartaModel::setPumpFixedFlow(bool value)
 {
+  if (queueInModelThread(this, "setPumpFixedFlow", Q_ARG(bool, value))) return;
+
   if (state_!=READY) return;
 
   bool state = getPumpFixedFlow();
@@ -341,6 +358,8 @@ void MartaModel::setPumpFixedFlow(bool value)
 
 void MartaModel::setTemperatureSetpoint(double value)
 {
+  if (queueInModelThread(this, "setTemperatureSetpoint", Q_ARG(double, value))) return;
+
   if (state_!=READY) return;
 
   if (value<-35.0 || value>25.0) return;
@@ -354,6 +373,8 @@ void MartaModel::setTemperatureSetpoint(double value)
 
 void MartaModel::setSpeedSetpoint(double value)
 {
+  if (queueInModelThread(this, "setSpeedSetpoint", Q_ARG(double, value))) return;
+
   if (state_!=READY) return;
 
   if (value<500.0 || value>6000.0) return;
@@ -367,6 +388,8 @@ void MartaModel::setSpeedSetpoint(double value)
 
 void MartaModel::setFlowSetpoint(double value)
 {
+  if (queueInModelThread(this, "setFlowSetpoint", Q_ARG(double, value))) return;
+
   if (state_!=READY) return;
 
   if (value<0.1 || value>6.0) return;
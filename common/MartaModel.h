@@ -18,6 +18,7 @@
 #include <tuple>
 
 #include <QString>
+#include <QMutex>
 #include <QStringList>
 #include <QTimer>
 
@@ -52,58 +53,60 @@ public:
 		      float updateInterval = 10, QObject* parent=nullptr);
   virtual ~MartaModel();
   
-  double getPT03() const { return PT03_; }
-  double getPT05() const { return PT05_; }
-  double getPT01CO2() const { return PT01CO2_; }
-  double getPT02CO2() const { return PT02CO2_; }
-  double getPT03CO2() const { return PT03CO2_; }
-  double getPT04CO2() const { return PT04CO2_; }
-  double getPT05CO2() const { return PT05CO2_; }
-  double getPT06CO2() const { return PT06CO2_; }
-  double getTT02() const { return TT02_; }
-  double getTT01CO2() const { return TT01CO2_; }
-  double getTT02CO2() const { return TT02CO2_; }
-  double getTT03CO2() const { return TT03CO2_; }
-  double getTT04CO2() const { return TT04CO2_; }
-  double getTT05CO2() const { return TT05CO2_; }
-  double getTT06CO2() const { return TT06CO2_; }
-  double getTT07CO2() const { return TT07CO2_; }
-  double getSH05() const { return SH05_; }
-  double getSC01CO2() const { return SC01CO2_; }
-  double getSC02CO2() const { return SC02CO2_; }
-  double getSC03CO2() const { return SC03CO2_; }
-  double getSC05CO2() const { return SC05CO2_; }
-  double getSC06CO2() const { return SC06CO2_; }
-  double getdP01CO2() const { return dP01CO2_; }
-  double getdP02CO2() const { return dP02CO2_; }
-  double getdP03CO2() const { return dP03CO2_; }
-  double getdP04CO2() const { return dP04CO2_; }
-  double getdT02CO2() const { return dT02CO2_; }
-  double getdT03CO2() const { return dT03CO2_; }
-  double getST01CO2() const { return ST01CO2_; }
-  double getST02CO2() const { return ST02CO2_; }
-  double getST03CO2() const { return ST03CO2_; }
-  double getST04CO2() const { return ST04CO2_; }
-  double getFT01CO2() const { return FT01CO2_; }
+  double getPT03() const { QMutexLocker locker(&mutex_); return PT03_; }
+  double getPT05() const { QMutexLocker locker(&mutex_); return PT05_; }
+  double getPT01CO2() const { QMutexLocker locker(&mutex_); return PT01CO2_; }
+  double getPT02CO2() const { QMutexLocker locker(&mutex_); return PT02CO2_; }
+  double getPT03CO2() const { QMutexLocker locker(&mutex_); return PT03CO2_; }
+  double getPT04CO2() const { QMutexLocker locker(&mutex_); return PT04CO2_; }
+  double getPT05CO2() const { QMutexLocker locker(&mutex_); return PT05CO2_; }
+  double getPT06CO2() const { QMutexLocker locker(&mutex_); return PT06CO2_; }
+  double getTT02() const { QMutexLocker locker(&mutex_); return TT02_; }
+  double getTT01CO2() const { QMutexLocker locker(&mutex_); return TT01CO2_; }
+  double getTT02CO2() const { QMutexLocker locker(&mutex_); return TT02CO2_; }
+  double getTT03CO2() const { QMutexLocker locker(&mutex_); return TT03CO2_; }
+  double getTT04CO2() const { QMutexLocker locker(&mutex_); return TT04CO2_; }
+  double getTT05CO2() const { QMutexLocker locker(&mutex_); return TT05CO2_; }
+  double getTT06CO2() const { QMutexLocker locker(&mutex_); return TT06CO2_; }
+  double getTT07CO2() const { QMutexLocker locker(&mutex_); return TT07CO2_; }
+  double getSH05() const { QMutexLocker locker(&mutex_); return SH05_; }
+  double getSC01CO2() const { QMutexLocker locker(&mutex_); return SC01CO2_; }
+  double getSC02CO2() const { QMutexLocker locker(&mutex_); return SC02CO2_; }
+  double getSC03CO2() const { QMutexLocker locker(&mutex_); return SC03CO2_; }
+  double getSC05CO2() const { QMutexLocker locker(&mutex_); return SC05CO2_; }
+  double getSC06CO2() const { QMutexLocker locker(&mutex_); return SC06CO2_; }
+  double getdP01CO2() const { QMutexLocker locker(&mutex_); return dP01CO2_; }
+  double getdP02CO2() const { QMutexLocker locker(&mutex_); return dP02CO2_; }
+  double getdP03CO2() const { QMutexLocker locker(&mutex_); return dP03CO2_; }
+  double getdP04CO2() const { QMutexLocker locker(&mutex_); return dP04CO2_; }
+  double getdT02CO2() const { QMutexLocker locker(&mutex_); return dT02CO2_; }
+  double getdT03CO2() const { QMutexLocker locker(&mutex_); return dT03CO2_; }
+  double getST01CO2() const { QMutexLocker locker(&mutex_); return ST01CO2_; }
+  double getST02CO2() const { QMutexLocker locker(&mutex_); return ST02CO2_; }
+  double getST03CO2() const { QMutexLocker locker(&mutex_); return ST03CO2_; }
+  double getST04CO2() const { QMutexLocker locker(&mutex_); return ST04CO2_; }
+  double getFT01CO2() const { QMutexLocker locker(&mutex_); return FT01CO2_; }
   
-  double getSpeedSetpoint() const { return SpeedSetpoint_; }
-  double getFlowSetpoint() const { return FlowSetpoint_; }
-  double getTemperatureSetpoint() const { return TemperatureSetpoint_; }
+  double getSpeedSetpoint() const { QMutexLocker locker(&mutex_); return SpeedSetpoint_; }
+  double getFlowSetpoint() const { QMutexLocker locker(&mutex_); return FlowSetpoint_; }
+  double getTemperatureSetpoint() const { QMutexLocker locker(&mutex_); return TemperatureSetpoint_; }
 
   uint16_t getAlarms(int idx) const;
-  const QStringList& getCurrentAlarms() const;
-  uint16_t getAlarmStatus() const { return AlarmStatus_; }
+  QStringList getCurrentAlarms() const;
+  uint16_t getAlarmStatus() const { QMutexLocker locker(&mutex_); return AlarmStatus_; }
   
-  uint16_t getStatus() const { return Status_; }
+  uint16_t getStatus() const { QMutexLocker locker(&mutex_); return Status_; }
   bool getChillerOn() const;
   bool getCO2On() const;
   bool getPumpFixedFlow() const;
-  double getTemperatureSetpoint2() const { return TemperatureSetpoint2_; }
-  double getSpeedSetpoint2() const { return SpeedSetpoint2_; }
-  double getFlowSetpoint2() const { return FlowSetpoint2_; }
+  double getTemperatureSetpoint2() const { QMutexLocker locker(&mutex_); return TemperatureSetpoint2_; }
+  double getSpeedSetpoint2() const { QMutexLocker locker(&mutex_); return SpeedSetpoint2_; }
+  double getFlowSetpoint2() const { QMutexLocker locker(&mutex_); return FlowSetpoint2_; }
 
   void statusMessage(const QString & text);
 
+  // Setters called from another thread return before the value is applied,
+  // see queueInModelThread().
 public slots:
 
   // Methods for control and status querying of the device itself, as specified
@@ -135,6 +138,9 @@ protected:
   bool valueChanged(double &storage, double value, unsigned int precision = 3);
   bool valueChanged(uint16_t &storage, uint16_t value);
 
+  /// Guards the cached values, which are read from other threads.
+  mutable QMutex mutex_;
+
   double PT03_;
   double PT05_;
   double PT01CO2_;
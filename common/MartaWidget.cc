@@ -88,7 +88,7 @@ MartaAlarmDialog::MartaAlarmDialog(MartaModel* model,
 void MartaAlarmDialog::updateInfo()
 {
   QString alarmText;
-  const QStringList &alarms = model_->getCurrentAlarms();
+  QStringList alarms = model_->getCurrentAlarms();
   QStringList::const_iterator constIterator;
   for (constIterator = alarms.constBegin();
        constIterator != alarms.constEnd();
@@ -50,12 +50,15 @@ RohdeSchwarzNGE103BModel::RohdeSchwarzNGE103BModel(const char* port,
 
 bool RohdeSchwarzNGE103BModel::getOutputState(int channel) const
 {
-  if (channel>=1 && channel<=3) return outputState_[channel-1];
-  return false;
+  if (channel<1 || channel>3) return false;
+  QMutexLocker locker(&mutex_);
+  return outputState_[channel-1];
 }
 
 void RohdeSchwarzNGE103BModel::setOutputState(int channel, bool state)
 {
+  if (queueInModelThread(this, "setOutputState", Q_ARG(int, channel), Q_ARG(bool, state))) return;
+
   NQLogDebug("RohdeSchwarzNGE103BModel") << "setOutputState(int channel, bool state) "
       << channel << " " << state;
 
@@ -68,7 +71,9 @@ void RohdeSchwarzNGE103BModel::setOutputState(int channel, bool state)
   controller_->SelectChannel(channel);
   controller_->SetOutputState(state);
 
+  QMutexLocker locker(&mutex_);
   outputState_[channel-1] = state;
+  locker.unlock();
   
   if (easyRampState_[channel-1]) {
     QTimer::singleShot(1000*easyRampDuration_[channel-1], this,
@@ -81,18 +86,22 @@ void RohdeSchwarzNGE103BModel::setOutputState(int channel, bool state)
 
 unsigned int RohdeSchwarzNGE103BModel::getOutputMode(int channel) const
 {
-  if (channel>=1 && channel<=3) return outputMode_[channel-1];
-  return 0;
+  if (channel<1 || channel>3) return 0;
+  QMutexLocker locker(&mutex_);
+  return outputMode_[channel-1];
 }
 
 float RohdeSchwarzNGE103BModel::getVoltage(int channel) const
 {
-  if (channel>=1 && channel<=3) return voltage_[channel-1];
-  return 0;
+  if (channel<1 || channel>3) return 0;
+  QMutexLocker locker(&mutex_);
+  return voltage_[channel-1];
 }
 
 void RohdeSchwarzNGE103BModel::setVoltage(int channel, float voltage)
 {
+  if (queueInModelThread(this, "setVoltage", Q_ARG(int, channel), Q_ARG(float, voltage))) return;
+
   NQLogDebug("RohdeSchwarzNGE103BModel") << "setVoltage(int channel, float voltage) "
       << channel << " " << voltage;
 
@@ -108,25 +117,31 @@ void RohdeSchwarzNGE103BModel::setVoltage(int channel, float voltage)
   controller_->SelectChannel(channel);
   controller_->SetVoltage(voltage);
 
+  QMutexLocker locker(&mutex_);
   voltage_[channel-1] = voltage;
+  locker.unlock();
 
   emit informationChanged();
 }
 
 float RohdeSchwarzNGE103BModel::getMeasuredVoltage(int channel) const
 {
-  if (channel>=1 && channel<=3) return measuredVoltage_[channel-1];
-  return 0;
+  if (channel<1 || channel>3) return 0;
+  QMutexLocker locker(&mutex_);
+  return measuredVoltage_[channel-1];
 }
 
 float RohdeSchwarzNGE103BModel::getCurrent(int channel) const
 {
-  if (channel>=1 && channel<=3) return current_[channel-1];
-  return 0;
+  if (channel<1 || channel>3) return 0;
+  QMutexLocker locker(&mutex_);
+  return current_[channel-1];
 }
 
 void RohdeSchwarzNGE103BModel::setCurrent(int channel, float current)
 {
+  if (queueInModelThread(this, "setCurrent", Q_ARG(int, channel), Q_ARG(float, current))) return;
+
   NQLogDebug("RohdeSchwarzNGE103BModel") << "setCurrent(int channel, float current) "
       << channel << " " << current;
 
@@ -142,25 +157,31 @@ void RohdeSchwarzNGE103BModel::setCurrent(int channel, float current)
   controller_->SelectChannel(channel);
   controller_->SetCurrent(current);
 
+  QMutexLocker locker(&mutex_);
   current_[channel-1] = current;
+  locker.unlock();
 
   emit informationChanged();
 }
 
 float RohdeSchwarzNGE103BModel::getMeasuredCurrent(int channel) const
 {
-  if (channel>=1 && channel<=3) return measuredCurrent_[channel-1];
-  return 0;
+  if (channel<1 || channel>3) return 0;
+  QMutexLocker locker(&mutex_);
+  return measuredCurrent_[channel-1];
 }
 
 float RohdeSchwarzNGE103BModel::getEasyRampDuration(int channel) const
 {
-  if (channel>=1 && channel<=3) return easyRampDuration_[channel-1];
-  return 0;
+  if (channel<1 || channel>3) return 0;
+  QMutexLocker locker(&mutex_);
+  return easyRampDuration_[channel-1];
 }
 
 void RohdeSchwarzNGE103BModel::setEasyRampDuration(int channel, float duration)
 {
+  if (queueInModelThread(this, "setEasyRampDuration", Q_ARG(int, channel), Q_ARG(float, duration))) return;
+
   NQLogDebug("RohdeSchwarzNGE103BModel") << "setEasyRampDuration(int channel, float duration) "
       << channel << " " << duration;
 
@@ -176,19 +197,24 @@ void RohdeSchwarzNGE103BModel::setEasyRampDuration(int channel, float duration)
   controller_->SelectChannel(channel);
   controller_->SetEasyRampDuration(duration);
 
+  QMutexLocker locker(&mutex_);
   easyRampDuration_[channel-1] = duration;
+  locker.unlock();
 
   emit informationChanged();
 }
 
 bool RohdeSchwarzNGE103BModel::getEasyRampState(int channel) const
 {
-  if (channel>=1 && channel<=3) return easyRampState_[channel-1];
-  return false;
+  if (channel<1 || channel>3) return false;
+  QMutexLocker locker(&mutex_);
+  return easyRampState_[channel-1];
 }
 
 void RohdeSchwarzNGE103BModel::setEasyRampState(int channel, bool state)
 {
+  if (queueInModelThread(this, "setEasyRampState", Q_ARG(int, channel), Q_ARG(bool, state))) return;
+
   NQLogDebug("RohdeSchwarzNGE103BModel") << "setEasyRampState(int channel, bool state) "
       << channel << " " << state;
 
@@ -201,7 +227,9 @@ void RohdeSchwarzNGE103BModel::setEasyRampState(int channel, bool state)
   controller_->SelectChannel(channel);
   controller_->SetEasyRampState(state);
 
+  QMutexLocker locker(&mutex_);
   easyRampState_[channel-1] = state;
+  locker.unlock();
 
   emit informationChanged();
 }
@@ -292,6 +320,7 @@ void RohdeSchwarzNGE103BModel::updateInformation()
         newEasyRampDuration!=easyRampDuration_ ||
         newEasyRampState!=easyRampState_) {
 
+      QMutexLocker locker(&mutex_);
       outputState_ = newOutputState;
       outputMode_ = newOutputMode;
       voltage_ = newVoltage;
@@ -300,6 +329,7 @@ void RohdeSchwarzNGE103BModel::updateInformation()
       measuredCurrent_ = newMeasuredCurrent;
       easyRampDuration_ = newEasyRampDuration;
       easyRampState_ = newEasyRampState;
+      locker.unlock();
 
       NQLogDebug("RohdeSchwarzNGE103BModel") << "information changed";
 
@@ -311,6 +341,8 @@ void RohdeSchwarzNGE103BModel::updateInformation()
 /// Attempts to enable/disable the (communication with) the RohdeSchwarzNGE103B power supply.
 void RohdeSchwarzNGE103BModel::setDeviceEnabled(bool enabled)
 {
+  if (queueInModelThread(this, "setDeviceEnabled", Q_ARG(bool, enabled))) return;
+
   AbstractDeviceModel<RohdeSchwarzNGE103B_t>::setDeviceEnabled(enabled);
 }
 
@@ -17,6 +17,7 @@
 #include <array>
 
 #include <QString>
+#include <QMutex>
 #include <QTimer>
 
 #include "DeviceState.h"
@@ -52,6 +53,8 @@ public:
   float getEasyRampDuration(int channel) const;
   bool getEasyRampState(int channel) const;
 
+  // Setters called from another thread return before the value is applied,
+  // see queueInModelThread().
 public slots:
   void setDeviceEnabled(bool enabled);
   void setControlsEnabled(bool enabled);
@@ -78,6 +81,9 @@ protected:
   DeviceParameterFloat currentParameter_;
   DeviceParameterFloat easyRampDurationParameter_;
 
+  /// Guards the cached values, which are read from other threads.
+  mutable QMutex mutex_;
+
   std::array<bool,3> outputState_;
   std::array<unsigned int,3> outputMode_;
   std::array<float,3> voltage_;
@@ -21,6 +21,11 @@
 
 #include <HuberUnistat525wModel.h>
 
+/**
+  Script interface of the Huber chiller. The setters hand the value to the
+  model thread and return; a getter called right after may still see the
+  previous value.
+  */
 class ScriptableHuberUnistat525w : public VScriptableDevice
 {
   Q_OBJECT
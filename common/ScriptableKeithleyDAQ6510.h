@@ -21,6 +21,11 @@
 
 #include <KeithleyDAQ6510Model.h>
 
+/**
+  Script interface of the Keithley DAQ6510. The setters hand the value to
+  the model thread and return; a getter called right after may still see
+  the previous value.
+  */
 class ScriptableKeithleyDAQ6510 : public VScriptableDevice
 {
   Q_OBJECT
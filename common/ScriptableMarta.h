@@ -21,6 +21,11 @@
 
 #include <MartaModel.h>
 
+/**
+  Script interface of the Marta CO2 chiller. The setters hand the value to
+  the model thread and return; a getter called right after may still see
+  the previous value.
+  */
 class ScriptableMarta : public VScriptableDevice
 {
   Q_OBJECT
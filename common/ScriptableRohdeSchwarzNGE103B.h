@@ -19,6 +19,11 @@
 
 #include <RohdeSchwarzNGE103BModel.h>
 
+/**
+  Script interface of the NGE103B power supply. The setters hand the value
+  to the model thread and return; a getter called right after may still
+  see the previous value.
+  */
 class ScriptableRohdeSchwarzNGE103B : public QObject
 {
   Q_OBJECT
@@ -0,0 +1,527 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#include <unistd.h>
+
+#include <QtEndian>
+
+#include <nqlogger.h>
+
+#include "ThermoDAQ2BinaryStream.h"
+
+const char ThermoDAQ2BinaryStream::magic[8] = { 'T', 'D', 'A', 'Q', '2', 'B', 'I', 'N' };
+const quint8 ThermoDAQ2BinaryStream::version = 1;
+
+bool ThermoDAQ2BinaryStream::isBinaryStream(QIODevice* device)
+{
+  QByteArray header = device->peek(sizeof(magic));
+  return header.size()==sizeof(magic) && std::memcmp(header.constData(), magic, sizeof(magic))==0;
+}
+
+namespace {
+
+quint64 zigzag(qint64 value)
+{
+  return ((quint64)value << 1) ^ (quint64)(value >> 63);
+}
+
+qint64 unzigzag(quint64 value)
+{
+  return (qint64)(value >> 1) ^ -(qint64)(value & 1);
+}
+
+/*
+  Values are only stored as numbers if the number gives back exactly the
+  text that was written, everything else (hex values, other date formats)
+  is kept as string.
+  */
+ThermoDAQ2BinaryStream::FieldType classify(const QString& value, qint64& i, double& d)
+{
+  bool ok;
+
+  i = value.toInt(&ok);
+  if (ok && QString::number(i)==value) return ThermoDAQ2BinaryStream::Int;
+
+  const int dot = value.indexOf('.');
+  if (dot>0) {
+    const int exponent = value.indexOf('e', dot);
+    const char format = exponent>0 ? 'e' : 'f';
+    const int precision = (exponent>0 ? exponent : value.length()) - dot - 1;
+
+    const float f = value.toFloat(&ok);
+    if (ok && QString::number(f, format, precision)==value) {
+      d = f;
+      return ThermoDAQ2BinaryStream::Float;
+    }
+
+    d = value.toDouble(&ok);
+    if (ok && QString::number(d, format, precision)==value) return ThermoDAQ2BinaryStream::Double;
+  }
+
+  if (value.length()>=19 && value[4]=='-' && value[10]=='T') {
+    QDateTime dt = QDateTime::fromString(value, Qt::ISODate);
+    if (dt.isValid()) {
+      i = dt.toMSecsSinceEpoch() / 1000;
+      if (QDateTime::fromMSecsSinceEpoch(i * 1000).toString(Qt::ISODate)==value) {
+        return ThermoDAQ2BinaryStream::Timestamp;
+      }
+    }
+  }
+
+  return ThermoDAQ2BinaryStream::String;
+}
+
+}
+
+ThermoDAQ2BinaryWriter::ThermoDAQ2BinaryWriter(QFile* file,
+                                               int flushInterval,
+                                               SyncPolicy policy,
+                                               int bufferSize)
+  : file_(file),
+    flushInterval_(flushInterval),
+    policy_(policy),
+    bufferSize_(bufferSize)
+{
+  buffer_.reserve(bufferSize_ + 4096);
+  buffer_.append(ThermoDAQ2BinaryStream::magic, sizeof(ThermoDAQ2BinaryStream::magic));
+  buffer_.append((char)ThermoDAQ2BinaryStream::version);
+
+  lastFlush_.start();
+}
+
+ThermoDAQ2BinaryWriter::~ThermoDAQ2BinaryWriter()
+{
+  close();
+}
+
+ThermoDAQ2BinaryWriter::SyncPolicy ThermoDAQ2BinaryWriter::syncPolicyFromString(const QString& policy)
+{
+  if (policy=="none") return SyncNone;
+  if (policy=="always") return SyncAlways;
+  return SyncOnFlush;
+}
+
+bool ThermoDAQ2BinaryWriter::writeFragment(const QString& fragment)
+{
+  if (!file_) return false;
+
+  xml_.addData(fragment);
+
+  bool valid = true;
+  while (valid) {
+    switch (xml_.readNext()) {
+    case QXmlStreamReader::StartElement:
+      whitespace_.clear();
+      writeStartElement();
+      break;
+    case QXmlStreamReader::EndElement:
+      whitespace_.clear();
+      writeVarint(ThermoDAQ2BinaryStream::EndElementTag);
+      break;
+    case QXmlStreamReader::Characters:
+      // indentation between elements is dropped, whitespace within text kept
+      if (xml_.isWhitespace()) {
+        whitespace_ += xml_.text();
+      } else {
+        writeVarint(ThermoDAQ2BinaryStream::CharactersTag);
+        writeString(whitespace_ + xml_.text().toString());
+        whitespace_.clear();
+      }
+      break;
+    case QXmlStreamReader::Invalid:
+      // the fragment is consumed, wait for the next one
+      if (xml_.error()!=QXmlStreamReader::PrematureEndOfDocumentError) {
+        NQLogWarning("ThermoDAQ2BinaryWriter") << "could not parse fragment: " << xml_.errorString();
+      }
+      valid = false;
+      break;
+    case QXmlStreamReader::EndDocument:
+      valid = false;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (policy_==SyncAlways ||
+      buffer_.size()>=bufferSize_ ||
+      lastFlush_.elapsed()>=1000*flushInterval_) {
+    flush();
+  }
+
+  return !xml_.hasError() || xml_.error()==QXmlStreamReader::PrematureEndOfDocumentError;
+}
+
+void ThermoDAQ2BinaryWriter::writeStartElement()
+{
+  const QXmlStreamAttributes attributes = xml_.attributes();
+
+  std::vector<ThermoDAQ2BinaryStream::FieldType> types(attributes.size());
+  std::vector<qint64> ints(attributes.size());
+  std::vector<double> doubles(attributes.size());
+
+  QByteArray signature = xml_.name().toUtf8();
+  for (int a=0;a<attributes.size();++a) {
+    types[a] = classify(attributes[a].value().toString(), ints[a], doubles[a]);
+    signature += '\0';
+    signature += attributes[a].name().toUtf8();
+    signature += (char)types[a];
+  }
+
+  QHash<QByteArray,int>::const_iterator it = schemaIds_.constFind(signature);
+  int id;
+  if (it==schemaIds_.constEnd()) {
+    id = schemaIds_.size();
+    schemaIds_.insert(signature, id);
+
+    writeVarint(ThermoDAQ2BinaryStream::SchemaTag);
+    writeVarint(id);
+    writeString(xml_.name().toString());
+    writeVarint(attributes.size());
+    for (int a=0;a<attributes.size();++a) {
+      writeString(attributes[a].name().toString());
+      buffer_.append((char)types[a]);
+    }
+  } else {
+    id = it.value();
+  }
+
+  writeVarint(ThermoDAQ2BinaryStream::FirstElementTag + id);
+
+  for (int a=0;a<attributes.size();++a) {
+    switch (types[a]) {
+    case ThermoDAQ2BinaryStream::Int:
+    case ThermoDAQ2BinaryStream::Timestamp:
+      writeVarint(zigzag(ints[a]));
+      break;
+    case ThermoDAQ2BinaryStream::Float: {
+      float f = doubles[a];
+      quint32 v;
+      std::memcpy(&v, &f, sizeof(v));
+      v = qToLittleEndian(v);
+      buffer_.append(reinterpret_cast<const char*>(&v), sizeof(v));
+      break;
+    }
+    case ThermoDAQ2BinaryStream::Double: {
+      quint64 v;
+      std::memcpy(&v, &doubles[a], sizeof(v));
+      v = qToLittleEndian(v);
+      buffer_.append(reinterpret_cast<const char*>(&v), sizeof(v));
+      break;
+    }
+    case ThermoDAQ2BinaryStream::String:
+      writeString(attributes[a].value().toString());
+      break;
+    }
+  }
+}
+
+void ThermoDAQ2BinaryWriter::writeVarint(quint64 value)
+{
+  while (value>=0x80) {
+    buffer_.append((char)(value | 0x80));
+    value >>= 7;
+  }
+  buffer_.append((char)value);
+}
+
+void ThermoDAQ2BinaryWriter::writeString(const QString& value)
+{
+  const QByteArray utf8 = value.toUtf8();
+  writeVarint(utf8.size());
+  buffer_.append(utf8);
+}
+
+void ThermoDAQ2BinaryWriter::flush()
+{
+  if (!file_) return;
+
+  if (buffer_.size()>0) {
+    if (file_->write(buffer_)!=buffer_.size()) {
+      NQLogWarning("ThermoDAQ2BinaryWriter") << "could not write to " << file_->fileName();
+    }
+    buffer_.clear();
+  }
+
+  file_->flush();
+  if (policy_!=SyncNone) ::fsync(file_->handle());
+
+  lastFlush_.restart();
+}
+
+void ThermoDAQ2BinaryWriter::close()
+{
+  if (!file_) return;
+
+  flush();
+  file_ = 0;
+}
+
+ThermoDAQ2BinaryReader::ThermoDAQ2BinaryReader(QIODevice* device)
+  : device_(device),
+    pos_(0),
+    tokenType_(NoToken),
+    schemaId_(-1)
+{
+
+}
+
+/*
+  Makes sure that n bytes are available in the buffer, the device is
+  read in blocks of at least 1 MB.
+  */
+bool ThermoDAQ2BinaryReader::ensure(int n)
+{
+  if (buffer_.size()-pos_>=n) return true;
+
+  buffer_.remove(0, pos_);
+  pos_ = 0;
+  buffer_.append(device_->read(std::max(n, 1024*1024)));
+
+  return buffer_.size()>=n;
+}
+
+/// bytes left in the buffer and the device
+qint64 ThermoDAQ2BinaryReader::remaining() const
+{
+  const qint64 available = device_->isSequential() ?
+    device_->bytesAvailable() : device_->size() - device_->pos();
+
+  return buffer_.size() - pos_ + std::max(available, (qint64)0);
+}
+
+bool ThermoDAQ2BinaryReader::readVarint(quint64& value)
+{
+  value = 0;
+  for (int shift=0;shift<64;shift+=7) {
+    if (!ensure(1)) return false;
+    const quint8 byte = buffer_[pos_++];
+    value |= (quint64)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+bool ThermoDAQ2BinaryReader::readString(QString& value)
+{
+  quint64 length;
+  if (!readVarint(length) || length>(quint64)std::numeric_limits<int>::max() ||
+      length>(quint64)remaining() || !ensure(length)) return false;
+  value = QString::fromUtf8(buffer_.constData() + pos_, length);
+  pos_ += length;
+  return true;
+}
+
+bool ThermoDAQ2BinaryReader::readSchema()
+{
+  quint64 id, n;
+  ThermoDAQ2BinaryStream::Schema schema;
+
+  if (!readVarint(id) || !readString(schema.name) || !readVarint(n)) return false;
+
+  // every field takes at least a length and a type byte
+  if (n>(quint64)ThermoDAQ2BinaryStream::maxFields || 2*n>(quint64)remaining()) return false;
+
+  schema.fields.resize(n);
+  for (quint64 f=0;f<n;++f) {
+    if (!readString(schema.fields[f].name) || !ensure(1)) return false;
+    schema.fields[f].type = (ThermoDAQ2BinaryStream::FieldType)buffer_[pos_++];
+  }
+
+  if (id!=schemas_.size()) return false;
+  schemas_.push_back(schema);
+
+  return true;
+}
+
+bool ThermoDAQ2BinaryReader::readValues()
+{
+  const ThermoDAQ2BinaryStream::Schema& s = schemas_[schemaId_];
+
+  values_.resize(s.fields.size());
+  for (size_t f=0;f<s.fields.size();++f) {
+    Value& v = values_[f];
+    switch (s.fields[f].type) {
+    case ThermoDAQ2BinaryStream::Int:
+    case ThermoDAQ2BinaryStream::Timestamp: {
+      quint64 u;
+      if (!readVarint(u)) return false;
+      v.i = unzigzag(u);
+      v.d = v.i;
+      break;
+    }
+    case ThermoDAQ2BinaryStream::Float: {
+      if (!ensure(4)) return false;
+      quint32 u = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(buffer_.constData() + pos_));
+      float x;
+      std::memcpy(&x, &u, sizeof(x));
+      pos_ += 4;
+      v.d = x;
+      v.i = (qint64)x;
+      break;
+    }
+    case ThermoDAQ2BinaryStream::Double: {
+      if (!ensure(8)) return false;
+      quint64 u = qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(buffer_.constData() + pos_));
+      std::memcpy(&v.d, &u, sizeof(v.d));
+      pos_ += 8;
+      v.i = (qint64)v.d;
+      break;
+    }
+    case ThermoDAQ2BinaryStream::String:
+      if (!readString(v.s)) return false;
+      break;
+    default:
+      return false;
+    }
+  }
+
+  return true;
+}
+
+ThermoDAQ2BinaryReader::TokenType ThermoDAQ2BinaryReader::setError(const QString& error)
+{
+  errorString_ = error;
+  tokenType_ = Invalid;
+  return tokenType_;
+}
+
+ThermoDAQ2BinaryReader::TokenType ThermoDAQ2BinaryReader::readNext()
+{
+  if (atEnd()) return tokenType_;
+
+  if (tokenType_==NoToken) {
+    if (!ensure(sizeof(ThermoDAQ2BinaryStream::magic)+1) ||
+        std::memcmp(buffer_.constData(), ThermoDAQ2BinaryStream::magic, sizeof(ThermoDAQ2BinaryStream::magic))!=0) {
+      return setError("not a thermoDAQ2 binary stream");
+    }
+    pos_ = sizeof(ThermoDAQ2BinaryStream::magic);
+    if ((quint8)buffer_[pos_++]!=ThermoDAQ2BinaryStream::version) {
+      return setError("unsupported binary stream version");
+    }
+  }
+
+  // a previous end element leaves its element
+  if (tokenType_==EndElement) elementStack_.pop_back();
+
+  quint64 tag;
+  while (true) {
+
+    if (!ensure(1)) {
+      tokenType_ = EndDocument;
+      return tokenType_;
+    }
+
+    if (!readVarint(tag)) return setError("truncated record");
+
+    if (tag==ThermoDAQ2BinaryStream::SchemaTag) {
+      if (!readSchema()) return setError("invalid schema record");
+      continue;
+    }
+
+    break;
+  }
+
+  if (tag==ThermoDAQ2BinaryStream::EndElementTag) {
+    if (elementStack_.empty()) return setError("unbalanced end element");
+    schemaId_ = elementStack_.back();
+    tokenType_ = EndElement;
+  } else if (tag==ThermoDAQ2BinaryStream::CharactersTag) {
+    if (!readString(text_)) return setError("truncated record");
+    tokenType_ = Characters;
+  } else if (tag>=ThermoDAQ2BinaryStream::FirstElementTag &&
+             tag-ThermoDAQ2BinaryStream::FirstElementTag<schemas_.size()) {
+    schemaId_ = tag - ThermoDAQ2BinaryStream::FirstElementTag;
+    if (!readValues()) return setError("truncated record");
+    elementStack_.push_back(schemaId_);
+    tokenType_ = StartElement;
+  } else {
+    return setError("unknown record");
+  }
+
+  return tokenType_;
+}
+
+int ThermoDAQ2BinaryReader::fieldIndex(const char* name) const
+{
+  if (tokenType_!=StartElement) return -1;
+
+  const std::vector<ThermoDAQ2BinaryStream::Field>& fields = schemas_[schemaId_].fields;
+  for (size_t f=0;f<fields.size();++f) {
+    if (fields[f].name==QLatin1String(name)) return f;
+  }
+
+  return -1;
+}
+
+int ThermoDAQ2BinaryReader::toInt(const char* name) const
+{
+  const int f = fieldIndex(name);
+  if (f<0) return 0;
+  if (schemas_[schemaId_].fields[f].type==ThermoDAQ2BinaryStream::String) return values_[f].s.toInt();
+  return values_[f].i;
+}
+
+float ThermoDAQ2BinaryReader::toFloat(const char* name) const
+{
+  const int f = fieldIndex(name);
+  if (f<0) return 0;
+  if (schemas_[schemaId_].fields[f].type==ThermoDAQ2BinaryStream::String) return values_[f].s.toFloat();
+  return values_[f].d;
+}
+
+QString ThermoDAQ2BinaryReader::toString(const char* name) const
+{
+  const int f = fieldIndex(name);
+  if (f<0) return QString();
+
+  switch (schemas_[schemaId_].fields[f].type) {
+  case ThermoDAQ2BinaryStream::Int:
+    return QString::number(values_[f].i);
+  case ThermoDAQ2BinaryStream::Timestamp:
+    return QDateTime::fromMSecsSinceEpoch(values_[f].i * 1000).toString(Qt::ISODate);
+  case ThermoDAQ2BinaryStream::Float:
+  case ThermoDAQ2BinaryStream::Double:
+    return QString::number(values_[f].d);
+  default:
+    return values_[f].s;
+  }
+}
+
+QDateTime ThermoDAQ2BinaryReader::toDateTime(const char* name, Qt::DateFormat format) const
+{
+  const int f = fieldIndex(name);
+  if (f<0) return QDateTime();
+  if (schemas_[schemaId_].fields[f].type==ThermoDAQ2BinaryStream::Timestamp) {
+    return QDateTime::fromMSecsSinceEpoch(values_[f].i * 1000);
+  }
+  return QDateTime::fromString(toString(name), format);
+}
+
+QString ThermoDAQ2BinaryReader::readElementText()
+{
+  QString text;
+  if (tokenType_!=StartElement) return text;
+
+  int depth = 1;
+  while (depth>0 && readNext()!=Invalid && tokenType_!=EndDocument) {
+    if (tokenType_==StartElement) depth++;
+    else if (tokenType_==EndElement) depth--;
+    else if (tokenType_==Characters) text += text_;
+  }
+
+  return text;
+}
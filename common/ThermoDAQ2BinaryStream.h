@@ -0,0 +1,220 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef THERMODAQ2BINARYSTREAM_H
+#define THERMODAQ2BINARYSTREAM_H
+
+#include <vector>
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QFile>
+#include <QIODevice>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QXmlStreamReader>
+
+/** @addtogroup common
+ *  @{
+ */
+
+/**
+  Typed, append-only binary encoding of the XML fragments streamed by
+  thermoDAQ2.
+
+  file   := "TDAQ2BIN" version:uint8 record*
+  record := tag:varint payload
+
+  tag 0       end of the current element
+  tag 1       schema: id:varint, element name:string, nfields:varint,
+              nfields x (attribute name:string, type:uint8)
+  tag 2       character data:string
+  tag 16+id   start of an element of schema id, followed by the
+              attribute values in schema order
+
+  Int and Timestamp (seconds since epoch) values are zigzag varints,
+  Float and Double little endian IEEE and String a varint length followed
+  by UTF-8. The XML element structure is kept one to one. Every distinct
+  combination of element name, attribute names and attribute types gets
+  its own schema the first time it is written, so the files describe
+  themselves and a reader does not need to know the devices.
+  */
+class ThermoDAQ2BinaryStream
+{
+public:
+
+  enum FieldType {
+    Int       = 1,
+    Float     = 2,
+    Double    = 3,
+    Timestamp = 4,
+    String    = 5
+  };
+
+  enum Tag {
+    EndElementTag   = 0,
+    SchemaTag       = 1,
+    CharactersTag   = 2,
+    FirstElementTag = 16
+  };
+
+  struct Field {
+    QString name;
+    FieldType type;
+  };
+
+  struct Schema {
+    QString name;
+    std::vector<Field> fields;
+  };
+
+  static const char magic[8];
+  static const quint8 version;
+
+  /// upper limit of the number of fields of a schema accepted by the reader
+  static const int maxFields = 4096;
+
+  /// true if the device is positioned at the start of a binary stream
+  static bool isBinaryStream(QIODevice* device);
+};
+
+/**
+  Converts the XML fragments of the DAQ into binary records.
+
+  The fragments do not have to be complete documents, they are parsed
+  incrementally in the order they are written. Records are collected in
+  memory and written to the file once the buffer is full or the flush
+  interval has passed since the last write. Depending on the sync policy
+  the file is synced to disk after every write of the buffer, after every
+  fragment or left to the operating system.
+  */
+class ThermoDAQ2BinaryWriter
+{
+public:
+
+  enum SyncPolicy {
+    SyncNone,
+    SyncOnFlush,
+    SyncAlways
+  };
+
+  ThermoDAQ2BinaryWriter(QFile* file,
+                         int flushInterval = 10,
+                         SyncPolicy policy = SyncOnFlush,
+                         int bufferSize = 64*1024);
+  ~ThermoDAQ2BinaryWriter();
+
+  bool writeFragment(const QString& fragment);
+  void flush();
+  void close();
+
+  static SyncPolicy syncPolicyFromString(const QString& policy);
+
+protected:
+
+  QFile* file_;
+  int flushInterval_;
+  SyncPolicy policy_;
+  int bufferSize_;
+
+  QByteArray buffer_;
+  QElapsedTimer lastFlush_;
+  QXmlStreamReader xml_;
+  QString whitespace_;
+  QHash<QByteArray,int> schemaIds_;
+
+  void writeStartElement();
+  void writeVarint(quint64 value);
+  void writeString(const QString& value);
+};
+
+/**
+  Reads a binary stream record by record, similar to QXmlStreamReader.
+
+  The device is read in large blocks. Attribute values of the current
+  start element can be accessed by name; the conversions follow the ones
+  of QString, so that code written for the XML files gives the same
+  results on the binary files.
+  */
+class ThermoDAQ2BinaryReader
+{
+public:
+
+  enum TokenType {
+    NoToken,
+    Invalid,
+    StartElement,
+    EndElement,
+    Characters,
+    EndDocument
+  };
+
+  ThermoDAQ2BinaryReader(QIODevice* device);
+
+  TokenType readNext();
+  TokenType tokenType() const { return tokenType_; }
+  bool atEnd() const { return tokenType_==EndDocument || tokenType_==Invalid; }
+  bool hasError() const { return tokenType_==Invalid; }
+  const QString& errorString() const { return errorString_; }
+
+  /// schema of the current start or end element
+  int schemaId() const { return schemaId_; }
+  const ThermoDAQ2BinaryStream::Schema& schema() const { return schemas_[schemaId_]; }
+  const ThermoDAQ2BinaryStream::Schema& schema(int id) const { return schemas_[id]; }
+  const QString& name() const { return schemas_[schemaId_].name; }
+
+  /// character data of the current characters token
+  const QString& text() const { return text_; }
+
+  int fieldIndex(const char* name) const;
+  bool hasAttribute(const char* name) const { return fieldIndex(name)>=0; }
+  int toInt(const char* name) const;
+  float toFloat(const char* name) const;
+  QString toString(const char* name) const;
+  QDateTime toDateTime(const char* name, Qt::DateFormat format = Qt::ISODate) const;
+
+  /// reads up to the end of the current element like QXmlStreamReader::readElementText
+  QString readElementText();
+
+protected:
+
+  struct Value {
+    qint64 i;
+    double d;
+    QString s;
+  };
+
+  QIODevice* device_;
+  QByteArray buffer_;
+  int pos_;
+
+  TokenType tokenType_;
+  QString errorString_;
+  std::vector<ThermoDAQ2BinaryStream::Schema> schemas_;
+  std::vector<int> elementStack_;
+  int schemaId_;
+  std::vector<Value> values_;
+  QString text_;
+
+  bool ensure(int n);
+  qint64 remaining() const;
+  bool readVarint(quint64& value);
+  bool readString(QString& value);
+  bool readSchema();
+  bool readValues();
+  TokenType setError(const QString& error);
+};
+
+/** @} */
+
+#endif // THERMODAQ2BINARYSTREAM_H
@@ -18,30 +18,293 @@
  **
  ****************************************************************************/
 
+
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 
 #include <QDateTime>
 #include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QThread>
+#include <QWaitCondition>
 
 #include "nqlogger.h"
 
+/*
+  Writer thread of NQLogger. The producers push their messages into an
+  intrusive multi-producer single-consumer queue (D. Vyukov), which only
+  needs one atomic exchange per message. All pops happen with the
+  destination mutex of the logger held, so that the queue can also be
+  drained by other threads once the writer thread has been stopped.
+*/
+class NQLogWriter : public QThread
+{
+public:
+
+  struct Entry {
+    std::atomic<Entry*> next;
+    qint64 time;
+    NQLog::LogLevel level;
+    QString module;
+    QString buffer;
+  };
+
+  explicit NQLogWriter(NQLogger* logger);
+
+  void push(Entry* entry);
+  void flush();
+  void stop();
+  void drain();
+  bool isStopped() const { return stop_.load(); }
+
+protected:
+
+  void run();
+  void link(Entry* entry);
+  Entry* pop();
+  int writeBatch();
+  void appendTime(QString& message, qint64 time);
+
+  NQLogger* logger_;
+
+  std::atomic<Entry*> head_;
+  Entry* tail_;
+  Entry stub_;
+
+  std::atomic<quint64> pushed_;
+  std::atomic<quint64> written_;
+  std::atomic<bool> waiting_;
+  std::atomic<bool> stop_;
+
+  QMutex mutex_;
+  QWaitCondition wakeup_;
+  QWaitCondition flushed_;
+
+  qint64 cachedSecond_;
+  QString cachedTime_;
+  QString message_;
+};
+
+NQLogWriter::NQLogWriter(NQLogger* logger)
+  : QThread(),
+    logger_(logger),
+    head_(&stub_),
+    tail_(&stub_),
+    pushed_(0),
+    written_(0),
+    waiting_(false),
+    stop_(false),
+    cachedSecond_(-1)
+{
+  stub_.next.store(0);
+}
+
+void NQLogWriter::link(Entry* entry)
+{
+  entry->next.store(0, std::memory_order_relaxed);
+  Entry* prev = head_.exchange(entry, std::memory_order_acq_rel);
+  prev->next.store(entry, std::memory_order_release);
+}
+
+void NQLogWriter::push(Entry* entry)
+{
+  link(entry);
+
+  pushed_.fetch_add(1);
+
+  if (waiting_.load()) {
+    QMutexLocker locker(&mutex_);
+    wakeup_.wakeOne();
+  }
+}
+
+NQLogWriter::Entry* NQLogWriter::pop()
+{
+  Entry* tail = tail_;
+  Entry* next = tail->next.load(std::memory_order_acquire);
+
+  if (tail==&stub_) {
+    if (next==0) return 0;
+    tail_ = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+
+  if (next) {
+    tail_ = next;
+    return tail;
+  }
+
+  // a producer is between the exchange and linking its entry
+  if (tail!=head_.load(std::memory_order_acquire)) return 0;
+
+  link(&stub_);
+
+  next = tail->next.load(std::memory_order_acquire);
+  if (next) {
+    tail_ = next;
+    return tail;
+  }
+
+  return 0;
+}
+
+void NQLogWriter::appendTime(QString& message, qint64 time)
+{
+  const qint64 second = time / 1000;
+  if (second!=cachedSecond_) {
+    cachedTime_ = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd hh:mm:ss.");
+    cachedSecond_ = second;
+  }
+
+  const int msec = time % 1000;
+  message += cachedTime_;
+  message += QChar('0' + msec / 100);
+  message += QChar('0' + (msec / 10) % 10);
+  message += QChar('0' + msec % 10);
+}
+
+int NQLogWriter::writeBatch()
+{
+  QMutexLocker locker(&logger_->mutex_);
+
+  int count = 0;
+  while (count<1024) {
+    Entry* entry = pop();
+    if (entry==0) break;
+
+    message_.clear();
+    appendTime(message_, entry->time);
+
+    switch (entry->level) {
+    case NQLog::Debug: message_ += " D"; break;
+    case NQLog::Spam: message_ += " S"; break;
+    case NQLog::Message: message_ += " M"; break;
+    case NQLog::Warning: message_ += " W"; break;
+    case NQLog::Critical: message_ += " C"; break;
+    case NQLog::Fatal: message_ += " F"; break;
+    }
+
+    message_ += " [";
+    message_ += entry->module;
+    message_ += "] ";
+    message_ += entry->buffer;
+    message_ += "\n";
+
+    for (std::pair<NQLog::LogLevel,QTextStream*> v : logger_->destinations_) {
+      if (entry->level>=v.first) {
+        v.second->operator <<(message_);
+      }
+    }
+
+    delete entry;
+    count++;
+  }
+
+  if (count>0) {
+    for (std::pair<NQLog::LogLevel,QTextStream*> v : logger_->destinations_) {
+      v.second->flush();
+    }
+  }
+
+  return count;
+}
+
+void NQLogWriter::run()
+{
+  forever {
+    int count = writeBatch();
+    if (count>0) {
+      written_.fetch_add(count);
+      QMutexLocker locker(&mutex_);
+      flushed_.wakeAll();
+      continue;
+    }
+
+    if (stop_.load() && written_.load()==pushed_.load()) break;
+
+    QMutexLocker locker(&mutex_);
+    waiting_.store(true);
+    if (written_.load()==pushed_.load() && !stop_.load()) {
+      wakeup_.wait(&mutex_, 100);
+    } else if (written_.load()!=pushed_.load()) {
+      // wait for the producer that has not linked its entry yet
+      locker.unlock();
+      QThread::yieldCurrentThread();
+      locker.relock();
+    }
+    waiting_.store(false);
+  }
+}
+
+void NQLogWriter::flush()
+{
+  const quint64 target = pushed_.load();
+
+  QMutexLocker locker(&mutex_);
+  while (written_.load()<target) {
+    if (isStopped() && !isRunning()) {
+      locker.unlock();
+      drain();
+      return;
+    }
+    wakeup_.wakeOne();
+    flushed_.wait(&mutex_, 100);
+  }
+}
+
+void NQLogWriter::stop()
+{
+  {
+    QMutexLocker locker(&mutex_);
+    stop_.store(true);
+    wakeup_.wakeOne();
+  }
+  wait();
+
+  // messages that came in while the thread was finishing
+  drain();
+}
+
+void NQLogWriter::drain()
+{
+  int count;
+  while ((count = writeBatch())>0) {
+    written_.fetch_add(count);
+  }
+}
+
 NQLog::NQLog(const QString& module, LogLevel level, int precision)
 : module_(module),
   level_(level),
-  stream_(&buffer_)
+  stream_(0)
 {
-  stream_.setRealNumberPrecision(precision);
+  if (NQLogger::instance()->isEnabled(module_, level_)) {
+    stream_ = new QTextStream(&buffer_);
+    stream_->setRealNumberPrecision(precision);
+  }
 }
 
 NQLog::~NQLog()
 {
-  NQLogger::instance()->write(module_, level_, buffer_);
+  if (stream_==0) return;
+
+  delete stream_;
+
+  NQLogger* logger = NQLogger::instance();
+  logger->enqueue(module_, level_, buffer_);
+  if (level_>=Critical) logger->flush();
 }
 
 NQLogger* NQLogger::instance_ = NULL;
 
 NQLogger::NQLogger(QObject *parent) :
-        QObject(parent)
+        QObject(parent),
+        minLevel_(NQLog::Fatal + 1),
+        writer_(0)
 {
 
 }
@@ -55,74 +318,139 @@ NQLogger* NQLogger::instance(QObject *parent)
   return instance_;
 }
 
-void NQLogger::write(const QString& module, NQLog::LogLevel level, const QString& buffer)
+void NQLogger::shutdown()
 {
-  if (activeModules_.empty()) return;
+  if (instance_==NULL) return;
 
-  bool filtered = true;
-  for (std::pair<QString,bool> v : activeModules_) {
+  QMutexLocker locker(&instance_->writerMutex_);
+  NQLogWriter* writer = instance_->writer_.loadAcquire();
+  if (writer) writer->stop();
+}
+
+NQLogWriter* NQLogger::writer()
+{
+  NQLogWriter* writer = writer_.loadAcquire();
+  if (writer) return writer;
+
+  QMutexLocker locker(&writerMutex_);
+
+  writer = writer_.loadAcquire();
+  if (writer==0) {
+    writer = new NQLogWriter(this);
+    writer->start(QThread::LowPriority);
+    writer_.storeRelease(writer);
+    std::atexit(NQLogger::shutdown);
+  }
+
+  return writer;
+}
+
+bool NQLogger::isActiveModule(const QString& module) const
+{
+  for (const std::pair<QString,bool>& v : activeModules_) {
     if (v.second==false) {
-      if (module==v.first) {
-        filtered = false;
-        break;
-      }
+      if (module==v.first) return true;
     } else {
-      if (v.first.length()==0 || module.startsWith(v.first)) {
-        filtered = false;
-        break;
-      }
+      if (v.first.length()==0 || module.startsWith(v.first)) return true;
     }
   }
 
-  if (filtered) return;
+  return false;
+}
 
-  QString dateString = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
+bool NQLogger::isEnabled(const QString& module, NQLog::LogLevel level)
+{
+  if (level<minLevel_.load()) return false;
 
-  QString message = dateString;
+  {
+    QReadLocker locker(&moduleCacheLock_);
+    QHash<QString,bool>::const_iterator it = moduleCache_.constFind(module);
+    if (it!=moduleCache_.constEnd()) return it.value();
+  }
 
-  switch (level) {
-  case NQLog::Debug: message += " D"; break;
-  case NQLog::Spam: message += " S"; break;
-  case NQLog::Message: message += " M"; break;
-  case NQLog::Warning: message += " W"; break;
-  case NQLog::Critical: message += " C"; break;
-  case NQLog::Fatal: message += " F"; break;
+  bool active;
+  {
+    QMutexLocker locker(&mutex_);
+    active = isActiveModule(module);
   }
 
-  message += " [";
-  message += module;
-  message += "] ";
-  message += buffer;
-  message += "\n";
+  QWriteLocker locker(&moduleCacheLock_);
+  moduleCache_.insert(module, active);
 
-  for (std::pair<NQLog::LogLevel,QTextStream*> v : destinations_) {
-    if (level>=v.first) {
-      QTextStream* stream = v.second;
-      QMutexLocker locker(&mutex_);
-      stream->operator <<(message);
-      stream->flush();
+  return active;
+}
+
+void NQLogger::write(const QString& module, NQLog::LogLevel level, const QString& buffer)
+{
+  if (!isEnabled(module, level)) return;
+
+  enqueue(module, level, buffer);
+}
+
+void NQLogger::enqueue(const QString& module, NQLog::LogLevel level, const QString& buffer)
+{
+  NQLogWriter::Entry* entry = new NQLogWriter::Entry;
+  entry->time = QDateTime::currentMSecsSinceEpoch();
+  entry->level = level;
+  entry->module = module;
+  entry->buffer = buffer;
+
+  NQLogWriter* w = writer();
+  w->push(entry);
+
+  // after shutdown the messages are written by the calling thread
+  if (w->isStopped() && !w->isRunning()) w->drain();
+}
+
+void NQLogger::flush()
+{
+  writer()->flush();
+}
+
+void NQLogger::updateFilter()
+{
+  int minLevel = NQLog::Fatal + 1;
+  if (!activeModules_.empty()) {
+    for (std::pair<NQLog::LogLevel,QTextStream*> v : destinations_) {
+      minLevel = std::min(minLevel, (int)v.first);
     }
   }
+  minLevel_.store(minLevel);
+
+  QWriteLocker locker(&moduleCacheLock_);
+  moduleCache_.clear();
 }
 
 void NQLogger::addActiveModule(const QString& module)
 {
+  QMutexLocker locker(&mutex_);
+
   if (module.endsWith("*")) {
     QString temp = module;
     temp.remove(temp.indexOf("*"), temp.length()-temp.indexOf("*"));
     activeModules_.insert(std::pair<QString,bool>(temp,true));
   }
   activeModules_.insert(std::pair<QString,bool>(module,false));
+
+  updateFilter();
 }
 
 void NQLogger::addDestiniation(QIODevice * device, NQLog::LogLevel level)
 {
+  QMutexLocker locker(&mutex_);
+
   QTextStream* stream = new QTextStream(device);
   destinations_.push_back(std::pair<NQLog::LogLevel,QTextStream*>(level,stream));
+
+  updateFilter();
 }
 
 void NQLogger::addDestiniation(FILE * fileHandle, NQLog::LogLevel level)
 {
+  QMutexLocker locker(&mutex_);
+
   QTextStream* stream = new QTextStream(fileHandle);
   destinations_.push_back(std::pair<NQLog::LogLevel,QTextStream*>(level,stream));
+
+  updateFilter();
 }
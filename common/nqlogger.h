@@ -29,6 +29,10 @@
 #include <QIODevice>
 #include <QTextStream>
 #include <QMutex>
+#include <QReadWriteLock>
+#include <QHash>
+#include <QAtomicInt>
+#include <QAtomicPointer>
 
 /** @addtogroup common
  *  @{
@@ -50,47 +54,54 @@ public:
     NQLog(const QString& module, LogLevel level = Message, int precision = 6);
     ~NQLog();
 
-    inline NQLog &operator<<(QChar t) { stream_ << '\'' << t << '\''; return *this;}
-    inline NQLog &operator<<(char t) { stream_ << t; return *this; }
+    /// false if the message is dropped by the module or level filter
+    inline bool isEnabled() const { return stream_!=0; }
+
+    inline NQLog &operator<<(QChar t) { if (stream_) *stream_ << '\'' << t << '\''; return *this;}
+    inline NQLog &operator<<(char t) { if (stream_) *stream_ << t; return *this; }
 
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-    inline NQLog &operator<<(QBool t) { stream_ << (bool(t != 0) ? "true" : "false"); return *this; }
+    inline NQLog &operator<<(QBool t) { if (stream_) *stream_ << (bool(t != 0) ? "true" : "false"); return *this; }
 #endif
-    inline NQLog &operator<<(bool t) { stream_ << (t ? "true" : "false"); return *this; }
+    inline NQLog &operator<<(bool t) { if (stream_) *stream_ << (t ? "true" : "false"); return *this; }
 
-    inline NQLog &operator<<(signed short t) { stream_ << t; return *this; }
-    inline NQLog &operator<<(unsigned short t) { stream_ << t; return *this; }
+    inline NQLog &operator<<(signed short t) { if (stream_) *stream_ << t; return *this; }
+    inline NQLog &operator<<(unsigned short t) { if (stream_) *stream_ << t; return *this; }
 
-    inline NQLog &operator<<(signed int t) { stream_ << t; return *this; }
-    inline NQLog &operator<<(unsigned int t) { stream_ << t; return *this; }
+    inline NQLog &operator<<(signed int t) { if (stream_) *stream_ << t; return *this; }
+    inline NQLog &operator<<(unsigned int t) { if (stream_) *stream_ << t; return *this; }
 
-    inline NQLog &operator<<(signed long t) { stream_ << t; return *this; }
-    inline NQLog &operator<<(unsigned long t) { stream_ << t; return *this; }
+    inline NQLog &operator<<(signed long t) { if (stream_) *stream_ << t; return *this; }
+    inline NQLog &operator<<(unsigned long t) { if (stream_) *stream_ << t; return *this; }
 
-    inline NQLog &operator<<(qint64 t) { stream_ << QString::number(t); return *this; }
-    inline NQLog &operator<<(quint64 t) { stream_ << QString::number(t); return *this; }
+    inline NQLog &operator<<(qint64 t) { if (stream_) *stream_ << QString::number(t); return *this; }
+    inline NQLog &operator<<(quint64 t) { if (stream_) *stream_ << QString::number(t); return *this; }
 
-    inline NQLog &operator<<(float t) { stream_ << t; return *this; }
-    inline NQLog &operator<<(double t) { stream_ << t; return *this; }
+    inline NQLog &operator<<(float t) { if (stream_) *stream_ << t; return *this; }
+    inline NQLog &operator<<(double t) { if (stream_) *stream_ << t; return *this; }
 
-    inline NQLog &operator<<(const char* t) { stream_ << QString::fromLatin1(t); return *this; }
-    inline NQLog &operator<<(const std::string& t) { stream_ << QString::fromStdString(t); return *this; }
-    inline NQLog &operator<<(const QString& t) { stream_ << '\"' << t << '\"'; return *this; }
-    inline NQLog &operator<<(const QStringRef & t) { return operator<<(t.toString()); }
-    inline NQLog &operator<<(const QLatin1String &t) { stream_ << '\"'  << t.latin1() << '\"'; return *this; }
-    inline NQLog &operator<<(const QByteArray & t) { stream_  << '\"' << t << '\"'; return *this; }
+    inline NQLog &operator<<(const char* t) { if (stream_) *stream_ << QString::fromLatin1(t); return *this; }
+    inline NQLog &operator<<(const std::string& t) { if (stream_) *stream_ << QString::fromStdString(t); return *this; }
+    inline NQLog &operator<<(const QString& t) { if (stream_) *stream_ << '\"' << t << '\"'; return *this; }
+    inline NQLog &operator<<(const QStringRef & t) { if (stream_) operator<<(t.toString()); return *this; }
+    inline NQLog &operator<<(const QLatin1String &t) { if (stream_) *stream_ << '\"'  << t.latin1() << '\"'; return *this; }
+    inline NQLog &operator<<(const QByteArray & t) { if (stream_) *stream_ << '\"' << t << '\"'; return *this; }
 
-    inline NQLog &operator<<(const void * t) { stream_ << t; return *this; }
+    inline NQLog &operator<<(const void * t) { if (stream_) *stream_ << t; return *this; }
 
-    inline NQLog &operator<<(QTextStreamFunction f) { stream_ << f; return *this; }
-    inline NQLog &operator<<(QTextStreamManipulator m) { stream_ << m; return *this; }
+    inline NQLog &operator<<(QTextStreamFunction f) { if (stream_) *stream_ << f; return *this; }
+    inline NQLog &operator<<(QTextStreamManipulator m) { if (stream_) *stream_ << m; return *this; }
 
 protected:
 
     QString module_;
     LogLevel level_;
     QString buffer_;
-    QTextStream stream_;
+    QTextStream* stream_;
+
+private:
+
+    Q_DISABLE_COPY(NQLog)
 };
 
 class NQLogDebug : public NQLog
@@ -135,6 +146,17 @@ public:
   ~NQLogFatal() {}
 };
 
+class NQLogWriter;
+
+/*
+  Messages are filtered by module and level before they are formatted,
+  the result of the module filter is cached per module name. Accepted
+  messages are put into a lock-free queue and written to the destinations
+  by a separate writer thread, which flushes the destinations once per
+  batch of messages. Messages of one thread keep their order. Critical
+  and fatal messages, as well as flush(), wait until everything queued
+  before them has been written; the queue is drained at program exit.
+*/
 class NQLogger : public QObject
 {
     Q_OBJECT
@@ -142,7 +164,10 @@ public:
 
     static NQLogger* instance(QObject *parent = 0);
 
+    bool isEnabled(const QString& module, NQLog::LogLevel level);
+
     void write(const QString& module, NQLog::LogLevel level, const QString&buffer);
+    void flush();
 
     void addActiveModule(const QString& module);
 
@@ -151,13 +176,29 @@ public:
 
 protected:
 
+    friend class NQLog;
+    friend class NQLogWriter;
+
     explicit NQLogger(QObject *parent = 0);
     static NQLogger* instance_;
+    static void shutdown();
+
+    bool isActiveModule(const QString& module) const;
+    void updateFilter();
+    void enqueue(const QString& module, NQLog::LogLevel level, const QString& buffer);
+    NQLogWriter* writer();
 
     QMutex mutex_;
 
     std::set<std::pair<QString,bool> > activeModules_;
     std::vector<std::pair<NQLog::LogLevel,QTextStream*> > destinations_;
+
+    QAtomicInt minLevel_;
+    QReadWriteLock moduleCacheLock_;
+    QHash<QString,bool> moduleCache_;
+
+    QMutex writerMutex_;
+    QAtomicPointer<NQLogWriter> writer_;
 };
 
 /** @} */
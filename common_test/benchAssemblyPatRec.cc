@@ -0,0 +1,246 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <nqlogger.h>
+#include <ApplicationConfig.h>
+
+#include <AssemblyUtilities.h>
+#include <AssemblyThresholder.h>
+#include <AssemblyObjectFinderPatRec.h>
+
+/*
+  Runs AssemblyObjectFinderPatRec::template_matching on the master images
+  of the fake camera and compares the result with the original angular
+  scan over the full resolution master image, which is kept here as
+  reference. For every image the distance between both positions in the
+  motion stage frame, the angle difference and the runtimes are reported.
+  The positions have to agree within the precision of the motion stage
+  (5 um) and the angles within one step of the fine scan.
+
+  usage: benchAssemblyPatRec [threshold [fine scan range [fine scan step]]]
+ */
+
+cv::Point2f legacyRotatePoint(const cv::Point2f& p, const double deg)
+{
+  const double rad = deg * (M_PI/180.);
+
+  const float x = std::cos(rad) * p.x - std::sin(rad) * p.y;
+  const float y = std::sin(rad) * p.x + std::cos(rad) * p.y;
+
+  return cv::Point2f(x, y);
+}
+
+void legacyPatRec(double& fom, cv::Point& match_loc, const cv::Mat& img_master_PatRec, const cv::Mat& img_templa_PatRec, const double angle, const int match_method)
+{
+  cv::Mat img_master_PatRec_rot;
+
+  const cv::Point2f src_center(img_master_PatRec.cols/2.0F, img_master_PatRec.rows/2.0F);
+
+  const double angle_master = (-1.0 * angle);
+
+  const cv::Mat rot_mat = cv::getRotationMatrix2D(src_center, angle_master, 1.0);
+
+  const cv::Scalar avgPixelIntensity = cv::mean(img_master_PatRec);
+
+  warpAffine(img_master_PatRec, img_master_PatRec_rot, rot_mat, img_master_PatRec.size(), cv::INTER_NEAREST, cv::BORDER_CONSTANT, avgPixelIntensity);
+
+  cv::Mat result_mat;
+  result_mat.create((img_master_PatRec.rows-img_templa_PatRec.rows+1), (img_master_PatRec.cols-img_templa_PatRec.cols+1), CV_32FC1);
+
+  matchTemplate(img_master_PatRec_rot, img_templa_PatRec, result_mat, match_method);
+
+  double minVal, maxVal;
+  cv::Point minLoc, maxLoc;
+
+  minMaxLoc(result_mat, &minVal, &maxVal, &minLoc, &maxLoc, cv::Mat());
+
+  const bool use_minFOM = ((match_method  == cv::TM_SQDIFF) || (match_method == cv::TM_SQDIFF_NORMED));
+
+  if(use_minFOM){ match_loc = minLoc; fom = minVal; }
+  else          { match_loc = maxLoc; fom = maxVal; }
+
+  match_loc = legacyRotatePoint(cv::Point2f(match_loc) - src_center, angle_master) + src_center;
+}
+
+void legacyTemplateMatching(double& best_angle, cv::Point& best_matchLoc, const AssemblyObjectFinderPatRec::Configuration& conf, const cv::Mat& img_master_PatRec, const cv::Mat& img_templa_PatRec)
+{
+  cv::Mat img_templa_PatRec_gs;
+  if(img_templa_PatRec.channels() > 1)
+  {
+    cv::cvtColor(img_templa_PatRec, img_templa_PatRec_gs, cv::COLOR_BGR2GRAY);
+  }
+  else
+  {
+    img_templa_PatRec_gs = img_templa_PatRec.clone();
+  }
+
+  const int match_method = cv::TM_SQDIFF_NORMED;
+
+  double angle_prescan(-9999.);
+  double best_FOM(0.);
+
+  for(unsigned int i=0; i<conf.angles_prescan_vec_.size(); ++i)
+  {
+    const double i_angle = conf.angles_prescan_vec_.at(i);
+
+    double i_FOM(0.);
+    cv::Point i_matchLoc;
+
+    legacyPatRec(i_FOM, i_matchLoc, img_master_PatRec, img_templa_PatRec_gs, i_angle, match_method);
+
+    if((i==0) || (i_FOM < best_FOM)){ best_FOM = i_FOM; angle_prescan = i_angle; }
+  }
+
+  const double angle_fine_min  = -1.0 * conf.angles_finemax_;
+  const double angle_fine_max  = +1.0 * conf.angles_finemax_;
+  const double angle_fine_step =        conf.angles_finestep_;
+
+  bool first = true;
+
+  for(double angle_fine=angle_fine_min; angle_fine<=angle_fine_max; angle_fine += angle_fine_step)
+  {
+    const double i_angle = angle_prescan + angle_fine;
+
+    double i_FOM(0.);
+    cv::Point i_matchLoc;
+
+    legacyPatRec(i_FOM, i_matchLoc, img_master_PatRec, img_templa_PatRec_gs, i_angle, match_method);
+
+    if(first || (i_FOM < best_FOM))
+    {
+      best_FOM      = i_FOM;
+      best_angle    = i_angle;
+      best_matchLoc = i_matchLoc;
+    }
+
+    first = false;
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  NQLogger::instance()->addActiveModule("*");
+  NQLogger::instance()->addDestiniation(stdout, NQLog::Warning);
+
+  const std::string basePath(Config::CMSTkModLabBasePath);
+
+  ApplicationConfig* config = ApplicationConfig::instance(basePath + "/assembly/assembly_SiDummyPS.cfg", "main");
+  config->append(basePath + "/assembly/assembly/parameters/SiDummyPS.cfg", "parameters");
+
+  const double mm_per_pixel_row = config->getValue<double>("main", "mm_per_pixel_row");
+  const double mm_per_pixel_col = config->getValue<double>("main", "mm_per_pixel_col");
+  const double angle_FromCameraXYtoRefFrameXY_deg = config->getValue<double>("parameters", "AngleOfCameraFrameInRefFrame_dA");
+
+  AssemblyObjectFinderPatRec::Configuration conf;
+  conf.thresholding_useThreshold_ = true;
+  conf.thresholding_threshold_ = argc>=2 ? std::atoi(argv[1]) : config->getValue<int>("main", "AssemblyObjectAlignerView_PatRec_threshold");
+  conf.angles_prescan_vec_.push_back(0.);
+  conf.angles_finemax_ = argc>=3 ? std::atof(argv[2]) : config->getValue<double>("main", "AssemblyObjectAlignerView_PatRec_angles_finemax");
+  conf.angles_finestep_ = argc>=4 ? std::atof(argv[3]) : config->getValue<double>("main", "AssemblyObjectAlignerView_PatRec_angles_finestep");
+
+  // master images of the fake camera and their templates
+  const std::vector<std::pair<std::string, std::string> > images = {
+    { "oldSpareSensor_master.png",        "oldSpareSensor_template_v01.png" },
+    { "markedglass_marker1_master.png",   "markedglass_marker1_template.png" },
+    { "SiDummyPSp_master_200218.png",     "SiDummyPSp_template_v01.png" },
+    { "SiDummyPSp_master_200120.png",     "SiDummyPSp_template_v01.png" }
+  };
+
+  QTemporaryDir outputDir;
+
+  AssemblyThresholder thresholder;
+  AssemblyObjectFinderPatRec finder(&thresholder, outputDir.path(), "rotations");
+  finder.save_subdir_images(false);
+
+  double patrec_dX(0.), patrec_dY(0.), patrec_angle(0.);
+  int patrec_exitcode(-1);
+
+  QObject::connect(&finder, &AssemblyObjectFinderPatRec::PatRec_results,
+                   [&](const double dX, const double dY, const double angle) {
+                     patrec_dX = dX; patrec_dY = dY; patrec_angle = angle;
+                   });
+  QObject::connect(&finder, &AssemblyObjectFinderPatRec::PatRec_exitcode,
+                   [&](const int code) { patrec_exitcode = code; });
+
+  std::cout << std::setw(32) << "master"
+            << std::setw(12) << "legacy[s]"
+            << std::setw(12) << "pyramid[s]"
+            << std::setw(12) << "dXY[um]"
+            << std::setw(12) << "dA[deg]" << std::endl;
+
+  bool ok = true;
+
+  for (const auto& image : images) {
+
+    conf.template_filepath_ = QString::fromStdString(basePath + "/share/assembly/" + image.second);
+
+    const cv::Mat img_master = assembly::cv_imread(basePath + "/share/assembly/" + image.first, cv::IMREAD_GRAYSCALE);
+    const cv::Mat img_templa = assembly::cv_imread(conf.template_filepath_, cv::IMREAD_COLOR);
+
+    if (img_master.empty() || img_templa.empty() || !conf.is_valid()) {
+      std::cout << std::setw(32) << image.first << "  cannot be read" << std::endl;
+      ok = false;
+      continue;
+    }
+
+    const cv::Mat img_master_PatRec = thresholder.get_image_binary_threshold(img_master, conf.thresholding_threshold_);
+
+    QElapsedTimer timer;
+
+    double legacy_angle(0.);
+    cv::Point legacy_matchLoc;
+    timer.start();
+    legacyTemplateMatching(legacy_angle, legacy_matchLoc, conf, img_master_PatRec, img_templa);
+    const double legacySeconds = 1.e-9 * timer.nsecsElapsed();
+
+    patrec_exitcode = -1;
+    timer.start();
+    finder.template_matching(conf, img_master, img_master_PatRec, img_templa);
+    const double patrecSeconds = 1.e-9 * timer.nsecsElapsed();
+
+    const double dX_0 = +1.0 * (legacy_matchLoc.x - (img_master.cols / 2.0)) * mm_per_pixel_col;
+    const double dY_0 = -1.0 * (legacy_matchLoc.y - (img_master.rows / 2.0)) * mm_per_pixel_row;
+
+    double legacy_dX, legacy_dY;
+    assembly::rotation2D_deg(legacy_dX, legacy_dY, angle_FromCameraXYtoRefFrameXY_deg, dX_0, dY_0);
+
+    const double dXY = 1000. * std::hypot(patrec_dX - legacy_dX, patrec_dY - legacy_dY);
+    const double dA = std::fabs(patrec_angle - legacy_angle);
+
+    const bool match = patrec_exitcode==0 && dXY<=5.0 && dA<=conf.angles_finestep_ && patrecSeconds<1.0;
+    ok = ok && match;
+
+    std::cout << std::setw(32) << image.first
+              << std::fixed << std::setprecision(3)
+              << std::setw(12) << legacySeconds
+              << std::setw(12) << patrecSeconds
+              << std::setprecision(2)
+              << std::setw(12) << dXY
+              << std::setprecision(3)
+              << std::setw(12) << dA
+              << (match ? "" : "  FAILED") << std::endl;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+#include <nqlogger.h>
+
+#include <KeithleyModel.h>
+#include <KeithleyDAQ6510Model.h>
+#include <RohdeSchwarzNGE103BModel.h>
+#include <HuberUnistat525wModel.h>
+
+#include "devices/Simulator/Keithley2700Simulator.h"
+#include "devices/Simulator/KeithleyDAQ6510Simulator.h"
+#include "devices/Simulator/RohdeSchwarzNGE103BSimulator.h"
+#include "devices/Simulator/HuberPilotOneSimulator.h"
+
+/*
+  Runs the device models of common/ for which a device simulator exists
+  against the simulator on a pseudo terminal, i.e. through the real
+  driver and ComHandler, and reports
+
+  - the polling rate, the number of complete updates per second,
+  - the mean, median and maximum duration of an update,
+  - the number of queries per update and the mean time per query.
+
+  The update slots are called directly, one after the other, so the
+  update intervals of the models play no role.
+
+  usage: benchDeviceModels [updates] [response delay in us] [response jitter in us]
+ */
+
+struct Benchmark
+{
+  const char* name;
+  std::function<DeviceSimulator*()> simulator;
+  std::function<QObject*(const char* port)> model;
+  std::vector<const char*> updateSlots;
+};
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+#ifdef USE_FAKEIO
+  std::cout << "built with fake devices, the models do not use the simulators" << std::endl;
+  return 0;
+#endif
+
+  int updates = 10;
+  int delay = 2000;
+  int jitter = 500;
+  if (argc>1) updates = std::atoi(argv[1]);
+  if (argc>2) delay = std::atoi(argv[2]);
+  if (argc>3) jitter = std::atoi(argv[3]);
+  if (updates<1) updates = 1;
+
+  NQLogger::instance()->addActiveModule("*");
+  NQLogger::instance()->addDestiniation(stdout, NQLog::Warning);
+
+  std::vector<Benchmark> benchmarks = {
+    { "KeithleyModel",
+      [] { return new Keithley2700Simulator(); },
+      [] (const char* port) {
+        KeithleyModel* model = new KeithleyModel(port);
+        model->setDeviceEnabled(true);
+        for (unsigned int sensor = 0;sensor<4;++sensor) model->setSensorEnabled(sensor, true);
+        return model;
+      },
+      { "scanTemperatures" } },
+    { "KeithleyDAQ6510Model",
+      [] { return new KeithleyDAQ6510Simulator(); },
+      [] (const char* port) {
+        KeithleyDAQ6510Model* model = new KeithleyDAQ6510Model(port);
+        for (unsigned int sensor = 101;sensor<=110;++sensor) model->setSensorEnabled(sensor, true);
+        return model;
+      },
+      { "scanTemperatures", "scanComplete" } },
+    { "RohdeSchwarzNGE103BModel",
+      [] { return new RohdeSchwarzNGE103BSimulator(); },
+      [] (const char* port) { return new RohdeSchwarzNGE103BModel(port); },
+      { "updateInformation" } },
+    { "HuberUnistat525wModel",
+      [] { return new HuberPilotOneSimulator(); },
+      [] (const char* port) { return new HuberUnistat525wModel(port); },
+      { "updateInformation" } }
+  };
+
+  std::cout << "response delay " << delay << " us, jitter " << jitter << " us" << std::endl;
+  std::cout << std::endl;
+  std::cout << std::left << std::setw(26) << "model" << std::right
+            << std::setw(12) << "updates/s"
+            << std::setw(12) << "mean[ms]"
+            << std::setw(12) << "median[ms]"
+            << std::setw(12) << "max[ms]"
+            << std::setw(14) << "queries/upd"
+            << std::setw(14) << "query[ms]" << std::endl;
+
+  for (auto& benchmark : benchmarks) {
+
+    std::unique_ptr<DeviceSimulator> simulator(benchmark.simulator());
+    simulator->SetResponseDelay(delay);
+    simulator->SetResponseJitter(jitter);
+    if (!simulator->Start()) return 1;
+
+    std::unique_ptr<QObject> model(benchmark.model(simulator->PortName().c_str()));
+
+    auto update = [&] {
+      for (auto slot : benchmark.updateSlots) {
+        QMetaObject::invokeMethod(model.get(), slot, Qt::DirectConnection);
+      }
+    };
+
+    // the first update fills the caches of the model
+    update();
+
+    const unsigned long responses = simulator->GetResponseCount();
+    std::vector<double> durations;
+
+    QElapsedTimer total;
+    total.start();
+    for (int i=0;i<updates;++i) {
+      QElapsedTimer timer;
+      timer.start();
+      update();
+      durations.push_back(timer.nsecsElapsed() * 1e-6);
+    }
+    const double elapsed = total.nsecsElapsed() * 1e-6;
+    const double queries = double(simulator->GetResponseCount() - responses) / updates;
+
+    std::sort(durations.begin(), durations.end());
+
+    std::cout << std::left << std::setw(26) << benchmark.name << std::right
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << 1000. * updates / elapsed
+              << std::setw(12) << elapsed / updates
+              << std::setw(12) << durations[durations.size()/2]
+              << std::setw(12) << durations.back()
+              << std::setw(14) << std::setprecision(1) << queries
+              << std::setw(14) << std::setprecision(2)
+              << (queries>0 ? elapsed / updates / queries : 0.0) << std::endl;
+
+    if (queries==0) {
+      std::cout << "  no queries answered, the model did not connect to the simulator" << std::endl;
+    }
+
+    model.reset();
+    simulator->Stop();
+  }
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+#include <QCoreApplication>
+#include <QTimer>
+
+#include <nqlogger.h>
+
+#include <DeviceModelExecutor.h>
+#include <KeithleyDAQ6510Model.h>
+#include <RohdeSchwarzNGE103BModel.h>
+#include <HuberUnistat525wModel.h>
+
+#include "devices/Simulator/KeithleyDAQ6510Simulator.h"
+#include "devices/Simulator/RohdeSchwarzNGE103BSimulator.h"
+#include "devices/Simulator/HuberPilotOneSimulator.h"
+
+/*
+  Polls the Huber, Rohde & Schwarz and Keithley DAQ6510 models against
+  their simulators with a DeviceModelExecutor, once with all models in
+  one shared thread, as thermoDAQ2 did before, and once with a thread
+  per device. The Huber simulator answers slowly, so in the shared
+  thread its updates delay the polls of the other devices.
+
+  For every device the configured and mean poll interval, the RMS and
+  maximum jitter of the interval and the mean and maximum duration of
+  an update are reported.
+
+  usage: benchDeviceThreads [seconds] [update interval in s] [slow response delay in us]
+ */
+
+void run(const char* title, bool shared, int seconds, float interval, int slowDelay)
+{
+  std::vector<std::unique_ptr<DeviceSimulator> > simulators;
+  simulators.emplace_back(new HuberPilotOneSimulator());
+  simulators.emplace_back(new RohdeSchwarzNGE103BSimulator());
+  simulators.emplace_back(new KeithleyDAQ6510Simulator());
+
+  simulators[0]->SetResponseDelay(slowDelay);
+  simulators[1]->SetResponseDelay(2000);
+  simulators[2]->SetResponseDelay(2000);
+  for (auto& simulator : simulators) {
+    simulator->SetResponseJitter(500);
+    if (!simulator->Start()) return;
+  }
+
+  {
+    DeviceModelExecutor executor;
+
+    const QString thread = shared ? "devices" : QString();
+
+    executor.addDevice("HuberUnistat525w",
+                       new HuberUnistat525wModel(simulators[0]->PortName().c_str(), interval),
+                       thread);
+    executor.addDevice("RohdeSchwarzNGE103B",
+                       new RohdeSchwarzNGE103BModel(simulators[1]->PortName().c_str(), interval),
+                       thread);
+
+    KeithleyDAQ6510Model* keithley = new KeithleyDAQ6510Model(simulators[2]->PortName().c_str(), interval);
+    for (unsigned int sensor = 101;sensor<=110;++sensor) keithley->setSensorEnabled(sensor, true);
+    executor.addDevice("KeithleyDAQ6510", keithley, thread);
+
+    QTimer::singleShot(seconds * 1000, QCoreApplication::instance(), SLOT(quit()));
+    QCoreApplication::exec();
+
+    executor.stop();
+
+    std::cout << title << std::endl;
+    std::cout << std::left << std::setw(22) << "device" << std::right
+              << std::setw(8) << "polls"
+              << std::setw(12) << "int.[ms]"
+              << std::setw(12) << "mean[ms]"
+              << std::setw(12) << "rms jit."
+              << std::setw(12) << "max jit."
+              << std::setw(12) << "upd.[ms]"
+              << std::setw(12) << "max upd." << std::endl;
+
+    QStringList devices = executor.getDevices();
+    for (QStringList::const_iterator it = devices.constBegin(); it != devices.constEnd(); ++it) {
+      DeviceModelExecutor::Statistics s = executor.getStatistics(*it);
+
+      std::cout << std::left << std::setw(22) << it->toStdString() << std::right
+                << std::fixed << std::setprecision(1)
+                << std::setw(8) << s.polls
+                << std::setw(12) << s.interval
+                << std::setw(12) << s.meanInterval
+                << std::setw(12) << s.rmsJitter
+                << std::setw(12) << s.maxJitter
+                << std::setw(12) << s.meanDuration
+                << std::setw(12) << s.maxDuration << std::endl;
+    }
+    std::cout << std::endl;
+  }
+
+  for (auto& simulator : simulators) simulator->Stop();
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+#ifdef USE_FAKEIO
+  std::cout << "built with fake devices, the models do not use the simulators" << std::endl;
+  return 0;
+#endif
+
+  int seconds = 20;
+  float interval = 1;
+  int slowDelay = 50000;
+  if (argc>1) seconds = std::atoi(argv[1]);
+  if (argc>2) interval = std::atof(argv[2]);
+  if (argc>3) slowDelay = std::atoi(argv[3]);
+  if (seconds<1) seconds = 1;
+
+  NQLogger::instance()->addActiveModule("*");
+  NQLogger::instance()->addDestiniation(stdout, NQLog::Warning);
+
+  std::cout << "update interval " << interval << " s, slow response delay "
+            << slowDelay << " us" << std::endl << std::endl;
+
+  run("one shared thread", true, seconds, interval, slowDelay);
+  run("one thread per device", false, seconds, interval, slowDelay);
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QTimer>
+#include <QMetaObject>
+
+#include <nqlogger.h>
+
+#include <LStepExpressModel.h>
+
+#include "devices/Simulator/LStepExpressSimulator.h"
+
+/*
+  Moves the x axis of the LStepExpressSimulator through LStepExpressModel
+  and reports, for the status polling interval of the idle stage and for
+  the faster intervals used while the stage moves,
+
+  - the mean and maximum delay between the end of a move in the
+    simulator and the motionFinished signal of the model,
+  - the number of queries and transfers per poll of the model.
+
+  usage: benchLStepExpressModel [moves] [response delay in us] [response jitter in us]
+ */
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+#ifdef USE_FAKEIO
+  std::cout << "built with fake devices, the model does not use the simulator" << std::endl;
+  return 0;
+#endif
+
+  int moves = 5;
+  int delay = 2000;
+  int jitter = 500;
+  if (argc>1) moves = std::atoi(argv[1]);
+  if (argc>2) delay = std::atoi(argv[2]);
+  if (argc>3) jitter = std::atoi(argv[3]);
+  if (moves<1) moves = 1;
+
+  NQLogger::instance()->addActiveModule("*");
+  NQLogger::instance()->addDestiniation(stdout, NQLog::Warning);
+
+  const double distance = 0.5;
+
+  std::cout << "response delay " << delay << " us, jitter " << jitter << " us" << std::endl;
+  std::cout << std::endl;
+  std::cout << std::setw(14) << "interval[ms]"
+            << std::setw(14) << "delay[ms]"
+            << std::setw(14) << "max[ms]"
+            << std::setw(14) << "queries/poll"
+            << std::setw(16) << "transfers/poll" << std::endl;
+
+  for (int interval : { 1000, 200, 50, 20 }) {
+
+    LStepExpressSimulator simulator;
+    simulator.SetResponseDelay(delay);
+    simulator.SetResponseJitter(jitter);
+    if (!simulator.Start()) return 1;
+
+    std::unique_ptr<LStepExpressModel> model(new LStepExpressModel(simulator.PortName(),
+                                                                   "PE43 1.00.01", "E2020.02.13-2002",
+                                                                   1000, 1000));
+    model->setFastMotionUpdateInterval(interval);
+    model->setDeviceEnabled(true);
+
+    if (model->getDeviceState()!=READY) {
+      std::cout << "model did not connect to the simulator" << std::endl;
+      return 1;
+    }
+
+    for (unsigned int axis = 0;axis<4;++axis) model->setAxisEnabled(axis, true);
+    QMetaObject::invokeMethod(model.get(), "updateInformation", Qt::DirectConnection);
+
+    const double duration = 1000. * distance / model->getVelocity(0);
+
+    std::vector<double> delays;
+
+    for (int i=0;i<moves;++i) {
+
+      QEventLoop loop;
+      QObject::connect(model.get(), SIGNAL(motionFinished()), &loop, SLOT(quit()));
+      QTimer::singleShot(10000 + int(duration), &loop, SLOT(quit()));
+
+      QElapsedTimer timer;
+      timer.start();
+
+      model->moveRelative(distance, 0., 0., 0.);
+      loop.exec();
+
+      delays.push_back(timer.nsecsElapsed() * 1e-6 - duration);
+    }
+
+    const LStepExpressModel::PollStatistics statistics = model->getPollStatistics();
+
+    double mean = 0;
+    for (double d : delays) mean += d;
+    mean /= delays.size();
+
+    std::cout << std::setw(14) << interval
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << mean
+              << std::setw(14) << *std::max_element(delays.begin(), delays.end())
+              << std::setw(14) << double(statistics.queries) / std::max(1ul, statistics.updates)
+              << std::setw(16) << double(statistics.transfers) / std::max(1ul, statistics.updates)
+              << std::endl;
+
+    model.reset();
+    simulator.Stop();
+  }
+
+  return 0;
+}
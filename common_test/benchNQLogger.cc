@@ -0,0 +1,134 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <future>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QStringList>
+
+#include <nqlogger.h>
+
+/*
+  Measures the cost of NQLog messages on the calling thread and the
+  throughput of the logger for an increasing number of threads writing
+  into a temporary file. Messages that are filtered by level or module
+  are timed separately. Afterwards the file is read back to check that
+  the messages of every thread arrived in order.
+
+  usage: benchNQLogger [messagesPerThread]
+ */
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  int messages = 200000;
+  if (argc>1) messages = std::atoi(argv[1]);
+
+  QTemporaryFile file;
+  if (!file.open()) {
+    std::cout << "could not open temporary file" << std::endl;
+    return 1;
+  }
+
+  NQLogger::instance()->addActiveModule("bench*");
+  NQLogger::instance()->addDestiniation(&file, NQLog::Message);
+
+  QElapsedTimer timer;
+
+  timer.start();
+  for (int i=0;i<messages;++i) {
+    NQLogDebug("benchNQLogger") << "filtered by level " << i << " " << 0.5*i;
+  }
+  std::cout << "filtered by level:  "
+            << std::setw(8) << std::setprecision(3) << double(timer.nsecsElapsed())/messages
+            << " ns/call" << std::endl;
+
+  timer.start();
+  for (int i=0;i<messages;++i) {
+    NQLogMessage("otherModule") << "filtered by module " << i << " " << 0.5*i;
+  }
+  std::cout << "filtered by module: "
+            << std::setw(8) << std::setprecision(3) << double(timer.nsecsElapsed())/messages
+            << " ns/call" << std::endl;
+
+  std::cout << std::endl;
+  std::cout << std::setw(8) << "threads"
+            << std::setw(14) << "call[ns]"
+            << std::setw(16) << "messages/s" << std::endl;
+
+  const int nThreads[] = { 1, 2, 4, 8 };
+
+  for (int n : nThreads) {
+
+    NQLogMessage("benchNQLogger") << "start " << n;
+    NQLogger::instance()->flush();
+
+    std::vector<std::future<qint64> > threads;
+
+    timer.start();
+    for (int t=0;t<n;++t) {
+      threads.push_back(std::async(std::launch::async,
+                                   [=]() {
+                                     QElapsedTimer callTimer;
+                                     callTimer.start();
+                                     for (int i=0;i<messages;++i) {
+                                       NQLogMessage("benchNQLogger") << "thread " << t << " message " << i << " " << 0.5*i;
+                                     }
+                                     return callTimer.nsecsElapsed();
+                                   }));
+    }
+
+    qint64 callTime = 0;
+    for (auto& f : threads) callTime += f.get();
+    NQLogger::instance()->flush();
+    const qint64 totalTime = timer.nsecsElapsed();
+
+    std::cout << std::setw(8) << n
+              << std::setw(14) << std::setprecision(3) << double(callTime)/(n*messages)
+              << std::setw(16) << std::setprecision(3) << 1e9*n*messages/totalTime
+              << std::endl;
+  }
+
+  file.seek(0);
+  QTextStream stream(&file);
+
+  std::vector<int> last;
+  int errors = 0;
+  while (!stream.atEnd()) {
+    QString line = stream.readLine();
+    int idx = line.indexOf("] thread ");
+    if (idx<0) {
+      if (line.contains("] start ")) last.clear();
+      continue;
+    }
+    QStringList tokens = line.mid(idx+2).split(' ');
+    int t = tokens[1].toInt();
+    int i = tokens[3].toInt();
+    if (t>=(int)last.size()) last.resize(t+1, -1);
+    if (i!=last[t]+1) errors++;
+    last[t] = i;
+  }
+
+  if (errors) {
+    std::cout << std::endl << errors << " messages out of order" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include <QCoreApplication>
+
+#include <nqlogger.h>
+
+#include <AssemblyUEyeFakeCamera.h>
+#include <AssemblyFramePool.h>
+
+/*
+  Acquires images with the fake uEye camera and checks the frame pool
+  metrics: a single copy per frame, recycled frame buffers while the
+  consumers hold at most the latest frame, and one colour conversion
+  per frame shared by all consumers.
+ */
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  NQLogger::instance()->addActiveModule("*");
+  NQLogger::instance()->addDestiniation(stdout, NQLog::Warning);
+
+  const unsigned long nFrames = 20;
+
+  AssemblyFramePool* pool = AssemblyFramePool::instance();
+  pool->set_max_frames(4);
+
+  AssemblyUEyeFakeCamera camera(nullptr);
+  camera.open();
+
+  // a single image file, i.e. all frames have the same size
+  camera.setPixelClock(5);
+
+  pool->reset_metrics();
+
+  // consumers keep shared references to the latest frame only
+  cv::Mat frame, color_view, color_thresholder;
+  bool shared = true;
+
+  QObject::connect(&camera, &AssemblyVUEyeCamera::imageAcquired, [&](const cv::Mat& img) {
+    frame = img;
+    color_view = pool->color(img);
+    color_thresholder = pool->color(img);
+
+    const cv::Mat gray = pool->gray(color_thresholder);
+
+    shared = shared && (color_view.data == color_thresholder.data) && (gray.data == img.data);
+  });
+
+  for (unsigned long i=0;i<nFrames;++i) camera.acquireImage();
+
+  const AssemblyFramePool::Metrics m = pool->metrics();
+
+  std::cout << "frames:      " << m.frames << std::endl;
+  std::cout << "allocations: " << m.allocations << std::endl;
+  std::cout << "reuses:      " << m.reuses << std::endl;
+  std::cout << "copies:      " << m.copies << std::endl;
+  std::cout << "conversions: " << m.conversions << std::endl;
+  std::cout << "cache hits:  " << m.cache_hits << std::endl;
+
+  if (frame.empty()) {
+    std::cout << "\nno image acquired by the fake camera\n" << std::endl;
+    return 1;
+  }
+
+  if (m.frames!=nFrames || m.copies!=nFrames) {
+    std::cout << "\nframe pool copy check failed\n" << std::endl;
+    return 1;
+  }
+
+  // the previous frame is still held while the next one is acquired
+  if (m.allocations!=2 || m.reuses!=nFrames-2) {
+    std::cout << "\nframe pool allocation check failed\n" << std::endl;
+    return 1;
+  }
+
+  if (m.conversions!=nFrames || m.cache_hits!=2*nFrames || !shared) {
+    std::cout << "\nframe pool derived products check failed\n" << std::endl;
+    return 1;
+  }
+
+  camera.close();
+
+  return 0;
+}
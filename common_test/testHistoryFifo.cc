@@ -13,6 +13,8 @@
 #include <string>
 #include <iostream>
 #include <array>
+#include <cmath>
+#include <random>
 
 #include <nqlogger.h>
 #include <HistoryFifo.h>
@@ -61,5 +63,88 @@ int main(int argc, char ** argv)
     */
   }
 
+  {
+    HistoryFifo<double> fifo(5);
+
+    const qint64 t0 = QDateTime::fromString("2017-06-13T09:09:11", Qt::ISODate).toMSecsSinceEpoch();
+    for (int i=1;i<=9;++i) fifo.push_back(t0 + 1000*(i-1), 10*i);
+
+    // entries 90 (0 s), 80 (-1 s), 70 (-2 s), 60 (-3 s), 50 (-4 s)
+    if (fifo.indexInPast(0)!=0 || fifo.indexInPast(2)!=2 ||
+        fifo.indexInPast(4)!=4 || fifo.indexInPast(100)!=4) {
+      std::cout << "\nhistory fifo indexInPast check failed\n" << std::endl;
+      return 1;
+    }
+
+    if (fifo.deltaTime()!=-4 || fifo.deltaTime(0, 2)!=-2 ||
+        fifo.delta()!=-40 || fifo.delta(1, 3)!=-20 ||
+        fifo.gradient()!=10 || fifo.gradient(2)!=10) {
+      std::cout << "\nhistory fifo delta and gradient check failed\n" << std::endl;
+      return 1;
+    }
+
+    if (fifo.mean()!=70 || fifo.mean(1)!=85 || fifo.mean(1, 3)!=70 ||
+        fifo.mean(3, 100)!=55 || fifo.stats().second!=200) {
+      std::cout << "\nhistory fifo mean check failed\n" << std::endl;
+      return 1;
+    }
+
+    fifo.resize(3);
+    if (fifo.fillLevel()!=3 || fifo.valueFront()!=90 || fifo.valueBack()!=70 ||
+        fifo.mean()!=80) {
+      std::cout << "\nhistory fifo resize check failed\n" << std::endl;
+      return 1;
+    }
+  }
+
+  {
+    // running sums against a direct calculation over many turns of the
+    // ring, with a large offset and a small spread of the values
+    const size_t size = 180;
+    HistoryFifo<double> fifo(size);
+
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0.0, 0.01);
+
+    qint64 t = QDateTime::fromString("2017-06-13T09:09:11", Qt::ISODate).toMSecsSinceEpoch();
+    for (int i=0;i<100000;++i) {
+      t += 10000;
+      fifo.push_back(t, 1.0e4 + 1.0e-3 * (i % 1000) + noise(generator));
+
+      if (i % 997 != 0 && i != 99999) continue;
+
+      const size_t pos = fifo.indexInPast(900);
+      size_t expectedPos = fifo.fillLevel() - 1;
+      for (size_t p=0;p<fifo.fillLevel();++p) {
+        if (fifo.timeAt(p).secsTo(fifo.timeAt(0))>=900) {
+          expectedPos = p;
+          break;
+        }
+      }
+
+      double mean = 0;
+      for (size_t p=0;p<=pos;++p) mean += fifo.valueAt(p);
+      mean /= pos + 1;
+      double variance = 0;
+      for (size_t p=0;p<=pos;++p) variance += std::pow(fifo.valueAt(p) - mean, 2);
+      variance /= pos + 1;
+
+      std::pair<double,double> stats = fifo.stats(pos);
+
+      if (pos!=expectedPos ||
+          std::fabs(stats.first - mean) > 1.0e-9 ||
+          std::fabs(stats.second - variance) > 1.0e-9 * variance) {
+
+        std::cout << "\nhistory fifo running sums check failed\n" << std::endl;
+
+        std::cout << "index in past:  " << pos << " expected " << expectedPos << std::endl;
+        std::cout << "mean:           " << stats.first << " expected " << mean << std::endl;
+        std::cout << "variance:       " << stats.second << " expected " << variance << std::endl;
+
+        return 1;
+      }
+    }
+  }
+
   return 0;
 }
@@ -0,0 +1,159 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <cmath>
+
+#include <LStepExpressMotionManager.h>
+
+/*
+  Checks the motion queue optimizer of LStepExpressMotionManager on the
+  motion sequences queued by set_movements_priorities_XYZA and the check
+  of motion sequences against the stage bounds, and reports the estimated
+  time saved.
+ */
+
+bool compare(const QQueue<LStepExpressMotion>& motions, const QQueue<LStepExpressMotion>& expected)
+{
+  if (motions.size()!=expected.size()) return false;
+
+  for (int i=0;i<motions.size();++i) {
+    if (motions[i].getMode()!=expected[i].getMode()) return false;
+    if (std::fabs(motions[i].getX()-expected[i].getX())>1e-9) return false;
+    if (std::fabs(motions[i].getY()-expected[i].getY())>1e-9) return false;
+    if (std::fabs(motions[i].getZ()-expected[i].getZ())>1e-9) return false;
+    if (std::fabs(motions[i].getA()-expected[i].getA())>1e-9) return false;
+  }
+
+  return true;
+}
+
+int main(int /* argc */, char ** /* argv */)
+{
+  const std::vector<double> velocities = { 10., 10., 5., 10. };
+  const double overhead = 25.;
+
+  bool passed = true;
+
+  // XYA and Z motions stay separate and ordered, no-op motions are dropped
+  {
+    QQueue<LStepExpressMotion> motions, expected;
+    motions.enqueue(LStepExpressMotion(0., 0., 1., 0., false));
+    motions.enqueue(LStepExpressMotion(0., 0., 0., 0., false));
+    motions.enqueue(LStepExpressMotion(1., 2., 0., 0., false));
+    expected = motions;
+    expected.removeAt(1);
+
+    passed = compare(LStepExpressMotionManager::optimized_motions(motions), expected) && passed;
+  }
+
+  // consecutive Z and consecutive collinear XYA motions are merged
+  {
+    QQueue<LStepExpressMotion> motions, expected;
+    motions.enqueue(LStepExpressMotion(0., 0., 1., 0., false));
+    motions.enqueue(LStepExpressMotion(0., 0., 2., 0., false));
+    motions.enqueue(LStepExpressMotion(1., 0.5, 0., 0., false));
+    motions.enqueue(LStepExpressMotion(2., 1., 0., 0., false));
+    motions.enqueue(LStepExpressMotion(-0.5, -0.25, 0., 0., false));
+    expected.enqueue(LStepExpressMotion(0., 0., 3., 0., false));
+    expected.enqueue(LStepExpressMotion(2.5, 1.25, 0., 0., false));
+
+    passed = compare(LStepExpressMotionManager::optimized_motions(motions), expected) && passed;
+  }
+
+  // XYA motions which are not collinear are only merged if the direct path is safe
+  {
+    QQueue<LStepExpressMotion> motions, expected;
+    motions.enqueue(LStepExpressMotion(1., 0., 0., 0., false));
+    motions.enqueue(LStepExpressMotion(0., 1., 0., 0.5, false));
+    expected.enqueue(LStepExpressMotion(1., 1., 0., 0.5, false));
+
+    passed = compare(LStepExpressMotionManager::optimized_motions(motions), motions) && passed;
+    passed = compare(LStepExpressMotionManager::optimized_motions(motions, true), expected) && passed;
+  }
+
+  // a Z dip between two XYA motions cancels, the XYA motions are merged
+  {
+    QQueue<LStepExpressMotion> motions, expected;
+    motions.enqueue(LStepExpressMotion(0.1, 0., 0., 0., false));
+    motions.enqueue(LStepExpressMotion(0., 0., -0.3, 0., false));
+    motions.enqueue(LStepExpressMotion(0., 0., 0.1, 0., false));
+    motions.enqueue(LStepExpressMotion(0., 0., 0.2, 0., false));
+    motions.enqueue(LStepExpressMotion(0.2, 0., 0., 0., false));
+    expected.enqueue(LStepExpressMotion(0.3, 0., 0., 0., false));
+
+    passed = compare(LStepExpressMotionManager::optimized_motions(motions), expected) && passed;
+  }
+
+  // absolute and mixed motions are kept as they are
+  {
+    QQueue<LStepExpressMotion> motions;
+    motions.enqueue(LStepExpressMotion(1., 0., 0., 0., false));
+    motions.enqueue(LStepExpressMotion(1., 0., 0., 0., true));
+    motions.enqueue(LStepExpressMotion(1., 0., 0., 0., false));
+    motions.enqueue(LStepExpressMotion(1., 0., 1., 0., false));
+    motions.enqueue(LStepExpressMotion(1., 0., 1., 0., false));
+
+    passed = compare(LStepExpressMotionManager::optimized_motions(motions), motions) && passed;
+  }
+
+  // end points of all motions are checked against the stage bounds
+  {
+    const std::vector<double> start = { 0., 0., 0., 0. };
+    const std::vector<double> lower = { -10., -10., -5., -180. };
+    const std::vector<double> upper = {  10.,  10.,  5.,  180. };
+
+    QQueue<LStepExpressMotion> motions;
+    motions.enqueue(LStepExpressMotion(0., 0., 4., 0., false));
+    motions.enqueue(LStepExpressMotion(8., 0., 0., 0., false));
+    passed = LStepExpressMotionManager::within_bounds(motions, start, lower, upper) && passed;
+
+    motions.enqueue(LStepExpressMotion(0., 0., 2., 0., false));
+    passed = !LStepExpressMotionManager::within_bounds(motions, start, lower, upper) && passed;
+
+    QQueue<LStepExpressMotion> absolute;
+    absolute.enqueue(LStepExpressMotion(20., 0., 0., 0., false));
+    absolute.enqueue(LStepExpressMotion(5., 0., 0., 0., true));
+    passed = !LStepExpressMotionManager::within_bounds(absolute, start, lower, upper) && passed;
+  }
+
+  if (!passed) {
+    std::cout << "\nmotion queue optimizer check failed\n" << std::endl;
+    return 1;
+  }
+
+  // pick-up like sequence: lift, move, lower, then a correction in small steps
+  QQueue<LStepExpressMotion> motions;
+  motions.enqueue(LStepExpressMotion(0., 0., 10., 0., false));
+  motions.enqueue(LStepExpressMotion(50., 20., 0., 0., false));
+  motions.enqueue(LStepExpressMotion(0., 0., -10., 0., false));
+  for (int i=0;i<5;++i) {
+    motions.enqueue(LStepExpressMotion(0.01, 0., 0., 0., false));
+    motions.enqueue(LStepExpressMotion(0., 0., 0., 0., false));
+  }
+
+  const QQueue<LStepExpressMotion> optimized = LStepExpressMotionManager::optimized_motions(motions);
+
+  const double before = LStepExpressMotionManager::estimate_duration(motions, velocities, overhead);
+  const double after = LStepExpressMotionManager::estimate_duration(optimized, velocities, overhead);
+
+  std::cout << "motions:            " << motions.size() << " -> " << optimized.size() << std::endl;
+  std::cout << "estimated duration: " << before << " ms -> " << after << " ms" << std::endl;
+  std::cout << "estimated saving:   " << before - after << " ms" << std::endl;
+
+  if (optimized.size()!=4 || !(after<before)) {
+    std::cout << "\nmotion queue optimizer saving check failed\n" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+
+#include <QTemporaryFile>
+
+#include <nqlogger.h>
+#include <ThermoDAQ2BinaryStream.h>
+
+int main(int argc, char ** argv)
+{
+  NQLogger::instance()->addActiveModule("*");
+  NQLogger::instance()->addDestiniation(stdout, NQLog::Debug);
+
+  QTemporaryFile file;
+  if (!file.open()) {
+    std::cout << "could not open temporary file" << std::endl;
+    return 1;
+  }
+
+  qint64 xmlSize = 0;
+  {
+    ThermoDAQ2BinaryWriter writer(&file, 10, ThermoDAQ2BinaryWriter::SyncNone);
+
+    QStringList fragments;
+    fragments << "<ThermoDAQ2>\n<DAQStarted time=\"2022-03-01T10:00:00\"/>";
+    for (int i=0;i<100;++i) {
+      QString time = QDateTime::fromString("2022-03-01T10:00:00", Qt::ISODate).addSecs(i).toString(Qt::ISODate);
+      fragments << QString("<KeithleyDAQ6510 time=\"%1\">\n"
+                           "  <KeithleyDAQ6510Sensor id=\"%2\" State=\"1\" T=\"%3\"/>\n"
+                           "  <KeithleyDAQ6510Sensor id=\"102\" State=\"0\" T=\"-1.250e+01\" Mode=\"0x1f\"/>\n"
+                           "</KeithleyDAQ6510>").arg(time).arg(101).arg(20.0 + 0.125*i, 0, 'f', 3);
+    }
+    fragments << "<Log time=\"Tue Mar 1 10:05:00 2022\">pump &amp; chiller on</Log>";
+    fragments << "</ThermoDAQ2>";
+
+    for (auto f : fragments) {
+      xmlSize += f.toUtf8().size() + 1;
+      if (!writer.writeFragment(f)) {
+        std::cout << "could not write fragment " << f.toStdString() << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  std::cout << "xml size:    " << xmlSize << std::endl;
+  std::cout << "binary size: " << file.size() << std::endl;
+
+  file.seek(0);
+  if (!ThermoDAQ2BinaryStream::isBinaryStream(&file)) {
+    std::cout << "magic of binary stream not found" << std::endl;
+    return 1;
+  }
+
+  ThermoDAQ2BinaryReader reader(&file);
+
+  int sensors = 0;
+  int depth = 0;
+  QString log;
+  while (!reader.atEnd()) {
+    reader.readNext();
+
+    if (reader.tokenType()==ThermoDAQ2BinaryReader::StartElement) {
+      depth++;
+
+      if (reader.name()=="KeithleyDAQ6510") {
+        QDateTime expected = QDateTime::fromString("2022-03-01T10:00:00", Qt::ISODate).addSecs(sensors/2);
+        if (reader.toDateTime("time")!=expected) {
+          std::cout << "time check failed: " << reader.toString("time").toStdString() << std::endl;
+          return 1;
+        }
+      }
+
+      if (reader.name()=="KeithleyDAQ6510Sensor") {
+        const int id = reader.toInt("id");
+        const float T = reader.toFloat("T");
+        const float expected = (id==101) ? 20.0 + 0.125*(sensors/2) : -12.5;
+        if (T!=expected || reader.toInt("State")!=(id==101 ? 1 : 0)) {
+          std::cout << "sensor check failed: " << id << " " << T << " != " << expected << std::endl;
+          return 1;
+        }
+        if (id==102 && reader.toString("Mode")!="0x1f") {
+          std::cout << "string check failed: " << reader.toString("Mode").toStdString() << std::endl;
+          return 1;
+        }
+        sensors++;
+      }
+
+      if (reader.name()=="Log") {
+        log = reader.readElementText();
+        depth--;
+      }
+
+    } else if (reader.tokenType()==ThermoDAQ2BinaryReader::EndElement) {
+      depth--;
+    }
+  }
+
+  if (reader.hasError() || depth!=0) {
+    std::cout << "binary stream error: " << reader.errorString().toStdString() << std::endl;
+    return 1;
+  }
+
+  if (sensors!=200 || log!="pump & chiller on") {
+    std::cout << "content check failed: " << sensors << " sensors, log '" << log.toStdString() << "'" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
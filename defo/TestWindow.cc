@@ -157,40 +157,17 @@ void TestWindow::pointButtonClicked() {
   DefoMeasurement* measurement = selectionModel_->getSelection();
   listModel_->setMeasurementPoints(measurement, NULL);
 
-  DefoPointFinder* finder;
   QRect searchArea = measurement->getImage().rect();
-  const int width = searchArea.width();
 
-  /*
-    The number of blocks depends on the number of cores available and the
-    number of cores you want to be available for other tasks.
-    */
-  const int blocks = 6;
+  DefoPointFinderPool* finder = new DefoPointFinderPool(listModel_,
+                                                        pointModel_,
+                                                        measurement,
+                                                        searchArea);
 
-  QMutex mutex;
-
-  for (double i = 0; i < blocks; ++i) {
-
-    /*
-      In Qt the rectangle borders are placed ON the pixels, in contrast to e.g.
-      Swing where they are in between the pixels.
-      As a consequence, the right-side border has to be one pixel to the left in
-      order to avoid overlapping rectangles.
-      */
-    searchArea.setLeft( i/blocks * width );
-    searchArea.setRight( (i+1)/blocks * width - 1 );
-
-    finder = new DefoPointFinder(i,
-				 &mutex,
-				 listModel_,
-				 pointModel_,
-				 measurement,
-				 searchArea);
-
-    finder->start();
-
-  }
+  connect(finder, SIGNAL(finished()),
+          finder, SLOT(deleteLater()));
 
+  finder->start();
 }
 
 void TestWindow::newCameraImage(QString location, bool keep) {
@@ -274,7 +251,8 @@ void TestWindow::writePoints()
   if (file.length() > 0) {
     CoordinateSaver saver(file);
     DefoMeasurement* meas = selectionModel_->getSelection();
-    const DefoPointCollection* points = listModel_->getMeasurementPoints(meas);
+    DefoPointSnapshot points = listModel_->getMeasurementPointSnapshot(meas);
+    if (!points) return;
 
     for ( DefoPointCollection::const_iterator it = points->begin()
         ; it < points->end()
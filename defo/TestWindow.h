@@ -44,7 +44,7 @@
 
 #include "DefoPointRecognitionModel.h"
 #include "DefoThresholdSpinBox.h"
-#include "DefoPointFinder.h"
+#include "DefoPointFinderPool.h"
 #include "DefoPoint.h"
 
 
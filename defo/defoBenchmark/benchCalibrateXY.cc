@@ -0,0 +1,247 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include "ApplicationConfig.h"
+
+#include "nvector2D.h"
+#include "nvector3D.h"
+#include "npoint3D.h"
+#include "ndirection3D.h"
+#include "nline3D.h"
+#include "nplane3D.h"
+
+#include "DefoRecoSurface.h"
+
+/*
+  Calibrates random points spread over a full camera image with the
+  geometry of defo.cfg, once with DefoRecoSurface::calibrateXYPoints and
+  once with the original per point calculation using the N* geometry
+  classes, which is kept here as reference. The calibrated positions and
+  the image and grid distances of both have to agree to 1e-9.
+
+  usage: benchCalibrateXY [points [repetitions]]
+ */
+
+struct Geometry
+{
+  double focalLength, gamma;
+  double pitchX, pitchY;
+  double calibX, calibY;
+  double angle1, angle2, angle3;
+  double distance, height1, height2;
+  std::pair<double, double> imageSize;
+};
+
+void legacyCalibrateXYPoints(DefoPointCollection & points, const Geometry& g)
+{
+  double f = g.focalLength;
+  double gamma = g.gamma;
+  double imageDistance = f * (gamma + 1.0);
+  double objectDistance = imageDistance / gamma;
+
+  NVector3D height1(0., 0., g.height1);
+  NVector3D height2(0., 0., g.height2);
+  NVector3D distance(0., -1.0*g.distance, 0.);
+
+  double a1 = g.angle1 * M_PI / 180.;
+  double a2 = g.angle2 * M_PI / 180.;
+  double a3 = g.angle3 * M_PI / 180.;
+
+  distance.rotateX(a2);
+
+  NPoint3D cameraPoint(0., 0., 0.);
+  cameraPoint.move(height1);
+  cameraPoint.move(distance);
+
+  NPoint3D objectPoint(0., 0., 0.);
+  objectPoint.move(height2);
+  NDirection3D objectNormal(0., 0., 1.);
+  NPlane3D objectPlane(objectPoint, objectNormal);
+
+  NDirection3D centerRayDirection(0., 0., -1.);
+  centerRayDirection.rotateX(a2 + a3);
+
+  NLine3D centerRay(cameraPoint, centerRayDirection);
+  centerRay.intersection(objectPlane, objectPoint);
+
+  NVector3D imageDistanceVector(objectPoint, cameraPoint);
+  imageDistanceVector *= objectDistance / imageDistanceVector.length();
+
+  NPoint3D imagePoint(objectPoint);
+  imagePoint.move(imageDistanceVector);
+
+  NPoint3D gridPoint(0., 0., 0.);
+  gridPoint.move(height1);
+
+  NDirection3D gridNormal(0., 0., -1.);
+  gridNormal.rotateX(-a1);
+
+  NPlane3D gridPlane(gridPoint, gridNormal);
+
+  NPoint3D objectIntersection;
+  NPoint3D gridIntersection;
+
+  for (DefoPointCollection::iterator it = points.begin();
+       it != points.end();
+       ++it) {
+
+    DefoPoint& aPoint = *it;
+
+    NDirection3D imageRayDirection((aPoint.getX() - 0.5 * g.imageSize.first) * g.pitchX,
+                                   (aPoint.getY() - 0.5 * g.imageSize.second) * g.pitchY,
+                                   imageDistance);
+    imageRayDirection.rotateX(a2 + a3);
+    NLine3D imageRay(imagePoint, imageRayDirection);
+    imageRay.intersection(objectPlane, objectIntersection);
+
+    NVector3D imageDistance(objectIntersection, imagePoint);
+
+    NDirection3D gridRayDirection(imageRayDirection);
+    gridRayDirection.rotateZ(M_PI);
+    NLine3D gridRay(objectIntersection, gridRayDirection);
+    gridRay.intersection(gridPlane, gridIntersection);
+
+    NVector3D gridDistance(objectIntersection, gridIntersection);
+
+    double x = -1.0 * objectIntersection.x() * g.calibX;
+    double y =  1.0 * objectIntersection.y() * g.calibY;
+
+    aPoint.setCalibratedPosition(x, y);
+
+    NVector2D imageDistanceX(imageDistance.x(), imageDistance.z());
+    NVector2D gridDistanceX(gridDistance.x(), gridDistance.z());
+
+    aPoint.setImageDistanceX(imageDistanceX.length());
+    aPoint.setGridDistanceX(gridDistanceX.length());
+
+    NVector2D imageDistanceY(imageDistance.y(), imageDistance.z());
+    NVector2D gridDistanceY(gridDistance.y(), gridDistance.z());
+
+    aPoint.setImageDistanceY(imageDistanceY.length());
+    aPoint.setGridDistanceY(gridDistanceY.length());
+  }
+}
+
+double relativeDifference(double a, double b)
+{
+  return std::fabs(a - b) / std::max(1.0, std::fabs(b));
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  const int nPoints = argc>=2 ? std::atoi(argv[1]) : 20000;
+  const int nRepetitions = argc>=3 ? std::atoi(argv[2]) : 20;
+
+  ApplicationConfig* config = ApplicationConfig::instance(std::string(Config::CMSTkModLabBasePath) + "/defo/defo.cfg", "main");
+
+  Geometry g;
+  g.focalLength = config->getValue<double>("LENS_FOCAL_LENGTH");
+  g.pitchX = config->getValue<double>("PIXEL_PITCH_X");
+  g.pitchY = config->getValue<double>("PIXEL_PITCH_Y");
+  g.calibX = config->getValue<double>("CALIBX", 1.0);
+  g.calibY = config->getValue<double>("CALIBY", 1.0);
+  g.angle1 = config->getValue<double>("ANGLE1");
+  g.angle2 = config->getValue<double>("ANGLE2");
+  g.angle3 = config->getValue<double>("ANGLE3");
+  g.distance = config->getValue<double>("DISTANCE");
+  g.height1 = config->getValue<double>("HEIGHT1");
+  g.height2 = config->getValue<double>("HEIGHT2");
+  g.imageSize = std::make_pair(5184., 3456.);
+
+  DefoRecoSurface surface;
+  surface.setFocalLength(g.focalLength);
+  surface.setPitchX(g.pitchX);
+  surface.setPitchY(g.pitchY);
+  surface.setCalibX(g.calibX);
+  surface.setCalibY(g.calibY);
+  surface.setAngle1(g.angle1);
+  surface.setAngle2(g.angle2);
+  surface.setAngle3(g.angle3);
+  surface.setDistance(g.distance);
+  surface.setHeight1(g.height1);
+  surface.setHeight2(g.height2);
+  surface.setImageSize(g.imageSize);
+  g.gamma = surface.imageScale(g.focalLength);
+
+  std::mt19937 generator(4711);
+  std::uniform_real_distribution<double> x(0., g.imageSize.first);
+  std::uniform_real_distribution<double> y(0., g.imageSize.second);
+
+  DefoPointCollection points;
+  for (int i=0;i<nPoints;++i) {
+    points.push_back(DefoPoint(x(generator), y(generator)));
+  }
+
+  QElapsedTimer timer;
+
+  DefoPointCollection legacy;
+  timer.start();
+  for (int r=0;r<nRepetitions;++r) {
+    legacy = points;
+    legacyCalibrateXYPoints(legacy, g);
+  }
+  const double legacySeconds = 1.e-9 * timer.nsecsElapsed() / nRepetitions;
+
+  DefoPointCollection calibrated;
+  timer.start();
+  for (int r=0;r<nRepetitions;++r) {
+    calibrated = points;
+    surface.calibrateXYPoints(calibrated);
+  }
+  const double calibratedSeconds = 1.e-9 * timer.nsecsElapsed() / nRepetitions;
+
+  const bool complete = calibrated.size()==legacy.size();
+
+  double maxPosition = 0., maxImageDistance = 0., maxGridDistance = 0.;
+  for (size_t i=0;complete && i<calibrated.size();++i) {
+    const DefoPoint& c = calibrated[i];
+    const DefoPoint& l = legacy[i];
+    maxPosition = std::max(maxPosition, relativeDifference(c.getCalibratedX(), l.getCalibratedX()));
+    maxPosition = std::max(maxPosition, relativeDifference(c.getCalibratedY(), l.getCalibratedY()));
+    maxImageDistance = std::max(maxImageDistance, relativeDifference(c.getImageDistanceX(), l.getImageDistanceX()));
+    maxImageDistance = std::max(maxImageDistance, relativeDifference(c.getImageDistanceY(), l.getImageDistanceY()));
+    maxGridDistance = std::max(maxGridDistance, relativeDifference(c.getGridDistanceX(), l.getGridDistanceX()));
+    maxGridDistance = std::max(maxGridDistance, relativeDifference(c.getGridDistanceY(), l.getGridDistanceY()));
+  }
+
+  const double tolerance = 1.e-9;
+  const bool identical = complete &&
+      maxPosition<=tolerance &&
+      maxImageDistance<=tolerance &&
+      maxGridDistance<=tolerance;
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "points calibrated:   " << nPoints << " x " << nRepetitions << std::endl;
+  std::cout << "points kept:         " << legacy.size() << " (legacy) "
+            << calibrated.size() << " (arrays)" << std::endl;
+  std::cout << "legacy N* geometry:  " << 1000. * legacySeconds << " ms" << std::endl;
+  std::cout << "coordinate arrays:   " << 1000. * calibratedSeconds << " ms" << std::endl;
+  std::cout << std::scientific << std::setprecision(2);
+  std::cout << "max. diff. position: " << maxPosition << std::endl;
+  std::cout << "max. diff. image:    " << maxImageDistance << std::endl;
+  std::cout << "max. diff. grid:     " << maxGridDistance << std::endl;
+  std::cout << "identical:           " << (identical ? "yes" : "NO") << std::endl;
+
+  return identical ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <nqlogger.h>
+
+#include "DefoMeasurement.h"
+#include "DefoImagePlanes.h"
+#include "DefoPointFinder.h"
+#include "DefoSquare.h"
+
+/*
+  Runs the point search on synthetic images of the same size with an
+  increasing number of dots. With the bucketed forbidden areas the scan
+  time has to stay flat; the linear DefoSquareCollection lookup is timed
+  for comparison as long as it finishes in reasonable time.
+
+  usage: benchForbiddenAreas [imageSize]
+ */
+
+class DefoSyntheticMeasurement : public DefoMeasurement
+{
+public:
+
+  DefoSyntheticMeasurement(int size, int dotsPerRow)
+    : DefoMeasurement(QDateTime::currentDateTime())
+  {
+    image_ = QImage(size, size, QImage::Format_RGB32);
+    image_.fill(qRgb(10, 10, 10));
+
+    const double spacing = double(size) / dotsPerRow;
+    const double radius = spacing / 6.;
+
+    for (int j=0;j<dotsPerRow;++j) {
+      const double cy = (j + 0.5) * spacing;
+      for (int i=0;i<dotsPerRow;++i) {
+        const double cx = (i + 0.5) * spacing;
+        for (int y=cy-radius;y<=cy+radius;++y) {
+          QRgb* line = reinterpret_cast<QRgb*>(image_.scanLine(y));
+          for (int x=cx-radius;x<=cx+radius;++x) {
+            const double r = std::sqrt((x-cx)*(x-cx) + (y-cy)*(y-cy)) / radius;
+            if (r>1.) continue;
+            const int v = 255 - 100 * r;
+            line[x] = qRgb(v, v, v);
+          }
+        }
+      }
+    }
+  }
+};
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  int size = 2000;
+  if (argc>1) size = std::atoi(argv[1]);
+
+  const int dotsPerRow[] = { 10, 20, 32, 50, 71, 100 };
+
+  std::cout << "image: " << size << " x " << size << std::endl;
+  std::cout << std::setw(8) << "points"
+            << std::setw(14) << "findPoints[s]"
+            << std::setw(14) << "grid scan[s]"
+            << std::setw(16) << "linear scan[s]" << std::endl;
+
+  QElapsedTimer timer;
+
+  for (unsigned int n=0;n<sizeof(dotsPerRow)/sizeof(int);++n) {
+
+    DefoSyntheticMeasurement measurement(size, dotsPerRow[n]);
+    DefoImagePlanes planes(measurement.getImage());
+    DefoPointFinder finder(&planes);
+
+    const int hsw = size / dotsPerRow[n] / 4;
+    const QRect searchArea = planes.rect();
+    const QPolygonF roi;
+
+    timer.start();
+    const DefoPointCollection* points = finder.findPoints(&searchArea, &roi, 100, 100, 60, hsw);
+    const double findTime = 1.e-9 * timer.nsecsElapsed();
+
+    // membership scan over every pixel, which is what findPoints used to do
+    DefoSquareGrid grid(QRect(0, 0, size, size), hsw);
+    DefoSquareCollection collection;
+    for (DefoPointCollection::const_iterator it = points->begin();
+         it != points->end();
+         ++it) {
+      grid.push_back(DefoSquare(*it, hsw));
+      collection.push_back(DefoSquare(*it, hsw));
+    }
+
+    int inside = 0;
+    timer.start();
+    for (int y=0;y<size;++y) {
+      for (int x=0;x<size;++x) {
+        if (grid.isInside(DefoPoint(x, y))) inside++;
+      }
+    }
+    const double gridTime = 1.e-9 * timer.nsecsElapsed();
+
+    std::cout << std::setw(8) << points->size()
+              << std::fixed << std::setprecision(3)
+              << std::setw(14) << findTime
+              << std::setw(14) << gridTime;
+
+    if (points->size()<=1000) {
+      int insideLinear = 0;
+      timer.start();
+      for (int y=0;y<size;++y) {
+        for (int x=0;x<size;++x) {
+          if (collection.isInside(DefoPoint(x, y))) insideLinear++;
+        }
+      }
+      const double linearTime = 1.e-9 * timer.nsecsElapsed();
+      std::cout << std::setw(16) << linearTime;
+      if (inside!=insideLinear) {
+        std::cout << std::endl << "membership mismatch: " << inside << " != " << insideLinear << std::endl;
+        return 1;
+      }
+    } else {
+      std::cout << std::setw(16) << "skipped";
+    }
+
+    std::cout << std::endl;
+
+    delete points;
+  }
+
+  return 0;
+}
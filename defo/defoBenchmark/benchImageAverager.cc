@@ -0,0 +1,167 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+#include <random>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QImage>
+
+#include "DefoImageAverager.h"
+
+/*
+  Averages a series of images with the column by column accumulation
+  DefoImageAverager used before, and with the streaming averager using
+  the mean, the sigma clipped mean and the median. The time to only
+  decode the images is given for reference.
+
+  Without arguments, a series of noisy JPEG frames of the size of a
+  DSLR image is written to a temporary directory first.
+
+  usage: benchImageAverager [image files]
+ */
+
+QImage legacyAverage(const QStringList& filenames)
+{
+  QImage ret(filenames.front());
+  const int width = ret.width();
+  const int height = ret.height();
+
+  std::vector<unsigned short> red(width * height, 0);
+  std::vector<unsigned short> green(width * height, 0);
+  std::vector<unsigned short> blue(width * height, 0);
+  int count = 0;
+
+  for (const QString& filename : filenames) {
+    QImage temp(filename);
+    for (int w=0;w<width;w++) {
+      for (int h=0;h<height;h++) {
+        QRgb rgb = temp.pixel(w, h);
+        red[w*height+h] += qRed(rgb);
+        green[w*height+h] += qGreen(rgb);
+        blue[w*height+h] += qBlue(rgb);
+      }
+    }
+    count++;
+  }
+
+  for (int w=0;w<width;w++) {
+    for (int h=0;h<height;h++) {
+      ret.setPixel(w, h, qRgb(red[w*height+h]/count,
+                              green[w*height+h]/count,
+                              blue[w*height+h]/count));
+    }
+  }
+
+  return ret;
+}
+
+QStringList writeFrames(const QString& path, int count, int width, int height)
+{
+  std::mt19937 generator(4711);
+  std::normal_distribution<float> noise(0., 8.);
+
+  QImage base(width, height, QImage::Format_RGB32);
+  for (int h=0;h<height;h++) {
+    QRgb* line = reinterpret_cast<QRgb*>(base.scanLine(h));
+    for (int w=0;w<width;w++) {
+      const bool dot = (w % 40)<8 && (h % 40)<8;
+      line[w] = dot ? qRgb(220, 220, 60) : qRgb(30, 30, 40);
+    }
+  }
+
+  QStringList filenames;
+  for (int i=0;i<count;++i) {
+    QImage frame = base;
+    for (int h=0;h<height;h++) {
+      QRgb* line = reinterpret_cast<QRgb*>(frame.scanLine(h));
+      for (int w=0;w<width;w++) {
+        const int n = noise(generator);
+        line[w] = qRgb(qBound(0, qRed(line[w]) + n, 255),
+                       qBound(0, qGreen(line[w]) + n, 255),
+                       qBound(0, qBlue(line[w]) + n, 255));
+      }
+    }
+    QString filename = QString("%1/frame%2.jpg").arg(path).arg(i);
+    frame.save(filename, "JPEG", 95);
+    filenames << filename;
+  }
+
+  return filenames;
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  QTemporaryDir directory;
+  QStringList filenames;
+
+  if (argc>1) {
+    for (int i=1;i<argc;++i) filenames << argv[i];
+  } else {
+    std::cout << "writing 10 frames of 5184x3456 pixels" << std::endl;
+    filenames = writeFrames(directory.path(), 10, 5184, 3456);
+  }
+
+  QElapsedTimer timer;
+
+  timer.start();
+  for (const QString& filename : filenames) QImage image(filename);
+  const double decodeSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  timer.start();
+  QImage legacy = legacyAverage(filenames);
+  const double legacySeconds = 1.e-9 * timer.nsecsElapsed();
+
+  const char* names[] = { "mean", "sigma clipped mean", "median" };
+  const DefoImageAverager::Method methods[] = { DefoImageAverager::Mean,
+                                                DefoImageAverager::SigmaClippedMean,
+                                                DefoImageAverager::Median };
+  double seconds[3];
+  QImage mean;
+
+  for (int m=0;m<3;++m) {
+    DefoImageAverager averager(filenames, methods[m]);
+    timer.start();
+    QImage image = averager.getAveragedImage();
+    seconds[m] = 1.e-9 * timer.nsecsElapsed();
+    if (m==0) mean = image;
+  }
+
+  // the legacy sums overflow beyond 257 images
+  long differences = 0;
+  if (filenames.size()<=257) {
+    for (int h=0;h<mean.height();h++) {
+      for (int w=0;w<mean.width();w++) {
+        if ((legacy.pixel(w, h) & 0xffffff)!=(mean.pixel(w, h) & 0xffffff)) differences++;
+      }
+    }
+  }
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "images:              " << filenames.size() << std::endl;
+  std::cout << "decode only:         " << decodeSeconds << " s" << std::endl;
+  std::cout << "legacy:              " << legacySeconds << " s" << std::endl;
+  for (int m=0;m<3;++m) {
+    std::cout << std::left << std::setw(21) << (std::string(names[m]) + ":") << std::right
+              << seconds[m] << " s" << std::endl;
+  }
+  std::cout << "pixels differing from legacy: " << differences << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include "DefoMeasurementListModel.h"
+#include "DefoImageCache.h"
+
+/*
+  Opens a measurement directory, steps through all of its measurements
+  like a user browsing the list, with prefetching of the neighbouring
+  images, and builds the thumbnails of the list. Reports the time to
+  open the directory, the time per image and the memory held by the
+  image cache.
+
+  usage: benchImageCache <measurements.odmx> [image cache size in MB]
+ */
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  if (argc<2) {
+    std::cerr << "usage: benchImageCache <measurements.odmx> [image cache size in MB]" << std::endl;
+    return 1;
+  }
+
+  DefoImageCache* cache = DefoImageCache::instance();
+  if (argc>=3) cache->setMemoryBudget(1024LL * 1024LL * std::atoi(argv[2]));
+
+  QElapsedTimer timer;
+
+  DefoMeasurementListModel listModel;
+  timer.start();
+  listModel.read(argv[1]);
+  const double openSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  const int count = listModel.getMeasurementCount();
+  if (count==0) {
+    std::cerr << "no measurements in " << argv[1] << std::endl;
+    return 1;
+  }
+
+  timer.start();
+  for (int i=0;i<count;++i) {
+    cache->getThumbnail(listModel.getMeasurement(i)->getImageLocations());
+  }
+  const double thumbnailSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  qint64 peakBytes = 0;
+  timer.start();
+  for (int i=0;i<count;++i) {
+    DefoMeasurement* measurement = listModel.getMeasurement(i);
+    listModel.prefetchImages(measurement);
+    if (measurement->getImage().isNull()) {
+      std::cerr << "could not read image of measurement " << i+1 << std::endl;
+    }
+    peakBytes = std::max(peakBytes, cache->getStatistics().imageBytes);
+  }
+  const double browseSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  const DefoImageCache::Statistics statistics = cache->getStatistics();
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "measurements:     " << count << std::endl;
+  std::cout << "open:             " << openSeconds << " s" << std::endl;
+  std::cout << "thumbnails:       " << thumbnailSeconds << " s ("
+            << 1000. * thumbnailSeconds / count << " ms each)" << std::endl;
+  std::cout << "browse:           " << browseSeconds << " s ("
+            << 1000. * browseSeconds / count << " ms per image)" << std::endl;
+  std::cout << "hits/misses:      " << statistics.hits << "/" << statistics.misses
+            << " (" << statistics.prefetched << " prefetched)" << std::endl;
+  std::cout << "cache budget:     " << cache->getMemoryBudget() / (1024*1024) << " MB" << std::endl;
+  std::cout << "cache peak:       " << peakBytes / (1024*1024) << " MB" << std::endl;
+  std::cout << "thumbnail memory: " << statistics.thumbnailBytes / 1024 << " kB" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,277 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <nqlogger.h>
+
+#include "DefoMeasurement.h"
+#include "DefoImagePlanes.h"
+#include "DefoPointFinder.h"
+
+/*
+  Compares the point search on the contiguous image planes with the
+  original per-pixel QImage::pixel() implementation, which is kept here
+  as reference. Both paths have to produce identical point collections.
+
+  usage: benchPointFinder <image> [threshold1 threshold2 threshold3 halfSquareWidth [repetitions]]
+ */
+
+class DefoLegacyPointFinder
+{
+public:
+
+  DefoLegacyPointFinder(const QImage& image)
+    : image_(image)
+  {
+
+  }
+
+  const DefoPointCollection* findPoints(int t1, int t2, int t3, int hsw)
+  {
+    DefoPointCollection* points = new DefoPointCollection();
+    DefoSquareCollection forbiddenAreas;
+    const int step2TotalThreshold = 4 * t2;
+
+    QRect imageArea = image_.rect();
+    QRect area = imageArea;
+
+    for (int y = area.y();y < area.y() + area.height();++y) {
+      for (int x = area.x();x < area.x() + area.width();++x) {
+
+        if (forbiddenAreas.isInside(DefoPoint(x, y)) ||
+            qGray(image_.pixel(x, y)) <= t1 ||
+            !imageArea.contains(x+3, y+3)) continue;
+
+        double theProbe = 0.;
+        theProbe += qGray(image_.pixel(x + 2, y + 2));
+        theProbe += qGray(image_.pixel(x + 2, y + 3));
+        theProbe += qGray(image_.pixel(x + 3, y + 2));
+        theProbe += qGray(image_.pixel(x + 3, y + 3));
+        if (theProbe <= step2TotalThreshold) continue;
+
+        DefoPoint intermediate(x, y);
+        QRect searchRect(intermediate.getPixX() - hsw,
+                         intermediate.getPixY() - hsw,
+                         2 * hsw,
+                         2 * hsw);
+
+        int i = 0;
+        while (i < 4 && imageArea.contains(searchRect)) {
+          intermediate = legacyCenterOfGravity(searchRect, t3);
+          searchRect.setCoords(intermediate.getPixX() - hsw,
+                               intermediate.getPixY() - hsw,
+                               intermediate.getPixX() + hsw,
+                               intermediate.getPixY() + hsw);
+          ++i;
+        }
+
+        if (i == 4 &&
+            area.contains(intermediate.getPixX(), intermediate.getPixY()) &&
+            !forbiddenAreas.isInside(intermediate)) {
+          forbiddenAreas.push_back(DefoSquare(intermediate, hsw));
+          intermediate.setValid(true);
+          points->push_back(intermediate);
+        }
+      }
+    }
+
+    QRect colorArea;
+    for (DefoPointCollection::iterator it = points->begin();
+         it != points->end();
+         ++it) {
+      colorArea.setCoords(it->getPixX() - hsw,
+                          it->getPixY() - hsw,
+                          it->getPixX() + hsw,
+                          it->getPixY() + hsw);
+      it->setColor(legacyAverageColor(colorArea, t3));
+    }
+
+    return points;
+  }
+
+protected:
+
+  QImage image_;
+
+  DefoPoint legacyCenterOfGravity(const QRect &area, int threshold) const
+  {
+    DefoPoint weightedSum(0, 0);
+
+    if (!area.isNull()) {
+      const int right = area.x() + area.width();
+      const int bottom = area.y() + area.height();
+
+      double totalGray = 0.;
+      double weightedX = 0.;
+      double weightedY = 0.;
+
+      for (int x = area.x(); x < right; ++x) {
+        for (int y = area.y(); y < bottom; ++y) {
+          int gray = qGray(image_.pixel(x, y));
+          if (gray > threshold) {
+            totalGray += gray;
+            weightedX += x*gray;
+            weightedY += y*gray;
+          }
+        }
+      }
+
+      if (totalGray > 0)
+        weightedSum.setPosition(weightedX/totalGray, weightedY/totalGray);
+    }
+
+    return weightedSum;
+  }
+
+  const QColor legacyAverageColor(const QRect &area, int threshold) const
+  {
+    QRect realArea = area & image_.rect();
+    QColor average(0, 0, 0);
+
+    if (!realArea.isNull()) {
+      double red = 0;
+      double green = 0;
+      double blue = 0;
+      int totalBrightness = 0;
+
+      const int right = realArea.x() + realArea.width();
+      const int bottom = realArea.y() + realArea.height();
+
+      for (int x = realArea.x(); x < right; ++x) {
+        for (int y = realArea.y(); y < bottom; ++y) {
+          QRgb pixel = image_.pixel(x, y);
+          int brightness = qGray(pixel);
+          if (brightness > threshold) {
+            red += qRed(pixel) * brightness;
+            green += qGreen(pixel) * brightness;
+            blue += qBlue(pixel) * brightness;
+            totalBrightness += brightness;
+          }
+        }
+      }
+
+      average.setRgb(red/totalBrightness,
+                     green/totalBrightness,
+                     blue/totalBrightness);
+    }
+
+    return average;
+  }
+};
+
+bool comparePoints(const DefoPointCollection* a, const DefoPointCollection* b)
+{
+  if (a->size()!=b->size()) {
+    std::cout << "number of points differs: "
+              << a->size() << " != " << b->size() << std::endl;
+    return false;
+  }
+
+  for (size_t i=0;i<a->size();++i) {
+    const DefoPoint& pa = a->at(i);
+    const DefoPoint& pb = b->at(i);
+    if (pa.getX()!=pb.getX() || pa.getY()!=pb.getY() ||
+        pa.getColor()!=pb.getColor()) {
+      std::cout << "point " << i << " differs: " << pa << " != " << pb << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  if (argc!=2 && argc<6) {
+    std::cerr << "usage: benchPointFinder <image> [threshold1 threshold2 threshold3 halfSquareWidth [repetitions]]" << std::endl;
+    return 1;
+  }
+
+  int t1 = 35, t2 = 50, t3 = 60, hsw = 15, repetitions = 3;
+  if (argc>=6) {
+    t1 = std::atoi(argv[2]);
+    t2 = std::atoi(argv[3]);
+    t3 = std::atoi(argv[4]);
+    hsw = std::atoi(argv[5]);
+  }
+  if (argc>=7) repetitions = std::atoi(argv[6]);
+
+  DefoMeasurement measurement(QString(argv[1]), false);
+  if (measurement.getImage().isNull()) {
+    std::cerr << "could not read image " << argv[1] << std::endl;
+    return 1;
+  }
+
+  DefoLegacyPointFinder legacyFinder(measurement.getImage());
+  DefoImagePlanes planes;
+  DefoPointFinder finder(&planes);
+
+  const QRect searchArea = measurement.getImage().rect();
+  const QPolygonF roi;
+
+  const double megaPixels = 1.e-6 * measurement.getWidth() * measurement.getHeight();
+  std::cout << "image: " << measurement.getWidth() << " x " << measurement.getHeight()
+            << " (" << megaPixels << " MP)" << std::endl;
+
+  QElapsedTimer timer;
+
+  const DefoPointCollection* legacyPoints = 0;
+  qint64 legacyTime = 0;
+  for (int r=0;r<repetitions;++r) {
+    delete legacyPoints;
+    timer.start();
+    legacyPoints = legacyFinder.findPoints(t1, t2, t3, hsw);
+    legacyTime += timer.nsecsElapsed();
+  }
+
+  const DefoPointCollection* planesPoints = 0;
+  qint64 conversionTime = 0;
+  qint64 planesTime = 0;
+  for (int r=0;r<repetitions;++r) {
+    delete planesPoints;
+    timer.start();
+    planes.setImage(measurement.getImage());
+    conversionTime += timer.nsecsElapsed();
+    timer.start();
+    planesPoints = finder.findPoints(&searchArea, &roi, t1, t2, t3, hsw);
+    planesTime += timer.nsecsElapsed();
+  }
+
+  const double legacySeconds = 1.e-9 * legacyTime / repetitions;
+  const double conversionSeconds = 1.e-9 * conversionTime / repetitions;
+  const double planesSeconds = 1.e-9 * planesTime / repetitions;
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "points found:         " << planesPoints->size() << std::endl;
+  std::cout << "QImage::pixel() path: " << legacySeconds << " s, "
+            << megaPixels/legacySeconds << " MP/s" << std::endl;
+  std::cout << "plane conversion:     " << conversionSeconds << " s" << std::endl;
+  std::cout << "image plane path:     " << planesSeconds << " s, "
+            << megaPixels/planesSeconds << " MP/s ("
+            << megaPixels/(planesSeconds+conversionSeconds) << " MP/s incl. conversion)" << std::endl;
+
+  bool identical = comparePoints(legacyPoints, planesPoints);
+  std::cout << "results identical:    " << (identical ? "yes" : "no") << std::endl;
+
+  delete legacyPoints;
+  delete planesPoints;
+
+  return identical ? 0 : 1;
+}
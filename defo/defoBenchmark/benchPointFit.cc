@@ -0,0 +1,188 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+
+#include "DefoMeasurement.h"
+#include "DefoImagePlanes.h"
+#include "DefoPointFinder.h"
+
+/*
+  Compares the center of gravity of the point finder with the position of
+  the 2D Gaussian fit.
+
+  Without an image, a grid of dots with known sub-pixel positions, a
+  background and noise is generated, and the RMS deviation from the true
+  positions is reported for both. With an image, the time of both and
+  the mean shift between them is reported.
+
+  usage: benchPointFit [<image> [threshold1 threshold2 threshold3 halfSquareWidth]]
+ */
+
+struct SampleDots
+{
+  int pitch;
+  int nDots;
+  std::vector<double> x;
+  std::vector<double> y;
+};
+
+QImage makeSample(SampleDots& dots, int nDots, int pitch, double sigma,
+                  double amplitude, double background, double noise)
+{
+  dots.pitch = pitch;
+  dots.nDots = nDots;
+
+  const int size = nDots * pitch;
+  std::vector<double> luminance((size_t)size * size, background);
+
+  std::mt19937 generator(4711);
+  std::uniform_real_distribution<double> offset(-0.5, 0.5);
+  std::normal_distribution<double> gaussNoise(0., noise);
+
+  const int reach = (int)std::ceil(5. * sigma);
+
+  for (int j=0;j<nDots;++j) {
+    for (int i=0;i<nDots;++i) {
+      const double cx = (i + 0.5) * pitch + offset(generator);
+      const double cy = (j + 0.5) * pitch + offset(generator);
+      dots.x.push_back(cx);
+      dots.y.push_back(cy);
+
+      for (int y=(int)cy-reach;y<=(int)cy+reach;++y) {
+        for (int x=(int)cx-reach;x<=(int)cx+reach;++x) {
+          const double r2 = (x-cx)*(x-cx) + (y-cy)*(y-cy);
+          luminance[(size_t)y*size+x] += amplitude * std::exp(-0.5 * r2 / (sigma*sigma));
+        }
+      }
+    }
+  }
+
+  QImage image(size, size, QImage::Format_RGB32);
+  for (int y=0;y<size;++y) {
+    QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+    for (int x=0;x<size;++x) {
+      const double v = luminance[(size_t)y*size+x] + gaussNoise(generator);
+      const int g = std::max(0, std::min(255, (int)std::lround(v)));
+      line[x] = qRgb(g, g, g);
+    }
+  }
+
+  return image;
+}
+
+double rmsDeviation(const DefoPointCollection* points, const SampleDots& dots, int& matched)
+{
+  double sum = 0.;
+  matched = 0;
+
+  for (DefoPointCollection::const_iterator it = points->begin();
+       it != points->end();
+       ++it) {
+    const int i = (int)(it->getX() / dots.pitch);
+    const int j = (int)(it->getY() / dots.pitch);
+    if (i<0 || j<0 || i>=dots.nDots || j>=dots.nDots) continue;
+
+    const double dx = it->getX() - dots.x[j*dots.nDots+i];
+    const double dy = it->getY() - dots.y[j*dots.nDots+i];
+    sum += dx*dx + dy*dy;
+    ++matched;
+  }
+
+  return matched>0 ? std::sqrt(sum / matched) : 0.;
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  int t1 = 35, t2 = 50, t3 = 60, hsw = 15;
+  if (argc>=6) {
+    t1 = std::atoi(argv[2]);
+    t2 = std::atoi(argv[3]);
+    t3 = std::atoi(argv[4]);
+    hsw = std::atoi(argv[5]);
+  }
+
+  QImage image;
+  SampleDots dots;
+  dots.nDots = 0;
+
+  if (argc>=2) {
+    DefoMeasurement measurement(QString(argv[1]), false);
+    image = measurement.getImage();
+    if (image.isNull()) {
+      std::cerr << "could not read image " << argv[1] << std::endl;
+      return 1;
+    }
+  } else {
+    // 10000 dots on a 16 MP image
+    image = makeSample(dots, 100, 40, 2.5, 200., 20., 3.);
+  }
+
+  DefoImagePlanes planes(image);
+  const QRect searchArea = image.rect();
+  const QPolygonF roi;
+
+  QElapsedTimer timer;
+
+  DefoPointFinder cogFinder(&planes, false);
+  timer.start();
+  DefoPointCollection* cogPoints = cogFinder.findPoints(&searchArea, &roi, t1, t2, t3, hsw);
+  const double cogSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  DefoPointCollection fitPoints(*cogPoints);
+  timer.start();
+  const int nFitted = cogFinder.fitPositions(&fitPoints, hsw);
+  const double fitSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  double shift = 0.;
+  for (size_t i=0;i<fitPoints.size();++i) {
+    shift += std::hypot(fitPoints[i].getX() - cogPoints->at(i).getX(),
+                        fitPoints[i].getY() - cogPoints->at(i).getY());
+  }
+  if (!fitPoints.empty()) shift /= fitPoints.size();
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "points found:         " << cogPoints->size() << std::endl;
+  std::cout << "points fitted:        " << nFitted << std::endl;
+  std::cout << "point search:         " << cogSeconds << " s" << std::endl;
+  std::cout << "2D fits:              " << fitSeconds << " s (single thread)" << std::endl;
+  std::cout << std::setprecision(4);
+  std::cout << "mean shift COG - fit: " << shift << " px" << std::endl;
+
+  bool passed = nFitted > 0;
+
+  if (dots.nDots>0) {
+    int matchedCog, matchedFit;
+    const double rmsCog = rmsDeviation(cogPoints, dots, matchedCog);
+    const double rmsFit = rmsDeviation(&fitPoints, dots, matchedFit);
+
+    std::cout << "RMS deviation COG:    " << rmsCog << " px" << std::endl;
+    std::cout << "RMS deviation fit:    " << rmsFit << " px" << std::endl;
+
+    passed = passed && matchedCog==dots.nDots*dots.nDots && rmsFit<rmsCog;
+  }
+
+  delete cogPoints;
+
+  return passed ? 0 : 1;
+}
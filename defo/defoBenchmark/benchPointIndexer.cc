@@ -0,0 +1,270 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include "DefoPropagationPointIndexer.h"
+
+/*
+  Indexes a slightly rotated and jittered grid of points, given in random
+  order and with a few holes, with DefoPropagationPointIndexer and with
+  the original propagation over the full collection, which is kept here
+  as reference. Every point has to end up with the same index, or be left
+  unindexed by both. The new indexer is timed with serial and parallel
+  propagation.
+
+  usage: benchPointIndexer [columns [rows]]
+ */
+
+typedef std::vector<DefoPoint*> PointVector;
+enum Axis { X, Y };
+enum Direction { Forward, Backward };
+
+DefoPoint * legacyFindSeed(DefoPointCollection* points, const QColor& seedColor)
+{
+  DefoPoint * temp = 0;
+  for (DefoPointCollection::iterator it = points->begin();
+       it != points->end();
+       ++it) {
+    if (it->hasReferenceColor(seedColor)) {
+      temp = &(*it);
+    }
+  }
+
+  return temp;
+}
+
+void legacyDetermineGrid(DefoPointCollection* points, const DefoPoint* seed,
+                         double& dx, double& dy, double& d)
+{
+  double tdx, tdy, td, mindx = 1.e6, mindy = 1.e6, mind = 1.e6;
+  for (DefoPointCollection::iterator it = points->begin();
+       it != points->end();
+       ++it) {
+    td = seed->getDistanceXY((*it), tdx, tdy);
+
+    if (td<20.0) continue;
+    if (std::fabs(tdx)<20.0 || std::fabs(tdy)<20.0) continue;
+    if ((std::fabs(tdx)<std::fabs(mindx) || std::fabs(tdy)<std::fabs(mindy)) &&
+        td < mind) {
+      mindx = tdx;
+      mindy = tdy;
+      mind = td;
+    }
+  }
+
+  dx = std::fabs(mindx);
+  dy = std::fabs(mindy);
+  d = mind;
+}
+
+DefoPoint * legacyFindNeighbour(DefoPointCollection* points, const DefoPoint* seed,
+                                Axis axis, Direction direction, double window)
+{
+  double min = 1.e6;
+  double dx, dy, d;
+  DefoPoint* nextPoint = 0;
+  for (DefoPointCollection::iterator it = points->begin();
+       it != points->end();
+       ++it) {
+    d = seed->getDistanceXY(*it, dx, dy);
+    if (d<20.0) continue;
+
+    if (axis==X) {
+      if (std::fabs(dy)>window) continue;
+      if (direction==Forward && dx>0) continue;
+      if (direction==Backward && dx<0) continue;
+      if (std::fabs(dx)<std::fabs(min)) {
+        min = dx;
+        nextPoint = &(*it);
+      }
+    } else {
+      if (std::fabs(dx)>window) continue;
+      if (direction==Forward && dy>0) continue;
+      if (direction==Backward && dy<0) continue;
+      if (std::fabs(dy)<std::fabs(min)) {
+        min = dy;
+        nextPoint = &(*it);
+      }
+    }
+  }
+
+  return nextPoint;
+}
+
+void legacyIndexPoints(DefoPointCollection *points, const QColor& seedColor)
+{
+  for (DefoPointCollection::iterator it = points->begin();
+       it != points->end();
+       ++it) {
+    it->unindex();
+  }
+
+  DefoPoint * seed = legacyFindSeed(points, seedColor);
+  if (!seed) return;
+  seed->setIndex(0, 0);
+
+  double dx, dy, d;
+  legacyDetermineGrid(points, seed, dx, dy, d);
+
+  PointVector horizontalSeeds;
+  horizontalSeeds.push_back(seed);
+
+  DefoPoint* currentPoint;
+  DefoPoint* nextPoint;
+
+  currentPoint = seed;
+  nextPoint = legacyFindNeighbour(points, currentPoint, X, Forward, dy/2.0);
+  while (nextPoint) {
+    nextPoint->setIndex(currentPoint->getIndex().first+1, currentPoint->getIndex().second);
+    horizontalSeeds.push_back(nextPoint);
+    currentPoint = nextPoint;
+    nextPoint = legacyFindNeighbour(points, currentPoint, X, Forward, dy/2.0);
+  }
+
+  currentPoint = seed;
+  nextPoint = legacyFindNeighbour(points, currentPoint, X, Backward, dy/2.0);
+  while (nextPoint) {
+    nextPoint->setIndex(currentPoint->getIndex().first-1, currentPoint->getIndex().second);
+    horizontalSeeds.push_back(nextPoint);
+    currentPoint = nextPoint;
+    nextPoint = legacyFindNeighbour(points, currentPoint, X, Backward, dy/2.0);
+  }
+
+  for (PointVector::iterator it = horizontalSeeds.begin();
+       it != horizontalSeeds.end();
+       ++it) {
+
+    currentPoint = *it;
+    nextPoint = legacyFindNeighbour(points, currentPoint, Y, Forward, dx/2.0);
+    while (nextPoint) {
+      nextPoint->setIndex(currentPoint->getIndex().first, currentPoint->getIndex().second-1);
+      currentPoint = nextPoint;
+      nextPoint = legacyFindNeighbour(points, currentPoint, Y, Forward, dx/2.0);
+    }
+
+    currentPoint = *it;
+    nextPoint = legacyFindNeighbour(points, currentPoint, Y, Backward, dx/2.0);
+    while (nextPoint) {
+      nextPoint->setIndex(currentPoint->getIndex().first, currentPoint->getIndex().second+1);
+      currentPoint = nextPoint;
+      nextPoint = legacyFindNeighbour(points, currentPoint, Y, Backward, dx/2.0);
+    }
+  }
+
+  DefoPointCollection& pointsRef = *points;
+  std::sort(pointsRef.begin(), pointsRef.end());
+}
+
+// the indexers sort by index, which leaves the order of points with
+// equal or no index open, so the results are compared by position
+bool precedesByPosition(const DefoPoint& left, const DefoPoint& right)
+{
+  if (left.getX()==right.getX()) return left.getY() < right.getY();
+  return left.getX() < right.getX();
+}
+
+bool sameIndices(DefoPointCollection a, DefoPointCollection b)
+{
+  if (a.size()!=b.size()) return false;
+
+  std::sort(a.begin(), a.end(), precedesByPosition);
+  std::sort(b.begin(), b.end(), precedesByPosition);
+
+  for (size_t i=0;i<a.size();++i) {
+    if (a[i].getX()!=b[i].getX() || a[i].getY()!=b[i].getY()) return false;
+    if (a[i].isIndexed()!=b[i].isIndexed()) return false;
+    if (a[i].isIndexed() && a[i].getIndex()!=b[i].getIndex()) return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  const int nColumns = argc>=2 ? std::atoi(argv[1]) : 120;
+  const int nRows = argc>=3 ? std::atoi(argv[2]) : 120;
+
+  // 30 px spacing, rotated by 1 degree, 1 px jitter and 1% of the
+  // points missing; the seed sits near the centre
+  std::mt19937 generator(4711);
+  std::uniform_real_distribution<double> jitter(-1.0, 1.0);
+  std::uniform_real_distribution<double> hole(0.0, 1.0);
+
+  const double spacing = 30.0;
+  const double angle = 1.0 * M_PI / 180.;
+  const QColor pointColor(Qt::white);
+  const QColor seedColor(Qt::red);
+
+  DefoPointCollection points;
+  for (int c=0;c<nColumns;++c) {
+    for (int r=0;r<nRows;++r) {
+      const bool isSeed = c==nColumns/2 && r==nRows/2;
+      if (!isSeed && hole(generator)<0.01) continue;
+
+      const double u = spacing * c + jitter(generator);
+      const double v = spacing * r + jitter(generator);
+      DefoPoint point(100. + u * std::cos(angle) - v * std::sin(angle),
+                      100. + u * std::sin(angle) + v * std::cos(angle));
+      point.setColor(isSeed ? seedColor : pointColor);
+      points.push_back(point);
+    }
+  }
+  std::shuffle(points.begin(), points.end(), generator);
+
+  QElapsedTimer timer;
+
+  DefoPointCollection legacy(points);
+  timer.start();
+  legacyIndexPoints(&legacy, seedColor);
+  const double legacySeconds = 1.e-9 * timer.nsecsElapsed();
+
+  DefoPropagationPointIndexer indexer;
+
+  DefoPointCollection serial(points);
+  indexer.setParallelPropagation(false);
+  timer.start();
+  indexer.indexPoints(&serial, seedColor);
+  const double serialSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  DefoPointCollection parallel(points);
+  indexer.setParallelPropagation(true);
+  timer.start();
+  indexer.indexPoints(&parallel, seedColor);
+  const double parallelSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  size_t indexed = 0;
+  for (DefoPointCollection::const_iterator it = legacy.begin();it!=legacy.end();++it) {
+    if (it->isIndexed()) ++indexed;
+  }
+
+  const bool identical = sameIndices(legacy, serial) && sameIndices(legacy, parallel);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "points:              " << points.size() << " (" << indexed << " indexed)" << std::endl;
+  std::cout << "legacy full scan:    " << 1000. * legacySeconds << " ms" << std::endl;
+  std::cout << "point grid:          " << 1000. * serialSeconds << " ms" << std::endl;
+  std::cout << "point grid, threads: " << 1000. * parallelSeconds << " ms" << std::endl;
+  std::cout << "identical:           " << (identical ? "yes" : "NO") << std::endl;
+
+  return identical ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <random>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QRunnable>
+
+#include "DefoMeasurementListModel.h"
+#include "DefoPointCollectionBuilder.h"
+
+/*
+  Appends blocks of points with sub-pixel duplicates to the list model
+  from several threads, like the point finders do, and compares the
+  result with the original copy and pairwise cleanup of the collection,
+  which is kept here as reference. Both have to keep the same points in
+  the same order. The longest time a reader waited for a snapshot during
+  the appends is reported as well.
+
+  usage: benchPointMerge [blocks [points per block]]
+ */
+
+void legacyAppend(DefoPointCollection*& current, const DefoPointCollection& points)
+{
+  DefoPointCollection* newPoints = current ? new DefoPointCollection(*current) : new DefoPointCollection();
+  newPoints->insert(newPoints->end(), points.begin(), points.end());
+
+  for (DefoPointCollection::iterator it1 = newPoints->begin();
+       it1 != newPoints->end();
+       ++it1) {
+    if ((*it1).isValid()==false) continue;
+
+    for (DefoPointCollection::iterator it2 = it1+1;
+         it2 != newPoints->end();
+         ++it2) {
+      if ((*it2).isValid()==false) continue;
+      if (it1->getDistance(*it2)<1.0) (*it2).setValid(false);
+    }
+  }
+
+  for (DefoPointCollection::iterator it1 = newPoints->begin();
+       it1 != newPoints->end();) {
+    if ((*it1).isValid()==false) {
+      it1 = newPoints->erase(it1);
+    } else {
+      ++it1;
+    }
+  }
+
+  delete current;
+  current = newPoints;
+}
+
+class AppendTask : public QRunnable
+{
+public:
+  AppendTask(DefoMeasurementListModel* model, DefoMeasurement* measurement,
+             const DefoPointCollection* points)
+    : model_(model), measurement_(measurement), points_(points) { }
+  void run() { model_->appendMeasurementPoints(measurement_, points_); }
+protected:
+  DefoMeasurementListModel* model_;
+  DefoMeasurement* measurement_;
+  const DefoPointCollection* points_;
+};
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  const int nBlocks = argc>=2 ? std::atoi(argv[1]) : 32;
+  const int nPoints = argc>=3 ? std::atoi(argv[2]) : 500;
+
+  // dots on a 20 px grid, found several times within 0.3 px, so every
+  // dot is kept exactly once whatever the order of the blocks
+  std::mt19937 generator(4711);
+  std::uniform_int_distribution<int> grid(0, 199);
+  std::uniform_real_distribution<double> offset(-0.3, 0.3);
+
+  std::vector<DefoPointCollection> blocks(nBlocks);
+  for (int b=0;b<nBlocks;++b) {
+    for (int i=0;i<nPoints;++i) {
+      blocks[b].push_back(DefoPoint(20. * grid(generator) + offset(generator),
+                                    20. * grid(generator) + offset(generator)));
+    }
+  }
+
+  QElapsedTimer timer;
+
+  DefoPointCollection* legacy = 0;
+  timer.start();
+  for (int b=0;b<nBlocks;++b) legacyAppend(legacy, blocks[b]);
+  const double legacySeconds = 1.e-9 * timer.nsecsElapsed();
+
+  // single thread, so the order of the blocks is the same
+  DefoMeasurementListModel listModel;
+  DefoMeasurement measurement(QString("bench.jpg"), false);
+  listModel.addMeasurement(&measurement);
+
+  timer.start();
+  for (int b=0;b<nBlocks;++b) listModel.appendMeasurementPoints(&measurement, &blocks[b]);
+  const double builderSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  DefoPointSnapshot merged = listModel.getMeasurementPointSnapshot(&measurement);
+  bool identical = merged && merged->size()==legacy->size();
+  for (size_t i=0;identical && i<merged->size();++i) {
+    identical = merged->at(i).getX()==legacy->at(i).getX() &&
+        merged->at(i).getY()==legacy->at(i).getY();
+  }
+
+  // all blocks at once from the thread pool while reading snapshots
+  DefoMeasurementListModel threadedModel;
+  threadedModel.addMeasurement(&measurement);
+
+  QThreadPool pool;
+  timer.start();
+  for (int b=0;b<nBlocks;++b) {
+    pool.start(new AppendTask(&threadedModel, &measurement, &blocks[b]));
+  }
+
+  QElapsedTimer readTimer;
+  qint64 maxReadNanoseconds = 0;
+  int reads = 0;
+  while (!pool.waitForDone(0)) {
+    readTimer.start();
+    DefoPointSnapshot snapshot = threadedModel.getMeasurementPointSnapshot(&measurement);
+    maxReadNanoseconds = std::max(maxReadNanoseconds, readTimer.nsecsElapsed());
+    ++reads;
+  }
+  const double threadedSeconds = 1.e-9 * timer.nsecsElapsed();
+
+  DefoPointSnapshot threaded = threadedModel.getMeasurementPointSnapshot(&measurement);
+  const bool complete = threaded && merged && threaded->size()==merged->size();
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "points appended:     " << nBlocks * nPoints << " in " << nBlocks << " blocks" << std::endl;
+  std::cout << "points kept:         " << legacy->size() << " (legacy) "
+            << (merged ? merged->size() : 0) << " (builder) "
+            << (threaded ? threaded->size() : 0) << " (threaded)" << std::endl;
+  std::cout << "legacy copy/cleanup: " << 1000. * legacySeconds << " ms" << std::endl;
+  std::cout << "builder:             " << 1000. * builderSeconds << " ms" << std::endl;
+  std::cout << "builder, " << pool.maxThreadCount() << " threads: " << 1000. * threadedSeconds << " ms" << std::endl;
+  std::cout << "longest read:        " << 1.e-3 * maxReadNanoseconds << " us in " << reads << " reads" << std::endl;
+  std::cout << "identical:           " << (identical ? "yes" : "NO") << std::endl;
+
+  delete legacy;
+
+  return identical && complete ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <algorithm>
+
+#include "DefoGaussFitter.h"
+
+DefoGaussFitter::DefoGaussFitter(int halfSquareWidth)
+  : width_(0),
+    height_(0),
+    iterations_(0)
+{
+  std::fill(p_, p_ + NPar, 0.);
+  reserve(2 * halfSquareWidth + 1, 2 * halfSquareWidth + 1);
+}
+
+void DefoGaussFitter::reserve(int width, int height)
+{
+  if ((int)ex_.size()<width || (int)ey_.size()<height) {
+    const int w = std::max(width, (int)ex_.size());
+    const int h = std::max(height, (int)ey_.size());
+    z_.resize((size_t)w * h);
+    used_.resize((size_t)w * h);
+    ex_.resize(w);
+    ux_.resize(w);
+    ey_.resize(h);
+    uy_.resize(h);
+  }
+}
+
+/**
+ * Returns chi^2 of the parameters p. If jtj is not null, the lower
+ * triangle of J^T J and J^T r are filled as well.
+ *
+ * Parameters: A, x0, y0, sx, sy, b
+ */
+double DefoGaussFitter::evaluate(const double* p, double* jtj, double* jtr)
+{
+  const double ax = 1. / p[3];
+  const double ay = 1. / p[4];
+
+  for (int i=0;i<width_;++i) {
+    ux_[i] = (i - p[1]) * ax;
+    ex_[i] = std::exp(-0.5 * ux_[i] * ux_[i]);
+  }
+  for (int j=0;j<height_;++j) {
+    uy_[j] = (j - p[2]) * ay;
+    ey_[j] = std::exp(-0.5 * uy_[j] * uy_[j]);
+  }
+
+  if (jtj) {
+    std::fill(jtj, jtj + NPar*NPar, 0.);
+    std::fill(jtr, jtr + NPar, 0.);
+  }
+
+  double chisq = 0.;
+  double d[NPar];
+
+  for (int j=0;j<height_;++j) {
+    const double* z = &z_[(size_t)j * width_];
+    const unsigned char* used = &used_[(size_t)j * width_];
+    const double uy = uy_[j];
+
+    for (int i=0;i<width_;++i) {
+      if (!used[i]) continue;
+
+      const double g = ex_[i] * ey_[j];
+      const double f = p[0] * g;
+      const double r = z[i] - f - p[5];
+      chisq += r * r;
+
+      if (!jtj) continue;
+
+      const double ux = ux_[i];
+      d[0] = g;
+      d[1] = f * ux * ax;
+      d[2] = f * uy * ay;
+      d[3] = d[1] * ux;
+      d[4] = d[2] * uy;
+      d[5] = 1.;
+
+      for (int k=0;k<NPar;++k) {
+        jtr[k] += d[k] * r;
+        for (int l=0;l<=k;++l) jtj[k*NPar+l] += d[k] * d[l];
+      }
+    }
+  }
+
+  return chisq;
+}
+
+/**
+ * Solves (A + lambda diag(A)) x = b by Cholesky decomposition, A being
+ * given by its lower triangle. Returns false if the matrix is not
+ * positive definite.
+ */
+bool DefoGaussFitter::solve(const double* a, const double* b, double lambda, double* x)
+{
+  double l[NPar*NPar];
+
+  for (int k=0;k<NPar;++k) {
+    for (int m=0;m<=k;++m) {
+      double s = a[k*NPar+m];
+      if (m==k) s *= 1. + lambda;
+      for (int n=0;n<m;++n) s -= l[k*NPar+n] * l[m*NPar+n];
+      if (m==k) {
+        if (!(s>0.)) return false;
+        l[k*NPar+k] = std::sqrt(s);
+      } else {
+        l[k*NPar+m] = s / l[m*NPar+m];
+      }
+    }
+  }
+
+  double y[NPar];
+  for (int k=0;k<NPar;++k) {
+    double s = b[k];
+    for (int n=0;n<k;++n) s -= l[k*NPar+n] * y[n];
+    y[k] = s / l[k*NPar+k];
+  }
+  for (int k=NPar-1;k>=0;--k) {
+    double s = y[k];
+    for (int n=k+1;n<NPar;++n) s -= l[n*NPar+k] * x[n];
+    x[k] = s / l[k*NPar+k];
+  }
+
+  return true;
+}
+
+bool DefoGaussFitter::fit(const DefoImagePlanes& planes,
+                          const QRect& area,
+                          const DefoPoint& start,
+                          DefoPoint& result)
+{
+  iterations_ = 0;
+
+  QRect realArea = area & planes.rect();
+  if (realArea.width()<5 || realArea.height()<5) return false;
+
+  // start values: background and amplitude from the darkest and brightest
+  // pixel, width from the number of pixels above half maximum
+  int zmin = 255;
+  int zmax = 0;
+  for (int y=realArea.y();y<realArea.y()+realArea.height();++y) {
+    const unsigned char* line = planes.grayLine(y);
+    for (int x=realArea.x();x<realArea.x()+realArea.width();++x) {
+      zmin = std::min(zmin, (int)line[x]);
+      zmax = std::max(zmax, (int)line[x]);
+    }
+  }
+
+  if (zmax-zmin<4) return false;
+
+  const int halfMaximum = (zmin + zmax) / 2;
+  int nAbove = 0;
+  for (int y=realArea.y();y<realArea.y()+realArea.height();++y) {
+    const unsigned char* line = planes.grayLine(y);
+    for (int x=realArea.x();x<realArea.x()+realArea.width();++x) {
+      nAbove += line[x] > halfMaximum;
+    }
+  }
+
+  // area above half maximum is 2 pi ln(2) sigma^2
+  const double sigma = std::max(1., std::sqrt(nAbove / 4.355));
+
+  // the profile is fitted up to four sigma from the start position
+  const int radius = std::max(3, (int)std::ceil(4. * sigma));
+  const QRect fitArea((int)std::floor(start.getX()) - radius + 1,
+                      (int)std::floor(start.getY()) - radius + 1,
+                      2 * radius,
+                      2 * radius);
+  realArea &= fitArea;
+  if (realArea.width()<5 || realArea.height()<5) return false;
+
+  width_ = realArea.width();
+  height_ = realArea.height();
+  reserve(width_, height_);
+
+  const int left = realArea.x();
+  const int top = realArea.y();
+
+  // copy the luminance of the area, pixel (i,j) is at (left+i, top+j)
+  int nUsed = 0;
+  for (int j=0;j<height_;++j) {
+    const unsigned char* line = planes.grayLine(top + j) + left;
+    double* z = &z_[(size_t)j * width_];
+    unsigned char* used = &used_[(size_t)j * width_];
+    for (int i=0;i<width_;++i) {
+      z[i] = line[i];
+      used[i] = line[i] < 255;
+      nUsed += used[i];
+    }
+  }
+
+  if (nUsed<=2*NPar) return false;
+
+  const double maxSigma = 0.5 * std::max(area.width(), area.height());
+
+  double p[NPar];
+  p[0] = zmax - zmin;
+  p[1] = start.getX() - left;
+  p[2] = start.getY() - top;
+  p[3] = std::min(maxSigma, sigma);
+  p[4] = std::min(maxSigma, sigma);
+  p[5] = zmin;
+
+  double jtj[NPar*NPar], jtr[NPar], delta[NPar], trial[NPar];
+
+  double chisq = evaluate(p, jtj, jtr);
+  double lambda = 1.e-3;
+  bool converged = false;
+
+  for (iterations_=1;iterations_<=50;++iterations_) {
+
+    if (!solve(jtj, jtr, lambda, delta)) {
+      lambda *= 10.;
+      if (lambda>1.e8) break;
+      continue;
+    }
+
+    for (int k=0;k<NPar;++k) trial[k] = p[k] + delta[k];
+
+    if (!(trial[3]>0.3 && trial[4]>0.3 &&
+          trial[3]<2.*maxSigma && trial[4]<2.*maxSigma)) {
+      lambda *= 10.;
+      if (lambda>1.e8) break;
+      continue;
+    }
+
+    const double trialChisq = evaluate(trial, 0, 0);
+
+    if (trialChisq<chisq) {
+      const bool small = std::fabs(delta[1])<1.e-4 && std::fabs(delta[2])<1.e-4;
+      const bool flat = (chisq - trialChisq) <= 1.e-10 * chisq;
+
+      std::copy(trial, trial + NPar, p);
+      chisq = evaluate(p, jtj, jtr);
+      lambda = std::max(1.e-7, 0.1 * lambda);
+
+      if (small || flat) {
+        converged = true;
+        break;
+      }
+    } else {
+      lambda *= 10.;
+      if (lambda>1.e8) {
+        // no further improvement possible, p is at the minimum
+        converged = true;
+        break;
+      }
+    }
+  }
+
+  std::copy(p, p + NPar, p_);
+
+  if (!converged) return false;
+
+  // reject fits that are not a dot inside of the area
+  if (!(p[0]>0.) ||
+      p[1]<0. || p[1]>width_-1 ||
+      p[2]<0. || p[2]>height_-1) return false;
+
+  result = start;
+  result.setPosition(left + p[1], top + p[2]);
+
+  return true;
+}
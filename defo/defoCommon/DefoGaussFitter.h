@@ -0,0 +1,77 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEFOGAUSSFITTER_H
+#define DEFOGAUSSFITTER_H
+
+#include <vector>
+
+#include <QRect>
+
+#include "DefoImagePlanes.h"
+#include "DefoPoint.h"
+
+///
+/// Sub-pixel position of a grid dot from a Levenberg-Marquardt fit of
+///
+///   z(x,y) = b + A exp(-(x-x0)^2/(2 sx^2) - (y-y0)^2/(2 sy^2))
+///
+/// to the luminance of the pixels in a square around the dot. The model
+/// is separable, so an iteration needs one exponential per row and per
+/// column of the square only, and the Jacobian is computed analytically.
+/// Saturated pixels do not constrain the profile and are left out.
+///
+/// All buffers are allocated once and reused for every fit, so a fitter
+/// must not be shared between threads; use one fitter per thread.
+///
+class DefoGaussFitter
+{
+public:
+
+  explicit DefoGaussFitter(int halfSquareWidth = 15);
+
+  /// Fits the dot in area starting at start. Returns false and leaves
+  /// result unchanged if the fit did not converge or ended up outside of
+  /// the area.
+  bool fit(const DefoImagePlanes& planes,
+           const QRect& area,
+           const DefoPoint& start,
+           DefoPoint& result);
+
+  int getIterations() const { return iterations_; }
+  double getAmplitude() const { return p_[0]; }
+  double getSigmaX() const { return p_[3]; }
+  double getSigmaY() const { return p_[4]; }
+  double getBackground() const { return p_[5]; }
+
+protected:
+
+  enum { NPar = 6 };
+
+  void reserve(int width, int height);
+  double evaluate(const double* p, double* jtj, double* jtr);
+  static bool solve(const double* a, const double* b, double lambda, double* x);
+
+  int width_;
+  int height_;
+  int iterations_;
+  double p_[NPar];
+
+  std::vector<double> z_;
+  std::vector<unsigned char> used_;
+  std::vector<double> ex_;
+  std::vector<double> ey_;
+  std::vector<double> ux_;
+  std::vector<double> uy_;
+};
+
+#endif // DEFOGAUSSFITTER_H
@@ -10,17 +10,24 @@
 //                                                                             //
 /////////////////////////////////////////////////////////////////////////////////
 
-#include <opencv2/highgui/highgui.hpp>
+#include <cmath>
+#include <algorithm>
+#include <future>
 
 #include <QColor>
 
 #include <nqlogger.h>
-#include <nmatrix.h>
 
 #include "DefoImageAverager.h"
 
-DefoImageAverager::DefoImageAverager(const QStringList& filenames)
-:filenames_(filenames)
+DefoImageAverager::DefoImageAverager(const QStringList& filenames,
+                                     Method method,
+                                     double kappa)
+:filenames_(filenames),
+ method_(method),
+ kappa_(kappa),
+ width_(0),
+ height_(0)
 {
   for (auto filename : filenames_) {
     NQLogMessage("DefoImageAverager") << filename;
@@ -32,67 +39,228 @@ DefoImageAverager::~DefoImageAverager()
 
 }
 
-QImage DefoImageAverager::getAveragedImage()
+QImage DefoImageAverager::loadImage(const QString& filename)
 {
-  int width, height;
+  QImage image(filename);
+  if (!image.isNull() && image.format()!=QImage::Format_RGB32) {
+    image = image.convertToFormat(QImage::Format_RGB32);
+  }
+  return image;
+}
 
-  QImage ret(filenames_.front());
-  width = ret.width();
-  height = ret.height();
+/**
+  Calls process for every image of the same size as the first image that
+  decodes. While process is running, the next image is already decoded on
+  another thread. Returns the number of processed images.
+  */
+int DefoImageAverager::streamImages(std::function<void(const QImage&)> process)
+{
+  int count = 0;
 
-  /*
-  NMatrix<unsigned short> red(width, height);
-  NMatrix<unsigned short> green(width, height);
-  NMatrix<unsigned short> blue(width, height);
+  std::future<QImage> next = std::async(std::launch::async,
+                                        &DefoImageAverager::loadImage,
+                                        filenames_.front());
 
-  int count = 0;
-  for (QString filename : filenames_) {
-    IplImage *img = cvLoadImage(filename.toStdString().c_str());
-    IplImage *imgRed = cvCreateImage(cvGetSize(img), 8, 1);
-    IplImage *imgGreen = cvCreateImage(cvGetSize(img), 8, 1);
-    IplImage *imgBlue = cvCreateImage(cvGetSize(img), 8, 1);
-    cvSplit(img, imgRed, imgGreen, imgBlue, NULL);
-    cvReleaseImage(&img);
+  for (int i=0;i<filenames_.size();++i) {
 
-    for (int w=0;w<width;w++) {
-      for (int h=0;h<height;h++) {
+    QImage current = next.get();
+    if (i+1<filenames_.size()) {
+      next = std::async(std::launch::async,
+                        &DefoImageAverager::loadImage,
+                        filenames_.at(i+1));
+    }
 
+    if (current.isNull()) {
+      NQLogWarning("DefoImageAverager") << "skipping " << filenames_.at(i)
+                                        << ": cannot be decoded";
+      continue;
+    }
+
+    if (width_==0) {
+      width_ = current.width();
+      height_ = current.height();
+    }
+
+    if (current.width()!=width_ || current.height()!=height_) {
+      NQLogWarning("DefoImageAverager") << "skipping " << filenames_.at(i)
+                                        << ": " << current.width() << "x" << current.height()
+                                        << " instead of " << width_ << "x" << height_;
+      continue;
+    }
+
+    process(current);
+    count++;
+  }
+
+  return count;
+}
+
+QImage DefoImageAverager::getAveragedImage()
+{
+  if (filenames_.size()==0) return QImage();
+
+  if (method_==SigmaClippedMean) return getSigmaClippedMean();
+  if (method_==Median) return getMedian();
+
+  std::vector<quint32> sum;
+
+  int count = streamImages([&](const QImage& image) {
+      if (sum.size()==0) sum.resize(3 * width_ * height_, 0);
+      for (int h=0;h<height_;h++) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(h));
+        quint32* s = &sum[3 * h * width_];
+        for (int w=0;w<width_;w++) {
+          const QRgb rgb = line[w];
+          s[3*w+0] += qRed(rgb);
+          s[3*w+1] += qGreen(rgb);
+          s[3*w+2] += qBlue(rgb);
+        }
       }
+    });
+
+  return getMean(sum, count);
+}
+
+QImage DefoImageAverager::getMean(const std::vector<quint32>& sum, int count) const
+{
+  if (count==0) return QImage();
+
+  QImage ret(width_, height_, QImage::Format_RGB32);
+
+  for (int h=0;h<height_;h++) {
+    QRgb* line = reinterpret_cast<QRgb*>(ret.scanLine(h));
+    const quint32* s = &sum[3 * h * width_];
+    for (int w=0;w<width_;w++) {
+      line[w] = qRgb(s[3*w+0]/count,
+                     s[3*w+1]/count,
+                     s[3*w+2]/count);
     }
   }
+
+  return ret;
+}
+
+/**
+  First pass determines mean and standard deviation of every channel of
+  every pixel, the second pass averages only the values within kappa
+  standard deviations of the mean.
   */
+QImage DefoImageAverager::getSigmaClippedMean()
+{
+  std::vector<quint32> sum;
+  std::vector<quint32> sum2;
+
+  int count = streamImages([&](const QImage& image) {
+      if (sum.size()==0) {
+        sum.resize(3 * width_ * height_, 0);
+        sum2.resize(3 * width_ * height_, 0);
+      }
+      for (int h=0;h<height_;h++) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(h));
+        quint32* s = &sum[3 * h * width_];
+        quint32* s2 = &sum2[3 * h * width_];
+        for (int w=0;w<width_;w++) {
+          const QRgb rgb = line[w];
+          const quint32 r = qRed(rgb), g = qGreen(rgb), b = qBlue(rgb);
+          s[3*w+0] += r; s2[3*w+0] += r*r;
+          s[3*w+1] += g; s2[3*w+1] += g*g;
+          s[3*w+2] += b; s2[3*w+2] += b*b;
+        }
+      }
+    });
 
-  NMatrix<unsigned short> red(width, height);
-  NMatrix<unsigned short> green(width, height);
-  NMatrix<unsigned short> blue(width, height);
+  if (count<3) return getMean(sum, count);
 
-  int count = 0;
-  for (QString filename : filenames_) {
+  // acceptance window [low, high] per channel
+  std::vector<float> low(sum.size());
+  std::vector<float> high(sum.size());
+  for (size_t i=0;i<sum.size();++i) {
+    const float mean = float(sum[i]) / count;
+    const float variance = std::max(0.f, float(sum2[i]) / count - mean * mean);
+    const float window = kappa_ * std::sqrt(variance);
+    low[i] = mean - window;
+    high[i] = mean + window;
+  }
 
-    QImage temp(filename);
+  std::vector<quint32>().swap(sum2);
+  std::vector<quint32> clippedSum(sum.size(), 0);
+  std::vector<quint32> clippedCount(sum.size(), 0);
 
-    for (int w=0;w<width;w++) {
-      for (int h=0;h<height;h++) {
-        QRgb rgb = temp.pixel(w, h);
+  streamImages([&](const QImage& image) {
+      for (int h=0;h<height_;h++) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(h));
+        const size_t offset = 3 * h * width_;
+        for (int w=0;w<width_;w++) {
+          const QRgb rgb = line[w];
+          const quint32 v[3] = { quint32(qRed(rgb)), quint32(qGreen(rgb)), quint32(qBlue(rgb)) };
+          for (int c=0;c<3;++c) {
+            const size_t i = offset + 3*w + c;
+            const bool accept = v[c]>=low[i] && v[c]<=high[i];
+            clippedSum[i] += accept ? v[c] : 0;
+            clippedCount[i] += accept;
+          }
+        }
+      }
+    });
 
-        int r = qRed(rgb);
-        int g = qGreen(rgb);
-        int b = qBlue(rgb);
+  QImage ret(width_, height_, QImage::Format_RGB32);
 
-        red(w, h) += r;
-        green(w, h) += g;
-        blue(w, h) += b;
+  for (int h=0;h<height_;h++) {
+    QRgb* line = reinterpret_cast<QRgb*>(ret.scanLine(h));
+    const size_t offset = 3 * h * width_;
+    for (int w=0;w<width_;w++) {
+      int v[3];
+      for (int c=0;c<3;++c) {
+        const size_t i = offset + 3*w + c;
+        v[c] = clippedCount[i]>0 ? clippedSum[i]/clippedCount[i] : sum[i]/count;
       }
+      line[w] = qRgb(v[0], v[1], v[2]);
     }
-
-    count++;
   }
 
-  for (int w=0;w<width;w++) {
-    for (int h=0;h<height;h++) {
-      ret.setPixel(w, h, qRgb(red(w, h)/count,
-                              green(w, h)/count,
-                              blue(w, h)/count));
+  return ret;
+}
+
+/**
+  The median needs all values of a pixel at once, so all frames are kept
+  in memory.
+  */
+QImage DefoImageAverager::getMedian()
+{
+  std::vector<QImage> images;
+
+  int count = streamImages([&](const QImage& image) {
+      images.push_back(image);
+    });
+
+  if (count==0) return QImage();
+
+  QImage ret(width_, height_, QImage::Format_RGB32);
+
+  std::vector<const QRgb*> lines(count);
+  std::vector<unsigned char> values[3];
+  for (int c=0;c<3;++c) values[c].resize(count);
+  const int mid = count / 2;
+
+  for (int h=0;h<height_;h++) {
+    for (int i=0;i<count;++i) {
+      lines[i] = reinterpret_cast<const QRgb*>(images[i].constScanLine(h));
+    }
+    QRgb* line = reinterpret_cast<QRgb*>(ret.scanLine(h));
+
+    for (int w=0;w<width_;w++) {
+      for (int i=0;i<count;++i) {
+        const QRgb rgb = lines[i][w];
+        values[0][i] = qRed(rgb);
+        values[1][i] = qGreen(rgb);
+        values[2][i] = qBlue(rgb);
+      }
+      int v[3];
+      for (int c=0;c<3;++c) {
+        std::nth_element(values[c].begin(), values[c].begin() + mid, values[c].end());
+        v[c] = values[c][mid];
+      }
+      line[w] = qRgb(v[0], v[1], v[2]);
     }
   }
 
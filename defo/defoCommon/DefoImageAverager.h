@@ -13,14 +13,34 @@
 #ifndef DEFOIMAGEAVERAGER_H
 #define DEFOIMAGEAVERAGER_H
 
+#include <vector>
+#include <functional>
+
 #include <QStringList>
 #include <QImage>
 
+///
+/// Averages a series of images of the same size pixel by pixel.
+///
+/// The images are streamed: the next file is decoded on a background
+/// thread while the current one is accumulated row by row into 32 bit
+/// per channel sums. Besides the plain mean, a sigma clipped mean (second
+/// streaming pass that drops values further than kappa sigma from the
+/// mean) and a median (keeps all frames in memory) are available.
+///
 class DefoImageAverager
 {
 public:
 
-  explicit DefoImageAverager(const QStringList& filenames);
+  enum Method {
+    Mean,
+    SigmaClippedMean,
+    Median
+  };
+
+  explicit DefoImageAverager(const QStringList& filenames,
+                             Method method = Mean,
+                             double kappa = 3.0);
   ~DefoImageAverager();
 
   QImage getAveragedImage();
@@ -28,6 +48,18 @@ public:
 protected:
 
   QStringList filenames_;
+  Method method_;
+  double kappa_;
+
+  int width_;
+  int height_;
+
+  static QImage loadImage(const QString& filename);
+  int streamImages(std::function<void(const QImage&)> process);
+
+  QImage getMean(const std::vector<quint32>& sum, int count) const;
+  QImage getSigmaClippedMean();
+  QImage getMedian();
 };
 
 #endif // DEFOIMAGEAVERAGER_H
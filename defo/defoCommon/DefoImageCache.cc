@@ -0,0 +1,364 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include <QRunnable>
+#include <QImageReader>
+#include <QMatrix>
+
+#include <nqlogger.h>
+
+#include "ApplicationConfig.h"
+
+#include "DefoImageAverager.h"
+#include "DefoImageCache.h"
+
+class DefoImageCache::Task : public QRunnable
+{
+public:
+  Task(DefoImageCache* cache, const QStringList& locations, bool thumbnail)
+    : cache_(cache), locations_(locations), thumbnail_(thumbnail) { }
+  void run() {
+    {
+      QMutexLocker locker(&cache_->mutex_);
+      if (thumbnail_) {
+        cache_->queuedThumbnails_.remove(key(locations_));
+      } else {
+        cache_->queued_.remove(key(locations_));
+      }
+    }
+    if (thumbnail_) {
+      cache_->getThumbnail(locations_);
+    } else {
+      cache_->getImage(locations_);
+    }
+  }
+protected:
+  DefoImageCache* cache_;
+  QStringList locations_;
+  bool thumbnail_;
+};
+
+DefoImageCache* DefoImageCache::instance()
+{
+  static DefoImageCache* instance = new DefoImageCache();
+
+  return instance;
+}
+
+DefoImageCache::DefoImageCache(QObject *parent)
+  : QObject(parent),
+    thumbnailSize_(128)
+{
+  statistics_.hits = 0;
+  statistics_.misses = 0;
+  statistics_.prefetched = 0;
+  statistics_.thumbnails = 0;
+  statistics_.imageBytes = 0;
+  statistics_.thumbnailBytes = 0;
+
+  ApplicationConfig* config = ApplicationConfig::instance();
+  setMemoryBudget(1024LL * 1024LL * config->getDefaultValue<int>("IMAGE_CACHE_SIZE", 1024));
+  setThumbnailBudget(1024LL * 1024LL * config->getDefaultValue<int>("THUMBNAIL_CACHE_SIZE", 32));
+
+  // leave the cores to the point recognition
+  prefetchPool_.setMaxThreadCount(2);
+}
+
+QString DefoImageCache::key(const QStringList& locations)
+{
+  return locations.join('\n');
+}
+
+/// cost of an image in the caches in kB
+int DefoImageCache::cost(const QImage& image)
+{
+  return std::max(1, (int)((qint64)image.bytesPerLine() * image.height() / 1024));
+}
+
+/**
+  Averaging method of images taken from several files, read from
+  IMAGE_AVERAGING (mean, sigmaclip or median).
+  */
+DefoImageAverager::Method DefoImageCache::averagingMethod()
+{
+  const std::string method = ApplicationConfig::instance()->getDefaultValue("IMAGE_AVERAGING", std::string("mean"));
+
+  if (method=="sigmaclip") return DefoImageAverager::SigmaClippedMean;
+  if (method=="median") return DefoImageAverager::Median;
+  if (method!="mean") {
+    NQLogWarning("DefoImageCache") << "unknown IMAGE_AVERAGING " << method.c_str() << ", using mean";
+  }
+
+  return DefoImageAverager::Mean;
+}
+
+double DefoImageCache::averagingKappa()
+{
+  return ApplicationConfig::instance()->getDefaultValue<double>("IMAGE_AVERAGING_KAPPA", 3.0);
+}
+
+/**
+  Decodes an image, averaging it from several files if needed, and
+  rotates it by 90 degrees.
+  */
+QImage DefoImageCache::decodeImage(const QStringList& locations)
+{
+  NQLogDebug("DefoImageCache") << "decodeImage " << locations.size();
+
+  QImage temp;
+
+  if (locations.size()==0) {
+    return temp;
+  } else if (locations.size()==1) {
+    temp = QImage(locations.front());
+  } else {
+    DefoImageAverager averager(locations, averagingMethod(), averagingKappa());
+    temp = averager.getAveragedImage();
+  }
+
+  QMatrix matrix;
+  matrix.rotate(90);
+
+  return temp.transformed(matrix);
+}
+
+/**
+  Decodes the first file of an image at reduced size, which the JPEG
+  decoder does at a fraction of the cost of a full decode.
+  */
+QImage DefoImageCache::decodeThumbnail(const QStringList& locations, int size)
+{
+  if (locations.size()==0) return QImage();
+
+  QImageReader reader(locations.front());
+  const QSize imageSize = reader.size();
+  if (imageSize.isValid()) {
+    reader.setScaledSize(imageSize.scaled(size, size, Qt::KeepAspectRatio));
+  }
+
+  QImage temp = reader.read();
+  if (temp.isNull()) return temp;
+
+  if (temp.width()>size || temp.height()>size) {
+    temp = temp.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  }
+
+  QMatrix matrix;
+  matrix.rotate(90);
+
+  return temp.transformed(matrix);
+}
+
+QImage DefoImageCache::insertImage(const QString& key, const QImage& image)
+{
+  if (!image.isNull()) {
+    sizes_[key] = image.size();
+    images_.insert(key, new QImage(image), cost(image));
+  }
+
+  return image;
+}
+
+/**
+  Returns the image, decoding it if it is not in the cache. If another
+  thread is already decoding the same image, the call waits for it.
+  */
+QImage DefoImageCache::getImage(const QStringList& locations)
+{
+  if (locations.size()==0) return QImage();
+
+  const QString k = key(locations);
+
+  {
+    QMutexLocker locker(&mutex_);
+
+    for (;;) {
+      QImage* image = images_.object(k);
+      if (image) {
+        statistics_.hits++;
+        return *image;
+      }
+      if (!pending_.contains(k)) break;
+      decoded_.wait(&mutex_);
+    }
+
+    pending_.insert(k);
+    statistics_.misses++;
+  }
+
+  QImage image = decodeImage(locations);
+
+  QMutexLocker locker(&mutex_);
+  pending_.remove(k);
+  insertImage(k, image);
+  decoded_.wakeAll();
+
+  return image;
+}
+
+/**
+  Returns the thumbnail, scaled from the image if that is cached or
+  decoded at reduced size otherwise.
+  */
+QImage DefoImageCache::getThumbnail(const QStringList& locations)
+{
+  if (locations.size()==0) return QImage();
+
+  const QString k = key(locations);
+  QImage image;
+
+  {
+    QMutexLocker locker(&mutex_);
+
+    for (;;) {
+      QImage* thumbnail = thumbnails_.object(k);
+      if (thumbnail) return *thumbnail;
+      if (!pendingThumbnails_.contains(k)) break;
+      decoded_.wait(&mutex_);
+    }
+
+    pendingThumbnails_.insert(k);
+    statistics_.thumbnails++;
+
+    QImage* cached = images_.object(k);
+    if (cached) image = *cached;
+  }
+
+  QImage thumbnail;
+  if (image.isNull()) {
+    thumbnail = decodeThumbnail(locations, thumbnailSize_);
+  } else {
+    thumbnail = image.scaled(thumbnailSize_, thumbnailSize_,
+                             Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  }
+
+  {
+    QMutexLocker locker(&mutex_);
+    pendingThumbnails_.remove(k);
+    if (!thumbnail.isNull()) {
+      thumbnails_.insert(k, new QImage(thumbnail), cost(thumbnail));
+    }
+    decoded_.wakeAll();
+  }
+
+  if (!thumbnail.isNull()) emit thumbnailReady(locations);
+
+  return thumbnail;
+}
+
+/**
+  Returns the size of the (rotated) image without decoding it.
+  */
+QSize DefoImageCache::getImageSize(const QStringList& locations)
+{
+  if (locations.size()==0) return QSize();
+
+  const QString k = key(locations);
+
+  {
+    QMutexLocker locker(&mutex_);
+    QHash<QString,QSize>::const_iterator it = sizes_.constFind(k);
+    if (it!=sizes_.constEnd()) return it.value();
+  }
+
+  // averaged images have the size of their inputs
+  QImageReader reader(locations.front());
+  QSize size = reader.size();
+  if (size.isValid()) {
+    size.transpose();
+  } else {
+    size = getImage(locations).size();
+  }
+
+  QMutexLocker locker(&mutex_);
+  sizes_[k] = size;
+
+  return size;
+}
+
+void DefoImageCache::prefetchImage(const QStringList& locations)
+{
+  if (locations.size()==0) return;
+
+  {
+    QMutexLocker locker(&mutex_);
+    const QString k = key(locations);
+    if (images_.contains(k) || pending_.contains(k) || queued_.contains(k)) return;
+    queued_.insert(k);
+    statistics_.prefetched++;
+  }
+
+  prefetchPool_.start(new Task(this, locations, false), 1);
+}
+
+void DefoImageCache::prefetchThumbnail(const QStringList& locations)
+{
+  if (locations.size()==0) return;
+
+  {
+    QMutexLocker locker(&mutex_);
+    const QString k = key(locations);
+    if (pendingThumbnails_.contains(k) || queuedThumbnails_.contains(k)) return;
+    if (thumbnails_.contains(k)) {
+      locker.unlock();
+      emit thumbnailReady(locations);
+      return;
+    }
+    queuedThumbnails_.insert(k);
+  }
+
+  prefetchPool_.start(new Task(this, locations, true), 0);
+}
+
+void DefoImageCache::setMemoryBudget(qint64 bytes)
+{
+  QMutexLocker locker(&mutex_);
+  images_.setMaxCost(std::max(1, (int)(bytes / 1024)));
+}
+
+qint64 DefoImageCache::getMemoryBudget() const
+{
+  QMutexLocker locker(&mutex_);
+  return 1024LL * images_.maxCost();
+}
+
+void DefoImageCache::setThumbnailBudget(qint64 bytes)
+{
+  QMutexLocker locker(&mutex_);
+  thumbnails_.setMaxCost(std::max(1, (int)(bytes / 1024)));
+}
+
+DefoImageCache::Statistics DefoImageCache::getStatistics() const
+{
+  QMutexLocker locker(&mutex_);
+
+  Statistics statistics = statistics_;
+  statistics.imageBytes = 1024LL * images_.totalCost();
+  statistics.thumbnailBytes = 1024LL * thumbnails_.totalCost();
+
+  return statistics;
+}
+
+void DefoImageCache::clear()
+{
+  prefetchPool_.clear();
+
+  QMutexLocker locker(&mutex_);
+  images_.clear();
+  thumbnails_.clear();
+  sizes_.clear();
+  // the prefetches removed from the pool will not run
+  queued_.clear();
+  queuedThumbnails_.clear();
+}
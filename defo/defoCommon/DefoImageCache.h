@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEFOIMAGECACHE_H
+#define DEFOIMAGECACHE_H
+
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+
+#include "DefoImageAverager.h"
+
+///
+/// Shared cache of the decoded (and rotated) images of the measurements.
+///
+/// Images are decoded on first use and kept in a least recently used
+/// cache with a memory budget. A separate, much smaller tier keeps low
+/// resolution thumbnails for the list widgets; they are decoded directly
+/// at reduced size and never need the full image. Images and thumbnails
+/// can be decoded ahead of time on a background thread.
+///
+/// An image is identified by the list of files it is averaged from. The
+/// budgets are read from IMAGE_CACHE_SIZE and THUMBNAIL_CACHE_SIZE (MB),
+/// the averaging of images from several files from IMAGE_AVERAGING and
+/// IMAGE_AVERAGING_KAPPA.
+///
+class DefoImageCache : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  struct Statistics
+  {
+    unsigned long hits;         // images taken from the cache
+    unsigned long misses;       // images decoded, including prefetches
+    unsigned long prefetched;   // images decoded ahead of time
+    unsigned long thumbnails;   // thumbnails decoded or scaled
+    qint64 imageBytes;          // memory held by the images
+    qint64 thumbnailBytes;      // memory held by the thumbnails
+  };
+
+  static DefoImageCache* instance();
+
+  QImage getImage(const QStringList& locations);
+  QImage getThumbnail(const QStringList& locations);
+  QSize getImageSize(const QStringList& locations);
+
+  void prefetchImage(const QStringList& locations);
+  void prefetchThumbnail(const QStringList& locations);
+
+  void setMemoryBudget(qint64 bytes);
+  qint64 getMemoryBudget() const;
+  void setThumbnailBudget(qint64 bytes);
+  int getThumbnailSize() const { return thumbnailSize_; }
+
+  Statistics getStatistics() const;
+  void clear();
+
+  static QImage decodeImage(const QStringList& locations);
+  static QImage decodeThumbnail(const QStringList& locations, int size);
+
+  static DefoImageAverager::Method averagingMethod();
+  static double averagingKappa();
+
+protected:
+
+  explicit DefoImageCache(QObject *parent = 0);
+
+  class Task;
+
+  static QString key(const QStringList& locations);
+  static int cost(const QImage& image);
+
+  QImage insertImage(const QString& key, const QImage& image);
+
+  mutable QMutex mutex_;
+  QWaitCondition decoded_;
+
+  QCache<QString,QImage> images_;
+  QCache<QString,QImage> thumbnails_;
+  QHash<QString,QSize> sizes_;
+  QSet<QString> pending_;
+  QSet<QString> pendingThumbnails_;
+  /// prefetches waiting in the pool, so a request is only queued once
+  QSet<QString> queued_;
+  QSet<QString> queuedThumbnails_;
+
+  int thumbnailSize_;
+  Statistics statistics_;
+
+  QThreadPool prefetchPool_;
+
+signals:
+
+  void thumbnailReady(const QStringList& locations);
+};
+
+#endif // DEFOIMAGECACHE_H
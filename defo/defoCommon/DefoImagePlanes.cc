@@ -0,0 +1,204 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "DefoImagePlanes.h"
+
+DefoImagePlanes::DefoImagePlanes()
+  : width_(0),
+    height_(0),
+    hasColor_(false)
+{
+
+}
+
+DefoImagePlanes::DefoImagePlanes(const QImage& image, bool withColor)
+  : width_(0),
+    height_(0),
+    hasColor_(false)
+{
+  setImage(image, withColor);
+}
+
+void DefoImagePlanes::setImage(const QImage& image, bool withColor)
+{
+  // QImage::pixel() returns unpremultiplied ARGB values for every format,
+  // converting to (A)RGB32 once gives exactly the same channel values.
+  QImage rgb;
+  if (image.format()==QImage::Format_RGB32 || image.format()==QImage::Format_ARGB32) {
+    rgb = image;
+  } else if (image.hasAlphaChannel()) {
+    rgb = image.convertToFormat(QImage::Format_ARGB32);
+  } else {
+    rgb = image.convertToFormat(QImage::Format_RGB32);
+  }
+
+  width_ = rgb.width();
+  height_ = rgb.height();
+  hasColor_ = withColor;
+
+  const size_t n = (size_t)width_ * height_;
+  gray_.resize(n);
+  if (hasColor_) {
+    red_.resize(n);
+    green_.resize(n);
+    blue_.resize(n);
+  } else {
+    red_.clear();
+    green_.clear();
+    blue_.clear();
+  }
+
+  for (int y=0;y<height_;++y) {
+    const QRgb* line = reinterpret_cast<const QRgb*>(rgb.constScanLine(y));
+    unsigned char* g = &gray_[(size_t)y*width_];
+
+    if (hasColor_) {
+      unsigned char* r = &red_[(size_t)y*width_];
+      unsigned char* gr = &green_[(size_t)y*width_];
+      unsigned char* b = &blue_[(size_t)y*width_];
+      for (int x=0;x<width_;++x) {
+        const QRgb pixel = line[x];
+        r[x] = qRed(pixel);
+        gr[x] = qGreen(pixel);
+        b[x] = qBlue(pixel);
+        g[x] = qGray(pixel);
+      }
+    } else {
+      for (int x=0;x<width_;++x) {
+        g[x] = qGray(line[x]);
+      }
+    }
+  }
+}
+
+int DefoImagePlanes::findAbove(int y, int begin, int end, int threshold) const
+{
+  if (threshold<0) return begin<end ? begin : end;
+  if (threshold>=255) return end;
+
+  const unsigned char* line = grayLine(y);
+  int x = begin;
+
+#if defined(__SSE2__)
+  // v > threshold  <=>  max(v, threshold+1) == v for unsigned bytes
+  const __m128i limit = _mm_set1_epi8((char)(threshold+1));
+  for (;x+16<=end;x+=16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x));
+    const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, limit), v));
+    if (mask) return x + __builtin_ctz(mask);
+  }
+#endif
+
+  for (;x<end;++x) {
+    if (line[x]>threshold) return x;
+  }
+
+  return end;
+}
+
+/**
+ * Sums are accumulated as integers, which is exact and therefore identical
+ * to the per-pixel double sums of the QImage based implementation while
+ * allowing the compiler to vectorise the inner loop.
+ */
+DefoPoint DefoImagePlanes::getCenterOfGravity(const QRect& area,
+                                              int threshold) const
+{
+  DefoPoint weightedSum(0, 0);
+
+  if (area.isNull()) return weightedSum;
+
+  const QRect realArea = area & rect();
+  if (realArea.isEmpty()) return weightedSum;
+
+  const int left = realArea.x();
+  const int right = realArea.x() + realArea.width();
+  const int bottom = realArea.y() + realArea.height();
+
+  long long totalGray = 0;
+  long long weightedX = 0;
+  long long weightedY = 0;
+
+  for (int y = realArea.y(); y < bottom; ++y) {
+    const unsigned char* line = grayLine(y);
+
+    int rowGray = 0;
+    long long rowX = 0;
+    for (int x = left; x < right; ++x) {
+      const int gray = line[x];
+      const int w = gray > threshold ? gray : 0;
+      rowGray += w;
+      rowX += x * w;
+    }
+
+    totalGray += rowGray;
+    weightedX += rowX;
+    weightedY += (long long)y * rowGray;
+  }
+
+  if (totalGray > 0)
+    weightedSum.setPosition((double)weightedX/totalGray, (double)weightedY/totalGray);
+
+  return weightedSum;
+}
+
+const QColor DefoImagePlanes::getAverageColor(const QRect& area,
+                                              int threshold) const
+{
+  QRect realArea = area & rect();
+  QColor average(0, 0, 0);
+
+  if (realArea.isNull() || !hasColor_) return average;
+
+  const int left = realArea.x();
+  const int right = realArea.x() + realArea.width();
+  const int bottom = realArea.y() + realArea.height();
+
+  long long red = 0;
+  long long green = 0;
+  long long blue = 0;
+  int totalBrightness = 0;
+
+  for (int y = realArea.y(); y < bottom; ++y) {
+    const unsigned char* g = grayLine(y);
+    const unsigned char* r = redLine(y);
+    const unsigned char* gr = greenLine(y);
+    const unsigned char* b = blueLine(y);
+
+    int rowRed = 0;
+    int rowGreen = 0;
+    int rowBlue = 0;
+    int rowBrightness = 0;
+    for (int x = left; x < right; ++x) {
+      const int brightness = g[x] > threshold ? g[x] : 0;
+      rowRed += r[x] * brightness;
+      rowGreen += gr[x] * brightness;
+      rowBlue += b[x] * brightness;
+      rowBrightness += brightness;
+    }
+
+    red += rowRed;
+    green += rowGreen;
+    blue += rowBlue;
+    totalBrightness += rowBrightness;
+  }
+
+  average.setRgb((double)red/totalBrightness,
+                 (double)green/totalBrightness,
+                 (double)blue/totalBrightness);
+
+  return average;
+}
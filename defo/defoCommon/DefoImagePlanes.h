@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEFOIMAGEPLANES_H
+#define DEFOIMAGEPLANES_H
+
+#include <vector>
+
+#include <QImage>
+#include <QRect>
+#include <QColor>
+
+#include "DefoPoint.h"
+
+///
+/// Contiguous 8-bit planes (luminance plus red, green and blue) of a
+/// measurement image. The image is converted once; afterwards all point
+/// recognition loops walk the planes with plain row pointers instead of
+/// calling QImage::pixel() and qGray() for every pixel.
+///
+/// The luminance plane uses the same integer weights as qGray(), so all
+/// results are bit-identical to the QImage based code.
+///
+class DefoImagePlanes
+{
+public:
+
+  DefoImagePlanes();
+  explicit DefoImagePlanes(const QImage& image, bool withColor = true);
+
+  void setImage(const QImage& image, bool withColor = true);
+
+  bool isNull() const { return width_==0 || height_==0; }
+  int width() const { return width_; }
+  int height() const { return height_; }
+  QRect rect() const { return QRect(0, 0, width_, height_); }
+  bool hasColor() const { return hasColor_; }
+
+  const unsigned char* grayLine(int y) const { return &gray_[(size_t)y*width_]; }
+  const unsigned char* redLine(int y) const { return &red_[(size_t)y*width_]; }
+  const unsigned char* greenLine(int y) const { return &green_[(size_t)y*width_]; }
+  const unsigned char* blueLine(int y) const { return &blue_[(size_t)y*width_]; }
+
+  int gray(int x, int y) const { return gray_[(size_t)y*width_+x]; }
+
+  /// Returns the first x in [begin, end) of row y with a luminance above
+  /// threshold or end if there is none.
+  int findAbove(int y, int begin, int end, int threshold) const;
+
+  /// Grayscale weighted center of gravity of all pixels in area with a
+  /// luminance above threshold. Returns (0,0) if there are none.
+  DefoPoint getCenterOfGravity(const QRect& area, int threshold) const;
+
+  /// Luminance weighted average color of all pixels in area with a
+  /// luminance above threshold.
+  const QColor getAverageColor(const QRect& area, int threshold) const;
+
+protected:
+
+  int width_;
+  int height_;
+  bool hasColor_;
+
+  std::vector<unsigned char> gray_;
+  std::vector<unsigned char> red_;
+  std::vector<unsigned char> green_;
+  std::vector<unsigned char> blue_;
+};
+
+#endif // DEFOIMAGEPLANES_H
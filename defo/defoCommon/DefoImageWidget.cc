@@ -310,12 +310,10 @@ void DefoImagePointsWidget::paintEvent(QPaintEvent *event)
 
   DefoMeasurement* measurement = selectionModel_->getSelection();
 
-  if ( measurement != NULL &&
-      listModel_->getMeasurementPoints(measurement) != NULL &&
-      listModel_->getMeasurementPoints(measurement)->size() > 0) {
+  DefoPointSnapshot points;
+  if (measurement != NULL) points = listModel_->getMeasurementPointSnapshot(measurement);
 
-    const DefoPointCollection* points =
-        listModel_->getMeasurementPoints(measurement);
+  if (points && points->size() > 0) {
 
     QPainter painter(this);
 
@@ -16,7 +16,7 @@
 #include <QXmlStreamWriter>
 
 #include "DefoExifReader.h"
-#include "DefoImageAverager.h"
+#include "DefoImageCache.h"
 
 #include "DefoMeasurement.h"
 
@@ -32,7 +32,8 @@ DefoMeasurement::DefoMeasurement(const QString& imageLocation, bool preview)
     previewImage_(preview)
 {
   imageLocations_.append(imageLocation);
-  readImages();
+
+  if (previewImage_) readPreviewImage();
 }
 
 DefoMeasurement::DefoMeasurement(const QStringList& imageLocations)
@@ -40,37 +41,40 @@ DefoMeasurement::DefoMeasurement(const QStringList& imageLocations)
     imageLocations_(imageLocations),
     previewImage_(false)
 {
-  readImages();
+
 }
 
-void DefoMeasurement::readImages()
+/**
+  Previews are temporary camera files, which the camera deletes later
+  on, so their image is decoded right away and kept with the measurement
+  instead of in the image cache.
+  */
+void DefoMeasurement::readPreviewImage()
 {
-  NQLogMessage("DefoMeasurement") << "readImages " << imageLocations_.size();
+  NQLogDebug("DefoMeasurement") << "readPreviewImage";
 
-  if (imageLocations_.size()==0) {
+  previewImageData_ = DefoImageCache::decodeImage(imageLocations_);
+}
 
-    return;
+/**
+  Decodes the images of the measurement into the image cache now instead
+  of on the first call of getImage().
+  */
+void DefoMeasurement::readImages() const
+{
+  if (previewImage_) return;
 
-  } else if (imageLocations_.size()==1) {
+  NQLogDebug("DefoMeasurement") << "readImages " << imageLocations_.size();
 
-    if (image_.isNull()) {
-      QImage temp(imageLocations_.front());
-      QMatrix matrix;
-      matrix.rotate(90);
-      image_ = temp.transformed(matrix);
-    }
-
-  } else {
+  DefoImageCache::instance()->getImage(imageLocations_);
+}
 
-    if (image_.isNull()) {
-      DefoImageAverager averager(imageLocations_);
-      QImage temp(averager.getAveragedImage());
-      QMatrix matrix;
-      matrix.rotate(90);
-      image_ = temp.transformed(matrix);
-    }
+/// Decodes the images of the measurement in the background.
+void DefoMeasurement::prefetchImages() const
+{
+  if (previewImage_) return;
 
-  }
+  DefoImageCache::instance()->prefetchImage(imageLocations_);
 }
 
 void DefoMeasurement::setTimeStamp(const QDateTime& dt)
@@ -85,28 +89,48 @@ const QDateTime & DefoMeasurement::getTimeStamp() const
 
 QImage DefoMeasurement::getImage() const
 {
-  return image_;
+  if (previewImage_) return previewImageData_;
+
+  return DefoImageCache::instance()->getImage(imageLocations_);
+}
+
+QImage DefoMeasurement::getThumbnail() const
+{
+  if (previewImage_) {
+    const int size = DefoImageCache::instance()->getThumbnailSize();
+    return previewImageData_.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  }
+
+  return DefoImageCache::instance()->getThumbnail(imageLocations_);
 }
 
 int DefoMeasurement::getWidth() const
 {
-  return image_.width();
+  if (previewImage_) return previewImageData_.width();
+
+  return DefoImageCache::instance()->getImageSize(imageLocations_).width();
 }
 
 int DefoMeasurement::getHeight() const
 {
-  return image_.height();
+  if (previewImage_) return previewImageData_.height();
+
+  return DefoImageCache::instance()->getImageSize(imageLocations_).height();
 }
 
 void DefoMeasurement::setImageLocation(const QString& imageLocation)
 {
   imageLocations_.clear();
   imageLocations_.append(imageLocation);
+
+  if (previewImage_) readPreviewImage();
 }
 
 void DefoMeasurement::setImageLocations(const QStringList& imageLocations)
 {
   imageLocations_ = imageLocations;
+
+  if (previewImage_) readPreviewImage();
 }
 
 void DefoMeasurement::readExifData()
@@ -46,6 +46,7 @@ public:
   void setTimeStamp(const QDateTime& dt);
   const QDateTime& getTimeStamp() const;
   QImage getImage() const;
+  QImage getThumbnail() const;
 
   float getFocalLength() const { return exifFocalLength_; }
   float getExposureTime() const { return exifExposureTime_; }
@@ -73,6 +74,7 @@ public:
 
   void setImageLocation(const QString& imageLocation);
   void setImageLocations(const QStringList& imageLocations);
+  const QStringList& getImageLocations() const { return imageLocations_; }
   void readExifData();
   void acquireData(const DefoCameraModel* model);
   void acquireData(const DefoPointRecognitionModel* model);
@@ -83,18 +85,22 @@ public:
   virtual void write(const QDir& path);
   virtual void read(const QDir&path);
 
-  void readImages();
+  void readImages() const;
+  void prefetchImages() const;
 
 protected:
 
   /// (Local) date and time of measurement.
   QDateTime timestamp_;
-  /// Image of the actual 'raw' measurement.
+  /// Image of the actual 'raw' measurement, decoded on first use into
+  /// the DefoImageCache.
   QStringList imageLocations_;
 
-  QImage image_;
-
   bool previewImage_;
+  /// Image of a preview, which is kept since its file is temporary.
+  QImage previewImageData_;
+
+  void readPreviewImage();
 
   std::vector<int> pointRecognitionThresholds_;
   int pointRecognitionHalfSquareWidth_;
@@ -10,6 +10,11 @@
 //                                                                             //
 /////////////////////////////////////////////////////////////////////////////////
 
+#include <QIcon>
+#include <QPixmap>
+
+#include "DefoImageCache.h"
+
 #include "DefoMeasurementListComboBox.h"
 
 DefoMeasurementListComboBox::DefoMeasurementListComboBox(
@@ -25,6 +30,8 @@ DefoMeasurementListComboBox::DefoMeasurementListComboBox(
   // No user editable text
   setEditable(false);
 
+  setIconSize(QSize(32, 32));
+
   // Copy values
   connect(
         listModel_
@@ -33,6 +40,14 @@ DefoMeasurementListComboBox::DefoMeasurementListComboBox(
       , SLOT(fillOptions(int))
   );
 
+  // Thumbnails are decoded in the background
+  connect(
+        DefoImageCache::instance()
+      , SIGNAL(thumbnailReady(QStringList))
+      , this
+      , SLOT(setThumbnail(QStringList))
+  );
+
   // Respond to selection changes
   connect(
         selectionModel_
@@ -60,18 +75,26 @@ void DefoMeasurementListComboBox::fillOptions(int count) {
 
   setEnabled(count > 0);
 
-  // FIXME this sets the selection to NULL
-  clear();
+  // Measurements are only appended to the list, or the list is cleared
+  if (count < this->count()) {
 
-  // Empty map
-  indexMap_.clear();
+    // FIXME this sets the selection to NULL
+    clear();
+
+    // Empty maps
+    indexMap_.clear();
+    rowMap_.clear();
+  }
+
+  const int first = this->count();
 
   const DefoMeasurement* measurement;
 
-  // Fill it up and add to view
-  for (int i = 0; i < count; ++i) {
+  // Add the new measurements to the view
+  for (int i = first; i < count; ++i) {
     measurement = listModel_->getMeasurement(i);
     indexMap_[measurement] = i;
+    rowMap_.insert(measurement->getImageLocations(), i);
     addItem(
         LABEL_FORMAT
           .arg(i+1)
@@ -80,10 +103,24 @@ void DefoMeasurementListComboBox::fillOptions(int count) {
     );
   }
 
+  for (int i = first; i < count; ++i) {
+    DefoImageCache::instance()->prefetchThumbnail(listModel_->getMeasurement(i)->getImageLocations());
+  }
+
   setSelection(selectionModel_->getSelection());
 
 }
 
+void DefoMeasurementListComboBox::setThumbnail(const QStringList& locations) {
+
+  QHash<QStringList,int>::const_iterator it = rowMap_.constFind(locations);
+  if (it == rowMap_.constEnd() || it.value() >= count()) return;
+
+  const QImage thumbnail = DefoImageCache::instance()->getThumbnail(locations);
+  setItemIcon(it.value(), QIcon(QPixmap::fromImage(thumbnail)));
+
+}
+
 void DefoMeasurementListComboBox::setSelection(
     DefoMeasurement *selection
 ) {
@@ -101,10 +138,12 @@ void DefoMeasurementListComboBox::setSelection(
 void DefoMeasurementListComboBox::selectionChanged(int index) {
 
   // Set NULL on no selection, or measurement on valid selection
-  if ( index == -1 )
+  if ( index == -1 ) {
     selectionModel_->setSelection(NULL);
-  else
+  } else {
     selectionModel_->setSelection( listModel_->getMeasurement(index) );
+    listModel_->prefetchImages( listModel_->getMeasurement(index) );
+  }
 
 }
 
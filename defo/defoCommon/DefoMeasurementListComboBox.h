@@ -14,6 +14,8 @@
 #define DEFOMEASUREMENTLISTCOMBOBOX_H
 
 #include <QComboBox>
+#include <QHash>
+#include <QStringList>
 #include "DefoMeasurementListModel.h"
 #include "DefoMeasurementSelectionModel.h"
 
@@ -42,10 +44,14 @@ protected:
   typedef std::map<const DefoMeasurement*, int> MeasurementMap;
   MeasurementMap indexMap_;
 
+  /// Rows of the measurements by image locations, for the thumbnails
+  QHash<QStringList, int> rowMap_;
+
 protected slots:
   void fillOptions(int count);
   void setSelection(DefoMeasurement* selection);
   void selectionChanged(int index);
+  void setThumbnail(const QStringList& locations);
 
 signals:
 
@@ -10,6 +10,8 @@
 //                                                                             //
 /////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include <QFile>
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
@@ -21,6 +23,13 @@ DefoMeasurementListModel::DefoMeasurementListModel(QObject *parent) :
     QObject(parent)
 {}
 
+DefoMeasurementListModel::~DefoMeasurementListModel()
+{
+  for (PointMap::iterator it = points_.begin(); it != points_.end(); ++it) {
+    delete it->second;
+  }
+}
+
 /**
   \brief Adds a deformation measurement to the list.
   \arg measurement DefoMeasurement to be added.
@@ -36,7 +45,8 @@ void DefoMeasurementListModel::addMeasurement(
   // Store measurement* in list
   measurementList_.push_back(measurement);
   // Set initial point collection to NULL, i.e. non existant
-  points_[measurement] = NULL;
+  if ( points_.find(measurement) == points_.end() )
+    points_[measurement] = new MeasurementPoints;
 
   emit measurementCountChanged( getMeasurementCount() );
 }
@@ -57,26 +67,61 @@ DefoMeasurement* DefoMeasurementListModel::getMeasurement(int i) {
   return measurementList_.at(i);
 }
 
-/**
-  Returns the point collection associated with the measurement, or NULL if
-  the image has not been scanned yet (or the measurement is not in the list).
-  */
-const DefoPointCollection* DefoMeasurementListModel::getMeasurementPoints(
+/// Returns the points of the measurement or NULL if it is not in the list.
+DefoMeasurementListModel::MeasurementPoints* DefoMeasurementListModel::findPoints(
     DefoMeasurement* measurement
 ) {
 
+  QMutexLocker locker(&mutex_);
+
   PointMap::const_iterator it = points_.find(measurement);
 
   if ( it == points_.end() )
     return NULL;
   else
     return it->second;
-
 }
 
+/**
+  Returns the current point collection of the measurement, or a null
+  snapshot if the image has not been scanned yet (or the measurement is
+  not in the list). The snapshot never changes and stays valid as long
+  as it is held, so callers keep the snapshot rather than a pointer to
+  its points. If points were merged since the last read, a new snapshot
+  is copied from the builder; while another thread is merging, the
+  previous snapshot is returned and pointsUpdated follows once the merge
+  is done.
+  */
+DefoPointSnapshot DefoMeasurementListModel::getMeasurementPointSnapshot(
+    DefoMeasurement* measurement
+) {
+
+  MeasurementPoints* entry = findPoints(measurement);
+
+  if ( entry == NULL )
+    return DefoPointSnapshot();
+
+  if ( entry->mergeMutex.tryLock() ) {
+
+    if ( entry->changed ) {
+      DefoPointSnapshot snapshot(new DefoPointCollection(entry->builder.getPoints()));
+      entry->changed = false;
+
+      QMutexLocker locker(&mutex_);
+      entry->snapshot = snapshot;
+    }
+
+    entry->mergeMutex.unlock();
+  }
+
+  QMutexLocker locker(&mutex_);
+
+  return entry->snapshot;
+}
 
 /**
-  Sets the current point collection for the given measurement.
+  Sets the current point collection for the given measurement. The list
+  model takes ownership of the collection.
   If the measurement is not already present, this will add the measurement to
   the list!
   If adding points to the current set, please use appendMeasurementPoints,
@@ -87,76 +132,58 @@ void DefoMeasurementListModel::setMeasurementPoints(
   , const DefoPointCollection *points
 ) {
 
-  if ( points_.find(measurement) == points_.end() )
+  if ( findPoints(measurement) == NULL )
     addMeasurement(measurement);
 
-  points_[measurement] = points;
-  emit pointsUpdated(measurement);
+  MeasurementPoints* entry = findPoints(measurement);
+  DefoPointSnapshot snapshot(points);
 
+  QMutexLocker mergeLocker(&entry->mergeMutex);
+
+  entry->builder.reset(points);
+  entry->changed = false;
+
+  {
+    QMutexLocker locker(&mutex_);
+    entry->snapshot = snapshot;
+  }
+
+  mergeLocker.unlock();
+
+  emit pointsUpdated(measurement);
 }
 
 /**
   Append the collection of points to the current collection of points.
-  This is equivalent to calling getMeasurementPoints, adding points to a copy
-  of that collection and then calling setMeasurementPoints with the extended
-  copy, but this function makes the whole proces thread safe.
+  Points closer than one pixel to a point that is already known are
+  dropped. The caller keeps ownership of the collection.
+
+  The points are merged into the measurement's builder by one thread at
+  a time, which only costs the size of the appended collection. Readers
+  never wait for a merge, the merged collection is published when it is
+  read next.
   */
 void DefoMeasurementListModel::appendMeasurementPoints(
     DefoMeasurement *measurement
   , const DefoPointCollection *points
 ) {
 
-  QMutexLocker locker(&mutex_);
+  if ( points == NULL ) return;
 
-  if ( points != NULL ) {
+  if ( findPoints(measurement) == NULL )
+    addMeasurement(measurement);
 
-    const DefoPointCollection* currentList = getMeasurementPoints(measurement);
-    DefoPointCollection* newPoints;
-    
-    if ( currentList != NULL ) {
-      newPoints = new DefoPointCollection(*currentList);
-    } else {
-      newPoints = new DefoPointCollection();
-    }
-    
-    // Insert given points
-    newPoints->insert(newPoints->end(), points->begin(), points->end());
+  MeasurementPoints* entry = findPoints(measurement);
 
-    cleanupPoints(newPoints);
+  QMutexLocker mergeLocker(&entry->mergeMutex);
 
-    // Set new points
-    setMeasurementPoints(measurement, newPoints);
-  }
-}
+  if ( entry->builder.append(*points) == 0 ) return;
 
-void DefoMeasurementListModel::cleanupPoints(DefoPointCollection* points)
-{
-  double d;
-  for (DefoPointCollection::iterator it1 = points->begin();
-       it1 != points->end();
-       ++it1) {
-    if ((*it1).isValid()==false) continue;
-
-    for (DefoPointCollection::iterator it2 = it1+1;
-         it2 != points->end();
-         ++it2) {
-      if ((*it2).isValid()==false) continue;
-
-      d = it1->getDistance(*it2);
-      if (d<1.0) {
-        (*it2).setValid(false);
-      }
-    }
-  }
+  entry->changed = true;
 
-  for (DefoPointCollection::iterator it1 = points->begin();
-       it1 != points->end();) {
-    if ((*it1).isValid()==false) {
-      points->erase(it1);
-    } else {
-      ++it1;
-    }
-  }
+  mergeLocker.unlock();
+
+  emit pointsUpdated(measurement);
 }
 
 void DefoMeasurementListModel::write(const QDir& path)
@@ -228,7 +255,7 @@ void DefoMeasurementListModel::writePoints(const QDir& path)
     DefoMeasurement* measurement = this->getMeasurement(i);
     if (measurement->isPreview()) continue;
 
-    const DefoPointCollection* points =this->getMeasurementPoints(measurement);
+    DefoPointSnapshot points = this->getMeasurementPointSnapshot(measurement);
     if (!points || points->size()==0) continue;
 
     QString fileLocation = path.absoluteFilePath(filename.arg(measurement->getTimeStamp().toString("yyyyMMddhhmmss")));
@@ -276,6 +303,9 @@ void DefoMeasurementListModel::writePoints(const QDir& path)
 
 void DefoMeasurementListModel::clear() {
   measurementList_.clear();
+  for (PointMap::iterator it = points_.begin(); it != points_.end(); ++it) {
+    delete it->second;
+  }
   points_.clear();
   emit measurementCountChanged(0);
 }
@@ -361,6 +391,25 @@ void DefoMeasurementListModel::readPoints(const QDir& path)
   }
 }
 
+/**
+  Decodes the images of the measurements next to the given one in the
+  background, so that stepping through the list does not wait for them.
+  */
+void DefoMeasurementListModel::prefetchImages(const DefoMeasurement* measurement, int range)
+{
+  std::vector<DefoMeasurement*>::const_iterator it = std::find(measurementList_.begin(),
+                                                               measurementList_.end(),
+                                                               measurement);
+  if (it == measurementList_.end()) return;
+
+  const int index = it - measurementList_.begin();
+
+  for (int d = 1; d <= range; ++d) {
+    if (index + d < getMeasurementCount()) getMeasurement(index + d)->prefetchImages();
+    if (index - d >= 0) getMeasurement(index - d)->prefetchImages();
+  }
+}
+
 DefoMeasurementPairListModel::DefoMeasurementPairListModel(QObject *parent) :
     QObject(parent)
 {}
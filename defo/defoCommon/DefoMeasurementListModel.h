@@ -18,9 +18,13 @@
 #include <QDateTime>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QSharedPointer>
 #include <QDir>
 
 #include "DefoMeasurement.h"
+#include "DefoPointCollectionBuilder.h"
+
+typedef QSharedPointer<const DefoPointCollection> DefoPointSnapshot;
 
 class DefoMeasurementListModel : public QObject
 {
@@ -28,6 +32,7 @@ class DefoMeasurementListModel : public QObject
 
 public:
   explicit DefoMeasurementListModel(QObject *parent = 0);
+  ~DefoMeasurementListModel();
 
   // Deformation measurements
   int getMeasurementCount() const;
@@ -35,7 +40,7 @@ public:
   DefoMeasurement* getMeasurement(int index);
 
   void addMeasurement(DefoMeasurement* measurement);
-  const DefoPointCollection* getMeasurementPoints(
+  DefoPointSnapshot getMeasurementPointSnapshot(
       DefoMeasurement* measurement
   );
   void setMeasurementPoints(
@@ -50,6 +55,8 @@ public:
   void read(const QString& filename);
   void readPoints(const QDir& path);
 
+  void prefetchImages(const DefoMeasurement* measurement, int range = 1);
+
 public slots:
 
   void appendMeasurementPoints(
@@ -60,10 +67,23 @@ public slots:
 protected:
   std::vector<DefoMeasurement*> measurementList_;
 
-  typedef std::map<DefoMeasurement*, const DefoPointCollection*> PointMap;
+  /// Points of a measurement. Appended collections are merged into the
+  /// builder by one thread at a time. The snapshot is only copied from the
+  /// builder when it is read after a merge, so any number of appends
+  /// between two reads cost a single copy.
+  struct MeasurementPoints
+  {
+    MeasurementPoints() : changed(false) { }
+    QMutex mergeMutex;                          // guards builder and changed
+    DefoPointCollectionBuilder builder;
+    bool changed;                               // builder is ahead of snapshot
+    DefoPointSnapshot snapshot;                 // guarded by mutex_
+  };
+
+  typedef std::map<DefoMeasurement*, MeasurementPoints*> PointMap;
   PointMap points_;
 
-  void cleanupPoints(DefoPointCollection* points);
+  MeasurementPoints* findPoints(DefoMeasurement* measurement);
 
   // For thread safety
   QMutex mutex_;
@@ -0,0 +1,50 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEFOPARALLELFOR_H
+#define DEFOPARALLELFOR_H
+
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <future>
+
+///
+/// run task(i) for i in [0, n) on all available cores,
+/// every thread works on a contiguous block of indices
+///
+template<class Task>
+void DefoParallelFor(int n, Task task)
+{
+  int nThreads = std::thread::hardware_concurrency();
+  nThreads = std::max(1, std::min(nThreads, n));
+
+  const int blockSize = (n + nThreads - 1) / nThreads;
+
+  std::vector<std::future<void> > blocks;
+  for (int begin = blockSize; begin < n; begin += blockSize) {
+    const int end = std::min(n, begin + blockSize);
+    blocks.push_back(std::async(std::launch::async,
+                                [=]() { for (int i = begin; i < end; ++i) task(i); }));
+  }
+
+  // the calling thread takes the first block
+  for (int i = 0; i < std::min(n, blockSize); ++i) task(i);
+
+  for (typename std::vector<std::future<void> >::iterator it = blocks.begin();
+       it != blocks.end();
+       ++it) {
+    it->get();
+  }
+}
+
+#endif // DEFOPARALLELFOR_H
@@ -0,0 +1,103 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include "DefoPointCollectionBuilder.h"
+
+DefoPointCollectionBuilder::DefoPointCollectionBuilder( double minDistance )
+  : minDistance_( minDistance > 0. ? minDistance : 1.0 )
+{
+
+}
+
+DefoPointCollectionBuilder::CellKey DefoPointCollectionBuilder::cellKey( int cx, int cy ) const {
+
+  return ( static_cast<CellKey>( cx ) << 32 ) ^ static_cast<unsigned int>( cy );
+}
+
+int DefoPointCollectionBuilder::cell( double v ) const {
+
+  return static_cast<int>( std::floor( v / minDistance_ ) );
+}
+
+///
+/// true if an accepted point lies closer than the minimum distance;
+/// such a point can only be in the cell of the point or its neighbours
+///
+bool DefoPointCollectionBuilder::isDuplicate( const DefoPoint& point ) const {
+
+  const int cx = cell( point.getX() );
+  const int cy = cell( point.getY() );
+
+  for( int y = cy - 1; y <= cy + 1; ++y ) {
+    for( int x = cx - 1; x <= cx + 1; ++x ) {
+      std::unordered_map<CellKey,std::vector<unsigned int> >::const_iterator it = cells_.find( cellKey( x, y ) );
+      if( it == cells_.end() ) continue;
+
+      for( std::vector<unsigned int>::const_iterator idx = it->second.begin();
+           idx != it->second.end();
+           ++idx ) {
+        if( point.getDistance( points_[*idx] ) < minDistance_ ) return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void DefoPointCollectionBuilder::insert( unsigned int index ) {
+
+  const DefoPoint& point = points_[index];
+  cells_[ cellKey( cell( point.getX() ), cell( point.getY() ) ) ].push_back( index );
+}
+
+///
+/// starts over with the given points, which are taken as they are
+///
+void DefoPointCollectionBuilder::reset( const DefoPointCollection* points ) {
+
+  cells_.clear();
+  points_.clear();
+
+  if( !points ) return;
+
+  points_ = *points;
+  cells_.reserve( points_.size() );
+  for( unsigned int i = 0; i < points_.size(); ++i ) insert( i );
+}
+
+///
+/// appends the valid points of the collection that are not duplicates of
+/// accepted points (or of earlier points of the same collection) and
+/// returns their number. The rejected points are squeezed out in a single
+/// stable pass over the appended range.
+///
+size_t DefoPointCollectionBuilder::append( const DefoPointCollection& points ) {
+
+  const size_t first = points_.size();
+  points_.insert( points_.end(), points.begin(), points.end() );
+  cells_.reserve( points_.size() );
+
+  size_t accepted = first;
+  for( size_t i = first; i < points_.size(); ++i ) {
+    if( !points_[i].isValid() || isDuplicate( points_[i] ) ) continue;
+
+    if( accepted != i ) points_[accepted] = points_[i];
+    insert( accepted );
+    ++accepted;
+  }
+
+  points_.resize( accepted );
+
+  return accepted - first;
+}
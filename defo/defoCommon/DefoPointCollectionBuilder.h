@@ -0,0 +1,54 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEFOPOINTCOLLECTIONBUILDER_H
+#define DEFOPOINTCOLLECTIONBUILDER_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "DefoPoint.h"
+
+///
+/// Accumulates the points found in a measurement, one collection at a
+/// time, and rejects points that lie closer than the minimum distance to
+/// a point already accepted. The accepted points are hashed in cells of
+/// the size of the minimum distance, so a duplicate check only looks at
+/// the points of the neighbouring cells. Accepted points keep the order in
+/// which they were appended, and the first point found at a position wins.
+///
+class DefoPointCollectionBuilder {
+
+ public:
+  explicit DefoPointCollectionBuilder( double minDistance = 1.0 );
+
+  void reset( const DefoPointCollection* points = 0 );
+  size_t append( const DefoPointCollection& points );
+
+  const DefoPointCollection& getPoints( void ) const { return points_; }
+  size_t size( void ) const { return points_.size(); }
+  double getMinDistance( void ) const { return minDistance_; }
+
+ private:
+  typedef long long CellKey;
+  CellKey cellKey( int cx, int cy ) const;
+  int cell( double v ) const;
+  bool isDuplicate( const DefoPoint& ) const;
+  void insert( unsigned int index );
+
+  double minDistance_;
+  DefoPointCollection points_;
+  std::unordered_map<CellKey,std::vector<unsigned int> > cells_;
+
+};
+
+#endif // DEFOPOINTCOLLECTIONBUILDER_H
@@ -13,87 +13,21 @@
 #include <cmath>
 #include <iostream>
 
-//#include <TString.h>
-
 #include <nqlogger.h>
 
 #include "DefoPointFinder.h"
 
-double twoDgauss(double *x, double *par)
-{
-  double r1 = (x[0]-par[1])/par[2];
-  double r2 = (x[1]-par[3])/par[4];
-
-  return par[0]*std::exp(-0.5*(r1*r1+r2*r2));
-}
-
-DefoPointFinder::DefoPointFinder(int block,
-                                 QMutex* mutex,
-                                 DefoMeasurementListModel *listModel,
-                                 DefoPointRecognitionModel *pointModel,
-                                 DefoMeasurement *measurement,
-                                 const QRect &searchRectangle,
-                                 bool do2Dfit,
-                                 DefoROIModel * roiModel)
-: block_(block),
-  mutex_(mutex),
-  listModel_(listModel),
-  pointModel_(pointModel),
-  measurement_(measurement),
-  searchArea_(searchRectangle),
-  do2Dfit_(do2Dfit),
-  roiModel_(roiModel)
+DefoPointFinder::DefoPointFinder(const DefoImagePlanes* planes,
+                                 bool do2Dfit)
+: planes_(planes),
+  do2Dfit_(do2Dfit)
 {
-  image_ = measurement_->getImage();
 
-  connect(this, SIGNAL(pointsFound(DefoMeasurement*, const DefoPointCollection*)),
-          listModel_, SLOT(appendMeasurementPoints(DefoMeasurement*, const DefoPointCollection*)));
-  
-  NQLogMessage("DefoPointFinder") << "DefoPointerFinder for block "
-      << block_ << " constructed";
 }
 
 DefoPointFinder::~DefoPointFinder()
 {
-  //delete gr2D_;
-  //delete fitFunc_;
 
-  NQLogMessage("DefoPointFinder") << "DefoPointerFinder for block "
-      << block_ << " destructed";
-}
-
-void DefoPointFinder::run()
-{
-  QPolygonF roi;
-
-  if (roiModel_) {
-    for (int j=0;j<roiModel_->size();++j) {
-      const QPointF& p = roiModel_->at(j);
-      QPointF np(p.x()*image_.width(), p.y()*image_.height());
-      roi.push_back(np);
-    }
-  }
-
-  /*
-  double x[4*pointModel_->getHalfSquareWidth()*pointModel_->getHalfSquareWidth()];
-  double y[4*pointModel_->getHalfSquareWidth()*pointModel_->getHalfSquareWidth()];
-  double z[4*pointModel_->getHalfSquareWidth()*pointModel_->getHalfSquareWidth()];
-  
-  gr2D_ = new TGraph2D(Form("gr2D_%d", block_), Form("gr2D_%d", block_),
-                       4*pointModel_->getHalfSquareWidth()*pointModel_->getHalfSquareWidth(),
-                       &x[0], &y[0], &z[0]);
-  gr2D_->SetDirectory(0);
-  fitFunc_ = new TF2(Form("fitFunc_%d", block_), twoDgauss, 0, 0, image_.width(), image_.height(), 5);
-  */
-  
-  const DefoPointCollection* points = findPoints(&searchArea_,
-                                                 &roi,
-                                                 pointModel_->getThresholdValue(DefoPointRecognitionModel::THRESHOLD_1),
-                                                 pointModel_->getThresholdValue(DefoPointRecognitionModel::THRESHOLD_2),
-                                                 pointModel_->getThresholdValue(DefoPointRecognitionModel::THRESHOLD_3),
-                                                 pointModel_->getHalfSquareWidth());
-
-  emit pointsFound(measurement_, points);
 }
 
 /**
@@ -102,29 +36,28 @@ void DefoPointFinder::run()
   image may be provided. In the case this points to NULL, the whole image is
   searched for suitable points.
  */
-const DefoPointCollection* DefoPointFinder::findPoints(const QRect* searchArea,
-                                                       const QPolygonF* roi,
-                                                       int step1Threshold,
-                                                       int step2Threshold,
-                                                       int step3Threshold,
-                                                       int halfSquareWidth)
+DefoPointCollection* DefoPointFinder::findPoints(const QRect* searchArea,
+                                                 const QPolygonF* roi,
+                                                 int step1Threshold,
+                                                 int step2Threshold,
+                                                 int step3Threshold,
+                                                 int halfSquareWidth) const
 {
   DefoPointCollection* points = new DefoPointCollection();
 
-  DefoSquareCollection forbiddenAreas;
   const int step2TotalThreshold = 4 * step2Threshold;
 
-  const int width = image_.width();
-  const int height = image_.height();
-
   // Determine intersection of area and image
-  QRect imageArea = image_.rect();
+  QRect imageArea = planes_->rect();
   QRect area;
   if (searchArea == NULL)
     area = imageArea;
   else
     area = imageArea & *searchArea;
 
+  // Squares around points found so far, bucketed by pixel position
+  DefoSquareGrid forbiddenAreas(area, halfSquareWidth);
+
   /*
   mutex_->lock();
   NQLogSpam("DefoMeasurement::findPoints()") << "[block=" << block_ << "] Scanning area ("
@@ -137,23 +70,30 @@ const DefoPointCollection* DefoPointFinder::findPoints(const QRect* searchArea,
   int y = area.y();
   while (  y < (area.y() + area.height()) ) {
 
+    const int right = area.x() + area.width();
     int x = area.x();
-    while ( x < (area.x() + area.width())) {
+    while ( x < right ) {
+
+      // Leap over all pixels that are not bright enough
+      x = planes_->findAbove(y, x, right, step1Threshold);
+      if (x >= right) break;
 
-      // Check if the point is in the allowed area AND bright enough
-      // FIXME leap over forbidden areas instead of having to skip every pixel
+      // Leap over forbidden areas around points that were already found
+      const int allowed = forbiddenAreas.nextOutside(x, y);
+      if (allowed != x) {
+        x = allowed;
+        continue;
+      }
 
-      if (!forbiddenAreas.isInside(DefoPoint(x, y)) &&
-          qGray( image_.pixel(x,y) ) > step1Threshold &&
-          imageArea.contains(x+3, y+3)) {
+      if (imageArea.contains(x+3, y+3)) {
 
         // We now have an initial seed. Check average amplitude
         // of some more pixels ahead
         double theProbe = 0.;
-        theProbe += qGray( image_.pixel( x + 2, y + 2 ) );
-        theProbe += qGray( image_.pixel( x + 2, y + 3 ) );
-        theProbe += qGray( image_.pixel( x + 3, y + 2 ) );
-        theProbe += qGray( image_.pixel( x + 3 ,y + 3 ) );
+        theProbe += planes_->gray( x + 2, y + 2 );
+        theProbe += planes_->gray( x + 2, y + 3 );
+        theProbe += planes_->gray( x + 3, y + 2 );
+        theProbe += planes_->gray( x + 3 ,y + 3 );
 
         // Check if the grayscale value is high enough for the (premultiplied)
         // second threshold.
@@ -186,12 +126,6 @@ const DefoPointCollection* DefoPointFinder::findPoints(const QRect* searchArea,
 
           if ( i == 4 ) { // Iterated without drifting
 
-            if (do2Dfit_) {
-              intermediate = getFitPosition(intermediate,
-                                            searchRect,
-                                            halfSquareWidth);
-            }
-
             // check again since the point can be reconstructed at a distance
             // from the seed
             if (area.contains(intermediate.getPixX(), intermediate.getPixY()) &&
@@ -239,9 +173,6 @@ const DefoPointCollection* DefoPointFinder::findPoints(const QRect* searchArea,
 
       }
       else {
-        // inside forbidden areas
-        // TODO find area, skip it
-        // x += 2*halfSquareWidth;
         ++x;
       }
     }
@@ -256,6 +187,10 @@ const DefoPointCollection* DefoPointFinder::findPoints(const QRect* searchArea,
   mutex_->unlock();
    */
 
+  // Refine the positions once all points are known, the fit moves a
+  // point by less than a pixel and does not change the search above
+  if (do2Dfit_) fitPositions(points, halfSquareWidth);
+
   // Now that all points have been found, determine their color
   determinePointColors(points, halfSquareWidth, step3Threshold);
 
@@ -299,87 +234,43 @@ void DefoPointFinder::determinePointColors(DefoPointCollection* points,
 DefoPoint DefoPointFinder::getCenterOfGravity(const QRect &area,
                                               int threshold) const
 {
-  // Ensure complete overlap of the area, everything outside is undefined
-  //  QRect area = area & image_.rect();
-  DefoPoint weightedSum(0, 0);
-
-  if ( !area.isNull() ) {
-    const int right = area.x() + area.width();
-    const int bottom = area.y() + area.height();
-
-    int gray;
-    double totalGray = 0.;
-    double weightedX = 0.;
-    double weightedY = 0.;
-
-    for (int x = area.x(); x < right; ++x) {
-      for (int y = area.y(); y < bottom; ++y) {
-
-        gray = qGray( image_.pixel(x, y) );
-
-        // Threshold 3 reduces false positives
-        if ( gray > threshold ) {
-          totalGray += gray;
-          weightedX += x*gray;
-          weightedY += y*gray;
-        }
-
-      }
-    }
-
-    if ( totalGray > 0 )
-      weightedSum.setPosition( weightedX/totalGray, weightedY/totalGray );
-  }
-
-  return weightedSum;
+  return planes_->getCenterOfGravity(area, threshold);
 }
 
-DefoPoint DefoPointFinder::getFitPosition(const DefoPoint& intermediate,
-                                          const QRect &area,
-                                          int threshold) const
+int DefoPointFinder::fitPositions(DefoPointCollection* points,
+                                  int halfSquareWidth) const
 {
-  const int right = area.x() + area.width();
-  const int bottom = area.y() + area.height();
-
-  DefoPoint newPoint = intermediate;
-
-  /*
-  QRgb rgb;
-  double value;
-  int nPoints = 0;
-
-  mutex_->lock();
-
-  //std::cout << intermediate.getX() << std::endl;
-  //std::cout << intermediate.getY() << std::endl;
-
-  for (int x = area.x(); x < right; ++x) {
-    for (int y = area.y(); y < bottom; ++y) {
+  int nFitted = 0;
+  QRect area;
+  DefoPoint position;
 
-      rgb = image_.pixel(x, y);
-      value = QColor::fromRgb(rgb).toHsv().valueF();
+  for (DefoPointCollection::iterator it = points->begin();
+       it != points->end();
+       ++it) {
 
-      gr2D_->SetPoint(nPoints, x, y, value);
+    area.setCoords(it->getPixX() - halfSquareWidth,
+                   it->getPixY() - halfSquareWidth,
+                   it->getPixX() + halfSquareWidth,
+                   it->getPixY() + halfSquareWidth);
 
-      nPoints++;
+    if (getFitPosition(*it, area, position)) {
+      *it = position;
+      ++nFitted;
     }
   }
 
-  fitFunc_->SetParameter(0, 1);
-  fitFunc_->SetParameter(1, intermediate.getX());
-  fitFunc_->SetParameter(2, 1);
-  fitFunc_->SetParameter(3, intermediate.getY());
-  fitFunc_->SetParameter(4, 1);
-
-  gr2D_->Fit(fitFunc_, "QNC");
-
-  mutex_->unlock();
+  return nFitted;
+}
 
-  newPoint.setX(fitFunc_->GetParameter(1));
-  newPoint.setY(fitFunc_->GetParameter(3));
-  */
-  
-  return newPoint;
+/**
+ * Position of a 2D Gaussian fit to the luminance in area, starting at the
+ * center of gravity intermediate. Returns false if the fit failed.
+ */
+bool DefoPointFinder::getFitPosition(const DefoPoint& intermediate,
+                                     const QRect &area,
+                                     DefoPoint& position) const
+{
+  return fitter_.fit(*planes_, area, intermediate, position);
 }
 
 /**
@@ -390,41 +281,5 @@ DefoPoint DefoPointFinder::getFitPosition(const DefoPoint& intermediate,
 const QColor DefoPointFinder::getAverageColor(const QRect &area,
                                               int threshold) const
 {
-  // Ensure complete overlap of the area, everything outside is undefined
-  QRect realArea = area & image_.rect();
-  QColor average(0, 0, 0);
-
-  if ( !realArea.isNull() ) {
-    QRgb pixel;
-    int brightness = 0;
-    double red = 0;
-    double green = 0;
-    double blue = 0;
-
-    int totalBrightness = 0;
-
-    const int right = realArea.x() + realArea.width();
-    const int bottom = realArea.y() + realArea.height();
-    // const int pixelCount = realArea.width() * realArea.height();
-
-    for (int x = realArea.x(); x < right; ++x) {
-      for (int y = realArea.y(); y < bottom; ++y) {
-        pixel = image_.pixel(x, y);
-        brightness = qGray(pixel);
-        // Only take into account sufficiently bright pixels, reduces background
-        if ( brightness > threshold ) {
-          red += qRed(pixel) * brightness;
-          green += qGreen(pixel) * brightness;
-          blue += qBlue(pixel) * brightness;
-          totalBrightness += brightness;
-        }
-      }
-    }
-
-    average.setRgb(red/totalBrightness,
-                   green/totalBrightness,
-                   blue/totalBrightness);
-  }
-
-  return average;
+  return planes_->getAverageColor(area, threshold);
 }
@@ -13,66 +13,55 @@
 #ifndef DEFOPOINTFINDER_H
 #define DEFOPOINTFINDER_H
 
-#include <QThread>
-#include <QMutex>
 #include <QImage>
 #include <QPolygonF>
 
-//#include <TGraph2D.h>
-//#include <TF2.h>
-
-#include "DefoMeasurement.h"
-#include "DefoMeasurementListModel.h"
-#include "DefoPointRecognitionModel.h"
-#include "DefoROIModel.h"
-
-class DefoPointFinder : public QThread
+#include "DefoImagePlanes.h"
+#include "DefoGaussFitter.h"
+#include "DefoPoint.h"
+#include "DefoSquare.h"
+
+///
+/// Image recognition of grid dots within a search area of the image planes
+/// of a measurement. Apart from the workspace of the 2D fit the finder
+/// holds no state of its own, so several finders may search different
+/// tiles of the same planes concurrently, one finder per thread (see
+/// DefoPointFinderPool).
+///
+class DefoPointFinder
 {
-  Q_OBJECT
-
 public:
 
-  explicit DefoPointFinder(int block,
-                           QMutex* mutex,
-                           DefoMeasurementListModel *listModel,
-                           DefoPointRecognitionModel *pointModel,
-                           DefoMeasurement *measurement,
-                           const QRect& searchRectangle,
-                           bool do2Dfit = false,
-                           DefoROIModel * roiModel = 0);
+  explicit DefoPointFinder(const DefoImagePlanes* planes,
+                           bool do2Dfit = false);
   ~DefoPointFinder();
 
-  void run();
+  DefoPointCollection* findPoints(const QRect* searchArea,
+                                  const QPolygonF* roi,
+                                  int step1Threshold,
+                                  int step2Threshold,
+                                  int step3Threshold,
+                                  int halfSquareWidth) const;
+
+  /// Replaces the center of gravity of all points by the position of a
+  /// 2D Gaussian fit. Points for which the fit fails keep their center
+  /// of gravity. Returns the number of successful fits.
+  int fitPositions(DefoPointCollection* points,
+                   int halfSquareWidth) const;
 
 protected:
 
-  int block_;
-  QMutex* mutex_;
-  DefoMeasurementListModel* listModel_;
-  DefoPointRecognitionModel* pointModel_;
-  DefoMeasurement* measurement_;
-  const QRect searchArea_;
+  const DefoImagePlanes* planes_;
   bool do2Dfit_;
-  DefoROIModel* roiModel_;
 
-  //TGraph2D *gr2D_;
-  //TF2* fitFunc_;
+  mutable DefoGaussFitter fitter_;
 
-  QImage image_;
-
-  const DefoPointCollection* findPoints(const QRect* searchArea,
-                                        const QPolygonF* roi,
-                                        int step1Threshold,
-                                        int step2Threshold,
-                                        int step3Threshold,
-                                        int halfSquareWidth);
- 
   DefoPoint getCenterOfGravity(const QRect &area,
                                int threshold) const;
  
-  DefoPoint getFitPosition(const DefoPoint& intermediate,
-			   const QRect &area,
-			   int threshold) const;
+  bool getFitPosition(const DefoPoint& intermediate,
+                      const QRect &area,
+                      DefoPoint& position) const;
 
   void determinePointColors(DefoPointCollection* points,
                             int halfSquareWidth,
@@ -80,10 +69,6 @@ protected:
 
   const QColor getAverageColor(const QRect& area,
                                int threshold) const;
-
-signals:
-
-  void pointsFound(DefoMeasurement*, const DefoPointCollection*);
 };
 
 #endif // DEFOPOINTFINDER_H
@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include <QThread>
+#include <QThreadPool>
+#include <QMetaObject>
+
+#include <nqlogger.h>
+
+#include "DefoPointFinder.h"
+#include "DefoPointFinderPool.h"
+
+DefoPointFinderPool::DefoPointFinderPool(DefoMeasurementListModel *listModel,
+                                         DefoPointRecognitionModel *pointModel,
+                                         DefoMeasurement *measurement,
+                                         const QRect &searchRectangle,
+                                         bool do2Dfit,
+                                         DefoROIModel * roiModel,
+                                         QObject *parent)
+: QObject(parent),
+  listModel_(listModel),
+  measurement_(measurement),
+  searchArea_(searchRectangle),
+  do2Dfit_(do2Dfit),
+  workers_(0),
+  nextTile_(0),
+  activeWorkers_(0)
+{
+  image_ = measurement_->getImage();
+
+  // read all parameters here, the models must not be accessed from the workers
+  thresholds_[0] = pointModel->getThresholdValue(DefoPointRecognitionModel::THRESHOLD_1);
+  thresholds_[1] = pointModel->getThresholdValue(DefoPointRecognitionModel::THRESHOLD_2);
+  thresholds_[2] = pointModel->getThresholdValue(DefoPointRecognitionModel::THRESHOLD_3);
+  halfSquareWidth_ = pointModel->getHalfSquareWidth();
+
+  if (roiModel) {
+    for (int j=0;j<roiModel->size();++j) {
+      const QPointF& p = roiModel->at(j);
+      QPointF np(p.x()*image_.width(), p.y()*image_.height());
+      roi_.push_back(np);
+    }
+  }
+
+  const QRect area = image_.rect() & searchArea_;
+  const int tileSize = std::max(512, 16 * halfSquareWidth_);
+
+  for (int y = area.y(); y < area.y() + area.height(); y += tileSize) {
+    for (int x = area.x(); x < area.x() + area.width(); x += tileSize) {
+      tiles_.push_back(QRect(x, y, tileSize, tileSize) & area);
+    }
+  }
+  tilePoints_.resize(tiles_.size(), 0);
+
+  connect(this, SIGNAL(pointsFound(DefoMeasurement*, const DefoPointCollection*)),
+          listModel_, SLOT(appendMeasurementPoints(DefoMeasurement*, const DefoPointCollection*)));
+
+  NQLogMessage("DefoPointFinderPool") << "constructed for " << tiles_.size() << " tiles";
+}
+
+DefoPointFinderPool::~DefoPointFinderPool()
+{
+  for (std::vector<DefoPointCollection*>::iterator it = tilePoints_.begin();
+       it != tilePoints_.end();
+       ++it) {
+    delete *it;
+  }
+
+  NQLogMessage("DefoPointFinderPool") << "destructed";
+}
+
+void DefoPointFinderPool::start()
+{
+  QThreadPool::globalInstance()->start(new Task(this, &DefoPointFinderPool::prepare));
+}
+
+/**
+  Converts the image once for all workers and starts them.
+  */
+void DefoPointFinderPool::prepare()
+{
+  planes_.setImage(image_);
+
+  workers_ = std::max(1, std::min(QThread::idealThreadCount(), (int)tiles_.size()));
+  activeWorkers_.storeRelease(workers_);
+
+  for (int i=0;i<workers_;++i) {
+    QThreadPool::globalInstance()->start(new Task(this, &DefoPointFinderPool::work));
+  }
+}
+
+void DefoPointFinderPool::work()
+{
+  // the points of the margins belong to other tiles, they are fitted there
+  DefoPointFinder finder(&planes_, false);
+
+  // a point drifts at most one half square width away from its seed during
+  // the center of gravity iterations, the second one covers the seed itself
+  const int margin = 2 * halfSquareWidth_;
+
+  int tile;
+  while ((tile = nextTile_.fetchAndAddOrdered(1)) < (int)tiles_.size()) {
+
+    const QRect& core = tiles_[tile];
+    const QRect searchArea = core.adjusted(-margin, -margin, margin, margin);
+
+    DefoPointCollection* points = finder.findPoints(&searchArea,
+                                                    &roi_,
+                                                    thresholds_[0],
+                                                    thresholds_[1],
+                                                    thresholds_[2],
+                                                    halfSquareWidth_);
+
+    // keep only the points owned by this tile
+    DefoPointCollection::iterator last = std::remove_if(points->begin(), points->end(),
+                                                        [&core](const DefoPoint& p) {
+                                                          return !core.contains(p.getPixX(), p.getPixY());
+                                                        });
+    points->erase(last, points->end());
+
+    if (do2Dfit_) finder.fitPositions(points, halfSquareWidth_);
+
+    tilePoints_[tile] = points;
+  }
+
+  if (!activeWorkers_.deref()) {
+    QMetaObject::invokeMethod(this, "merge", Qt::QueuedConnection);
+  }
+}
+
+/**
+  Collects the points of all tiles in tile order and hands them to the
+  list model in one go.
+  */
+void DefoPointFinderPool::merge()
+{
+  DefoPointCollection* points = new DefoPointCollection();
+
+  for (std::vector<DefoPointCollection*>::iterator it = tilePoints_.begin();
+       it != tilePoints_.end();
+       ++it) {
+    if (*it == 0) continue;
+    points->insert(points->end(), (*it)->begin(), (*it)->end());
+  }
+
+  NQLogMessage("DefoPointFinderPool") << points->size() << " points found in "
+                                      << tiles_.size() << " tiles by "
+                                      << workers_ << " workers";
+
+  // the list model keeps its own copy of the points
+  emit pointsFound(measurement_, points);
+  delete points;
+
+  emit finished();
+}
@@ -0,0 +1,105 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEFOPOINTFINDERPOOL_H
+#define DEFOPOINTFINDERPOOL_H
+
+#include <vector>
+
+#include <QObject>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QImage>
+#include <QPolygonF>
+
+#include "DefoImagePlanes.h"
+#include "DefoMeasurement.h"
+#include "DefoMeasurementListModel.h"
+#include "DefoPointRecognitionModel.h"
+#include "DefoROIModel.h"
+
+///
+/// Schedules the point search of a measurement on the global QThreadPool.
+///
+/// The search area is split into tiles that are much smaller than the
+/// area per thread. QThread::idealThreadCount() workers take the next
+/// tile from a shared counter until all tiles are done, so a tile with
+/// many points does not hold up the other threads. Every tile is searched
+/// with a margin of two half square widths, but only keeps the points
+/// whose center lies in the tile itself. Points on tile seams are thus
+/// found exactly once, and the merged collection is independent of the
+/// order in which the tiles were processed.
+///
+class DefoPointFinderPool : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  explicit DefoPointFinderPool(DefoMeasurementListModel *listModel,
+                               DefoPointRecognitionModel *pointModel,
+                               DefoMeasurement *measurement,
+                               const QRect& searchRectangle,
+                               bool do2Dfit = false,
+                               DefoROIModel * roiModel = 0,
+                               QObject *parent = 0);
+  ~DefoPointFinderPool();
+
+  void start();
+
+  int getTileCount() const { return tiles_.size(); }
+  int getWorkerCount() const { return workers_; }
+
+protected:
+
+  class Task : public QRunnable
+  {
+  public:
+    Task(DefoPointFinderPool* pool, void (DefoPointFinderPool::*method)())
+      : pool_(pool), method_(method) { }
+    void run() { (pool_->*method_)(); }
+  protected:
+    DefoPointFinderPool* pool_;
+    void (DefoPointFinderPool::*method_)();
+  };
+
+  DefoMeasurementListModel* listModel_;
+  DefoMeasurement* measurement_;
+  const QRect searchArea_;
+  bool do2Dfit_;
+
+  QImage image_;
+  DefoImagePlanes planes_;
+  QPolygonF roi_;
+  int thresholds_[3];
+  int halfSquareWidth_;
+
+  std::vector<QRect> tiles_;
+  std::vector<DefoPointCollection*> tilePoints_;
+  int workers_;
+  QAtomicInt nextTile_;
+  QAtomicInt activeWorkers_;
+
+  void prepare();
+  void work();
+
+protected slots:
+
+  void merge();
+
+signals:
+
+  void pointsFound(DefoMeasurement*, const DefoPointCollection*);
+  void finished();
+};
+
+#endif // DEFOPOINTFINDERPOOL_H
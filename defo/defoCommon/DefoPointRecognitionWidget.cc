@@ -17,7 +17,7 @@
 
 #include "DefoThresholdSpinBox.h"
 #include "DefoHalfSquareWidthSpinBox.h"
-#include "DefoPointFinder.h"
+#include "DefoPointFinderPool.h"
 #include "DefoPoint.h"
 #include "DefoPointSaver.h"
 
@@ -90,42 +90,20 @@ void DefoPointRecognitionWidget::findPointsButtonClicked()
   DefoMeasurement* measurement = selectionModel_->getSelection();
   listModel_->setMeasurementPoints(measurement, NULL);
 
-  DefoPointFinder* finder;
   QRect searchArea = measurement->getImage().rect();
-  const int width = searchArea.width();
 
   bool do2Dfit = fitPoints_->isChecked();
 
-  /*
-    The number of blocks depends on the number of cores available and the
-    number of cores you want to be available for other tasks.
-   */
-  const int blocks = 6;
-
-  for (double i = 0; i < blocks; ++i) {
-
-    /*
-      In Qt the rectangle borders are placed ON the pixels, in contrast to e.g.
-      Swing where they are in between the pixels.
-      As a consequence, the right-side border has to be one pixel to the left in
-      order to avoid overlapping rectangles.
-     */
-    searchArea.setLeft( i/blocks * width );
-    searchArea.setRight( (i+1)/blocks * width - 1 );
-
-    finder = new DefoPointFinder(i,
-                                 &mutex_,
-                                 listModel_,
-                                 pointModel_,
-                                 measurement,
-                                 searchArea,
-                                 do2Dfit);
-    
-    connect(finder, SIGNAL(finished()),
-            finder, SLOT(deleteLater()));
-
-    finder->start();
-  }
+  DefoPointFinderPool* finder = new DefoPointFinderPool(listModel_,
+                                                        pointModel_,
+                                                        measurement,
+                                                        searchArea,
+                                                        do2Dfit);
+
+  connect(finder, SIGNAL(finished()),
+          finder, SLOT(deleteLater()));
+
+  finder->start();
 }
 
 void DefoPointRecognitionWidget::savePointsButtonClicked()
@@ -135,7 +113,8 @@ void DefoPointRecognitionWidget::savePointsButtonClicked()
   if (file.length() > 0) {
     DefoPointSaver saver(file);
     DefoMeasurement* meas = selectionModel_->getSelection();
-    const DefoPointCollection* points = listModel_->getMeasurementPoints(meas);
+    DefoPointSnapshot points = listModel_->getMeasurementPointSnapshot(meas);
+    if (!points) return;
 
     saver.writePoints(*points);
   }
@@ -48,8 +48,6 @@ protected:
   QPushButton* findPoints_;
   QPushButton* savePoints_;
 
-  QMutex mutex_;
-
 protected slots:
 
   void findPointsButtonClicked();
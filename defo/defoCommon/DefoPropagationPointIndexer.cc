@@ -12,13 +12,17 @@
 
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
+#include "ApplicationConfig.h"
+
+#include "DefoParallelFor.h"
 #include "DefoPropagationPointIndexer.h"
 
 DefoPropagationPointIndexer::DefoPropagationPointIndexer(QObject *parent) :
     DefoVPointIndexer(parent)
 {
-
+    parallel_ = ApplicationConfig::instance()->getDefaultValue<int>("PARALLEL_INDEXING", 0) != 0;
 }
 
 void DefoPropagationPointIndexer::indexPoints(DefoPointCollection *points, const QColor& seedColor) {
@@ -36,48 +40,55 @@ void DefoPropagationPointIndexer::indexPoints(DefoPointCollection *points, const
     double dx, dy, d;
     determineGrid(points, seed, dx, dy, d);
 
+    PointGrid grid(points);
+
     PointVector horizontalSeeds;
     horizontalSeeds.push_back(seed);
 
-    DefoPoint* currentPoint;
-    DefoPoint* nextPoint;
+    PointVector path;
 
-    currentPoint = seed;
-    nextPoint = findNeighbour(points, currentPoint, X, Forward, dy/2.0);
-    while (nextPoint) {
-        nextPoint->setIndex(currentPoint->getIndex().first+1, currentPoint->getIndex().second);
-        horizontalSeeds.push_back(nextPoint);
-        currentPoint = nextPoint;
-        nextPoint = findNeighbour(points, currentPoint, X, Forward, dy/2.0);
+    propagate(grid, seed, X, Forward, dy/2.0, path);
+    for (int i = 0; i < (int)path.size(); ++i) {
+        path[i]->setIndex(seed->getIndex().first+1+i, seed->getIndex().second);
+        horizontalSeeds.push_back(path[i]);
     }
 
-    currentPoint = seed;
-    nextPoint = findNeighbour(points, currentPoint, X, Backward, dy/2.0);
-    while (nextPoint) {
-        nextPoint->setIndex(currentPoint->getIndex().first-1, currentPoint->getIndex().second);
-        horizontalSeeds.push_back(nextPoint);
-        currentPoint = nextPoint;
-        nextPoint = findNeighbour(points, currentPoint, X, Backward, dy/2.0);
+    propagate(grid, seed, X, Backward, dy/2.0, path);
+    for (int i = 0; i < (int)path.size(); ++i) {
+        path[i]->setIndex(seed->getIndex().first-1-i, seed->getIndex().second);
+        horizontalSeeds.push_back(path[i]);
     }
 
-    for (PointVector::iterator it = horizontalSeeds.begin();
-         it != horizontalSeeds.end();
-         ++it) {
+    // the paths along the columns only depend on the point positions,
+    // so they can be searched in parallel. The indices are assigned
+    // afterwards in the order of the horizontal seeds.
+    const int nColumns = horizontalSeeds.size();
+    std::vector<PointVector> forwardPaths(nColumns);
+    std::vector<PointVector> backwardPaths(nColumns);
+
+    auto searchColumn = [&](int i) {
+        propagate(grid, horizontalSeeds[i], Y, Forward, dx/2.0, forwardPaths[i]);
+        propagate(grid, horizontalSeeds[i], Y, Backward, dx/2.0, backwardPaths[i]);
+    };
+
+    if (parallel_) {
+        DefoParallelFor(nColumns, searchColumn);
+    } else {
+        for (int i = 0; i < nColumns; ++i) searchColumn(i);
+    }
 
-        currentPoint = *it;
-        nextPoint = findNeighbour(points, currentPoint, Y, Forward, dx/2.0);
-        while (nextPoint) {
-            nextPoint->setIndex(currentPoint->getIndex().first, currentPoint->getIndex().second-1);
-            currentPoint = nextPoint;
-            nextPoint = findNeighbour(points, currentPoint, Y, Forward, dx/2.0);
+    for (int c = 0; c < nColumns; ++c) {
+
+        const DefoPoint* columnSeed = horizontalSeeds[c];
+
+        std::pair<int,int> index = columnSeed->getIndex();
+        for (int i = 0; i < (int)forwardPaths[c].size(); ++i) {
+            forwardPaths[c][i]->setIndex(index.first, index.second-1-i);
         }
 
-        currentPoint = *it;
-        nextPoint = findNeighbour(points, currentPoint, Y, Backward, dx/2.0);
-        while (nextPoint) {
-            nextPoint->setIndex(currentPoint->getIndex().first, currentPoint->getIndex().second+1);
-            currentPoint = nextPoint;
-            nextPoint = findNeighbour(points, currentPoint, Y, Backward, dx/2.0);
+        index = columnSeed->getIndex();
+        for (int i = 0; i < (int)backwardPaths[c].size(); ++i) {
+            backwardPaths[c][i]->setIndex(index.first, index.second+1+i);
         }
     }
 
@@ -85,7 +96,6 @@ void DefoPropagationPointIndexer::indexPoints(DefoPointCollection *points, const
     std::sort(pointsRef.begin(), pointsRef.end());
     
 }
-
 DefoPoint * DefoPropagationPointIndexer::findSeed(DefoPointCollection* points, const QColor& seedColor) {
 
     DefoPoint * temp = 0;
@@ -124,36 +134,146 @@ void DefoPropagationPointIndexer::determineGrid(DefoPointCollection* points, con
     d = mind;
 }
 
-DefoPoint * DefoPropagationPointIndexer::findNeighbour(DefoPointCollection* points, const DefoPoint* seed,
-                                                       Axis axis, Direction direction, double window) {
+void DefoPropagationPointIndexer::propagate(const PointGrid& grid, const DefoPoint* seed,
+                                            Axis axis, Direction direction, double window,
+                                            PointVector& path) const {
+
+    path.clear();
+
+    const DefoPoint* currentPoint = seed;
+    DefoPoint* nextPoint = grid.findNeighbour(currentPoint, axis, direction, window);
+    while (nextPoint) {
+        path.push_back(nextPoint);
+        currentPoint = nextPoint;
+        nextPoint = grid.findNeighbour(currentPoint, axis, direction, window);
+    }
+}
+
+DefoPropagationPointIndexer::PointGrid::PointGrid(DefoPointCollection* points)
+    : points_(points),
+      x0_(0.),
+      y0_(0.),
+      cellSize_(1.),
+      nx_(0),
+      ny_(0)
+{
+    if (points_->empty()) return;
+
+    double x1, y1;
+    x0_ = x1 = points_->front().getX();
+    y0_ = y1 = points_->front().getY();
+    for (DefoPointCollection::const_iterator it = points_->begin();
+         it != points_->end();
+         ++it) {
+        x0_ = std::min(x0_, it->getX());
+        x1 = std::max(x1, it->getX());
+        y0_ = std::min(y0_, it->getY());
+        y1 = std::max(y1, it->getY());
+    }
+
+    // about one point per cell
+    const double area = std::max(x1 - x0_, 1.) * std::max(y1 - y0_, 1.);
+    cellSize_ = std::max(1., std::sqrt(area / points_->size()));
+    nx_ = (int)((x1 - x0_) / cellSize_) + 1;
+    ny_ = (int)((y1 - y0_) / cellSize_) + 1;
+
+    // counting sort of the point indices by cell, keeping the
+    // collection order within every cell
+    cellStart_.assign(nx_ * ny_ + 1, 0);
+    for (DefoPointCollection::const_iterator it = points_->begin();
+         it != points_->end();
+         ++it) {
+        cellStart_[cellY(it->getY()) * nx_ + cellX(it->getX()) + 1]++;
+    }
+    for (size_t c = 1; c < cellStart_.size(); ++c) {
+        cellStart_[c] += cellStart_[c-1];
+    }
+
+    std::vector<int> fill(cellStart_.begin(), cellStart_.end() - 1);
+    cellPoints_.resize(points_->size());
+    for (size_t i = 0; i < points_->size(); ++i) {
+        const DefoPoint& p = (*points_)[i];
+        cellPoints_[fill[cellY(p.getY()) * nx_ + cellX(p.getX())]++] = i;
+    }
+}
+
+int DefoPropagationPointIndexer::PointGrid::cellX(double x) const {
+    const double c = std::floor((x - x0_) / cellSize_);
+    return c < 0 ? 0 : (c >= nx_ ? nx_ - 1 : (int)c);
+}
+
+int DefoPropagationPointIndexer::PointGrid::cellY(double y) const {
+    const double c = std::floor((y - y0_) / cellSize_);
+    return c < 0 ? 0 : (c >= ny_ ? ny_ - 1 : (int)c);
+}
+
+/*
+  Same selection as a scan over all points: the closest point along the
+  axis on the requested side within the window, the first one in the
+  collection on ties. The band of cells across the axis contains every
+  point within the window, and the walk along the axis stops once the
+  cells are further away than the best point so far (with one cell of
+  slack against rounding at the cell edges).
+ */
+DefoPoint * DefoPropagationPointIndexer::PointGrid::findNeighbour(const DefoPoint* seed,
+                                                                  Axis axis, Direction direction,
+                                                                  double window) const {
+
+    if (nx_ == 0) return 0;
+
+    int bandBegin, bandEnd, start, end;
+    if (axis==X) {
+        bandBegin = cellY(seed->getY() - window);
+        bandEnd = cellY(seed->getY() + window);
+        start = cellX(seed->getX());
+        end = direction==Forward ? nx_ : -1;
+    } else {
+        bandBegin = cellX(seed->getX() - window);
+        bandEnd = cellX(seed->getX() + window);
+        start = cellY(seed->getY());
+        end = direction==Forward ? ny_ : -1;
+    }
+    const int step = direction==Forward ? 1 : -1;
 
     double min = 1.e6;
     double dx, dy, d;
-    DefoPoint* nextPoint = 0;
-    for (DefoPointCollection::iterator it = points->begin();
-         it != points->end();
-         ++it) {
-        d = seed->getDistanceXY(*it, dx, dy);
-        if (d<20.0) continue;
-
-        if (axis==X) {
-            if (std::fabs(dy)>window) continue;
-            if (direction==Forward && dx>0) continue;
-            if (direction==Backward && dx<0) continue;
-            if (std::fabs(dx)<std::fabs(min)) {
-                min = dx;
-                nextPoint = &(*it);
-            }
-        } else {
-            if (std::fabs(dx)>window) continue;
-            if (direction==Forward && dy>0) continue;
-            if (direction==Backward && dy<0) continue;
-            if (std::fabs(dy)<std::fabs(min)) {
-                min = dy;
-                nextPoint = &(*it);
+    int best = -1;
+
+    for (int c = start; c != end; c += step) {
+
+        if (best >= 0 && (std::abs(c - start) - 2) * cellSize_ > std::fabs(min)) break;
+
+        for (int b = bandBegin; b <= bandEnd; ++b) {
+
+            const int cell = axis==X ? b * nx_ + c : c * nx_ + b;
+
+            for (int k = cellStart_[cell]; k < cellStart_[cell+1]; ++k) {
+
+                const int i = cellPoints_[k];
+                d = seed->getDistanceXY((*points_)[i], dx, dy);
+                if (d<20.0) continue;
+
+                double distance;
+                if (axis==X) {
+                    if (std::fabs(dy)>window) continue;
+                    if (direction==Forward && dx>0) continue;
+                    if (direction==Backward && dx<0) continue;
+                    distance = dx;
+                } else {
+                    if (std::fabs(dx)>window) continue;
+                    if (direction==Forward && dy>0) continue;
+                    if (direction==Backward && dy<0) continue;
+                    distance = dy;
+                }
+
+                if (std::fabs(distance)<std::fabs(min) ||
+                    (best >= 0 && std::fabs(distance)==std::fabs(min) && i < best)) {
+                    min = distance;
+                    best = i;
+                }
             }
         }
     }
 
-    return nextPoint;
+    return best >= 0 ? &(*points_)[best] : 0;
 }
@@ -30,15 +30,45 @@ public:
 
   void indexPoints(DefoPointCollection* points, const QColor& seedColor);
 
+  void setParallelPropagation(bool parallel) { parallel_ = parallel; }
+  bool getParallelPropagation() const { return parallel_; }
+
 protected:
 
   typedef std::vector<DefoPoint*> PointVector;
 
+  /// Buckets the points of a collection in a uniform grid of cells of
+  /// about one point each. Neighbour queries only visit the cells of the
+  /// search band, walking away from the seed until no closer point can
+  /// follow, and return the same point as a scan of the full collection.
+  class PointGrid
+  {
+  public:
+    PointGrid(DefoPointCollection* points);
+
+    DefoPoint * findNeighbour(const DefoPoint* seed,
+                              Axis axis, Direction direction, double window) const;
+
+  protected:
+    DefoPointCollection* points_;
+    double x0_, y0_;
+    double cellSize_;
+    int nx_, ny_;
+    std::vector<int> cellStart_;
+    std::vector<int> cellPoints_;
+
+    int cellX(double x) const;
+    int cellY(double y) const;
+  };
+
+  bool parallel_;
+
   DefoPoint * findSeed(DefoPointCollection* points, const QColor& seedColor);
   void determineGrid(DefoPointCollection* points, const DefoPoint* seed,
                      double& dx, double& dy, double& d);
-  DefoPoint * findNeighbour(DefoPointCollection* points, const DefoPoint* seed,
-                            Axis axis, Direction direction, double window);
+  void propagate(const PointGrid& grid, const DefoPoint* seed,
+                 Axis axis, Direction direction, double window,
+                 PointVector& path) const;
 };
 
 #endif // DEFOPROPAGATIONPOINTINDEXER_H
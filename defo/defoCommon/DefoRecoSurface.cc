@@ -19,10 +19,48 @@
 #include "ndirection3D.h"
 #include "nline3D.h"
 #include "nplane3D.h"
-#include "nvector2D.h"
 
+#include "DefoParallelFor.h"
 #include "DefoRecoSurface.h"
 
+///
+/// fill the table, the first point with a given index wins
+///
+DefoPointIndexTable::DefoPointIndexTable(DefoPointCollection const& points)
+  : indexRangeX_(0, -1),
+    indexRangeY_(0, -1),
+    width_(0)
+{
+  if (points.empty()) return;
+
+  indexRangeX_ = std::pair<int,int>(points.front().getIndex().first, points.front().getIndex().first);
+  indexRangeY_ = std::pair<int,int>(points.front().getIndex().second, points.front().getIndex().second);
+
+  for (DefoPointCollection::const_iterator it = points.begin(); it < points.end(); ++it) {
+    indexRangeX_.first = std::min(indexRangeX_.first, it->getIndex().first);
+    indexRangeX_.second = std::max(indexRangeX_.second, it->getIndex().first);
+    indexRangeY_.first = std::min(indexRangeY_.first, it->getIndex().second);
+    indexRangeY_.second = std::max(indexRangeY_.second, it->getIndex().second);
+  }
+
+  width_ = indexRangeX_.second - indexRangeX_.first + 1;
+  table_.assign((size_t)width_ * (indexRangeY_.second - indexRangeY_.first + 1), 0);
+
+  for (DefoPointCollection::const_iterator it = points.begin(); it < points.end(); ++it) {
+    const DefoPoint*& entry = table_[(size_t)(it->getIndex().second - indexRangeY_.first) * width_
+                                     + (it->getIndex().first - indexRangeX_.first)];
+    if (!entry) entry = &(*it);
+  }
+}
+
+const DefoPoint* DefoPointIndexTable::find(int indexX, int indexY) const
+{
+  if (indexX < indexRangeX_.first || indexX > indexRangeX_.second ||
+      indexY < indexRangeY_.first || indexY > indexRangeY_.second) return 0;
+
+  return table_[(size_t)(indexY - indexRangeY_.first) * width_ + (indexX - indexRangeX_.first)];
+}
+
 ///
 ///
 ///
@@ -174,52 +212,113 @@ void DefoRecoSurface::calibrateXYPoints(DefoPointCollection & points)
 
   NPlane3D gridPlane(gridPoint, gridNormal);
 
-  NPoint3D objectIntersection;
-  NPoint3D gridIntersection;
+  // Everything above only depends on the geometry. Per point the image
+  // ray (u, v, imageDistance) is normalised and rotated around x, then
+  // intersected with the object plane; the reflected ray (rotated by pi
+  // around z) is intersected with the grid plane. Both intersections are
+  // written out as plane equations below, so that the loop over the points
+  // is plain arithmetic on contiguous arrays which the compiler vectorises.
+  const double cosA = std::cos(a2 + a3);
+  const double sinA = std::sin(a2 + a3);
+  const double cosPi = std::cos(M_PI);
+  const double sinPi = std::sin(M_PI);
+
+  const double px = imagePoint.x();
+  const double py = imagePoint.y();
+  const double pz = imagePoint.z();
+
+  const double onx = objectPlane.normal().x();
+  const double ony = objectPlane.normal().y();
+  const double onz = objectPlane.normal().z();
+  const double onP = onx * (objectPlane.point().x() - px)
+                   + ony * (objectPlane.point().y() - py)
+                   + onz * (objectPlane.point().z() - pz);
+
+  const double gnx = gridPlane.normal().x();
+  const double gny = gridPlane.normal().y();
+  const double gnz = gridPlane.normal().z();
+  const double gnG = gnx * gridPlane.point().x()
+                   + gny * gridPlane.point().y()
+                   + gnz * gridPlane.point().z();
+
+  const double offsetX = 0.5 * imageSize_.first;
+  const double offsetY = 0.5 * imageSize_.second;
 
   /*
   std::cout << imageSize_.first << std::endl;
   std::cout << imageSize_.second << std::endl;
   */
 
-  for( DefoPointCollection::iterator it = points.begin();
-      it != points.end();
-      ++it ) {
-
-    DefoPoint& aPoint = *it;
+  const size_t n = points.size();
 
-    NDirection3D imageRayDirection((aPoint.getX() - 0.5 * imageSize_.first) * pitchX_,
-                                   (aPoint.getY() - 0.5 * imageSize_.second) * pitchY_,
-                                   imageDistance);
-    imageRayDirection.rotateX(a2 + a3);
-    NLine3D imageRay(imagePoint, imageRayDirection);
-    imageRay.intersection(objectPlane, objectIntersection);
+  std::vector<double> calX(n), calY(n);
+  std::vector<double> imgX(n), grdX(n), imgY(n), grdY(n);
+  std::vector<char> intersects(n);
 
-    NVector3D imageDistance(objectIntersection, imagePoint);
+  for (size_t i = 0; i < n; ++i) {
+    calX[i] = points[i].getX();
+    calY[i] = points[i].getY();
+  }
 
-    NDirection3D gridRayDirection(imageRayDirection);
-    gridRayDirection.rotateZ(M_PI);
-    NLine3D gridRay(objectIntersection, gridRayDirection);
-    gridRay.intersection(gridPlane, gridIntersection);
+  for (size_t i = 0; i < n; ++i) {
+
+    // normalised image ray, rotated around x
+    const double u = (calX[i] - offsetX) * pitchX_;
+    const double v = (calY[i] - offsetY) * pitchY_;
+    const double l = std::sqrt(u*u + v*v + imageDistance*imageDistance);
+    const double dx = u / l;
+    const double vn = v / l;
+    const double wn = imageDistance / l;
+    const double dy = vn * cosA - wn * sinA;
+    const double dz = vn * sinA + wn * cosA;
+
+    // intersection with the object plane
+    const double objectDenominator = onx*dx + ony*dy + onz*dz;
+    const double s = onP / objectDenominator;
+    const double ix = px + s * dx;
+    const double iy = py + s * dy;
+    const double iz = pz + s * dz;
+
+    // reflected ray, intersection with the grid plane
+    const double rx = dx * cosPi - dy * sinPi;
+    const double ry = dx * sinPi + dy * cosPi;
+    const double rl = std::sqrt(rx*rx + ry*ry + dz*dz);
+    const double gx = rx / rl;
+    const double gy = ry / rl;
+    const double gz = dz / rl;
+    const double gridDenominator = gnx*gx + gny*gy + gnz*gz;
+    const double t = (gnG - (gnx*ix + gny*iy + gnz*iz)) / gridDenominator;
+
+    // rays parallel to one of the planes do not intersect it
+    intersects[i] = objectDenominator!=0. && gridDenominator!=0.;
+
+    calX[i] = -1.0 * ix * calibX_;
+    calY[i] =  1.0 * iy * calibY_;
+
+    imgX[i] = std::fabs(s) * std::sqrt(dx*dx + dz*dz);
+    grdX[i] = std::fabs(t) * std::sqrt(gx*gx + gz*gz);
+    imgY[i] = std::fabs(s) * std::sqrt(dy*dy + dz*dz);
+    grdY[i] = std::fabs(t) * std::sqrt(gy*gy + gz*gz);
+  }
 
-    NVector3D gridDistance(objectIntersection, gridIntersection);
+  // points whose rays miss one of the planes have no calibrated position
+  // and are dropped, keeping the order of the others
+  size_t kept = 0;
 
-    double x = -1.0 * objectIntersection.x() * calibX_;
-    double y =  1.0 * objectIntersection.y() * calibY_;
+  for (size_t i = 0; i < n; ++i) {
 
-    aPoint.setCalibratedPosition(x, y);
+    if (!intersects[i]) continue;
 
-    NVector2D imageDistanceX(imageDistance.x(), imageDistance.z());
-    NVector2D gridDistanceX(gridDistance.x(), gridDistance.z());
+    if (kept!=i) points[kept] = points[i];
+    DefoPoint& aPoint = points[kept++];
 
-    aPoint.setImageDistanceX(imageDistanceX.length());
-    aPoint.setGridDistanceX(gridDistanceX.length());
+    aPoint.setCalibratedPosition(calX[i], calY[i]);
 
-    NVector2D imageDistanceY(imageDistance.y(), imageDistance.z());
-    NVector2D gridDistanceY(gridDistance.y(), gridDistance.z());
+    aPoint.setImageDistanceX(imgX[i]);
+    aPoint.setGridDistanceX(grdX[i]);
 
-    aPoint.setImageDistanceY(imageDistanceY.length());
-    aPoint.setGridDistanceY(gridDistanceY.length());
+    aPoint.setImageDistanceY(imgY[i]);
+    aPoint.setGridDistanceY(grdY[i]);
 
     /*
     std::cout << "("
@@ -233,6 +332,12 @@ void DefoRecoSurface::calibrateXYPoints(DefoPointCollection & points)
 	      << std::endl;
 	*/
   }
+
+  if (kept<n) {
+    NQLogWarning("DefoRecoSurface") << "calibrateXYPoints: " << n - kept
+                                    << " points without plane intersection skipped";
+    points.erase(points.begin() + kept, points.end());
+  }
 }
 
 ///
@@ -295,122 +400,135 @@ const DefoSplineField DefoRecoSurface::createZSplines(DefoPointCollection const&
   indexRangeY.second = std::min(indexRangeYref.second, indexRangeY.second);
    */
 
-  // we need the blue point (from *ref*) as geom. reference, it always has index 0,0
-  std::pair<bool,DefoPointCollection::const_iterator> bluePointByIndex =
-      findPointByIndex(referencePoints, std::pair<int,int>( 0, 0 ));
+  // lookup tables from index to point, built once for both collections
+  const DefoPointIndexTable currentTable(currentPoints);
+  const DefoPointIndexTable referenceTable(referencePoints);
+
+  // now attach the points to the spline sets according to their indices;
+  // the sets are independent of each other and are fitted in parallel
+
+  // first along-y ("columns")
+  std::vector<DefoSplineSetY> columns(indexRangeX.second - indexRangeX.first + 1);
+  DefoParallelFor(columns.size(),
+                [&](int i) {
+                  createSplineSetY(indexRangeX.first + i, indexRangeY,
+                                   currentTable, referenceTable, columns[i]);
+                });
+
+  // attach to output field (as *second*!!) if there are enough points (min 2)
+  for (std::vector<DefoSplineSetY>::const_iterator it = columns.begin();
+       it != columns.end();
+       ++it) {
+    if( 2 > it->getNPoints() ) continue;
+    theOutput.second.push_back(*it);
+  }
 
-  // now attach the points to the spline sets according to their indices
-  std::pair<int,int> index = std::pair<int,int>( indexRangeX.first, indexRangeY.first );
+  // then along-x ("rows")
+  std::vector<DefoSplineSetX> rows(indexRangeY.second - indexRangeY.first + 1);
+  DefoParallelFor(rows.size(),
+                [&](int i) {
+                  createSplineSetX(indexRangeY.first + i, indexRangeX,
+                                   currentTable, referenceTable, rows[i]);
+                });
+
+  // attach to output field (as *first*!!) if there are enough points (min 2)
+  for (std::vector<DefoSplineSetX>::const_iterator it = rows.begin();
+       it != rows.end();
+       ++it) {
+    if( 2 > it->getNPoints() ) continue;
+    theOutput.first.push_back(*it);
+  }
 
-  // first along-y
-  for( ; index.first <= indexRangeX.second; ++index.first ) {
+  // c'est tout
+  NQLog("DefoRecoSurface", NQLog::Message) << "createZSplines done";
 
-    // create a spline set along-y (a "column") .. 
-    DefoSplineSetY aSplineSet;
-    index.second = indexRangeY.first; // reset
+  return theOutput;
+}
 
-    for( ; index.second <= indexRangeY.second; ++index.second ) {
-      
-      std::pair<bool,DefoPointCollection::const_iterator> currentPointByIndex =
-          findPointByIndex(currentPoints, index);
+///
+/// create and fit the spline set along-y (a "column") with index indexX
+///
+void DefoRecoSurface::createSplineSetY(int indexX,
+                                       std::pair<int,int> const& indexRangeY,
+                                       DefoPointIndexTable const& currentTable,
+                                       DefoPointIndexTable const& referenceTable,
+                                       DefoSplineSetY& aSplineSet) const
+{
+  for (int indexY = indexRangeY.first; indexY <= indexRangeY.second; ++indexY) {
 
-      std::pair<bool,DefoPointCollection::const_iterator> referencePointByIndex =
-          findPointByIndex(referencePoints, index);
-      
-      // check if a point with that index exists in both images
-      // (it should then have been a reflection from the same source)
-      if (currentPointByIndex.first && referencePointByIndex.first) {
+    const DefoPoint* currentPoint = currentTable.find(indexX, indexY);
+    const DefoPoint* referencePoint = referenceTable.find(indexX, indexY);
 
-        // this point is abstract and lives where the *ref* point is on the module
-        // (make a copy)
-        DefoPoint aPoint = DefoPoint(*(referencePointByIndex.second));
+    // check if a point with that index exists in both images
+    // (it should then have been a reflection from the same source)
+    if (currentPoint && referencePoint) {
 
-        // the attached slope (= tan(alpha)) is derived from the difference in y position
-        double currentY = (*(currentPointByIndex.second)).getCalibratedY();
-        double referenceY = (*(referencePointByIndex.second)).getCalibratedY();
-        double dY = 1.0*(currentY - referenceY);
+      // this point is abstract and lives where the *ref* point is on the module
+      // (make a copy)
+      DefoPoint aPoint = DefoPoint(*referencePoint);
 
-        aPoint.setSlope( aPoint.getCorrectionFactor(DefoPoint::Y) * dY);
+      // the attached slope (= tan(alpha)) is derived from the difference in y position
+      double currentY = currentPoint->getCalibratedY();
+      double referenceY = referencePoint->getCalibratedY();
+      double dY = 1.0*(currentY - referenceY);
 
-        aSplineSet.addPoint( aPoint );
+      aPoint.setSlope( aPoint.getCorrectionFactor(DefoPoint::Y) * dY);
 
-        //NQLog("DefoRecoSurface", NQLog::Spam) << "found shared point along y with indices: "
-        //    << index.first << " , " << index.second;
+      aSplineSet.addPoint( aPoint );
 
-      } else {
-        NQLog("DefoRecoSurface", NQLog::Warning) << "Non-shared point along y in current image with indices: "
-            << index.first << " , " << index.second;
-      }
+    } else {
+      NQLog("DefoRecoSurface", NQLog::Warning) << "Non-shared point along y in current image with indices: "
+          << indexX << " , " << indexY;
     }
-    
-    // check if there are enough points attached to the set (min 2)
-    if( 2 > aSplineSet.getNPoints() ) continue;
-
-    // do the fit
-    aSplineSet.doFitZ();
-    
-    // attach to output field (as *second*!!)
-    theOutput.second.push_back(aSplineSet);
   }
 
-  // then along-x
-  index = std::pair<int,int>( indexRangeX.first, indexRangeY.first );
+  // do the fit if there are enough points attached to the set (min 2)
+  if( 2 > aSplineSet.getNPoints() ) return;
 
-  for( ; index.second <= indexRangeY.second; ++index.second ) {
-
-    // create a spline set along-x (a "row") .. 
-    DefoSplineSetX aSplineSet;
-    index.first = indexRangeX.first; // reset
+  aSplineSet.doFitZ();
+}
 
-    for( ; index.first <= indexRangeX.second; ++index.first ) {
-      
-      std::pair<bool,DefoPointCollection::const_iterator> currentPointByIndex =
-          findPointByIndex( currentPoints, index );
+///
+/// create and fit the spline set along-x (a "row") with index indexY
+///
+void DefoRecoSurface::createSplineSetX(int indexY,
+                                       std::pair<int,int> const& indexRangeX,
+                                       DefoPointIndexTable const& currentTable,
+                                       DefoPointIndexTable const& referenceTable,
+                                       DefoSplineSetX& aSplineSet) const
+{
+  for (int indexX = indexRangeX.first; indexX <= indexRangeX.second; ++indexX) {
 
-      std::pair<bool,DefoPointCollection::const_iterator> referencePointByIndex =
-          findPointByIndex( referencePoints, index );
-      
-      // check if a point with that index exists in both images
-      // (it should then have been a reflection from the same source)
-      if (currentPointByIndex.first && referencePointByIndex.first) {
+    const DefoPoint* currentPoint = currentTable.find(indexX, indexY);
+    const DefoPoint* referencePoint = referenceTable.find(indexX, indexY);
 
-        // this point is abstract and lives where the ref point is on the module
-        // (make a copy)
-        DefoPoint aPoint = DefoPoint( *(referencePointByIndex.second) );
-        // convert from pixel units to real units on module
+    // check if a point with that index exists in both images
+    // (it should then have been a reflection from the same source)
+    if (currentPoint && referencePoint) {
 
-        // the attached slope (= tan(alpha)) is derived from the difference in x position
-        double currentX = (*(currentPointByIndex.second)).getCalibratedX();
-        double referenceX = (*(referencePointByIndex.second)).getCalibratedX();
-        double dX = 1.0*(currentX - referenceX);
+      // this point is abstract and lives where the ref point is on the module
+      // (make a copy)
+      DefoPoint aPoint = DefoPoint(*referencePoint);
 
-        aPoint.setSlope( aPoint.getCorrectionFactor(DefoPoint::Y) * dX);
+      // the attached slope (= tan(alpha)) is derived from the difference in x position
+      double currentX = currentPoint->getCalibratedX();
+      double referenceX = referencePoint->getCalibratedX();
+      double dX = 1.0*(currentX - referenceX);
 
-        aSplineSet.addPoint( aPoint );
+      aPoint.setSlope( aPoint.getCorrectionFactor(DefoPoint::Y) * dX);
 
-        //NQLog("DefoRecoSurface", NQLog::Spam) << "found shared point along x with indices: "
-        //    << index.first << " , " << index.second;
+      aSplineSet.addPoint( aPoint );
 
-      } else {
-        NQLog("DefoRecoSurface", NQLog::Warning) << "Non-shared point along x in current image with indices: "
-            << index.first << " , " << index.second;
-      }
+    } else {
+      NQLog("DefoRecoSurface", NQLog::Warning) << "Non-shared point along x in current image with indices: "
+          << indexX << " , " << indexY;
     }
-
-    // check if there are enought points attached to the set (min 2)
-    if( 2 > aSplineSet.getNPoints() ) continue;
-
-    // do the fit
-    aSplineSet.doFitZ();
-    
-    // attach to output field (as *second*!!)
-    theOutput.first.push_back(aSplineSet);
   }
 
-  // c'est tout
-  NQLog("DefoRecoSurface", NQLog::Message) << "createZSplines done";
+  // do the fit if there are enough points attached to the set (min 2)
+  if( 2 > aSplineSet.getNPoints() ) return;
 
-  return theOutput;
+  aSplineSet.doFitZ();
 }
 
 ///
@@ -560,23 +678,6 @@ void DefoRecoSurface::mountZSplines( DefoSplineField& splineField ) const {
   }
 }
 
-const std::pair<bool,DefoPointCollection::const_iterator> 
-DefoRecoSurface::findPointByIndex(DefoPointCollection const& points,
-                                  std::pair<int,int> const& index ) const
-{
-  DefoPointCollection::const_iterator it = points.begin();
-  bool isFound = false;
-
-  for( ; it < points.end(); ++it) {
-    if (index == it->getIndex()) {
-      isFound = true;
-      break;
-    }
-  }
-
-  return std::pair<bool,DefoPointCollection::const_iterator>(isFound, it);
-}
-
 ///
 /// determine and apply a common offset to all spline sets in the field
 /// such that the lowermost point has height zero in the end
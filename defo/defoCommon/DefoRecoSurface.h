@@ -19,6 +19,7 @@
 #include <cmath>
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 #include <QObject>
 
@@ -26,6 +27,26 @@
 #include "DefoSurface.h"
 #include "DefoSpline.h"
 
+///
+/// dense lookup table from grid index to point,
+/// returns the first point of the collection with a given index
+/// like a linear search through the collection would
+///
+class DefoPointIndexTable
+{
+ public:
+  DefoPointIndexTable( DefoPointCollection const& );
+
+  const DefoPoint* find( int indexX, int indexY ) const;
+  const DefoPoint* find( std::pair<int,int> const& index ) const { return find( index.first, index.second ); }
+
+ protected:
+  std::pair<int,int> indexRangeX_;
+  std::pair<int,int> indexRangeY_;
+  int width_;
+  std::vector<const DefoPoint*> table_;
+};
+
 ///
 /// perform surface reconstruction
 /// based on reco point collection
@@ -67,16 +88,17 @@ class DefoRecoSurface : public QObject
 
   void dump();
 
- private:
-
   void calibrateXYPoints(DefoPointCollection & points);
+  double imageScale(double focalLength) const;
+
+ private:
 
   const DefoSplineField createZSplines( DefoPointCollection const&, DefoPointCollection const& );
+  void createSplineSetY( int, std::pair<int,int> const&, DefoPointIndexTable const&, DefoPointIndexTable const&, DefoSplineSetY& ) const;
+  void createSplineSetX( int, std::pair<int,int> const&, DefoPointIndexTable const&, DefoPointIndexTable const&, DefoSplineSetX& ) const;
   void mountZSplines( DefoSplineField& ) const;
-  const std::pair<bool,DefoPointCollection::const_iterator> findPointByIndex( DefoPointCollection const&, std::pair<int,int> const& ) const;
   void removeGlobalOffset( DefoSplineField& ) const;
   void removeTilt( DefoSplineField& ) const;
-  double imageScale(double focalLength) const;
 
   int spacingEstimate_;
   int searchPathHalfWidth_;
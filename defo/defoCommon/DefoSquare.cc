@@ -12,6 +12,9 @@
 
 
 
+#include <cmath>
+#include <algorithm>
+
 #include "DefoSquare.h"
 
 ///
@@ -180,3 +183,124 @@ void DefoSquareCollection::makeEmpty( void ) {
 //  else
 //    return NULL;
 //}
+
+
+
+///
+///
+///
+DefoSquareGrid::DefoSquareGrid( const QRect& area, const unsigned int& theHalfWidth ) {
+
+  area_ = area;
+  halfWidth_ = theHalfWidth;
+
+  // a point can only be inside squares centered in its own or a neighbouring cell
+  cellSize_ = std::max( 1, 2 * static_cast<int>( halfWidth_ ) );
+  nCellsX_ = std::max( 1, area_.width() / cellSize_ + 1 );
+  nCellsY_ = std::max( 1, area_.height() / cellSize_ + 1 );
+
+  cells_.resize( nCellsX_ * nCellsY_ );
+
+}
+
+
+
+///
+///
+///
+int DefoSquareGrid::cellX( double x ) const {
+
+  int cell = static_cast<int>( std::floor( ( x - area_.x() ) / cellSize_ ) );
+  return std::min( std::max( cell, 0 ), nCellsX_ - 1 );
+
+}
+
+
+
+///
+///
+///
+int DefoSquareGrid::cellY( double y ) const {
+
+  int cell = static_cast<int>( std::floor( ( y - area_.y() ) / cellSize_ ) );
+  return std::min( std::max( cell, 0 ), nCellsY_ - 1 );
+
+}
+
+
+
+///
+///
+///
+void DefoSquareGrid::push_back( const DefoSquare& aSquare ) {
+
+  const int cx = cellX( aSquare.getCenter().getX() );
+  const int cy = cellY( aSquare.getCenter().getY() );
+
+  cells_[ cy * nCellsX_ + cx ].push_back( squares_.size() );
+  squares_.push_back( aSquare );
+
+}
+
+
+
+///
+/// returns the square containing aPoint that extends furthest
+/// in x or NULL if aPoint is not inside any square
+///
+const DefoSquare* DefoSquareGrid::findSquare( const DefoPoint& aPoint ) const {
+
+  const DefoSquare* found = NULL;
+
+  const int cx = cellX( aPoint.getX() );
+  const int cy = cellY( aPoint.getY() );
+
+  for( int iy = std::max( cy - 1, 0 ); iy <= std::min( cy + 1, nCellsY_ - 1 ); ++iy ) {
+    for( int ix = std::max( cx - 1, 0 ); ix <= std::min( cx + 1, nCellsX_ - 1 ); ++ix ) {
+
+      const std::vector<unsigned int>& cell = cells_[ iy * nCellsX_ + ix ];
+
+      for( std::vector<unsigned int>::const_iterator it = cell.begin(); it != cell.end(); ++it ) {
+        const DefoSquare& square = squares_[ *it ];
+        if( square.isInside( aPoint ) &&
+            ( found == NULL || square.getCenter().getX() > found->getCenter().getX() ) ) {
+          found = &square;
+        }
+      }
+
+    }
+  }
+
+  return found;
+
+}
+
+
+
+///
+///
+///
+bool DefoSquareGrid::isInside( const DefoPoint& aPoint ) const {
+
+  return findSquare( aPoint ) != NULL;
+
+}
+
+
+
+///
+/// returns the first pixel column >= x in row y that is not inside
+/// any of the squares, leaping over forbidden spans in one step
+///
+int DefoSquareGrid::nextOutside( int x, int y ) const {
+
+  const DefoSquare* square;
+
+  while( ( square = findSquare( DefoPoint( x, y ) ) ) != NULL ) {
+    // squares are open intervals, the first pixel at or beyond the right edge is outside
+    x = static_cast<int>( std::ceil( square->getCenter().getX() + square->getHalfWidth() ) );
+  }
+
+  return x;
+
+}
@@ -15,7 +15,11 @@
 #define _DEFOSQUARE_H
 
 
+#include <vector>
+
 #include <QImage>
+#include <QRect>
+
 #include "DefoPoint.h"
 
 class DefoSquareIterator;
@@ -80,4 +84,36 @@ class DefoSquareCollection : public std::vector<DefoSquare> {
 
 };
 
+
+///
+/// collection of squares with equal half width, bucketed in a regular grid
+/// of cells with the size of a square. Membership tests only look at the
+/// squares in the neighbouring cells and therefore cost O(1) independent of
+/// the number of squares in the collection.
+///
+class DefoSquareGrid {
+
+ public:
+  DefoSquareGrid( const QRect& area, const unsigned int& theHalfWidth );
+  void push_back( const DefoSquare& );
+  bool isInside( const DefoPoint& ) const;
+  int nextOutside( int x, int y ) const;
+  size_t size( void ) const { return squares_.size(); }
+  const DefoSquareCollection& getSquares( void ) const { return squares_; }
+
+ private:
+  int cellX( double x ) const;
+  int cellY( double y ) const;
+  const DefoSquare* findSquare( const DefoPoint& ) const;
+
+  QRect area_;
+  unsigned int halfWidth_;
+  int cellSize_;
+  int nCellsX_;
+  int nCellsY_;
+  DefoSquareCollection squares_;
+  std::vector<std::vector<unsigned int> > cells_;
+
+};
+
 #endif
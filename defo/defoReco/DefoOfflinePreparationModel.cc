@@ -101,27 +101,27 @@ void DefoOfflinePreparationModel::prepare()
     return;
   }
 
-  const DefoPointCollection* refPoints = listModel_->getMeasurementPoints(refMeasurement_);
+  DefoPointSnapshot refPoints = listModel_->getMeasurementPointSnapshot(refMeasurement_);
   if (!refPoints || refPoints->size()==0) {
      NQLogWarning("DefoOfflinePreparationModel") 
        << "reco: reference measurement does not contain points";
     return;
   }
 
-  const DefoPointCollection* defoPoints = listModel_->getMeasurementPoints(defoMeasurement_);
+  DefoPointSnapshot defoPoints = listModel_->getMeasurementPointSnapshot(defoMeasurement_);
   if (!defoPoints || defoPoints->size()==0) {
     NQLogWarning("DefoOfflinePreparationModel") 
       << "reco: deformed measurement does not contain points";
     return;
   }
 
-  if (!alignPoints(refPoints, refCollection_)) {
+  if (!alignPoints(refPoints.data(), refCollection_)) {
     NQLogWarning("DefoOfflinePreparationModel") 
       << "reco: reference points could not be aligned";
     return;
   }
 
-  if (!alignPoints(defoPoints, defoCollection_)) {
+  if (!alignPoints(defoPoints.data(), defoCollection_)) {
      NQLogWarning("DefoOfflinePreparationModel") 
        << "reco: deformed points could not be aligned";
     return;
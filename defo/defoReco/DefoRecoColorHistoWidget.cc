@@ -74,7 +74,7 @@ void DefoRecoColorHistoWidget::paintEvent(QPaintEvent *event) {
   if (selectionModel_->getSelection() != NULL) {
 
     DefoMeasurement* measurement = selectionModel_->getSelection();
-    const DefoPointCollection* points = listModel_->getMeasurementPoints(measurement);
+    DefoPointSnapshot points = listModel_->getMeasurementPointSnapshot(measurement);
 
     if (points && points->size()>0) {
 
@@ -39,8 +39,6 @@ void DefoRecoMeasurementListModel::read(const QString& filename) {
       measurement = new DefoRecoMeasurement(dt);
       measurement->read(basepath);
 
-      measurement->readImages();
-
       addMeasurement(measurement);
     }
   }
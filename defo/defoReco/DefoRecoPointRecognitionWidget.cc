@@ -5,7 +5,7 @@
 
 #include "DefoThresholdSpinBox.h"
 #include "DefoHalfSquareWidthSpinBox.h"
-#include "DefoPointFinder.h"
+#include "DefoPointFinderPool.h"
 #include "DefoPoint.h"
 #include "DefoPointSaver.h"
 #include "DefoRecoMeasurement.h"
@@ -119,8 +119,6 @@ void DefoRecoPointRecognitionWidget::findPointsButtonClicked()
   DefoMeasurement* measurement = selectionModel_->getSelection();
   listModel_->setMeasurementPoints(measurement, NULL);
 
-  DefoPointFinder* finder;
-
   QRect imageArea = measurement->getImage().rect();
   QRectF roiArea = roiModel_->boundingRect();
   float xmin = roiArea.left();
@@ -133,41 +131,19 @@ void DefoRecoPointRecognitionWidget::findPointsButtonClicked()
                    (xmax-xmin)*imageArea.width(),
                    (ymax-ymin)*imageArea.height() + pointModel_->getHalfSquareWidth());
 
-  /*
-    The number of blocks depends on the number of cores available and the
-    number of cores you want to be available for other tasks.
-   */
-  const int blocks = 6;
-  const int width = searchArea.width() / blocks;
-
   bool do2Dfit = fitPoints_->isChecked();
 
-  for (double i = 0; i < blocks; ++i) {
-
-    /*
-      In Qt the rectangle borders are placed ON the pixels, in contrast to e.g.
-      Swing where they are in between the pixels.
-      As a consequence, the right-side border has to be one pixel to the left in
-      order to avoid overlapping rectangles.
-     */
-    QRect area = searchArea;
-    area.setX(searchArea.x()+i*width - pointModel_->getHalfSquareWidth());
-    area.setWidth(width + 2 * pointModel_->getHalfSquareWidth());
-
-    finder = new DefoPointFinder(i,
-                                 &mutex_,
-                                 listModel_,
-                                 pointModel_,
-                                 measurement,
-                                 area,
-                                 do2Dfit,
-                                 roiModel_);
-    
-    connect(finder, SIGNAL(finished()),
-            finder, SLOT(deleteLater()));
-
-    finder->start();
-  }
+  DefoPointFinderPool* finder = new DefoPointFinderPool(listModel_,
+                                                        pointModel_,
+                                                        measurement,
+                                                        searchArea,
+                                                        do2Dfit,
+                                                        roiModel_);
+
+  connect(finder, SIGNAL(finished()),
+          finder, SLOT(deleteLater()));
+
+  finder->start();
 }
 
 void DefoRecoPointRecognitionWidget::savePointsButtonClicked()
@@ -177,7 +153,8 @@ void DefoRecoPointRecognitionWidget::savePointsButtonClicked()
   if (file.length() > 0) {
     DefoPointSaver saver(file);
     DefoMeasurement* meas = selectionModel_->getSelection();
-    const DefoPointCollection* points = listModel_->getMeasurementPoints(meas);
+    DefoPointSnapshot points = listModel_->getMeasurementPointSnapshot(meas);
+    if (!points) return;
 
     saver.writePoints(*points);
   }
@@ -47,8 +47,6 @@ protected:
   QPushButton* findPoints_;
   QPushButton* savePoints_;
 
-  QMutex mutex_;
-
 protected slots:
 
   void findPointsButtonClicked();
@@ -261,14 +261,14 @@ void DefoReconstructionModel::reconstruct()
     return;
   }
 
-  const DefoPointCollection* refPoints = listModel_->getMeasurementPoints(refMeasurement_);
+  DefoPointSnapshot refPoints = listModel_->getMeasurementPointSnapshot(refMeasurement_);
   if (!refPoints || refPoints->size()==0) {
      NQLogWarning("DefoOfflinePreparationModel") 
        << "reco: reference measurement does not contain points";
     return;
   }
 
-  const DefoPointCollection* defoPoints = listModel_->getMeasurementPoints(defoMeasurement_);
+  DefoPointSnapshot defoPoints = listModel_->getMeasurementPointSnapshot(defoMeasurement_);
   if (!defoPoints || defoPoints->size()==0) {
     NQLogWarning("DefoOfflinePreparationModel") 
       << "reco: deformed measurement does not contain points";
@@ -278,13 +278,13 @@ void DefoReconstructionModel::reconstruct()
   reco_->setImageSize(std::pair<double,double>(refMeasurement_->getWidth(),
                                                refMeasurement_->getHeight()));
 
-  if (!alignPoints(refPoints, refCollection_)) {
+  if (!alignPoints(refPoints.data(), refCollection_)) {
     std::cout << "reco: reference points could not be aligned" << std::endl;
     return;
   }
   emit incrementProgress();
 
-  if (!alignPoints(defoPoints, defoCollection_)) {
+  if (!alignPoints(defoPoints.data(), defoCollection_)) {
     NQLogWarning("DefoOfflinePreparationModel") 
       << "reco: reference points could not be aligned";
     return;
@@ -16,6 +16,9 @@
 
 AgilentTwisTorr304ComHandler::AgilentTwisTorr304ComHandler( const ioport_t ioPort )
 {
+  fTransport.SetFrameEnd( 0x03, 2 );
+  fTransport.SetTimeout( 1500 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -39,19 +42,8 @@ AgilentTwisTorr304ComHandler::~AgilentTwisTorr304ComHandler( void )
 //! Send the command string &lt;commandString&gt; to device.
 void AgilentTwisTorr304ComHandler::SendCommand( const char *commandString )
 {
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-//   std::cout << "write: " << commandString << std::endl;
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\n" );
 }
 
 //! flush the IO memory
@@ -64,6 +56,9 @@ void AgilentTwisTorr304ComHandler::flush(void)
       perror("tcflush error");
     }
     sleep(1);
+
+    // drop what the transport buffered already
+    fTransport.Discard();
 }
 
 //! Read a string from device.
@@ -78,25 +73,7 @@ void AgilentTwisTorr304ComHandler::flush(void)
 */
 void AgilentTwisTorr304ComHandler::ReceiveString( char *receiveString )
 {
-  usleep( ComHandlerDelay );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 10 )  {
-
-    usleep( 100000 );
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-//       std::cout << "read: " << readResult << " " << receiveString << std::endl;
-      return;
-    }
-    timeout++;
-  }
-
-  //std::cout << "timeout" << std::endl;
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -118,6 +95,9 @@ void AgilentTwisTorr304ComHandler::OpenIoPort( void ) noexcept(false)
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 }
 
@@ -177,14 +157,8 @@ void AgilentTwisTorr304ComHandler::RestoreIoPort( void )
 */
 void AgilentTwisTorr304ComHandler::CloseIoPort( void )
 {
+  fTransport.SetFileDescriptor( -1 );
+
   close( fIoPortFileDescriptor );
 }
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void AgilentTwisTorr304ComHandler::SendFeedString( void )
-{
-  write(fIoPortFileDescriptor, "\n", 1);
-}
@@ -22,6 +22,8 @@
 #include <unistd.h>
 #include <cmath>
 
+#include "../Serial/SerialTransport.h"
+
 /** @addtogroup devices
  *  @{
  */
@@ -65,7 +67,6 @@ class AgilentTwisTorr304ComHandler
 
   void flush( void);
 
-  static constexpr int ComHandlerDelay = 1000;
 
  private:
 
@@ -73,9 +74,9 @@ class AgilentTwisTorr304ComHandler
   void InitializeIoPort();
   void RestoreIoPort();
   void CloseIoPort();
-  void SendFeedString();
 
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
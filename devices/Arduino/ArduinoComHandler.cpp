@@ -21,6 +21,9 @@
 */
 ArduinoComHandler::ArduinoComHandler( const ioport_t ioPort ) {
 
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 1500 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -43,22 +46,10 @@ ArduinoComHandler::~ArduinoComHandler( void ) {
 
 //! Send the command string &lt;commandString&gt; to device.
 void ArduinoComHandler::SendCommand( const char *commandString ) {
-
   if (!fDeviceAvailable) return;
 
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-//   std::cout << "write: -" << commandString <<"-"<< std::endl;
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\n" );
 }
 
 //! Read a string from device.
@@ -72,32 +63,7 @@ void ArduinoComHandler::SendCommand( const char *commandString ) {
   See example program in class description.
 */
 void ArduinoComHandler::ReceiveString( char *receiveString ) {
-
-  if (!fDeviceAvailable) {
-    receiveString[0] = 0;
-    return;
-  }
-
-  usleep( ComHandlerDelay );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 10 )  {
-
-    usleep( 100000 );
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 12 );
-    // std::cout << "read: -" << readResult << "- -" << receiveString <<"-"<< std::endl;
-
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-      // std::cout << "read: -" << readResult << "- -" << receiveString <<"-"<< std::endl;
-      return;
-    }
-    timeout++;
-  }
-
-  //std::cout << "timeout" << std::endl;
+  fTransport.ReceiveString( receiveString, 13 );
 }
 
 //! Open I/O port.
@@ -120,6 +86,9 @@ void ArduinoComHandler::OpenIoPort( void ) noexcept(false) {
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 
   fDeviceAvailable = true;
@@ -193,20 +162,13 @@ void ArduinoComHandler::RestoreIoPort( void ) {
 */
 void ArduinoComHandler::CloseIoPort( void ) {
 
+  fTransport.SetFileDescriptor( -1 );
+
   if (!fDeviceAvailable) return;
 
   close( fIoPortFileDescriptor );
 }
 
-//! Send command termination string (<NL>).
-/*!
-  \internal
-*/
-void ArduinoComHandler::SendFeedString( void )
-{
-  write( fIoPortFileDescriptor, "\n", 1 );
-}
-
 bool ArduinoComHandler::DeviceAvailable()
 {
   return fDeviceAvailable;
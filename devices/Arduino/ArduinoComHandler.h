@@ -8,6 +8,8 @@
 #include <unistd.h>
 #include <cmath>
 
+#include "../Serial/SerialTransport.h"
+
 typedef const char* ioport_t;
 typedef struct termios termios_t;
 
@@ -29,7 +31,6 @@ class ArduinoComHandler {
 
   bool DeviceAvailable();
 
-  static constexpr int ComHandlerDelay = 1000;
 
  private:
 
@@ -37,10 +38,10 @@ class ArduinoComHandler {
   void InitializeIoPort( void );
   void RestoreIoPort( void );
   void CloseIoPort( void );
-  void SendFeedString( void );
 
   bool fDeviceAvailable;
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
@@ -31,6 +31,9 @@
 */
 CoriFlowComHandler::CoriFlowComHandler( const ioport_t ioPort ) {
 
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 1500 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -53,20 +56,8 @@ CoriFlowComHandler::~CoriFlowComHandler( void ) {
 
 //! Send the command string &lt;commandString&gt; to device.
 void CoriFlowComHandler::SendCommand( const char *commandString ) {
-
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-//   std::cout << "write: " << commandString << std::endl;
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, std::string( "\r\n\0", 3 ) );
 }
 
 //! flush the IO memory
@@ -79,6 +70,9 @@ void CoriFlowComHandler::flush(void) {
       perror("tcflush error");
     }
     sleep(1);
+
+    // drop what the transport buffered already
+    fTransport.Discard();
 }
 
 //! Read a string from device.
@@ -92,26 +86,7 @@ void CoriFlowComHandler::flush(void) {
   See example program in class description.
 */
 void CoriFlowComHandler::ReceiveString( char *receiveString ) {
-
-  usleep( ComHandlerDelay );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 10 )  {
-
-    usleep( 100000 );
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-//       std::cout << "read: " << readResult << " " << receiveString << std::endl;
-      return;
-    }
-    timeout++;
-  }
-
-  //std::cout << "timeout" << std::endl;
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -133,6 +108,9 @@ void CoriFlowComHandler::OpenIoPort( void ) noexcept(false) {
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 }
 
@@ -194,14 +172,8 @@ void CoriFlowComHandler::RestoreIoPort( void ) {
 */
 void CoriFlowComHandler::CloseIoPort( void ) {
 
+  fTransport.SetFileDescriptor( -1 );
+
   close( fIoPortFileDescriptor );
 }
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void CoriFlowComHandler::SendFeedString( void )
-{
-  write( fIoPortFileDescriptor, "\r\n", 4 ); // /r nicht noetig?
-}
@@ -33,6 +33,9 @@
 */
 GMH3750ComHandler::GMH3750ComHandler( ioport_t ioPort )
 {
+  fTransport.SetQuietTime( 20 );
+  fTransport.SetTimeout( 1000 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -56,20 +59,12 @@ GMH3750ComHandler::~GMH3750ComHandler( void )
 //! Send the command string &lt;commandString&gt; to device.
 void GMH3750ComHandler::SendCommand( const char *commandString, int length )
 {
-  char singleCharacter = 0; 
   int size = length;
   if (length==-1) size = strlen( commandString );
 
-  for ( unsigned int i = 0; i < size; i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-  
-  // send feed characters
-  //SendFeedString();
+  // the frames are binary, no feed characters
+  fTransport.Write( commandString, size );
+  fTransport.Flush();
 }
 
 //! Read a string from device.
@@ -84,24 +79,8 @@ void GMH3750ComHandler::SendCommand( const char *commandString, int length )
 */
 void GMH3750ComHandler::ReceiveString( char *receiveString )
 {
-  usleep( _COMHANDLER_DELAY );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 500000 )  {
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 )   {
-    
-      receiveString[readResult] = 0;
-      break;
-    }
-    
-    timeout++;
-  }
-  
-  std::cout << "TO: " << timeout << std::endl; /////////////////////////////////
+  // the response ends when the line stays quiet
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -126,6 +105,9 @@ void GMH3750ComHandler::OpenIoPort( void )
   
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   
   }
 
@@ -199,18 +181,8 @@ void GMH3750ComHandler::RestoreIoPort( void )
 */
 void GMH3750ComHandler::CloseIoPort( void )
 {
+  fTransport.SetFileDescriptor( -1 );
+
   close( fIoPortFileDescriptor );
 }
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void GMH3750ComHandler::SendFeedString( void )
-{
-  // feed string is <NL>
-  char feedString = 10;
-
-  // write <CR> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
-}
@@ -23,6 +23,9 @@
 */
 HO820ComHandler::HO820ComHandler(ioport_t ioPort)
 {
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 1000 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -45,17 +48,8 @@ void HO820ComHandler::SendCommand( const char *commandString )
 {
   if (!fDeviceAvailable) return;
 
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\n" );
 }
 
 //! Read a string from device.
@@ -70,26 +64,7 @@ void HO820ComHandler::SendCommand( const char *commandString )
 */
 void HO820ComHandler::ReceiveString( char *receiveString )
 {
-  if (!fDeviceAvailable) {
-    receiveString[0] = 0;
-    return;
-  }
-
-  usleep( 10000 );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 100000 )  {
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-      break;
-    }
-    
-    timeout++;
-  }
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -112,6 +87,9 @@ void HO820ComHandler::OpenIoPort( void )
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 
   fDeviceAvailable = true;
@@ -147,24 +125,11 @@ void HO820ComHandler::RestoreIoPort( void )
 */
 void HO820ComHandler::CloseIoPort( void )
 {
-  if (!fDeviceAvailable) return;
-
-  close( fIoPortFileDescriptor );
-}
+  fTransport.SetFileDescriptor( -1 );
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void HO820ComHandler::SendFeedString( void )
-{
   if (!fDeviceAvailable) return;
 
-  // feed string is <NL>
-  char feedString = 10;
-
-  // write <CR> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
+  close( fIoPortFileDescriptor );
 }
 
 bool HO820ComHandler::DeviceAvailable()
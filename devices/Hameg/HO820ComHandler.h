@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include "../Serial/SerialTransport.h"
+
 /** @addtogroup devices
  *  @{
  */
@@ -54,10 +56,10 @@ class HO820ComHandler {
   void InitializeIoPort( void );
   void RestoreIoPort( void );
   void CloseIoPort( void );
-  void SendFeedString( void );
 
   bool fDeviceAvailable;
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
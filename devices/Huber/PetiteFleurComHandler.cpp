@@ -33,6 +33,9 @@
 */
 PetiteFleurComHandler::PetiteFleurComHandler( const ioport_t ioPort ) {
 
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 1500 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -55,20 +58,8 @@ PetiteFleurComHandler::~PetiteFleurComHandler( void ) {
 
 //! Send the command string &lt;commandString&gt; to device.
 void PetiteFleurComHandler::SendCommand( const char *commandString ) {
-
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-  //std::cout << "write: " << commandString << std::endl;
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\n\r" );
 }
 
 //! Read a string from device.
@@ -82,26 +73,7 @@ void PetiteFleurComHandler::SendCommand( const char *commandString ) {
   See example program in class description.
 */
 void PetiteFleurComHandler::ReceiveString( char *receiveString ) {
-
-  usleep( ComHandlerDelay );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 10 )  {
-
-    usleep( 100000 );
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-      //std::cout << "read: " << readResult << " " << receiveString << std::endl;
-      return;
-    }
-    timeout++;
-  }
-
-  //std::cout << "timeout" << std::endl;
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -123,6 +95,9 @@ void PetiteFleurComHandler::OpenIoPort( void ) noexcept(false) {
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 }
 
@@ -224,14 +199,8 @@ void PetiteFleurComHandler::RestoreIoPort( void ) {
 */
 void PetiteFleurComHandler::CloseIoPort( void ) {
 
+  fTransport.SetFileDescriptor( -1 );
+
   close( fIoPortFileDescriptor );
 }
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void PetiteFleurComHandler::SendFeedString( void )
-{
-  write( fIoPortFileDescriptor, "\n\r", 2 );
-}
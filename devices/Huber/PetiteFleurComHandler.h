@@ -20,6 +20,8 @@
 #include <unistd.h>
 #include <cmath>
 
+#include "../Serial/SerialTransport.h"
+
 typedef const char* ioport_t;
 typedef struct termios termios_t;
 
@@ -39,7 +41,6 @@ class PetiteFleurComHandler {
   void SendCommand( const char* );
   void ReceiveString( char* );
 
-  static constexpr int ComHandlerDelay = 1000;
 
  private:
 
@@ -47,9 +48,9 @@ class PetiteFleurComHandler {
   void InitializeIoPort( void );
   void RestoreIoPort( void );
   void CloseIoPort( void );
-  void SendFeedString( void );
 
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
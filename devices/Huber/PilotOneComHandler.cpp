@@ -23,6 +23,9 @@
 */
 PilotOneComHandler::PilotOneComHandler(ioport_t ioPort)
 {
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 1000 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -45,10 +48,8 @@ void PilotOneComHandler::SendCommand(const char *commandString)
 {
   if (!fDeviceAvailable) return;
 
-  std::string theCommand = commandString;
-  theCommand += "\r\n";
-
-  write( fIoPortFileDescriptor, theCommand.c_str(), theCommand.length());
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\r\n" );
 }
 
 //! Read a string from device.
@@ -63,26 +64,7 @@ void PilotOneComHandler::SendCommand(const char *commandString)
 */
 void PilotOneComHandler::ReceiveString( char *receiveString )
 {
-  if (!fDeviceAvailable) {
-    receiveString[0] = 0;
-    return;
-  }
-
-  usleep( 10000 );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 100000 )  {
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-      break;
-    }
-    
-    timeout++;
-  }
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -105,6 +87,9 @@ void PilotOneComHandler::OpenIoPort( void )
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 
   fDeviceAvailable = true;
@@ -140,6 +125,8 @@ void PilotOneComHandler::RestoreIoPort( void )
 */
 void PilotOneComHandler::CloseIoPort( void )
 {
+  fTransport.SetFileDescriptor( -1 );
+
   if (!fDeviceAvailable) return;
 
   close( fIoPortFileDescriptor );
@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include "../Serial/SerialTransport.h"
+
 typedef const char* ioport_t;
 typedef struct termios termios_t;
 
@@ -49,6 +51,7 @@ class PilotOneComHandler {
 
   bool fDeviceAvailable;
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
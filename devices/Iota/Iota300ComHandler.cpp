@@ -31,6 +31,9 @@
 */
 Iota300ComHandler::Iota300ComHandler( const ioport_t ioPort ) {
 
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 1500 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -53,20 +56,8 @@ Iota300ComHandler::~Iota300ComHandler( void ) {
 
 //! Send the command string &lt;commandString&gt; to device.
 void Iota300ComHandler::SendCommand( const char *commandString ) {
-
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-//   std::cout << "write: " << commandString << std::endl;
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, std::string( "\n", 2 ) );
 }
 
 //! flush the IO memory
@@ -79,6 +70,9 @@ void Iota300ComHandler::flush(void) {
       perror("tcflush error");
     }
     sleep(1);
+
+    // drop what the transport buffered already
+    fTransport.Discard();
 }
 
 //! Read a string from device.
@@ -92,26 +86,7 @@ void Iota300ComHandler::flush(void) {
   See example program in class description.
 */
 void Iota300ComHandler::ReceiveString( char *receiveString ) {
-
-  usleep( ComHandlerDelay );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 10 )  {
-
-    usleep( 100000 );
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-//       std::cout << "read: " << readResult << " " << receiveString << std::endl;
-      return;
-    }
-    timeout++;
-  }
-
-  //std::cout << "timeout" << std::endl;
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -133,6 +108,9 @@ void Iota300ComHandler::OpenIoPort( void ) noexcept(false) {
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 }
 
@@ -194,14 +172,8 @@ void Iota300ComHandler::RestoreIoPort( void ) {
 */
 void Iota300ComHandler::CloseIoPort( void ) {
 
+  fTransport.SetFileDescriptor( -1 );
+
   close( fIoPortFileDescriptor );
 }
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void Iota300ComHandler::SendFeedString( void )
-{
-  write( fIoPortFileDescriptor, "\n", 2 ); // /r nicht noetig?
-}
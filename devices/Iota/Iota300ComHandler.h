@@ -22,6 +22,8 @@
 #include <unistd.h>
 #include <cmath>
 
+#include "../Serial/SerialTransport.h"
+
 #define COM1 "/dev/ttyS0"
 #define COM2 "/dev/ttyS1"
 #define COM3 "/dev/ttyS2"
@@ -57,7 +59,6 @@ class Iota300ComHandler {
 
   void flush( void);
 
-  static constexpr int ComHandlerDelay = 1000;
 
  private:
 
@@ -65,10 +66,10 @@ class Iota300ComHandler {
   void InitializeIoPort( void );
   void RestoreIoPort( void );
   void CloseIoPort( void );
-  void SendFeedString( void );
 
 
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
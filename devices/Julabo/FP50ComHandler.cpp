@@ -28,6 +28,9 @@
 */
 FP50ComHandler::FP50ComHandler( const ioport_t ioPort ) {
 
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 1000 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -50,19 +53,8 @@ FP50ComHandler::~FP50ComHandler( void ) {
 
 //! Send the command string &lt;commandString&gt; to device.
 void FP50ComHandler::SendCommand( const char *commandString ) {
-
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-
-  }
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\n" );
 }
 
 //! Read a string from device.
@@ -76,23 +68,7 @@ void FP50ComHandler::SendCommand( const char *commandString ) {
   See example program in class description.
 */
 void FP50ComHandler::ReceiveString( char *receiveString ) {
-
-  usleep( ComHandlerDelay );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 100000 )  {
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 )   {
-      receiveString[readResult] = 0;
-      break;
-    }
-    
-    timeout++;
-
-  }
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -115,6 +91,9 @@ void FP50ComHandler::OpenIoPort( void ) noexcept(false) {
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 }
 
@@ -216,20 +195,8 @@ void FP50ComHandler::RestoreIoPort( void ) {
 */
 void FP50ComHandler::CloseIoPort( void ) {
 
-  close( fIoPortFileDescriptor );
-}
+  fTransport.SetFileDescriptor( -1 );
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void FP50ComHandler::SendFeedString( void ) {
-
-  // feed string is <NL>
-  char feedString = 10;
-
-  // write <CR> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
+  close( fIoPortFileDescriptor );
 }
 
-
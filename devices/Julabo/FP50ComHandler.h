@@ -22,6 +22,8 @@
 #include <unistd.h>
 #include <cmath>
 
+#include "../Serial/SerialTransport.h"
+
 #define COM1 "/dev/ttyS0"
 #define COM2 "/dev/ttyS1"
 #define COM3 "/dev/ttyS2"
@@ -51,7 +53,6 @@ class FP50ComHandler {
   void SendCommand( const char* );
   void ReceiveString( char* );
 
-  static constexpr int ComHandlerDelay = 1000;
 
  private:
 
@@ -59,9 +60,9 @@ class FP50ComHandler {
   void InitializeIoPort( void );
   void RestoreIoPort( void );
   void CloseIoPort( void );
-  void SendFeedString( void );
 
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
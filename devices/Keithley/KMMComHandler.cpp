@@ -32,6 +32,9 @@
 */
 KMMComHandler::KMMComHandler( ioport_t ioPort ) {
 
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 2000 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -55,20 +58,8 @@ KMMComHandler::~KMMComHandler( void ) {
 //! Send the command string &lt;commandString&gt; to device.
 void KMMComHandler::SendCommand( const char *commandString )
 {
-  if (fIoPortFileDescriptor != -1 ) {
-
-    char singleCharacter = 0; 
-    
-    for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-      
-      // scan command string character wise & write
-      singleCharacter = commandString[i];
-      write( fIoPortFileDescriptor, &singleCharacter, 1 );
-    }
-    
-    // send feed characters ( <CR> <LF> )
-    SendFeedString();
-  }
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\n" );
 }
 
 //! Read a string from device.
@@ -82,26 +73,7 @@ void KMMComHandler::SendCommand( const char *commandString )
   See example program in class description.
 */
 void KMMComHandler::ReceiveString( char *receiveString ) {
-
-  usleep( 1000000 );
-
-  if (fIoPortFileDescriptor != -1 ) {
-    int timeout = 0, readResult = 0;
-    
-    while ( timeout < 100000 )  {
-      
-      readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-      
-      if ( readResult > 0 )   {
-	receiveString[readResult] = 0;
-	break;
-      }
-      
-      timeout++;
-    }
-  } else {
-    receiveString[0] = 0;
-  }
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -125,6 +97,9 @@ void KMMComHandler::OpenIoPort( void ) noexcept(false)
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 }
 
@@ -185,20 +160,10 @@ void KMMComHandler::RestoreIoPort( void )
 */
 void KMMComHandler::CloseIoPort( void )
 {
+  fTransport.SetFileDescriptor( -1 );
+
   if (fIoPortFileDescriptor != -1 ) {
     close( fIoPortFileDescriptor );
   }
 }
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void KMMComHandler::SendFeedString( void )
-{
-  // feed string is <NL>
-  char feedString = 10;
-  
-  // write <CR> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
-}
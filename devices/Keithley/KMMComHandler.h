@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include "../Serial/SerialTransport.h"
+
 #define COM1 "/dev/ttyS0"
 #define COM2 "/dev/ttyS1"
 #define COM3 "/dev/ttyS2"
@@ -62,9 +64,9 @@ class KMMComHandler
   void InitializeIoPort( void );
   void RestoreIoPort( void );
   void CloseIoPort( void );
-  void SendFeedString( void );
 
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
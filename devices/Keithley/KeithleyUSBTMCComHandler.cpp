@@ -32,6 +32,9 @@
 */
 KeithleyUSBTMCComHandler::KeithleyUSBTMCComHandler(ioport_t ioPort)
 {
+  fTransport.SetPollable( false );
+  fTransport.SetLineEnd( "\n" );
+
 #ifdef __DEBUG
   std::cout << "KeithleyUSBTMCComHandler::KeithleyUSBTMCComHandler(ioport_t ioPort)" << std::endl;
 #endif
@@ -61,11 +64,9 @@ void KeithleyUSBTMCComHandler::SendCommand( const char *commandString )
 	    << commandString << std::endl;
 #endif
 
-  std::string theCommand = commandString;
-  theCommand += "\n";
-  
-  write( fIoPortFileDescriptor, theCommand.c_str(), strlen(theCommand.c_str()));
-  
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\n" );
+
   usleep(10);
 }
 
@@ -91,31 +92,13 @@ void KeithleyUSBTMCComHandler::ReceiveString( char *receiveString )
     return;
   }
  
-  int timeout = 0, readResult = 0;
-
-  /*
-  while (timeout < 100000)  {
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    // std::cout << "receiveString: " << readResult << " " << receiveString << std::endl;
-    
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-      break;
-    }
-    
-    timeout++;
-  }
-  */
-  
-  readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
+  // the driver returns a complete message per read
 #ifdef __DEBUG
-  std::cout << "receiveString: " << readResult << " " << receiveString << std::endl;
+  size_t length = fTransport.ReceiveString( receiveString, 1024 );
+  std::cout << "receiveString: " << length << " " << receiveString << std::endl;
+#else
+  fTransport.ReceiveString( receiveString, 1024 );
 #endif
-
-  usleep(10);
 }
 
 //! Open I/O port.
@@ -143,6 +126,9 @@ void KeithleyUSBTMCComHandler::OpenIoPort( void )
     // configure port with no delay
     // fcntl(fIoPortFileDescriptor, F_SETFL, FNDELAY);
 
+    // buffered I/O on the port, the usbtmc driver does not support poll
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
+
 #ifndef USE_FAKEIO
     int rv = ioctl(fIoPortFileDescriptor, USBTMC_IOCTL_CLEAR);
     if(rv==-1) {
@@ -184,6 +170,8 @@ void KeithleyUSBTMCComHandler::RestoreIoPort( void )
 */
 void KeithleyUSBTMCComHandler::CloseIoPort( void )
 {
+  fTransport.SetFileDescriptor( -1 );
+
   if (!fDeviceAvailable) return;
 
 #ifndef USE_FAKEIO
@@ -21,6 +21,8 @@
 
 #include <string>
 
+#include "../Serial/SerialTransport.h"
+
 typedef const char* ioport_t;
 typedef struct termios termios_t;
 
@@ -57,6 +59,7 @@ class KeithleyUSBTMCComHandler {
 
   bool fDeviceAvailable;
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
@@ -25,6 +25,8 @@
 */
 KeyenceComHandler::KeyenceComHandler(ioport_t ioPort)
 {
+    fTransport.SetLineEnd( "\r" );
+
     // save ioport 
     fIoPort = ioPort;
     
@@ -47,17 +49,8 @@ void KeyenceComHandler::SendCommand( const char *commandString )
 {
   if (!fDeviceAvailable) return;
 
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\r" );
 }
 
 //! Read a string from device.
@@ -79,31 +72,14 @@ void KeyenceComHandler::ReceiveString(std::string & receiveString, char *temp_ou
 
   temp_output[0] = 0;
 
-  usleep( 5000 );
-
-  int timeout = 0;
-  size_t readResult = 0;
-  int limit = 1000 + 2*samplingRate*averagingRate;
-  while ( timeout < limit)  {
+  // the measurement takes longer for high sampling and averaging rates
+  fTransport.SetTimeout( 100 + samplingRate*averagingRate/5 );
 
-    readResult = read( fIoPortFileDescriptor, temp_output, 1024 );
-    if ( readResult > 0 ) {
-      receiveString += std::string(temp_output, readResult);
-      if(receiveString.find(13) != std::string::npos){
-	break;
-      }
-    }
-    usleep ( 5 );
-    readResult = 0;
-    temp_output[0] = 0;
-    timeout++;
-  }
-
-#ifdef KEYENCEDEBUG
-  std::cout<<"[KeyenceComHandler::ReceiveString] waited for "<<timeout<<" microseconds"<<std::endl;
-#endif
+  std::string response;
+  bool complete = fTransport.ReceiveResponse( response );
+  receiveString += response;
 
-  if ( timeout == limit ) {
+  if ( !complete ) {
     //      std::cerr << "[KeyenceComHandler::ReceiveString] ** ERROR: command timed out! "
     //	    << std::endl;
       std::cout << "[KeyenceComHandler::ReceiveString] ** ERROR: command timed out! "
@@ -111,6 +87,9 @@ void KeyenceComHandler::ReceiveString(std::string & receiveString, char *temp_ou
       return;
   }
 
+#ifdef KEYENCEDEBUG
+  std::cout<<"[KeyenceComHandler::ReceiveString] received "<<response.size()<<" characters"<<std::endl;
+#endif
 }
 
 //! Open I/O port.
@@ -136,6 +115,9 @@ void KeyenceComHandler::OpenIoPort( void )
         flags |= O_NONBLOCK;
         flags |= FNDELAY;
         fcntl( fIoPortFileDescriptor, F_SETFL, flags );
+
+        // buffered, poll based I/O on the port
+        fTransport.SetFileDescriptor( fIoPortFileDescriptor );
     }
     
     fDeviceAvailable = true;
@@ -200,24 +182,11 @@ void KeyenceComHandler::RestoreIoPort( void )
 */
 void KeyenceComHandler::CloseIoPort( void )
 {
-  if (!fDeviceAvailable) return;
-
-  close( fIoPortFileDescriptor );
-}
+  fTransport.SetFileDescriptor( -1 );
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void KeyenceComHandler::SendFeedString( void )
-{
   if (!fDeviceAvailable) return;
 
-  // feed string is <CR> ; see documentation page 4.1
-  char feedString = 13;
-
-  // write <CR> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
+  close( fIoPortFileDescriptor );
 }
 
 bool KeyenceComHandler::DeviceAvailable()
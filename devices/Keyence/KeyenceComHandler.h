@@ -20,6 +20,8 @@
 #include <unistd.h>
 #include <string.h>
 
+#include "../Serial/SerialTransport.h"
+
 typedef const char* ioport_t;
 typedef struct termios termios_t;
 
@@ -52,10 +54,10 @@ class KeyenceComHandler {
   void InitializeIoPort( void );
   void RestoreIoPort( void );
   void CloseIoPort( void );
-  void SendFeedString( void );
 
   bool fDeviceAvailable;
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
@@ -56,6 +56,8 @@ void LStepExpress::SendCommand(const std::string & command)
   std::cout << "Device SendCommand: " << command << std::endl;
 #endif
 
+  ++transferCount_;
+
   comHandler_->SendCommand(command.c_str());
 }
 
@@ -70,10 +72,37 @@ void LStepExpress::ReceiveString(std::string & buffer)
   std::cout << "Device ReceiveString: " << buf << std::endl;
 #endif
 
+  ++queryCount_;
+
   StripBuffer(buf);
   buffer = buf;
 }
 
+//! Send all queries in a single write and collect the responses in order.
+bool LStepExpress::GetValues(const std::vector<std::string> & commands,
+                             std::vector<std::string> & values)
+{
+#ifdef LSTEPDEBUG
+  for (const std::string& command : commands) {
+    std::cout << "Device SendCommand: " << command << std::endl;
+  }
+#endif
+
+  ++transferCount_;
+  queryCount_ += commands.size();
+
+  bool ok = comHandler_->Query(commands, values);
+  values.resize(commands.size());
+
+#ifdef LSTEPDEBUG
+  for (const std::string& value : values) {
+    std::cout << "Device ReceiveString: " << value << std::endl;
+  }
+#endif
+
+  return ok;
+}
+
 void LStepExpress::StripBuffer(char* buffer) const
 {
   for (unsigned int c=0; c<strlen(buffer);++c) {
@@ -172,67 +201,8 @@ void LStepExpress::GetAxisStatus(std::vector<int> & values)
 {
   std::string line;
   GetValue("statusaxis", line);
-  
-  std::string token;
-
-  values.clear();
 
-  for (unsigned int i=0;i<4;++i) {
-    char token = line[i];
-  
-    switch (token) {
-    case '@': {
-      values.push_back(AXISSTANDSANDREADY);
-      break;
-    }
-    case 'M': {
-      values.push_back(AXISMOVING);
-      break;
-    }
-    case 'J': {
-      values.push_back(AXISJOYSTICK);
-      break;
-    }
-    case 'C': {
-      values.push_back(AXISINCONTROL);
-      break;
-    }
-    case 'S': {
-      values.push_back(AXISLIMITSWITCHTRIPPED);
-      break;
-    }
-    case 'A': {
-      values.push_back(AXISACKAFTERCALIBRATION);
-      break;
-    }
-    case 'E': {
-      values.push_back(AXISERRACKAFTERCALIBRATION);
-      break;
-    }
-    case 'D': {
-      values.push_back(AXISACKAFTERTBLSTROKEMSR);
-      break;
-    }
-    case 'U': {
-      values.push_back(AXISINSETUP);
-      break;
-    }
-    case 'T': {
-      values.push_back(AXISTIMEOUT);
-      break;
-    }
-    case 'F': {
-      values.push_back(AXISERROR);
-      break;
-    }
-    case '-': {
-      values.push_back(AXISDISABLED);
-      break;
-    }
-    default:
-      values.push_back(AXISSTATEUNKNOWN);
-    }
-  }
+  ParseAxisStatus(line, values);
 }
 
 void LStepExpress::GetAxisEnabled(std::vector<int> & values)
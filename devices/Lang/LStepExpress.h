@@ -138,6 +138,7 @@ class LStepExpress : public VLStepExpress
   // low level debugging methods
   void SendCommand(const std::string &);
   void ReceiveString(std::string &);
+  bool GetValues(const std::vector<std::string> & commands, std::vector<std::string> & values);
 
  private:
 
@@ -24,6 +24,9 @@
 LStepExpressComHandler::LStepExpressComHandler(const std::string& ioPort)
  : fIoPort(ioPort)
 {
+  fTransport.SetLineEnd( "\r" );
+  fTransport.SetTimeout( 500 );
+
   // initialize
   OpenIoPort();
   InitializeIoPort();
@@ -43,17 +46,8 @@ void LStepExpressComHandler::SendCommand( const char *commandString )
 {
   if (!fDeviceAvailable) return;
 
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\r" );
 }
 
 //! Read a string from device.
@@ -67,30 +61,32 @@ void LStepExpressComHandler::SendCommand( const char *commandString )
   See example program in class description.
 */
 void LStepExpressComHandler::ReceiveString( char *receiveString )
+{
+  fTransport.ReceiveString( receiveString, 1024, true );
+}
+
+//! Send several queries in a single write and read their responses.
+/*!
+  The controller queues the commands and answers them in order. The
+  responses are returned without their line end. Returns false if not
+  all responses arrived within the timeout.
+*/
+bool LStepExpressComHandler::Query( const std::vector<std::string>& commands,
+                                    std::vector<std::string>& responses )
 {
   if (!fDeviceAvailable) {
-    receiveString[0] = 0;
-    return;
+    responses.clear();
+    return false;
   }
 
-  receiveString[0] = 0;
-
-  usleep( 20000 );
-
-  int timeout = 0;
-  size_t readResult = 0;
-
-  while ( timeout < 100000 )  {
+  bool ok = fTransport.QueryPipelined( commands, "\r", responses );
 
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 ) {
-      receiveString[readResult-1] = '\0';
-      break;
-    }
-    
-    timeout++;
+  for (std::string& response : responses) {
+    size_t idx = response.find_last_not_of( "\r" );
+    response.erase( idx==std::string::npos ? 0 : idx + 1 );
   }
+
+  return ok;
 }
 
 //! Open I/O port.
@@ -119,6 +115,9 @@ void LStepExpressComHandler::OpenIoPort( void )
     flags |= O_NONBLOCK;
     flags |= FNDELAY;
     fcntl( fIoPortFileDescriptor, F_SETFL, flags );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 
   fDeviceAvailable = true;
@@ -182,24 +181,11 @@ void LStepExpressComHandler::RestoreIoPort( void )
 */
 void LStepExpressComHandler::CloseIoPort( void )
 {
-  if (!fDeviceAvailable) return;
-
-  close( fIoPortFileDescriptor );
-}
+  fTransport.SetFileDescriptor( -1 );
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void LStepExpressComHandler::SendFeedString( void )
-{
   if (!fDeviceAvailable) return;
 
-  // feed string is <CR> ; see documentation page 4.1
-  char feedString = 13;
-
-  // write <CR> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
+  close( fIoPortFileDescriptor );
 }
 
 bool LStepExpressComHandler::DeviceAvailable()
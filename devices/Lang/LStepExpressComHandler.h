@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include "../Serial/SerialTransport.h"
+
 /** @addtogroup devices
  *  @{
  */
@@ -46,6 +48,7 @@ class LStepExpressComHandler {
 
   void SendCommand( const char* );
   void ReceiveString( char* );
+  bool Query( const std::vector<std::string>&, std::vector<std::string>& );
 
   bool DeviceAvailable();
 
@@ -55,10 +58,10 @@ class LStepExpressComHandler {
   void InitializeIoPort( void );
   void RestoreIoPort( void );
   void CloseIoPort( void );
-  void SendFeedString( void );
 
   bool fDeviceAvailable;
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   const std::string fIoPort;
   termios_t fCurrentTermios, fThisTermios;
@@ -400,6 +400,43 @@ void LStepExpressFake::SetJoystickAxisEnabled(VLStepExpress::Axis axis, int valu
   joystickAxisEnabled_[axis] = value;
 }
 
+/*!
+  Counts the queries and the single transfer the controller would need
+  for the batch, so that the polling costs can be compared to the real
+  device and the simulator.
+*/
+bool LStepExpressFake::GetMotionStatus(VLStepExpress::MotionStatus & status)
+{
+  ++transferCount_;
+  queryCount_ += 4;
+
+  status.axisStatus = axisStatus_;
+  status.powerAmplifierStatus = pa_;
+  status.axisEnabled = axis_;
+  status.position = position_;
+
+  return true;
+}
+
+bool LStepExpressFake::GetConfiguration(VLStepExpress::Configuration & configuration)
+{
+  ++transferCount_;
+  queryCount_ += 10;
+
+  configuration.axisEnabled = axis_;
+  configuration.dimension = dim_;
+  configuration.acceleration = acceleration_;
+  configuration.deceleration = deceleration_;
+  configuration.accelerationJerk = accelerationJerk_;
+  configuration.decelerationJerk = decelerationJerk_;
+  configuration.velocity = velocity_;
+  configuration.position = position_;
+  configuration.joystickEnabled = joystickEnabled_;
+  configuration.joystickAxisEnabled = joystickAxisEnabled_;
+
+  return true;
+}
+
 void LStepExpressFake::SendCommand(const std::string& command)
 {
   std::cout << "SendCommand: " << command << std::endl;
@@ -119,6 +119,9 @@ class LStepExpressFake : public VLStepExpress
   void SetJoystickAxisEnabled(const std::vector<int> & values);
   void SetJoystickAxisEnabled(VLStepExpress::Axis axis, int value);
 
+  bool GetMotionStatus(VLStepExpress::MotionStatus & status);
+  bool GetConfiguration(VLStepExpress::Configuration & configuration);
+
   void Reset() {}
   void ConfirmErrorRectification() {}
   void ValidConfig() {}
@@ -15,6 +15,8 @@
 #include "VLStepExpress.h"
 
 VLStepExpress::VLStepExpress(const std::string& /* ioPort */)
+ : queryCount_(0)
+ , transferCount_(0)
 {
 }
 
@@ -284,6 +286,127 @@ void VLStepExpress::GetValue(const std::string & command, VLStepExpress::Axis ax
   }
 }
 
+/*!
+  Send all commands and return one response per command, in order.
+  The base implementation queries one command after the other; devices
+  that queue commands send the whole batch at once. Returns false if a
+  response did not arrive.
+*/
+bool VLStepExpress::GetValues(const std::vector<std::string> & commands,
+                              std::vector<std::string> & values)
+{
+  values.resize(commands.size());
+
+  for (size_t i=0;i<commands.size();++i) {
+    this->SendCommand(commands[i]);
+    this->ReceiveString(values[i]);
+  }
+
+  return true;
+}
+
+//! Read status, power amplifier status, enabled flag and position of all axes in one batch.
+bool VLStepExpress::GetMotionStatus(VLStepExpress::MotionStatus & status)
+{
+  static const std::vector<std::string> commands = { "statusaxis", "pa", "axis", "pos" };
+
+  std::vector<std::string> values;
+  bool ok = this->GetValues(commands, values);
+
+  ParseAxisStatus(values[0], status.axisStatus);
+  ParseValues(values[1], status.powerAmplifierStatus);
+  ParseValues(values[2], status.axisEnabled);
+  ParseValues(values[3], status.position);
+
+  return ok
+    && status.axisStatus.size()==4
+    && status.powerAmplifierStatus.size()==4
+    && status.axisEnabled.size()==4
+    && status.position.size()==4;
+}
+
+//! Read the motion parameters of all axes and the joystick settings in one batch.
+bool VLStepExpress::GetConfiguration(VLStepExpress::Configuration & configuration)
+{
+  static const std::vector<std::string> commands = { "axis", "dim",
+                                                     "accel", "decel",
+                                                     "acceljerk", "deceljerk",
+                                                     "vel", "pos",
+                                                     "joy", "joyenable" };
+
+  std::vector<std::string> values;
+  bool ok = this->GetValues(commands, values);
+
+  ParseValues(values[0], configuration.axisEnabled);
+  ParseValues(values[1], configuration.dimension);
+  ParseValues(values[2], configuration.acceleration);
+  ParseValues(values[3], configuration.deceleration);
+  ParseValues(values[4], configuration.accelerationJerk);
+  ParseValues(values[5], configuration.decelerationJerk);
+  ParseValues(values[6], configuration.velocity);
+  ParseValues(values[7], configuration.position);
+
+  std::vector<int> joystick;
+  ParseValues(values[8], joystick);
+  configuration.joystickEnabled = joystick.empty() ? 0 : joystick[0];
+
+  ParseValues(values[9], configuration.joystickAxisEnabled);
+
+  return ok
+    && !joystick.empty()
+    && configuration.axisEnabled.size()==4
+    && configuration.position.size()==4;
+}
+
+void VLStepExpress::ParseAxisStatus(const std::string & buffer,
+                                    std::vector<int> & values)
+{
+  values.clear();
+
+  // one character per axis, missing ones are unknown
+  for (unsigned int i=0;i<4;++i) {
+    switch (i<buffer.size() ? buffer[i] : 'X') {
+    case '@': values.push_back(AXISSTANDSANDREADY); break;
+    case 'M': values.push_back(AXISMOVING); break;
+    case 'J': values.push_back(AXISJOYSTICK); break;
+    case 'C': values.push_back(AXISINCONTROL); break;
+    case 'S': values.push_back(AXISLIMITSWITCHTRIPPED); break;
+    case 'A': values.push_back(AXISACKAFTERCALIBRATION); break;
+    case 'E': values.push_back(AXISERRACKAFTERCALIBRATION); break;
+    case 'D': values.push_back(AXISACKAFTERTBLSTROKEMSR); break;
+    case 'U': values.push_back(AXISINSETUP); break;
+    case 'T': values.push_back(AXISTIMEOUT); break;
+    case 'F': values.push_back(AXISERROR); break;
+    case '-': values.push_back(AXISDISABLED); break;
+    default: values.push_back(AXISSTATEUNKNOWN);
+    }
+  }
+}
+
+void VLStepExpress::ParseValues(const std::string & buffer,
+                                std::vector<int> & values)
+{
+  int temp;
+
+  values.clear();
+  std::istringstream is(buffer);
+  while (is >> temp) {
+    values.push_back(temp);
+  }
+}
+
+void VLStepExpress::ParseValues(const std::string & buffer,
+                                std::vector<double> & values)
+{
+  double temp;
+
+  values.clear();
+  std::istringstream is(buffer);
+  while (is >> temp) {
+    values.push_back(temp);
+  }
+}
+
 char VLStepExpress::GetAxisName(VLStepExpress::Axis axis)
 {
   switch (axis) {
@@ -59,6 +59,28 @@ class VLStepExpress
     AXISSTATEUNKNOWN           = 0xff
   };
 
+  //! Status of all axes, read in a single batch of queries
+  struct MotionStatus {
+    std::vector<int> axisStatus;
+    std::vector<int> powerAmplifierStatus;
+    std::vector<int> axisEnabled;
+    std::vector<double> position;
+  };
+
+  //! Settings of all axes, read in a single batch of queries
+  struct Configuration {
+    std::vector<int> axisEnabled;
+    std::vector<int> dimension;
+    std::vector<double> acceleration;
+    std::vector<double> deceleration;
+    std::vector<double> accelerationJerk;
+    std::vector<double> decelerationJerk;
+    std::vector<double> velocity;
+    std::vector<double> position;
+    int joystickEnabled;
+    std::vector<int> joystickAxisEnabled;
+  };
+
   VLStepExpress(const std::string&);
 
   virtual ~VLStepExpress();
@@ -155,10 +177,18 @@ class VLStepExpress
   void ValidParameter();
   virtual void Calibrate() = 0;
 
+  virtual bool GetMotionStatus(MotionStatus & status);
+  virtual bool GetConfiguration(Configuration & configuration);
+
   // low level methods
   virtual void SendCommand(const std::string &) = 0;
   virtual void ReceiveString(std::string &) = 0;
 
+  //! Number of queries answered by the device
+  unsigned long GetQueryCount() const { return queryCount_; }
+  //! Number of transfers to the device; a batch of queries is one transfer
+  unsigned long GetTransferCount() const { return transferCount_; }
+
   void SetValue(const std::string & command, const std::string & value);
   void SetValue(const std::string & command, VLStepExpress::Axis axis, const std::string & value);
   void SetValue(const std::string & command, int value1);
@@ -184,6 +214,7 @@ class VLStepExpress
   void GetValue(const std::string & command, std::vector<double> & values);
   void GetValue(const std::string & command, VLStepExpress::Axis axis, double & value);
   void GetValue(const std::string & command, VLStepExpress::Axis axis, std::vector<double> & values);
+  virtual bool GetValues(const std::vector<std::string> & commands, std::vector<std::string> & values);
 
   char GetAxisName(VLStepExpress::Axis axis);
   const char * GetAxisDimensionShortName(VLStepExpress::Dimension dimension);
@@ -195,6 +226,15 @@ class VLStepExpress
   const char * GetAxisAccelerationJerkShortName(VLStepExpress::Dimension dimension);
   const char * GetAxisAccelerationJerkName(VLStepExpress::Dimension dimension);
   char GetAxisStatusText(VLStepExpress::AxisStatus status);
+
+  static void ParseAxisStatus(const std::string & buffer, std::vector<int> & values);
+  static void ParseValues(const std::string & buffer, std::vector<int> & values);
+  static void ParseValues(const std::string & buffer, std::vector<double> & values);
+
+ protected:
+
+  unsigned long queryCount_;
+  unsigned long transferCount_;
 };
 
 /** @} */
@@ -23,6 +23,9 @@
 */
 LeyboldComHandler::LeyboldComHandler(ioport_t ioPort)
 {
+  fTransport.SetFrameEnd( 0x04 );
+  fTransport.SetTimeout( 1000 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -45,17 +48,11 @@ void LeyboldComHandler::SendCommand( const char *commandString )
 {
   if (!fDeviceAvailable) return;
 
-  char singleCharacter = 0; 
-
-  for (unsigned int i=0;i<strlen(commandString);i++) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
+  // the telegram carries its own end character
+  fTransport.SendCommand( commandString, "" );
 
+  // give the controller time to process the telegram
   usleep(50000);
-  // std::cout << "command: |" << commandString << "|" << std::endl;
 }
 
 //! Read a string from device.
@@ -75,21 +72,7 @@ void LeyboldComHandler::ReceiveString( char *receiveString )
     return;
   }
 
-  usleep(25000);
-
-  int timeout = 0, readResult = 0;
-
-  while (timeout < 100000)  {
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if (readResult > 0) {
-      receiveString[readResult] = 0;
-      break;
-    }
-    
-    timeout++;
-  }
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -112,6 +95,9 @@ void LeyboldComHandler::OpenIoPort( void )
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 
   fDeviceAvailable = true;
@@ -180,6 +166,8 @@ void LeyboldComHandler::RestoreIoPort( void )
 */
 void LeyboldComHandler::CloseIoPort( void )
 {
+  fTransport.SetFileDescriptor( -1 );
+
   if (!fDeviceAvailable) return;
 
   close(fIoPortFileDescriptor);
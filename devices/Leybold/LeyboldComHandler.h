@@ -20,6 +20,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include "../Serial/SerialTransport.h"
+
 /** @addtogroup devices
  *  @{
  */
@@ -59,6 +61,7 @@ class LeyboldComHandler {
 
   bool fDeviceAvailable;
   int fIoPortFileDescriptor;
+  SerialTransport fTransport;
 
   ioport_t fIoPort;
   termios_t fCurrentTermios, fThisTermios;
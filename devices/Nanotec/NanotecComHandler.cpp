@@ -23,6 +23,9 @@
 */
 NanotecComHandler::NanotecComHandler(ioport_t ioPort)
 {
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 500 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -45,21 +48,10 @@ void NanotecComHandler::SendCommand( const char *commandString )
 {
   if (!fDeviceAvailable) return;
 
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\r" );
 
   usleep(10000);
-
-  // std::cout << "command: |" << commandString << "|" << std::endl;
 }
 
 //! Read a string from device.
@@ -74,26 +66,7 @@ void NanotecComHandler::SendCommand( const char *commandString )
 */
 void NanotecComHandler::ReceiveString( char *receiveString )
 {
-  if (!fDeviceAvailable) {
-    receiveString[0] = 0;
-    return;
-  }
-
-  usleep( 10000 );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 100000 )  {
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1024 );
-
-    if ( readResult > 0 ) {
-      receiveString[readResult] = 0;
-      break;
-    }
-    
-    timeout++;
-  }
+  fTransport.ReceiveString( receiveString, 1024 );
 }
 
 //! Open I/O port.
@@ -116,6 +89,9 @@ void NanotecComHandler::OpenIoPort( void )
   } else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 
   fDeviceAvailable = true;
@@ -184,24 +160,11 @@ void NanotecComHandler::RestoreIoPort( void )
 */
 void NanotecComHandler::CloseIoPort( void )
 {
-  if (!fDeviceAvailable) return;
-
-  close( fIoPortFileDescriptor );
-}
+  fTransport.SetFileDescriptor( -1 );
 
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void NanotecComHandler::SendFeedString( void )
-{
   if (!fDeviceAvailable) return;
 
-  // feed string is <CR>
-  char feedString = '\r';
-
-  // write <CR> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
+  close( fIoPortFileDescriptor );
 }
 
 bool NanotecComHandler::DeviceAvailable()
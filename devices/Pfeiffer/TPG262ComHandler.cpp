@@ -20,6 +20,9 @@
 */
 TPG262ComHandler::TPG262ComHandler( const ioport_t ioPort )
 {
+  fTransport.SetLineEnd( "\r\n" );
+  fTransport.SetTimeout( 1000 );
+
   // save ioport 
   fIoPort = ioPort;
 
@@ -45,29 +48,15 @@ void TPG262ComHandler::SendCommand( const char *commandString )
 {
   if (!fDeviceAvailable) return;
 
-  char singleCharacter = 0; 
-
-  for ( unsigned int i = 0; i < strlen( commandString ); i++ ) {
-    
-    // scan command string character wise & write
-    singleCharacter = commandString[i];
-    write( fIoPortFileDescriptor, &singleCharacter, 1 );
-  }
-
-  // send feed characters
-  SendFeedString();
+  // command and feed string in a single write
+  fTransport.SendCommand( commandString, "\r\n" );
 }
 
 void TPG262ComHandler::SendEnquiry( )
 {
   if (!fDeviceAvailable) return;
 
-  char singleCharacter = 0x05; 
-
-  write( fIoPortFileDescriptor, &singleCharacter, 1 );
-
-  // send feed characters
-  SendFeedString();
+  fTransport.SendCommand( "\x05", "\r\n" );
 }
 
 //! Read a string from device.
@@ -87,21 +76,7 @@ void TPG262ComHandler::ReceiveString( char *receiveString )
     return;
   }
 
-  usleep( ComHandlerDelay );
-
-  int timeout = 0, readResult = 0;
-
-  while ( timeout < 100000 )  {
-
-    readResult = read( fIoPortFileDescriptor, receiveString, 1000 );
-
-    if ( readResult > 0 )   {
-      receiveString[readResult] = 0;
-      break;
-    }
-    
-    timeout++;
-  }
+  fTransport.ReceiveString( receiveString, 1001 );
 }
 
 //! Open I/O port.
@@ -125,6 +100,9 @@ void TPG262ComHandler::OpenIoPort( void )
   else {
     // configure port with no delay
     fcntl( fIoPortFileDescriptor, F_SETFL, FNDELAY );
+
+    // buffered, poll based I/O on the port
+    fTransport.SetFileDescriptor( fIoPortFileDescriptor );
   }
 
   fDeviceAvailable = true;
@@ -229,35 +207,14 @@ void TPG262ComHandler::RestoreIoPort( void )
 */
 void TPG262ComHandler::CloseIoPort( void )
 {
-  close( fIoPortFileDescriptor );
-}
-
-//! Send command termination string (<CR><NL>).
-/*!
-  \internal
-*/
-void TPG262ComHandler::SendFeedString( void )
-{
-  // feed string is <NL>
-  char feedString = 13;
-
-  // write <CR> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
-
-  feedString = 10;
-
-  // write <LF> and get echo
-  write( fIoPortFileDescriptor, &feedString, 1 );
+  fTransport.SetFileDescriptor( -1 );
 
+  close( fIoPortFileDescriptor );
 }
 
 void TPG262ComHandler::SendResetInterface()
 {
-  char singleCharacter=0x03;
-  write( fIoPortFileDescriptor, &singleCharacter, 1);
-  
-  // send feed characters
-  SendFeedString();
+  fTransport.SendCommand( "\x03", "\r\n" );
 }
 
 bool TPG262ComHandler::DeviceAvailable()
@@ -0,0 +1,337 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SERIALTRANSPORT_H_
+#define _SERIALTRANSPORT_H_
+
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+/** @addtogroup devices
+ *  @{
+ */
+
+/** @defgroup Serial Serial
+ * Transport layer shared by the ComHandlers of serial and USB devices
+ *  @{
+ */
+
+/*!
+  Buffered, event driven I/O on the file descriptor of a ComHandler.
+
+  Commands are collected in an output buffer and written with a single
+  write() call. Responses are read with poll() as soon as the device
+  sends them and are complete when
+
+  - one of the line end characters arrived (SetLineEnd); line end
+    characters directly following it belong to the same response,
+    left over ones at the start of the next response are skipped, or
+  - the frame end character and a fixed number of trailing bytes, e.g.
+    a checksum, arrived (SetFrameEnd), or
+  - nothing else arrived for the quiet time after the first byte, if
+    neither of the above is set.
+
+  A response that is not complete within the timeout is returned as far
+  as it arrived. Bytes following a complete response stay buffered for
+  the next one, so that several commands can be sent at once and their
+  responses collected in order (QueryPipelined).
+
+  The file descriptor stays owned by the ComHandler. Devices like usbtmc
+  that do not support poll() can be read with blocking reads instead
+  (SetPollable).
+*/
+class SerialTransport
+{
+ public:
+
+  typedef std::chrono::steady_clock Clock;
+
+  //! Constructor.
+  SerialTransport()
+    : fFileDescriptor(-1),
+      fPollable(true),
+      fFrameEnd(-1),
+      fTrailerLength(0),
+      fTimeout(1000),
+      fQuietTime(20)
+  { }
+
+  void SetFileDescriptor(int fileDescriptor) {
+    fFileDescriptor = fileDescriptor;
+    fInput.clear();
+    fOutput.clear();
+  }
+  int FileDescriptor() const { return fFileDescriptor; }
+  bool IsOpen() const { return fFileDescriptor!=-1; }
+
+  void SetPollable(bool pollable) { fPollable = pollable; }
+  void SetLineEnd(const std::string& characters) { fLineEnd = characters; fFrameEnd = -1; }
+  void SetFrameEnd(char frameEnd, size_t trailerLength = 0) {
+    fLineEnd.clear();
+    fFrameEnd = (unsigned char)frameEnd;
+    fTrailerLength = trailerLength;
+  }
+  void SetTimeout(int msec) { fTimeout = msec; }
+  void SetQuietTime(int msec) { fQuietTime = msec; }
+
+  //! Mutex serializing complete request/response cycles on this port
+  std::mutex& Mutex() { return fMutex; }
+
+  //! Append data to the output buffer
+  void Write(const char* data, size_t length) { fOutput.append(data, length); }
+  void Write(const std::string& data) { fOutput.append(data); }
+
+  bool Flush();
+
+  //! Write command and feed string in a single write() call
+  bool SendCommand(const std::string& command, const std::string& feed) {
+    Write(command);
+    Write(feed);
+    return Flush();
+  }
+
+  bool ReceiveResponse(std::string& response);
+  size_t ReceiveString(char* buffer, size_t size, bool stripLineEnd = false);
+
+  bool Query(const std::string& command, const std::string& feed,
+             std::string& response);
+  bool QueryPipelined(const std::vector<std::string>& commands, const std::string& feed,
+                      std::vector<std::string>& responses);
+
+  //! Drop buffered and pending input, e.g. late responses after a timeout
+  void Discard();
+
+ protected:
+
+  size_t CompleteLength(bool quiet) const;
+  int Remaining(const Clock::time_point& until) const {
+    auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(until - Clock::now()).count();
+    return std::max<int>(0, msec);
+  }
+
+  int fFileDescriptor;
+  bool fPollable;
+  std::string fLineEnd;
+  int fFrameEnd;
+  size_t fTrailerLength;
+  int fTimeout;
+  int fQuietTime;
+
+  std::string fInput;
+  std::string fOutput;
+
+  std::mutex fMutex;
+};
+
+/*!
+  Write the output buffer. Partial writes are continued as soon as the
+  device accepts more data, for at most the timeout.
+*/
+inline bool SerialTransport::Flush()
+{
+  if (fFileDescriptor==-1) {
+    fOutput.clear();
+    return false;
+  }
+
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(fTimeout);
+
+  size_t written = 0;
+  while (written<fOutput.size()) {
+    ssize_t n = write(fFileDescriptor, fOutput.data() + written, fOutput.size() - written);
+    if (n>0) {
+      written += n;
+      continue;
+    }
+    if (n<0 && errno==EINTR) continue;
+    if (n<0 && (errno==EAGAIN || errno==EWOULDBLOCK)) {
+      struct pollfd p = { fFileDescriptor, POLLOUT, 0 };
+      if (poll(&p, 1, Remaining(deadline))>0) continue;
+    }
+    fOutput.clear();
+    return false;
+  }
+
+  fOutput.clear();
+  return true;
+}
+
+/*!
+  \internal
+  Length of the first complete response in the input buffer or 0.
+*/
+inline size_t SerialTransport::CompleteLength(bool quiet) const
+{
+  if (!fLineEnd.empty()) {
+    size_t idx = fInput.find_first_of(fLineEnd);
+    if (idx==std::string::npos) return 0;
+    idx = fInput.find_first_not_of(fLineEnd, idx);
+    return (idx==std::string::npos) ? fInput.size() : idx;
+  }
+
+  if (fFrameEnd>=0) {
+    size_t idx = fInput.find((char)fFrameEnd);
+    if (idx==std::string::npos) return 0;
+    idx += 1 + fTrailerLength;
+    return (idx<=fInput.size()) ? idx : 0;
+  }
+
+  return quiet ? fInput.size() : 0;
+}
+
+/*!
+  Read the next response. Returns false if the response was not
+  complete within the timeout; response then holds what arrived.
+*/
+inline bool SerialTransport::ReceiveResponse(std::string& response)
+{
+  response.clear();
+
+  if (fFileDescriptor==-1) return false;
+
+  const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(fTimeout);
+  Clock::time_point lastData = Clock::now();
+
+  for (;;) {
+
+    // skip line ends left over from the previous response
+    if (!fLineEnd.empty()) {
+      size_t idx = fInput.find_first_not_of(fLineEnd);
+      fInput.erase(0, idx==std::string::npos ? fInput.size() : idx);
+    }
+
+    const bool quiet = !fInput.empty() && Clock::now() - lastData >= std::chrono::milliseconds(fQuietTime);
+    size_t length = CompleteLength(quiet);
+    if (length>0) {
+      response = fInput.substr(0, length);
+      fInput.erase(0, length);
+      return true;
+    }
+
+    int wait = Remaining(deadline);
+    if (wait==0) break;
+
+    if (fLineEnd.empty() && fFrameEnd<0 && !fInput.empty()) {
+      wait = std::min(wait, Remaining(lastData + std::chrono::milliseconds(fQuietTime)));
+    }
+
+    if (fPollable) {
+      struct pollfd p = { fFileDescriptor, POLLIN, 0 };
+      int ret = poll(&p, 1, wait);
+      if (ret<0 && errno!=EINTR) break;
+      if (ret<=0) continue;
+    }
+
+    char buffer[1024];
+    ssize_t n = read(fFileDescriptor, buffer, sizeof(buffer));
+    if (n>0) {
+      fInput.append(buffer, n);
+      lastData = Clock::now();
+      continue;
+    }
+    if (n<0 && (errno==EINTR || errno==EAGAIN || errno==EWOULDBLOCK)) continue;
+
+    // end of file, hangup or, for blocking devices, a timeout of the driver
+    break;
+  }
+
+  response.swap(fInput);
+  fInput.clear();
+
+  return false;
+}
+
+/*!
+  Read the next response into a C string of the given size, optionally
+  without its line end. Returns the length of the string.
+*/
+inline size_t SerialTransport::ReceiveString(char* buffer, size_t size, bool stripLineEnd)
+{
+  std::string response;
+  ReceiveResponse(response);
+
+  if (stripLineEnd && !fLineEnd.empty()) {
+    size_t idx = response.find_last_not_of(fLineEnd);
+    response.erase(idx==std::string::npos ? 0 : idx + 1);
+  }
+
+  size_t length = std::min(response.size(), size - 1);
+  response.copy(buffer, length);
+  buffer[length] = 0;
+
+  return length;
+}
+
+inline bool SerialTransport::Query(const std::string& command, const std::string& feed,
+                                   std::string& response)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  if (!SendCommand(command, feed)) {
+    response.clear();
+    return false;
+  }
+
+  return ReceiveResponse(response);
+}
+
+/*!
+  Send all commands with a single write() and collect one response per
+  command in order. Only for devices that queue commands in their input
+  buffer and answer every one of them.
+*/
+inline bool SerialTransport::QueryPipelined(const std::vector<std::string>& commands,
+                                            const std::string& feed,
+                                            std::vector<std::string>& responses)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  responses.clear();
+
+  for (const std::string& command : commands) {
+    Write(command);
+    Write(feed);
+  }
+  if (!Flush()) return false;
+
+  bool ok = true;
+  responses.resize(commands.size());
+  for (std::string& response : responses) {
+    if (!ReceiveResponse(response)) ok = false;
+  }
+
+  return ok;
+}
+
+inline void SerialTransport::Discard()
+{
+  fInput.clear();
+
+  if (fFileDescriptor==-1 || !fPollable) return;
+
+  char buffer[1024];
+  struct pollfd p = { fFileDescriptor, POLLIN, 0 };
+  while (poll(&p, 1, 0)>0 && read(fFileDescriptor, buffer, sizeof(buffer))>0) { }
+}
+
+/** @} */
+
+/** @} */
+
+#endif
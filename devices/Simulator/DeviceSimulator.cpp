@@ -0,0 +1,184 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <sys/stat.h>
+
+#include <cmath>
+#include <iostream>
+
+#include "DeviceSimulator.h"
+
+DeviceSimulator::DeviceSimulator(const std::string& commandEnd, const std::string& responseEnd)
+  : fCommandEnd(commandEnd),
+    fResponseEnd(responseEnd),
+    fMasterFileDescriptor(-1),
+    fSlaveFileDescriptor(-1),
+    fResponseDelay(0),
+    fResponseJitter(0),
+    fRunning(false),
+    fCommandCount(0),
+    fResponseCount(0)
+{
+
+}
+
+DeviceSimulator::~DeviceSimulator()
+{
+  Stop();
+}
+
+bool DeviceSimulator::Start(const std::string& link)
+{
+  if (fRunning) return true;
+
+  fMasterFileDescriptor = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fMasterFileDescriptor==-1 ||
+      grantpt(fMasterFileDescriptor)!=0 ||
+      unlockpt(fMasterFileDescriptor)!=0) {
+    std::cerr << "[DeviceSimulator::Start] ** ERROR: could not open pseudo terminal." << std::endl;
+    Stop();
+    return false;
+  }
+
+  char name[256];
+  if (ptsname_r(fMasterFileDescriptor, name, sizeof(name))!=0) {
+    std::cerr << "[DeviceSimulator::Start] ** ERROR: no name for pseudo terminal." << std::endl;
+    Stop();
+    return false;
+  }
+
+  // keep the slave open, otherwise the master sees a hangup
+  // whenever the ComHandler closes and reopens the port
+  fSlaveFileDescriptor = open(name, O_RDWR | O_NOCTTY);
+  if (fSlaveFileDescriptor==-1) {
+    std::cerr << "[DeviceSimulator::Start] ** ERROR: could not open " << name << "." << std::endl;
+    Stop();
+    return false;
+  }
+
+  // raw line until the ComHandler configures its own settings
+  struct termios settings;
+  tcgetattr(fSlaveFileDescriptor, &settings);
+  cfmakeraw(&settings);
+  tcsetattr(fSlaveFileDescriptor, TCSANOW, &settings);
+
+  fcntl(fMasterFileDescriptor, F_SETFL, fcntl(fMasterFileDescriptor, F_GETFL) | O_NONBLOCK);
+
+  fPortName = name;
+  if (!link.empty()) {
+    struct stat status;
+    if (lstat(link.c_str(), &status)==0 && S_ISLNK(status.st_mode)) unlink(link.c_str());
+    if (symlink(name, link.c_str())==0) {
+      fLinkName = link;
+      fPortName = link;
+    } else {
+      std::cerr << "[DeviceSimulator::Start] ** WARNING: could not create link "
+                << link << ", using " << name << "." << std::endl;
+    }
+  }
+
+  fStartTime = Clock::now();
+  fRunning = true;
+  fThread = std::thread(&DeviceSimulator::Run, this);
+
+  return true;
+}
+
+void DeviceSimulator::Stop()
+{
+  fRunning = false;
+  if (fThread.joinable()) fThread.join();
+
+  if (fMasterFileDescriptor!=-1) close(fMasterFileDescriptor);
+  if (fSlaveFileDescriptor!=-1) close(fSlaveFileDescriptor);
+  fMasterFileDescriptor = -1;
+  fSlaveFileDescriptor = -1;
+
+  if (!fLinkName.empty()) unlink(fLinkName.c_str());
+  fLinkName.clear();
+}
+
+void DeviceSimulator::Run()
+{
+  std::string input;
+  char buffer[1024];
+
+  while (fRunning) {
+
+    struct pollfd p = { fMasterFileDescriptor, POLLIN, 0 };
+    if (poll(&p, 1, 100)<=0) continue;
+
+    ssize_t n = read(fMasterFileDescriptor, buffer, sizeof(buffer));
+    if (n<=0) continue;
+    input.append(buffer, n);
+
+    size_t idx;
+    while ((idx = input.find_first_of(fCommandEnd))!=std::string::npos) {
+      std::string command = input.substr(0, idx);
+
+      size_t next = input.find_first_not_of(fCommandEnd, idx);
+      input.erase(0, next==std::string::npos ? input.size() : next);
+
+      if (command.empty()) continue;
+
+      ++fCommandCount;
+      HandleCommand(command);
+    }
+  }
+}
+
+void DeviceSimulator::Respond(const std::string& response)
+{
+  int delay = fResponseDelay;
+  const int jitter = fResponseJitter;
+  if (jitter>0) {
+    std::uniform_int_distribution<int> distribution(-jitter, jitter);
+    delay += distribution(fRandom);
+  }
+  if (delay>0) std::this_thread::sleep_for(std::chrono::microseconds(delay));
+
+  Write(response + fResponseEnd);
+  ++fResponseCount;
+}
+
+void DeviceSimulator::Write(const std::string& data)
+{
+  size_t written = 0;
+  while (written<data.size() && fRunning) {
+    ssize_t n = write(fMasterFileDescriptor, data.data() + written, data.size() - written);
+    if (n>0) {
+      written += n;
+    } else if (n<0 && (errno==EAGAIN || errno==EINTR)) {
+      struct pollfd p = { fMasterFileDescriptor, POLLOUT, 0 };
+      poll(&p, 1, 100);
+    } else {
+      break;
+    }
+  }
+}
+
+double DeviceSimulator::Elapsed() const
+{
+  return std::chrono::duration<double>(Clock::now() - fStartTime).count();
+}
+
+double DeviceSimulator::Reading(double value, double amplitude, double period)
+{
+  std::normal_distribution<double> noise(0.0, 0.05 * amplitude);
+  return value + amplitude * std::sin(2. * M_PI * Elapsed() / period) + noise(fRandom);
+}
@@ -0,0 +1,113 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _DEVICESIMULATOR_H_
+#define _DEVICESIMULATOR_H_
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+
+/** @addtogroup devices
+ *  @{
+ */
+
+/** @defgroup Simulator Simulator
+ * Device simulators on pseudo terminals
+ *  @{
+ */
+
+/*!
+  Base class of the device simulators.
+
+  A simulator opens a pseudo terminal and answers the ASCII protocol of a
+  device on its master side. The slave side behaves like the serial port
+  of the real device, so that the ComHandlers, drivers and models can be
+  used without any change by passing PortName() as their port.
+
+  Incoming data is split into commands at the command end characters and
+  handed to HandleCommand() in a dedicated thread. Responses are delayed
+  by the response delay plus a uniformly distributed jitter of up to
+  +- the response jitter, which models the processing time of the
+  device. As on the real devices, the commands are processed one after
+  the other.
+*/
+class DeviceSimulator
+{
+ public:
+
+  typedef std::chrono::steady_clock Clock;
+
+  DeviceSimulator(const std::string& commandEnd, const std::string& responseEnd);
+  virtual ~DeviceSimulator();
+
+  //! Open the pseudo terminal and start answering; link is an optional symlink to the slave
+  bool Start(const std::string& link = "");
+  void Stop();
+  bool IsRunning() const { return fRunning; }
+
+  //! Device file to be used as the port of the device
+  const std::string& PortName() const { return fPortName; }
+
+  //! Response delay and jitter in microseconds
+  void SetResponseDelay(int usec) { fResponseDelay = usec; }
+  void SetResponseJitter(int usec) { fResponseJitter = usec; }
+  void SetSeed(unsigned int seed) { fRandom.seed(seed); }
+
+  unsigned long GetCommandCount() const { return fCommandCount; }
+  unsigned long GetResponseCount() const { return fResponseCount; }
+
+ protected:
+
+  virtual void HandleCommand(const std::string& command) = 0;
+
+  //! Send a response after the response delay; the response end is appended
+  void Respond(const std::string& response);
+
+  //! Seconds since Start(), for the time dependence of simulated readings
+  double Elapsed() const;
+
+  //! Simulated reading around value with a slow drift and some noise
+  double Reading(double value, double amplitude, double period);
+
+  std::mt19937 fRandom;
+
+ private:
+
+  void Run();
+  void Write(const std::string& data);
+
+  std::string fCommandEnd;
+  std::string fResponseEnd;
+
+  int fMasterFileDescriptor;
+  int fSlaveFileDescriptor;
+  std::string fPortName;
+  std::string fLinkName;
+
+  std::atomic<int> fResponseDelay;
+  std::atomic<int> fResponseJitter;
+
+  std::atomic<bool> fRunning;
+  std::atomic<unsigned long> fCommandCount;
+  std::atomic<unsigned long> fResponseCount;
+  std::thread fThread;
+  Clock::time_point fStartTime;
+};
+
+/** @} */
+
+/** @} */
+
+#endif
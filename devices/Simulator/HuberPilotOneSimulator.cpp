@@ -0,0 +1,99 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "HuberPilotOneSimulator.h"
+
+namespace {
+  // PB addresses of the variables with a simulated behaviour
+  const int SetPoint            = 0x00;
+  const int InternalTemperature = 0x01;
+  const int ReturnTemperature   = 0x02;
+  const int ProcessTemperature  = 0x07;
+  const int ControlEnabled      = 0x14;
+  const int Identification      = 0x1B;
+
+  const double AmbientTemperature = 20.0;
+}
+
+HuberPilotOneSimulator::HuberPilotOneSimulator(double timeConstant)
+  : DeviceSimulator("\r\n", "\r\n"),
+    fTimeConstant(timeConstant),
+    fTemperature(AmbientTemperature),
+    fLastUpdate(0)
+{
+  fVariables[SetPoint]            = 2000;
+  fVariables[InternalTemperature] = 2000;
+  fVariables[ReturnTemperature]   = 2000;
+  fVariables[0x03]                = 1500;   // pump pressure
+  fVariables[0x04]                = 0;      // power
+  fVariables[ProcessTemperature]  = 2000;
+  fVariables[0x12]                = 1;      // auto PID
+  fVariables[0x13]                = 0;      // internal control
+  fVariables[ControlEnabled]      = 0;
+  fVariables[0x16]                = 0;      // circulation
+  fVariables[Identification]      = (int16_t)0xD98B;
+  fVariables[0x1D]                = 1000;   // Kp, Tn and Tv of the internal,
+  fVariables[0x1E]                = 100;    // jacket and process controllers
+  fVariables[0x1F]                = 0;
+  fVariables[0x20]                = 1000;
+  fVariables[0x21]                = 100;
+  fVariables[0x22]                = 0;
+  fVariables[0x23]                = 1000;
+  fVariables[0x24]                = 100;
+  fVariables[0x25]                = 0;
+  fVariables[0x2C]                = 1500;   // cooling water inlet
+  fVariables[0x4C]                = 1800;   // cooling water outlet
+}
+
+void HuberPilotOneSimulator::UpdateTemperatures()
+{
+  const double now = Elapsed();
+  const double target = fVariables[ControlEnabled] ? fVariables[SetPoint] / 100. : AmbientTemperature;
+
+  fTemperature = target + (fTemperature - target) * std::exp(-(now - fLastUpdate) / fTimeConstant);
+  fLastUpdate = now;
+
+  fVariables[InternalTemperature] = std::lround(100. * Reading(fTemperature, 0.05, 30.));
+  fVariables[ReturnTemperature]   = std::lround(100. * Reading(fTemperature + 0.3, 0.05, 30.));
+  fVariables[ProcessTemperature]  = std::lround(100. * Reading(fTemperature + 0.5, 0.05, 30.));
+  fVariables[0x04] = std::lround(10. * std::fabs(target - fTemperature));
+}
+
+void HuberPilotOneSimulator::HandleCommand(const std::string& command)
+{
+  if (command.size()<8 || command.compare(0, 2, "{M")!=0) return;
+
+  const int address = std::strtol(command.substr(2, 2).c_str(), 0, 16);
+  auto variable = fVariables.find(address);
+  if (variable==fVariables.end()) return;
+
+  const std::string value = command.substr(4, 4);
+  const bool readOnly = (address==InternalTemperature || address==ReturnTemperature ||
+                         address==ProcessTemperature || address==Identification ||
+                         address==0x03 || address==0x04 ||
+                         address==0x2C || address==0x4C);
+  // writes to read only variables are answered with the current value
+  if (value!="****" && !readOnly) {
+    UpdateTemperatures();
+    variable->second = (int16_t)std::strtol(value.c_str(), 0, 16);
+  }
+
+  UpdateTemperatures();
+
+  char response[16];
+  snprintf(response, sizeof(response), "{S%02X%04X", address, (uint16_t)variable->second);
+  Respond(response);
+}
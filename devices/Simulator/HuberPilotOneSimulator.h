@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _HUBERPILOTONESIMULATOR_H_
+#define _HUBERPILOTONESIMULATOR_H_
+
+#include <map>
+#include <cstdint>
+
+#include "DeviceSimulator.h"
+
+/** @addtogroup devices
+ *  @{
+ */
+
+/** @addtogroup Simulator
+ *  @{
+ */
+
+/*!
+  Huber chiller with a Pilot ONE controller, speaking the PB protocol.
+
+  "{M" followed by the two digit hex address of a variable and either
+  "****" or a four digit hex value reads or writes the variable; the
+  answer is "{S" with the address and the current value. Temperatures
+  are in units of 0.01 degC. The internal, return and process
+  temperatures follow the set point with a time constant while the
+  temperature control is enabled and relax to the ambient temperature
+  otherwise.
+*/
+class HuberPilotOneSimulator : public DeviceSimulator
+{
+ public:
+
+  HuberPilotOneSimulator(double timeConstant = 60.0);
+
+ protected:
+
+  void HandleCommand(const std::string& command);
+
+  void UpdateTemperatures();
+
+  double fTimeConstant;
+  double fTemperature;
+  double fLastUpdate;
+  std::map<int,int16_t> fVariables;
+};
+
+/** @} */
+
+/** @} */
+
+#endif
@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+
+#include "Keithley2700Simulator.h"
+
+Keithley2700Simulator::Keithley2700Simulator()
+  : ScpiSimulator("KEITHLEY INSTRUMENTS INC.,MODEL 2700,1234567,B09  /A02"),
+    fReadingNumber(0)
+{
+  Reset();
+}
+
+void Keithley2700Simulator::Reset()
+{
+  fScanList = ParseChannelList("(@101:110)");
+  fReadingNumber = 0;
+}
+
+bool Keithley2700Simulator::HandleScpi(const std::string& header, const std::string& parameters,
+                                       std::string& response)
+{
+  if (header=="ROUT:SCAN") {
+    fScanList = ParseChannelList(parameters);
+    return true;
+  }
+
+  if (header=="READ?") {
+    response.clear();
+    char reading[64];
+    for (auto channel : fScanList) {
+      if (!response.empty()) response += ",";
+      snprintf(reading, sizeof(reading), "%+.7EC,%+.3fSECS,%+06dRDNG#",
+               Reading(20.0 + 0.1 * (channel % 100), 0.5, 600.), Elapsed(), (int)++fReadingNumber);
+      response += reading;
+    }
+    return true;
+  }
+
+  // configuration of the scan and the sensors is accepted as is
+  return header.back()!='?';
+}
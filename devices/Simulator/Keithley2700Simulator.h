@@ -0,0 +1,53 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _KEITHLEY2700SIMULATOR_H_
+#define _KEITHLEY2700SIMULATOR_H_
+
+#include "ScpiSimulator.h"
+
+/** @addtogroup devices
+ *  @{
+ */
+
+/** @addtogroup Simulator
+ *  @{
+ */
+
+/*!
+  Keithley 2700 multimeter with two 7700 multiplexer cards, as used by
+  Keithley2700 with PT100 sensors on channels 101-110 and 201-210.
+
+  READ? returns one reading, time stamp and reading number per channel
+  of the scan list set with ROUT:SCAN.
+*/
+class Keithley2700Simulator : public ScpiSimulator
+{
+ public:
+
+  Keithley2700Simulator();
+
+ protected:
+
+  bool HandleScpi(const std::string& header, const std::string& parameters,
+                  std::string& response);
+  void Reset();
+
+  channels_t fScanList;
+  unsigned int fReadingNumber;
+};
+
+/** @} */
+
+/** @} */
+
+#endif
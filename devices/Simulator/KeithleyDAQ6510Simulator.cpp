@@ -0,0 +1,80 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "KeithleyDAQ6510Simulator.h"
+
+KeithleyDAQ6510Simulator::KeithleyDAQ6510Simulator(unsigned int cards)
+  : ScpiSimulator("KEITHLEY INSTRUMENTS,MODEL DAQ6510,04446497,1.7.3b"),
+    fCards(cards)
+{
+
+}
+
+void KeithleyDAQ6510Simulator::Reset()
+{
+  fScanList.clear();
+  fBuffer.clear();
+}
+
+bool KeithleyDAQ6510Simulator::HandleScpi(const std::string& header, const std::string& parameters,
+                                          std::string& response)
+{
+  if (header=="SYST:CARD1:IDN?" || header=="SYST:CARD2:IDN?") {
+    const unsigned int card = header[9] - '0';
+    response = (card<=fCards) ? "7700,20Ch Mux w/CJC,1.0.0a,0123456" : "Empty Slot";
+    return true;
+  }
+
+  if (header=="ROUT:SCAN:CRE") {
+    fScanList = ParseChannelList(parameters);
+    return true;
+  }
+
+  if (header=="ROUT:SCAN:STAT?") {
+    response = "IDLE;0";
+    return true;
+  }
+
+  if (header=="INIT:IMM") {
+    for (auto channel : fScanList) {
+      fBuffer.push_back(std::make_pair(channel, Reading(20.0 + 0.1 * (channel % 100), 0.5, 600.)));
+    }
+    return true;
+  }
+
+  if (header=="TRAC:CLE") {
+    fBuffer.clear();
+    return true;
+  }
+
+  if (header=="TRAC:DATA?") {
+    // start and end index, buffer name and the elements CHAN, READ
+    unsigned int start = std::atoi(parameters.c_str());
+    size_t comma = parameters.find(',');
+    unsigned int end = (comma==std::string::npos) ? start : std::atoi(parameters.c_str() + comma + 1);
+
+    response.clear();
+    char reading[64];
+    for (unsigned int i = start;i<=end && i>0 && i<=fBuffer.size();++i) {
+      if (!response.empty()) response += ",";
+      snprintf(reading, sizeof(reading), "%u,%.6E", fBuffer[i-1].first, fBuffer[i-1].second);
+      response += reading;
+    }
+    return true;
+  }
+
+  // channel functions, routing and timing are accepted as is
+  return header.back()!='?';
+}
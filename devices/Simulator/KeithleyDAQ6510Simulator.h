@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _KEITHLEYDAQ6510SIMULATOR_H_
+#define _KEITHLEYDAQ6510SIMULATOR_H_
+
+#include <utility>
+
+#include "ScpiSimulator.h"
+
+/** @addtogroup devices
+ *  @{
+ */
+
+/** @addtogroup Simulator
+ *  @{
+ */
+
+/*!
+  Keithley DAQ6510 data acquisition system with up to two 7700
+  multiplexer cards.
+
+  :INIT:IMM scans the channels of the scan created with :ROUT:SCAN:CRE
+  into defbuffer1, :TRAC:DATA? returns channel and reading of the
+  requested buffer entries and :TRAC:CLE clears the buffer.
+*/
+class KeithleyDAQ6510Simulator : public ScpiSimulator
+{
+ public:
+
+  KeithleyDAQ6510Simulator(unsigned int cards = 2);
+
+ protected:
+
+  bool HandleScpi(const std::string& header, const std::string& parameters,
+                  std::string& response);
+  void Reset();
+
+  unsigned int fCards;
+  channels_t fScanList;
+  std::vector<std::pair<unsigned int,double>> fBuffer;
+};
+
+/** @} */
+
+/** @} */
+
+#endif
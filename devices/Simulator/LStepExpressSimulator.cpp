@@ -0,0 +1,203 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include "LStepExpressSimulator.h"
+
+LStepExpressSimulator::LStepExpressSimulator(const std::string& version,
+                                             const std::string& internalVersion)
+  : DeviceSimulator("\r", "\r"),
+    fVersion(version),
+    fInternalVersion(internalVersion),
+    fJoystick(0),
+    fPositionController(0),
+    fAutoStatus(0)
+{
+  fParameters["axis"]      = { 1, 1, 1, 1 };
+  fParameters["axisdir"]   = { 0, 0, 0, 0 };
+  fParameters["dim"]       = { 2, 2, 2, 3 };
+  fParameters["pa"]        = { 1, 1, 1, 1 };
+  fParameters["joyenable"] = { 1, 1, 1, 1 };
+  fParameters["acceljerk"] = { 1, 1, 1, 1 };
+  fParameters["deceljerk"] = { 1, 1, 1, 1 };
+  fParameters["accel"]     = { 0.5, 0.5, 0.5, 0.5 };
+  fParameters["decel"]     = { 0.5, 0.5, 0.5, 0.5 };
+  fParameters["vel"]       = { 10, 10, 10, 10 };
+  fParameters["pos"]       = { 0, 0, 0, 0 };
+
+  fStart.fill(0);
+  fTarget.fill(0);
+  fMoveDuration.fill(0);
+}
+
+void LStepExpressSimulator::UpdateMotion()
+{
+  const double elapsed = std::chrono::duration<double>(Clock::now() - fMoveStart).count();
+  values_t& position = fParameters["pos"];
+
+  for (int axis = 0;axis<4;++axis) {
+    if (fMoveDuration[axis]<=0) continue;
+    if (elapsed>=fMoveDuration[axis]) {
+      position[axis] = fTarget[axis];
+      fMoveDuration[axis] = 0;
+    } else {
+      position[axis] = fStart[axis] + (fTarget[axis] - fStart[axis]) * elapsed / fMoveDuration[axis];
+    }
+  }
+}
+
+void LStepExpressSimulator::StartMove(const values_t& target)
+{
+  UpdateMotion();
+
+  const values_t& velocity = fParameters["vel"];
+  fStart = fParameters["pos"];
+  fTarget = target;
+  fMoveStart = Clock::now();
+
+  for (int axis = 0;axis<4;++axis) {
+    const double distance = std::fabs(fTarget[axis] - fStart[axis]);
+    fMoveDuration[axis] = (velocity[axis]>0) ? distance / velocity[axis] : 0;
+    if (fMoveDuration[axis]==0) fParameters["pos"][axis] = fTarget[axis];
+  }
+}
+
+bool LStepExpressSimulator::IsMoving(int axis) const
+{
+  return fMoveDuration[axis]>0;
+}
+
+std::string LStepExpressSimulator::Format(const values_t& values, int axis, bool integer) const
+{
+  std::string response;
+  char buffer[32];
+  for (int i = 0;i<4;++i) {
+    if (axis>=0 && i!=axis) continue;
+    if (integer) {
+      snprintf(buffer, sizeof(buffer), "%d", (int)values[i]);
+    } else {
+      snprintf(buffer, sizeof(buffer), "%.4f", values[i]);
+    }
+    if (!response.empty()) response += " ";
+    response += buffer;
+  }
+  return response;
+}
+
+void LStepExpressSimulator::HandleCommand(const std::string& command)
+{
+  std::istringstream is(command);
+  std::vector<std::string> tokens;
+  std::string token;
+  while (is >> token) tokens.push_back(token);
+  if (tokens.empty()) return;
+
+  std::string name = tokens[0];
+  const bool action = (name[0]=='!');
+  if (action) name.erase(0, 1);
+
+  // optional axis name as first argument
+  int axis = -1;
+  size_t first = 1;
+  if (tokens.size()>1 && tokens[1].size()==1) {
+    static const std::string axes = "xyza";
+    size_t idx = axes.find(tokens[1][0]);
+    if (idx!=std::string::npos) {
+      axis = idx;
+      first = 2;
+    }
+  }
+
+  const bool set = action || tokens.size()>first;
+
+  UpdateMotion();
+
+  if (set && (name=="moa" || name=="mor")) {
+    values_t target = fParameters["pos"];
+    for (size_t i = first;i<tokens.size() && i-first<4;++i) {
+      const int a = (axis>=0) ? axis : i - first;
+      const double value = std::atof(tokens[i].c_str());
+      target[a] = (name=="moa") ? value : target[a] + value;
+    }
+    StartMove(target);
+    return;
+  }
+
+  auto parameter = fParameters.find(name);
+  if (parameter!=fParameters.end()) {
+    const bool integer = (name=="axis" || name=="axisdir" || name=="dim" ||
+                          name=="pa" || name=="joyenable");
+    if (set) {
+      for (size_t i = first;i<tokens.size() && i-first<4;++i) {
+        parameter->second[(axis>=0) ? axis : i - first] = std::atof(tokens[i].c_str());
+      }
+      if (name=="pos") fMoveDuration.fill(0);
+    } else {
+      Respond(Format(parameter->second, axis, integer));
+    }
+    return;
+  }
+
+  if (action) {
+    if (name=="joy" && tokens.size()>1) fJoystick = std::atoi(tokens[1].c_str());
+    if (name=="poscon" && tokens.size()>1) fPositionController = std::atoi(tokens[1].c_str());
+    if (name=="autostatus" && tokens.size()>1) fAutoStatus = std::atoi(tokens[1].c_str());
+    if (name=="a") fMoveDuration.fill(0);
+    if (name=="cal") {
+      fMoveDuration.fill(0);
+      fParameters["pos"].fill(0);
+    }
+    return;
+  }
+
+  if (name=="ver") {
+    Respond(fVersion);
+  } else if (name=="iver") {
+    Respond(fInternalVersion);
+  } else if (name=="readsn") {
+    Respond("80050323881");
+  } else if (name=="status") {
+    Respond("OK...");
+  } else if (name=="err") {
+    Respond("0");
+  } else if (name=="joy") {
+    Respond(std::to_string(fJoystick));
+  } else if (name=="?poscon") {
+    Respond(std::to_string(fPositionController));
+  } else if (name=="autostatus") {
+    Respond(std::to_string(fAutoStatus));
+  } else if (name=="statusaxis") {
+    std::string status;
+    for (int a = 0;a<4;++a) {
+      if (fParameters["axis"][a]==0) {
+        status += '-';
+      } else if (fJoystick) {
+        status += 'J';
+      } else {
+        status += IsMoving(a) ? 'M' : '@';
+      }
+    }
+    Respond(status);
+  } else if (name=="?sysstat") {
+    values_t status;
+    for (int a = 0;a<4;++a) status[a] = IsMoving(a) ? 1 : 0;
+    Respond(Format(status, axis, true));
+  } else if (name=="?sysstatus") {
+    Respond("no errors");
+  }
+
+  // unknown queries are not answered
+}
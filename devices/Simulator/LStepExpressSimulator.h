@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _LSTEPEXPRESSSIMULATOR_H_
+#define _LSTEPEXPRESSSIMULATOR_H_
+
+#include <array>
+#include <map>
+#include <vector>
+
+#include "DeviceSimulator.h"
+
+/** @addtogroup devices
+ *  @{
+ */
+
+/** @addtogroup Simulator
+ *  @{
+ */
+
+/*!
+  LANG LStep Express motion controller with the axes x, y, z and a.
+
+  Parameters are read with "name", "name axis" and written with "!name"
+  or, for the motion parameters, "name values". Moves started with !moa
+  and !mor run with the set velocity; while an axis moves its position
+  is interpolated and statusaxis reports 'M'.
+*/
+class LStepExpressSimulator : public DeviceSimulator
+{
+ public:
+
+  LStepExpressSimulator(const std::string& version = "PE43 1.00.01",
+                        const std::string& internalVersion = "E2020.02.13-2002");
+
+ protected:
+
+  typedef std::array<double,4> values_t;
+
+  void HandleCommand(const std::string& command);
+
+  void UpdateMotion();
+  void StartMove(const values_t& target);
+  bool IsMoving(int axis) const;
+  std::string Format(const values_t& values, int axis, bool integer) const;
+
+  std::string fVersion;
+  std::string fInternalVersion;
+
+  std::map<std::string,values_t> fParameters;
+  int fJoystick;
+  int fPositionController;
+  int fAutoStatus;
+
+  values_t fStart;
+  values_t fTarget;
+  std::array<double,4> fMoveDuration;
+  Clock::time_point fMoveStart;
+};
+
+/** @} */
+
+/** @} */
+
+#endif
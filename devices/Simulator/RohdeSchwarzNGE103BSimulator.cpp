@@ -0,0 +1,139 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include "RohdeSchwarzNGE103BSimulator.h"
+
+RohdeSchwarzNGE103BSimulator::RohdeSchwarzNGE103BSimulator(double loadResistance)
+  : ScpiSimulator("Rohde&Schwarz,NGE103B,5601.3800k03/101234,1.54"),
+    fLoadResistance(loadResistance)
+{
+  Reset();
+}
+
+void RohdeSchwarzNGE103BSimulator::Reset()
+{
+  fChannel = 1;
+  fOutputState.fill(false);
+  fVoltage.fill(0.0);
+  fCurrent.fill(0.1);
+  fEasyRampDuration.fill(0.01);
+  fEasyRampState.fill(false);
+}
+
+double RohdeSchwarzNGE103BSimulator::MeasuredVoltage() const
+{
+  const unsigned int c = fChannel - 1;
+  if (!fOutputState[c]) return 0.0;
+  return std::min(fVoltage[c], fCurrent[c] * fLoadResistance);
+}
+
+double RohdeSchwarzNGE103BSimulator::MeasuredCurrent() const
+{
+  return MeasuredVoltage() / fLoadResistance;
+}
+
+std::string RohdeSchwarzNGE103BSimulator::Format(double value) const
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.3f", value);
+  return buffer;
+}
+
+bool RohdeSchwarzNGE103BSimulator::HandleScpi(const std::string& header, const std::string& parameters,
+                                              std::string& response)
+{
+  const unsigned int c = fChannel - 1;
+
+  if (header=="INST:SEL" || header=="INST:NSEL") {
+    // OUT1 ... OUT3 or the plain channel number
+    size_t idx = parameters.find_first_of("0123456789");
+    if (idx!=std::string::npos) {
+      unsigned int channel = std::atoi(parameters.c_str() + idx);
+      if (channel>=1 && channel<=3) fChannel = channel;
+    }
+    return true;
+  }
+  if (header=="INST:NSEL?") {
+    response = std::to_string(fChannel);
+    return true;
+  }
+
+  if (header=="VOLT") {
+    fVoltage[c] = std::atof(parameters.c_str());
+    return true;
+  }
+  if (header=="VOLT?") {
+    response = Format(fVoltage[c]);
+    return true;
+  }
+  if (header=="CURR") {
+    fCurrent[c] = std::atof(parameters.c_str());
+    return true;
+  }
+  if (header=="CURR?") {
+    response = Format(fCurrent[c]);
+    return true;
+  }
+
+  if (header=="MEAS:VOLT?") {
+    response = Format(MeasuredVoltage());
+    return true;
+  }
+  if (header=="MEAS:CURR?") {
+    response = Format(MeasuredCurrent());
+    return true;
+  }
+  if (header=="MEAS:POW?") {
+    response = Format(MeasuredVoltage() * MeasuredCurrent());
+    return true;
+  }
+
+  if (header=="VOLT:RAMP:DUR") {
+    fEasyRampDuration[c] = std::atof(parameters.c_str());
+    return true;
+  }
+  if (header=="VOLT:RAMP:DUR?") {
+    response = Format(fEasyRampDuration[c]);
+    return true;
+  }
+  if (header=="VOLT:RAMP") {
+    fEasyRampState[c] = std::atoi(parameters.c_str());
+    return true;
+  }
+  if (header=="VOLT:RAMP?") {
+    response = fEasyRampState[c] ? "1" : "0";
+    return true;
+  }
+
+  if (header=="OUTP:STAT" || header=="OUTP") {
+    fOutputState[c] = (parameters=="ON" || std::atoi(parameters.c_str())==1);
+    return true;
+  }
+  if (header=="OUTP:STAT?" || header=="OUTP?") {
+    response = fOutputState[c] ? "1" : "0";
+    return true;
+  }
+  if (header=="OUTP:MODE?") {
+    if (!fOutputState[c]) {
+      response = "OFF";
+    } else {
+      response = (fVoltage[c] > fCurrent[c] * fLoadResistance) ? "CC" : "CV";
+    }
+    return true;
+  }
+
+  return false;
+}
@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ROHDESCHWARZNGE103BSIMULATOR_H_
+#define _ROHDESCHWARZNGE103BSIMULATOR_H_
+
+#include <array>
+
+#include "ScpiSimulator.h"
+
+/** @addtogroup devices
+ *  @{
+ */
+
+/** @addtogroup Simulator
+ *  @{
+ */
+
+/*!
+  Rohde & Schwarz NGE103B power supply with three channels.
+
+  Every output drives a resistive load. An output is in constant voltage
+  mode as long as the load current stays below the current limit and in
+  constant current mode otherwise.
+*/
+class RohdeSchwarzNGE103BSimulator : public ScpiSimulator
+{
+ public:
+
+  RohdeSchwarzNGE103BSimulator(double loadResistance = 10.0);
+
+ protected:
+
+  bool HandleScpi(const std::string& header, const std::string& parameters,
+                  std::string& response);
+  void Reset();
+
+  double MeasuredVoltage() const;
+  double MeasuredCurrent() const;
+  std::string Format(double value) const;
+
+  double fLoadResistance;
+  unsigned int fChannel;
+  std::array<bool,3> fOutputState;
+  std::array<double,3> fVoltage;
+  std::array<double,3> fCurrent;
+  std::array<double,3> fEasyRampDuration;
+  std::array<bool,3> fEasyRampState;
+};
+
+/** @} */
+
+/** @} */
+
+#endif
@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+#include "ScpiSimulator.h"
+
+ScpiSimulator::ScpiSimulator(const std::string& identification)
+  : DeviceSimulator("\r\n", "\n"),
+    fIdentification(identification)
+{
+
+}
+
+ScpiSimulator::channels_t ScpiSimulator::ParseChannelList(const std::string& list)
+{
+  channels_t channels;
+
+  size_t begin = list.find('@');
+  size_t end = list.find(')');
+  if (begin==std::string::npos) return channels;
+
+  std::istringstream is(list.substr(begin + 1, end==std::string::npos ? std::string::npos : end - begin - 1));
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    size_t colon = range.find(':');
+    unsigned int first = std::atoi(range.c_str());
+    unsigned int last = (colon==std::string::npos) ? first : std::atoi(range.c_str() + colon + 1);
+    for (unsigned int channel = first;channel<=last;++channel) channels.push_back(channel);
+  }
+
+  return channels;
+}
+
+void ScpiSimulator::HandleCommand(const std::string& command)
+{
+  std::string responses;
+  bool query = false;
+
+  std::istringstream is(command);
+  std::string message;
+  while (std::getline(is, message, ';')) {
+
+    size_t begin = message.find_first_not_of(" \t:");
+    if (begin==std::string::npos) continue;
+    size_t end = message.find_first_of(" \t", begin);
+
+    std::string header = message.substr(begin, end==std::string::npos ? std::string::npos : end - begin);
+    for (auto& c : header) c = std::toupper(c);
+
+    std::string parameters;
+    if (end!=std::string::npos) {
+      size_t first = message.find_first_not_of(" \t", end);
+      if (first!=std::string::npos) parameters = message.substr(first);
+    }
+
+    std::string response;
+    bool known = true;
+
+    if (header=="*IDN?") {
+      response = fIdentification;
+    } else if (header=="*OPC?") {
+      response = "1";
+    } else if (header=="*RST" || header=="*CLS") {
+      if (header=="*RST") Reset();
+    } else {
+      known = HandleScpi(header, parameters, response);
+    }
+
+    if (known && header.back()=='?') {
+      if (query) responses += ";";
+      responses += response;
+      query = true;
+    }
+  }
+
+  if (query) Respond(responses);
+}
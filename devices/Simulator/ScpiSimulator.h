@@ -0,0 +1,67 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SCPISIMULATOR_H_
+#define _SCPISIMULATOR_H_
+
+#include <vector>
+
+#include "DeviceSimulator.h"
+
+/** @addtogroup devices
+ *  @{
+ */
+
+/** @addtogroup Simulator
+ *  @{
+ */
+
+/*!
+  Simulator of a SCPI instrument.
+
+  Every command line is split at ';' into program messages. Their headers
+  are passed to HandleScpi() in upper case without the leading ':',
+  together with the parameters. The answers to all queries of a line are
+  sent as one response separated by ';'. Unknown queries are not
+  answered, just like on the instruments, so that the driver runs into
+  its timeout.
+
+  *IDN?, *OPC?, *RST and *CLS are handled here.
+*/
+class ScpiSimulator : public DeviceSimulator
+{
+ public:
+
+  typedef std::vector<unsigned int> channels_t;
+
+  ScpiSimulator(const std::string& identification);
+
+  //! Parse a channel list like "(@101:103,105)"
+  static channels_t ParseChannelList(const std::string& list);
+
+ protected:
+
+  void HandleCommand(const std::string& command);
+
+  //! Returns false for unknown headers; queries set response
+  virtual bool HandleScpi(const std::string& header, const std::string& parameters,
+                          std::string& response) = 0;
+  virtual void Reset() { }
+
+  std::string fIdentification;
+};
+
+/** @} */
+
+/** @} */
+
+#endif
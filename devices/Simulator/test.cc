@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "Keithley2700Simulator.h"
+#include "KeithleyDAQ6510Simulator.h"
+#include "RohdeSchwarzNGE103BSimulator.h"
+#include "LStepExpressSimulator.h"
+#include "HuberPilotOneSimulator.h"
+
+static volatile sig_atomic_t running = 1;
+
+static void stop(int)
+{
+  running = 0;
+}
+
+/*
+  Runs all simulators until interrupted. The ports are linked to
+  /tmp/sim<Device>, so that the configurations of the applications can
+  point to fixed names.
+
+  usage: test [response delay in us] [response jitter in us]
+*/
+int main(int argc, char* argv[])
+{
+  int delay = 2000;
+  int jitter = 500;
+  if (argc>1) delay = std::atoi(argv[1]);
+  if (argc>2) jitter = std::atoi(argv[2]);
+
+  std::vector<std::pair<std::string,std::unique_ptr<DeviceSimulator>>> simulators;
+  simulators.emplace_back("/tmp/simKeithley2700", std::make_unique<Keithley2700Simulator>());
+  simulators.emplace_back("/tmp/simKeithleyDAQ6510", std::make_unique<KeithleyDAQ6510Simulator>());
+  simulators.emplace_back("/tmp/simRohdeSchwarzNGE103B", std::make_unique<RohdeSchwarzNGE103BSimulator>());
+  simulators.emplace_back("/tmp/simLStepExpress", std::make_unique<LStepExpressSimulator>());
+  simulators.emplace_back("/tmp/simHuberPilotOne", std::make_unique<HuberPilotOneSimulator>());
+
+  for (auto& simulator : simulators) {
+    simulator.second->SetResponseDelay(delay);
+    simulator.second->SetResponseJitter(jitter);
+    if (!simulator.second->Start(simulator.first)) return 1;
+    std::cout << simulator.second->PortName() << std::endl;
+  }
+
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+  while (running) pause();
+
+  for (auto& simulator : simulators) {
+    std::cout << simulator.second->PortName() << ": "
+              << simulator.second->GetCommandCount() << " commands, "
+              << simulator.second->GetResponseCount() << " responses" << std::endl;
+    simulator.second->Stop();
+  }
+
+  return 0;
+}
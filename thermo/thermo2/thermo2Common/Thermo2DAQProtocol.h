@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef THERMO2DAQPROTOCOL_H
+#define THERMO2DAQPROTOCOL_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QtEndian>
+
+/*
+  Subscription protocol between thermoDAQ2 and thermoDisplay2.
+
+  Every message is a frame of a 32 bit big endian payload length followed
+  by the payload, which is written with QDataStream and starts with the
+  message type.
+
+  client -> server
+    Subscribe  quint64 session, quint64 lastSequence
+               session and sequence number of the last message received
+               before the connection was lost, 0 for a new display
+
+  server -> client
+    Snapshot   quint64 session, quint64 sequence, QDateTime time, QString records
+               all device records as of sequence
+    Update     quint64 session, quint64 sequence, QDateTime time, QString records
+               only the device records that changed since sequence-1;
+               empty if only the measurement time advanced
+
+  The session changes whenever thermoDAQ2 is restarted, which also
+  restarts the sequence numbers.
+
+  A new subscriber gets a snapshot of the current state. A returning
+  subscriber gets all updates after lastSequence that are still kept by
+  the server, preceded by a snapshot if some of them were dropped already.
+  Afterwards updates are pushed as they are created.
+*/
+class Thermo2DAQProtocol
+{
+public:
+
+  enum MessageType {
+    Subscribe = 1,
+    Snapshot  = 2,
+    Update    = 3
+  };
+
+  static const QDataStream::Version streamVersion = QDataStream::Qt_5_0;
+
+  /// prepends the length header to a payload
+  static QByteArray frame(const QByteArray& payload) {
+    QByteArray block(sizeof(quint32), 0);
+    qToBigEndian<quint32>(payload.size(), reinterpret_cast<uchar*>(block.data()));
+    block.append(payload);
+    return block;
+  }
+
+  /// removes the next complete frame from buffer; false if it is incomplete
+  static bool takeFrame(QByteArray& buffer, QByteArray& payload) {
+    if (buffer.size()<(int)sizeof(quint32)) return false;
+    const quint32 length = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(buffer.constData()));
+    if ((quint32)buffer.size()-sizeof(quint32)<length) return false;
+    payload = buffer.mid(sizeof(quint32), length);
+    buffer.remove(0, sizeof(quint32) + length);
+    return true;
+  }
+};
+
+#endif // THERMO2DAQPROTOCOL_H
@@ -103,6 +103,11 @@ void Thermo2CommunicationThread::readData()
   quit();
 }
 
+/**
+  Handles a command. The setters of the device models queue themselves to
+  the thread of the model, so the reply does not wait for the device, and a
+  get right after a set may still return the previous value.
+  */
 bool Thermo2CommunicationThread::handleCommand(QStringList& tokens, QTextStream& os)
 {
   QMutexLocker locker(&mutex_);
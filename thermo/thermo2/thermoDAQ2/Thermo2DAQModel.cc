@@ -15,6 +15,7 @@
 #include <QApplication>
 #include <QDateTime>
 #include <QXmlStreamWriter>
+#include <QMutexLocker>
 
 #include <nqlogger.h>
 
@@ -34,10 +35,26 @@ Thermo2DAQModel::Thermo2DAQModel(HuberUnistat525wModel* huberModel,
    agilentModel_(agilentModel),
    leyboldModel_(leyboldModel),
    nge103BModel_(nge103BModel),
-   keithleyModel_(keithleyModel)
+   keithleyModel_(keithleyModel),
+   huber_(),
+   marta_(),
+   agilent_(),
+   leybold_(),
+   nge103B_(),
+   keithley_(),
+   writtenNGE103B_(),
+   writtenKeithley_()
 {
   currentTime_ = QDateTime::currentDateTime();
 
+  for (int device=0;device<Thermo2DAQSnapshot::DeviceCount;++device) {
+    status_[device].name = Thermo2DAQSnapshot::name((Thermo2DAQSnapshot::Device)device);
+    status_[device].version = 0;
+    status_[device].changes = 0;
+    status_[device].time = 0;
+    writtenChanges_[device] = 0;
+  }
+
   if (huberModel_) {
   	connect(huberModel_, SIGNAL(informationChanged()),
   			this, SLOT(huberInfoChanged()));
@@ -63,68 +80,29 @@ Thermo2DAQModel::Thermo2DAQModel(HuberUnistat525wModel* huberModel,
 
   connect(keithleyModel_, SIGNAL(informationChanged()),
   		this, SLOT(keithleyInfoChanged()));
+
+  // first snapshots, the device models still live in this thread
+  if (huberModel_) huberInfoChanged();
+  if (martaModel_) martaInfoChanged();
+  if (agilentModel_) agilentInfoChanged();
+  if (leyboldModel_) leyboldInfoChanged();
+  nge103BInfoChanged();
+  keithleyInfoChanged();
 }
 
+/**
+  Moves the DAQ model to its thread. The device models run in threads of
+  their own (DeviceModelExecutor), their signals reach the DAQ model as
+  queued connections.
+  */
 void Thermo2DAQModel::myMoveToThread(QThread *thread)
 {
-  if (huberModel_) huberModel_->moveToThread(thread);
-  if (martaModel_) martaModel_->moveToThread(thread);
-  if (agilentModel_) agilentModel_->moveToThread(thread);
-  if (leyboldModel_) leyboldModel_->moveToThread(thread);
-  nge103BModel_->moveToThread(thread);
-  keithleyModel_->moveToThread(thread);
-
   this->moveToThread(thread);
 }
 
 void Thermo2DAQModel::startMeasurement()
 {
-  for (int i=0;i<3;++i) {
-    nge103BOutputState_[i] = false;
-    nge103BOutputMode_[i] = 0;
-    nge103BVoltage_[i] = -1.0;
-    nge103BCurrent_[i] = -1.0;
-    nge103BMeasuredVoltage_[i] = 0.;
-    nge103BMeasuredCurrent_[i] = 0.;
-  }
-
-  u525wState_ = false;
-  u525wTemperatureSetPoint_ = 0.0;
-  u525wTemperatureControlMode_ = false;
-  u525wTemperatureControlEnabled_ = false;
-  u525wCirculatorEnabled_ = false;
-  u525wInternalTemperature_ = 0.0;
-  u525wProcessTemperature_ = 0.0;
-  u525wReturnTemperature_ = 0.0;
-  u525wPumpPressure_ = 0.0;
-  u525wPower_ = 0.0;
-  u525wCWInletTemperature_ = 0.0;
-  u525wCWOutletTemperature_ = 0.0;
-  u525AutoPID_ = false;
-  u525KpInternal_ = 0;
-  u525TnInternal_ = 0.0;
-  u525TvInternal_ = 0.0;
-  u525KpJacket_ = 0;
-  u525TnJacket_ = 0.0;
-  u525TvJacket_ = 0.0;
-  u525KpProcess_ = 0;
-  u525TnProcess_ = 0.0;
-  u525TvProcess_ = 0.0;
-
-  agilentState_ = false;
-  agilentPumpState_ = false;
-  agilentPumpStatus_ = 0;
-  agilentErrorCode_ = 0;
-
-  leyboldState_ = false;
-  leyboldPressure_ = 1.013;
-
-  for (unsigned int card=0;card<2;++card) {
-    for (unsigned int channel=0;channel<10;++channel) {
-      keithleyState_[card][channel] = false;
-      keithleyTemperature_[card][channel] = 0.;
-    }
-  }
+  resetUpdateState();
 
   daqState_ = true;
   emit daqStateChanged(true);
@@ -136,246 +114,184 @@ void Thermo2DAQModel::startMeasurement()
   NQLogMessage("thermo2DAQ") << "measurement started";
 }
 
-void Thermo2DAQModel::createDAQStatusMessage(QString &buffer, bool start)
+/**
+  Builds the status record of a device if the snapshot has a new version.
+  Called with statusMutex_ held.
+  */
+template <typename T> void Thermo2DAQModel::updateStatusRecord(Thermo2DAQSnapshot::Device device,
+                                                               const Thermo2DAQSeqLock<T>& lock)
 {
-  QDateTime& utime = currentTime();
+  StatusRecord& status = status_[device];
+  if (!status.record.isEmpty() && status.version==lock.version()) return;
 
-  if (start) {
-    buffer += QString("<ThermoDAQ2>");
+  T snapshot;
+  status.version = lock.read(snapshot);
+  status.changes = snapshot.changes;
+  status.time = snapshot.time;
+
+  QString buffer;
+  {
+    QXmlStreamWriter xml(&buffer);
+    xml.setAutoFormatting(true);
+    Thermo2DAQSnapshot::write(xml, snapshot);
   }
+  status.record = buffer.trimmed();
+}
 
-  QXmlStreamWriter xml(&buffer);
-  xml.setAutoFormatting(true);
+/**
+  Returns the status records of the active devices. A record is only
+  serialised again if the device was updated since it was last asked for,
+  and is shared with the caller otherwise.
+  */
+void Thermo2DAQModel::getStatusRecords(QVector<StatusRecord>& records)
+{
+  QMutexLocker locker(&statusMutex_);
 
-  //
-  // Start of Huber Unistat 525w
-  //
   if (huberModel_) {
-  	xml.writeStartElement("HuberUnistat525w");
-  	xml.writeAttribute("time", utime.toString(Qt::ISODate));
-  	xml.writeAttribute("State", huberModel_->getDeviceState()==READY ? "1" : "0");
-
-  	xml.writeStartElement("HuberUnistat525wControl");
-  	xml.writeAttribute("SetPoint", QString::number(huberModel_->getTemperatureSetPoint(), 'f', 2));
-  	xml.writeAttribute("ControlMode", QString::number(huberModel_->getTemperatureControlMode()));
-  	xml.writeAttribute("ControlEnabled", QString::number(huberModel_->getTemperatureControlEnabled()));
-  	xml.writeAttribute("CirculatorEnabled", QString::number(huberModel_->getCirculatorEnabled()));
-  	xml.writeEndElement();
-
-    xml.writeStartElement("HuberUnistat525wInfo");
-    xml.writeAttribute("Internal", QString::number(huberModel_->getInternalTemperature(), 'f', 2));
-    xml.writeAttribute("Process", QString::number(huberModel_->getProcessTemperature(), 'f', 2));
-    xml.writeAttribute("Return", QString::number(huberModel_->getReturnTemperature(), 'f', 2));
-    xml.writeAttribute("Pressure", QString::number(huberModel_->getPumpPressure(), 'f', 3));
-    xml.writeAttribute("Power", QString::number(huberModel_->getPower()));
-    xml.writeAttribute("CWI", QString::number(huberModel_->getCoolingWaterInletTemperature(), 'f', 2));
-    xml.writeAttribute("CWO", QString::number(huberModel_->getCoolingWaterOutletTemperature(), 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("HuberUnistat525wPID");
-    xml.writeAttribute("AutoPID", huberModel_->getAutoPID() ? "1" : "0");
-
-    xml.writeStartElement("HuberUnistat525wPIDInternal");
-    xml.writeAttribute("Kp", QString::number(huberModel_->getKpInternal()));
-    xml.writeAttribute("Tn", QString::number(huberModel_->getTnInternal(), 'f', 1));
-    xml.writeAttribute("Tv", QString::number(huberModel_->getTvInternal(), 'f', 1));
-    xml.writeEndElement();
-
-    xml.writeStartElement("HuberUnistat525wPIDJacket");
-    xml.writeAttribute("Kp", QString::number(huberModel_->getKpJacket()));
-    xml.writeAttribute("Tn", QString::number(huberModel_->getTnJacket(), 'f', 1));
-    xml.writeAttribute("Tv", QString::number(huberModel_->getTvJacket(), 'f', 1));
-    xml.writeEndElement();
-
-    xml.writeStartElement("HuberUnistat525wPIDProcess");
-    xml.writeAttribute("Kp", QString::number(huberModel_->getKpProcess()));
-    xml.writeAttribute("Tn", QString::number(huberModel_->getTnProcess(), 'f', 1));
-    xml.writeAttribute("Tv", QString::number(huberModel_->getTvProcess(), 'f', 1));
-    xml.writeEndElement();
-
-    xml.writeEndElement();
-
-  	xml.writeEndElement();
+    updateStatusRecord(Thermo2DAQSnapshot::HuberUnistat525wDevice, huberSnapshot_);
+    records.append(status_[Thermo2DAQSnapshot::HuberUnistat525wDevice]);
   }
-  //
-  // End of Huber Unistat 525w
-  //
-
-  //
-  // Start of Marta CO2 Chiller
-  //
   if (martaModel_) {
-  	xml.writeStartElement("Marta");
-  	xml.writeAttribute("time", utime.toString(Qt::ISODate));
-  	xml.writeAttribute("State", martaModel_->getDeviceState()==READY ? "1" : "0");
-
-  	xml.writeStartElement("MartaR507");
-  	xml.writeAttribute("PT03", QString::number(martaModel_->getPT03(), 'f', 2));
-  	xml.writeAttribute("PT05", QString::number(martaModel_->getPT05(), 'f', 2));
-  	xml.writeAttribute("TT02", QString::number(martaModel_->getTT02(), 'f', 2));
-  	xml.writeAttribute("SH05", QString::number(martaModel_->getSH05(), 'f', 2));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaPTCO2");
-  	xml.writeAttribute("PT01CO2", QString::number(martaModel_->getPT01CO2(), 'f', 2));
-  	xml.writeAttribute("PT02CO2", QString::number(martaModel_->getPT02CO2(), 'f', 2));
-  	xml.writeAttribute("PT03CO2", QString::number(martaModel_->getPT03CO2(), 'f', 2));
-  	xml.writeAttribute("PT04CO2", QString::number(martaModel_->getPT04CO2(), 'f', 2));
-  	xml.writeAttribute("PT05CO2", QString::number(martaModel_->getPT05CO2(), 'f', 2));
-  	xml.writeAttribute("PT06CO2", QString::number(martaModel_->getPT06CO2(), 'f', 2));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaTTCO2");
-  	xml.writeAttribute("TT01CO2", QString::number(martaModel_->getTT01CO2(), 'f', 2));
-  	xml.writeAttribute("TT02CO2", QString::number(martaModel_->getTT02CO2(), 'f', 2));
-  	xml.writeAttribute("TT03CO2", QString::number(martaModel_->getTT03CO2(), 'f', 2));
-  	xml.writeAttribute("TT04CO2", QString::number(martaModel_->getTT04CO2(), 'f', 2));
-  	xml.writeAttribute("TT05CO2", QString::number(martaModel_->getTT05CO2(), 'f', 2));
-  	xml.writeAttribute("TT06CO2", QString::number(martaModel_->getTT06CO2(), 'f', 2));
-  	xml.writeAttribute("TT07CO2", QString::number(martaModel_->getTT07CO2(), 'f', 2));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaSCCO2");
-  	xml.writeAttribute("SC01CO2", QString::number(martaModel_->getSC01CO2(), 'f', 2));
-  	xml.writeAttribute("SC02CO2", QString::number(martaModel_->getSC02CO2(), 'f', 2));
-  	xml.writeAttribute("SC03CO2", QString::number(martaModel_->getSC03CO2(), 'f', 2));
-  	xml.writeAttribute("SC05CO2", QString::number(martaModel_->getSC05CO2(), 'f', 2));
-  	xml.writeAttribute("SC06CO2", QString::number(martaModel_->getSC06CO2(), 'f', 2));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaDPCO2");
-  	xml.writeAttribute("DP01CO2", QString::number(martaModel_->getdP01CO2(), 'f', 2));
-  	xml.writeAttribute("DP02CO2", QString::number(martaModel_->getdP02CO2(), 'f', 2));
-  	xml.writeAttribute("DP03CO2", QString::number(martaModel_->getdP03CO2(), 'f', 2));
-  	xml.writeAttribute("DP04CO2", QString::number(martaModel_->getdP04CO2(), 'f', 2));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaDTCO2");
-  	xml.writeAttribute("DT02CO2", QString::number(martaModel_->getdT02CO2(), 'f', 2));
-  	xml.writeAttribute("DT03CO2", QString::number(martaModel_->getdT03CO2(), 'f', 2));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaSTCO2");
-  	xml.writeAttribute("ST01CO2", QString::number(martaModel_->getST01CO2(), 'f', 2));
-  	xml.writeAttribute("ST02CO2", QString::number(martaModel_->getST02CO2(), 'f', 2));
-  	xml.writeAttribute("ST03CO2", QString::number(martaModel_->getST03CO2(), 'f', 2));
-  	xml.writeAttribute("ST04CO2", QString::number(martaModel_->getST04CO2(), 'f', 2));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaFlow");
-  	xml.writeAttribute("FT01CO2", QString::number(martaModel_->getFT01CO2(), 'f', 3));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaSettings");
-  	xml.writeAttribute("Speed", QString::number((int)martaModel_->getSpeedSetpoint()));
-  	xml.writeAttribute("Flow", QString::number(martaModel_->getFlowSetpoint(), 'f', 1));
-  	xml.writeAttribute("Temperature", QString::number(martaModel_->getTemperatureSetpoint(), 'f', 1));
-  	xml.writeAttribute("Speed2", QString::number((int)martaModel_->getSpeedSetpoint2()));
-  	xml.writeAttribute("Flow2", QString::number(martaModel_->getFlowSetpoint2(), 'f', 1));
-  	xml.writeAttribute("Temperature2", QString::number(martaModel_->getTemperatureSetpoint2(), 'f', 1));
-  	xml.writeAttribute("Status", QString("0x") + QStringLiteral("%1").arg(martaModel_->getStatus(), 4, 16, QLatin1Char('0')));
-  	xml.writeEndElement();
-
-  	xml.writeStartElement("MartaAlarms");
-  	xml.writeAttribute("Status", QString::number(martaModel_->getAlarmStatus()));
-  	for (int idx=0;idx<4;++idx) {
-  		xml.writeAttribute(QString("Alarm") + QString::number(idx),
-  				QString("0x") + QStringLiteral("%1").arg(martaModel_->getAlarms(idx), 4, 16, QLatin1Char('0')));
-  	}
-  	xml.writeEndElement();
-
-  	xml.writeEndElement();
+    updateStatusRecord(Thermo2DAQSnapshot::MartaDevice, martaSnapshot_);
+    records.append(status_[Thermo2DAQSnapshot::MartaDevice]);
   }
-  //
-  // End of Marta CO2 Chiller
-  //
-
-  //
-  // Start of Agilent TwisTorr 304
-  //
   if (agilentModel_) {
-  	xml.writeStartElement("AgilentTwisTorr304");
-  	xml.writeAttribute("time", utime.toString(Qt::ISODate));
-  	xml.writeAttribute("State", agilentModel_->getDeviceState()==READY ? "1" : "0");
-  	xml.writeAttribute("PumpState", agilentModel_->getPumpState()==true ? "1" : "0");
-  	xml.writeAttribute("PumpStatus", QString::number(agilentModel_->getPumpStatus()));
-  	xml.writeAttribute("ErrorCode", QString::number(agilentModel_->getErrorCode()));
-  	xml.writeEndElement();
+    updateStatusRecord(Thermo2DAQSnapshot::AgilentTwisTorr304Device, agilentSnapshot_);
+    records.append(status_[Thermo2DAQSnapshot::AgilentTwisTorr304Device]);
   }
-  //
-  // End of Agilent TwisTorr 304
-  //
-
-  //
-  // Start of Leybold Graphix One
-  //
   if (leyboldModel_) {
-  	xml.writeStartElement("LeyboldGraphixOne");
-  	xml.writeAttribute("time", utime.toString(Qt::ISODate));
-  	xml.writeAttribute("State", leyboldModel_->getDeviceState()==READY ? "1" : "0");
-  	xml.writeAttribute("Pressure", QString::number(leyboldModel_->getPressure(), 'e', 3));
-  	xml.writeEndElement();
+    updateStatusRecord(Thermo2DAQSnapshot::LeyboldGraphixOneDevice, leyboldSnapshot_);
+    records.append(status_[Thermo2DAQSnapshot::LeyboldGraphixOneDevice]);
   }
-  //
-  // End of Leybold Graphix One
-  //
-
-  //
-  // Start of Rohde & Schwarz NGE103B
-  //
-  xml.writeStartElement("RohdeSchwarzNGE103B");
-  xml.writeAttribute("time", utime.toString(Qt::ISODate));
-  for (int i=0;i<3;++i) {
-    xml.writeStartElement(QString("RohdeSchwarzNGE103BChannel"));
-    xml.writeAttribute("id", QString::number(i+1));
-    xml.writeAttribute("State", nge103BModel_->getOutputState(i+1)==true ? "1" : "0");
-    xml.writeAttribute("Mode", QString::number(nge103BModel_->getOutputMode(i+1)));
-    xml.writeAttribute("U", QString::number(nge103BModel_->getVoltage(i+1), 'f', 3));
-    xml.writeAttribute("mU", QString::number(nge103BModel_->getMeasuredVoltage(i+1), 'f', 3));
-    xml.writeAttribute("I", QString::number(nge103BModel_->getCurrent(i+1), 'f', 3));
-    xml.writeAttribute("mI", QString::number(nge103BModel_->getMeasuredCurrent(i+1), 'f', 3));
-    xml.writeEndElement();
+
+  updateStatusRecord(Thermo2DAQSnapshot::RohdeSchwarzNGE103BDevice, nge103BSnapshot_);
+  records.append(status_[Thermo2DAQSnapshot::RohdeSchwarzNGE103BDevice]);
+
+  updateStatusRecord(Thermo2DAQSnapshot::KeithleyDAQ6510Device, keithleySnapshot_);
+  records.append(status_[Thermo2DAQSnapshot::KeithleyDAQ6510Device]);
+}
+
+void Thermo2DAQModel::createDAQStatusMessage(QString &buffer, bool start)
+{
+  if (start) {
+    buffer += QString("<ThermoDAQ2>");
   }
-  xml.writeEndElement();
-  //
-  // End of Rohde & Schwarz NGE103B
-  //
-
-  //
-  // Start of Keithley DAQ6510
-  //
-  xml.writeStartElement("KeithleyDAQ6510");
-  xml.writeAttribute("time", utime.toString(Qt::ISODate));
-  for (unsigned int card=1;card<=2;++card) {
-    for (unsigned int channel=1;channel<=10;++channel) {
-      unsigned int sensor = card*100 + channel;
-
-      keithleyState_[card-1][channel-1] = keithleyModel_->getSensorState(sensor)==READY;
-      if (keithleyState_[card-1][channel-1]) {
-        keithleyTemperature_[card-1][channel-1] = keithleyModel_->getTemperature(sensor);
-      } else {
-        keithleyTemperature_[card-1][channel-1] = 0;
-      }
 
-      xml.writeStartElement(QString("KeithleyDAQ6510Sensor"));
-      xml.writeAttribute("id", QString::number(sensor));
-      xml.writeAttribute("State", keithleyState_[card-1][channel-1]==true ? "1" : "0");
-      xml.writeAttribute("T", QString::number(keithleyTemperature_[card-1][channel-1], 'f', 4));
-      xml.writeEndElement();
-    }
+  QVector<StatusRecord> records;
+  getStatusRecords(records);
+
+  for (QVector<StatusRecord>::const_iterator it = records.constBegin();
+       it != records.constEnd();
+       ++it) {
+    buffer += "\n";
+    buffer += it->record;
   }
-  xml.writeEndElement();
-  //
-  // End of Keithley DAQ6510
-  //
 
   if (start) {
+    QXmlStreamWriter xml(&buffer);
+    xml.setAutoFormatting(true);
+
     xml.writeStartElement("DAQStarted");
-    xml.writeAttribute("time", utime.toString(Qt::ISODate));
+    xml.writeAttribute("time", QDateTime::currentDateTime().toString(Qt::ISODate));
     xml.writeEndElement();
   }
 }
 
+static bool changedSince(quint64 changes, quint64& written)
+{
+  if (changes==written) return false;
+  written = changes;
+  return true;
+}
+
+/**
+  Writes the data of a device that changed since it was last written to
+  the buffer. Called by the streamer in its thread for every update.
+  */
+void Thermo2DAQModel::createDAQUpdateMessage(int device, QString & buffer)
+{
+  QMutexLocker locker(&updateMutex_);
+
+  QXmlStreamWriter xml(&buffer);
+  xml.setAutoFormatting(true);
+
+  switch (device) {
+  case Thermo2DAQSnapshot::HuberUnistat525wDevice: {
+    Thermo2DAQSnapshot::HuberUnistat525w s;
+    huberSnapshot_.read(s);
+    if (changedSince(s.changes, writtenChanges_[device])) Thermo2DAQSnapshot::write(xml, s, false);
+    break;
+  }
+  case Thermo2DAQSnapshot::MartaDevice: {
+    Thermo2DAQSnapshot::Marta s;
+    martaSnapshot_.read(s);
+    if (changedSince(s.changes, writtenChanges_[device])) Thermo2DAQSnapshot::write(xml, s);
+    break;
+  }
+  case Thermo2DAQSnapshot::AgilentTwisTorr304Device: {
+    Thermo2DAQSnapshot::AgilentTwisTorr304 s;
+    agilentSnapshot_.read(s);
+    if (changedSince(s.changes, writtenChanges_[device])) Thermo2DAQSnapshot::write(xml, s);
+    break;
+  }
+  case Thermo2DAQSnapshot::LeyboldGraphixOneDevice: {
+    Thermo2DAQSnapshot::LeyboldGraphixOne s;
+    leyboldSnapshot_.read(s);
+    if (changedSince(s.changes, writtenChanges_[device])) Thermo2DAQSnapshot::write(xml, s);
+    break;
+  }
+  case Thermo2DAQSnapshot::RohdeSchwarzNGE103BDevice: {
+    // written for every update, with the channels that changed
+    Thermo2DAQSnapshot::RohdeSchwarzNGE103B s;
+    nge103BSnapshot_.read(s);
+    Thermo2DAQSnapshot::write(xml, s, &writtenNGE103B_);
+    writtenNGE103B_ = s;
+    break;
+  }
+  case Thermo2DAQSnapshot::KeithleyDAQ6510Device: {
+    // written for every update, with the sensors that changed
+    Thermo2DAQSnapshot::KeithleyDAQ6510 s;
+    keithleySnapshot_.read(s);
+    Thermo2DAQSnapshot::write(xml, s, &writtenKeithley_);
+    writtenKeithley_ = s;
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+/**
+  Takes the current snapshots as written, as they are part of the status
+  message that starts a measurement.
+  */
+void Thermo2DAQModel::resetUpdateState()
+{
+  QMutexLocker locker(&updateMutex_);
+
+  Thermo2DAQSnapshot::HuberUnistat525w huber;
+  huberSnapshot_.read(huber);
+  writtenChanges_[Thermo2DAQSnapshot::HuberUnistat525wDevice] = huber.changes;
+
+  Thermo2DAQSnapshot::Marta marta;
+  martaSnapshot_.read(marta);
+  writtenChanges_[Thermo2DAQSnapshot::MartaDevice] = marta.changes;
+
+  Thermo2DAQSnapshot::AgilentTwisTorr304 agilent;
+  agilentSnapshot_.read(agilent);
+  writtenChanges_[Thermo2DAQSnapshot::AgilentTwisTorr304Device] = agilent.changes;
+
+  Thermo2DAQSnapshot::LeyboldGraphixOne leybold;
+  leyboldSnapshot_.read(leybold);
+  writtenChanges_[Thermo2DAQSnapshot::LeyboldGraphixOneDevice] = leybold.changes;
+
+  nge103BSnapshot_.read(writtenNGE103B_);
+  writtenChanges_[Thermo2DAQSnapshot::RohdeSchwarzNGE103BDevice] = writtenNGE103B_.changes;
+
+  keithleySnapshot_.read(writtenKeithley_);
+  writtenChanges_[Thermo2DAQSnapshot::KeithleyDAQ6510Device] = writtenKeithley_.changes;
+}
+
 void Thermo2DAQModel::stopMeasurement()
 {
   QString buffer("</ThermoDAQ2>");
@@ -404,446 +320,168 @@ void Thermo2DAQModel::customDAQMessage(const QString & message)
   emit daqMessage(message);
 }
 
+/*
+  The *InfoChanged() slots run in the DAQ thread. They copy the values of
+  the device into its snapshot and publish it; the XML is written by the
+  readers of the snapshots.
+  */
 
 void Thermo2DAQModel::huberInfoChanged()
 {
-  if (!daqState_) return;
-
   NQLogDebug("Thermo2DAQModel") << "huberInfoChanged()";
 
-  if (thread()==QApplication::instance()->thread()) {
-    NQLogDebug("Thermo2DAQModel") << "running in main application thread";
-  } else {
-    NQLogDebug("Thermo2DAQModel") << "running in dedicated DAQ thread";
-  }
-
-  QMutexLocker locker(&mutex_);
-
-  QDateTime& utime = currentTime();
-
-  QString buffer;
+  Thermo2DAQSnapshot::HuberUnistat525w& s = huber_;
 
   bool changed = false;
-  changed |= updateIfChanged<bool>(u525wState_, huberModel_->getDeviceState()==READY ? true : false);
-  changed |= updateIfChanged<float>(u525wTemperatureSetPoint_, huberModel_->getTemperatureSetPoint());
-  changed |= updateIfChanged<bool>(u525wTemperatureControlMode_, huberModel_->getTemperatureControlMode());
-  changed |= updateIfChanged<bool>(u525wTemperatureControlEnabled_, huberModel_->getTemperatureControlEnabled());
-  changed |= updateIfChanged<bool>(u525wCirculatorEnabled_, huberModel_->getCirculatorEnabled());
-  changed |= updateIfChanged<float>(u525wInternalTemperature_, huberModel_->getInternalTemperature());
-  changed |= updateIfChanged<float>(u525wProcessTemperature_, huberModel_->getProcessTemperature());
-  changed |= updateIfChanged<float>(u525wReturnTemperature_, huberModel_->getReturnTemperature());
-  changed |= updateIfChanged<float>(u525wPumpPressure_, huberModel_->getPumpPressure());
-  changed |= updateIfChanged<int>(u525wPower_, huberModel_->getPower());
-  changed |= updateIfChanged<float>(u525wCWInletTemperature_, huberModel_->getCoolingWaterInletTemperature());
-  changed |= updateIfChanged<float>(u525wCWOutletTemperature_, huberModel_->getCoolingWaterOutletTemperature());
-  changed |= updateIfChanged<bool>(u525AutoPID_, huberModel_->getAutoPID());
-  changed |= updateIfChanged<int>(u525KpInternal_, huberModel_->getKpInternal());
-  changed |= updateIfChanged<float>(u525TnInternal_, huberModel_->getTnInternal());
-  changed |= updateIfChanged<float>(u525TvInternal_, huberModel_->getTvInternal());
-  changed |= updateIfChanged<int>(u525KpJacket_, huberModel_->getKpJacket());
-  changed |= updateIfChanged<float>(u525TnJacket_, huberModel_->getTnJacket());
-  changed |= updateIfChanged<float>(u525TvJacket_, huberModel_->getTvJacket());
-  changed |= updateIfChanged<int>(u525KpProcess_, huberModel_->getKpProcess());
-  changed |= updateIfChanged<float>(u525TnProcess_, huberModel_->getTnProcess());
-  changed |= updateIfChanged<float>(u525TvProcess_, huberModel_->getTvProcess());
-
-  if (changed) {
-    QXmlStreamWriter xml(&buffer);
-    xml.setAutoFormatting(true);
-
-    xml.writeStartElement("HuberUnistat525w");
-    xml.writeAttribute("time", utime.toString(Qt::ISODate));
-    xml.writeAttribute("State", QString::number(u525wState_));
-
-    xml.writeStartElement("HuberUnistat525wControl");
-    xml.writeAttribute("SetPoint", QString::number(u525wTemperatureSetPoint_, 'f', 2));
-    xml.writeAttribute("ControlMode", QString::number(u525wTemperatureControlMode_));
-    xml.writeAttribute("ControlEnabled", QString::number(u525wTemperatureControlEnabled_));
-    xml.writeAttribute("CirculatorEnabled", QString::number(u525wCirculatorEnabled_));
-    xml.writeEndElement();
-
-    xml.writeStartElement("HuberUnistat525wInfo");
-    xml.writeAttribute("Internal", QString::number(u525wInternalTemperature_, 'f', 2));
-    xml.writeAttribute("Process", QString::number(u525wProcessTemperature_, 'f', 2));
-    xml.writeAttribute("Return", QString::number(u525wReturnTemperature_, 'f', 2));
-    xml.writeAttribute("Pressure", QString::number(u525wPumpPressure_, 'f', 3));
-    xml.writeAttribute("Power", QString::number(u525wPower_));
-    xml.writeAttribute("CWI", QString::number(u525wCWInletTemperature_, 'f', 2));
-    xml.writeAttribute("CWO", QString::number(u525wCWOutletTemperature_, 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("HuberUnistat525wPID");
-    xml.writeAttribute("AutoPID", u525AutoPID_ ? "1" : "0");
-    if (!u525AutoPID_) {
-      if (!u525wTemperatureControlMode_) {
-        xml.writeStartElement("HuberUnistat525wPIDInternal");
-        xml.writeAttribute("Kp", QString::number(u525KpInternal_));
-        xml.writeAttribute("Tn", QString::number(u525TnInternal_, 'f', 1));
-        xml.writeAttribute("Tv", QString::number(u525TvInternal_, 'f', 1));
-        xml.writeEndElement();
-      } else {
-        xml.writeStartElement("HuberUnistat525wPIDProcess");
-        xml.writeAttribute("Kp", QString::number(u525KpProcess_));
-        xml.writeAttribute("Tn", QString::number(u525TnProcess_, 'f', 1));
-        xml.writeAttribute("Tv", QString::number(u525TvProcess_, 'f', 1));
-        xml.writeEndElement();
-     }
-    }
-    xml.writeEndElement();
-
-    xml.writeEndElement();
-  }
-
-  if (buffer.length()>0) {
-    emit daqMessage(buffer);
-    emit newDataAvailable();
-  }
+  changed |= updateIfChanged<bool>(s.state, huberModel_->getDeviceState()==READY ? true : false);
+  changed |= updateIfChanged<float>(s.temperatureSetPoint, huberModel_->getTemperatureSetPoint());
+  changed |= updateIfChanged<bool>(s.temperatureControlMode, huberModel_->getTemperatureControlMode());
+  changed |= updateIfChanged<bool>(s.temperatureControlEnabled, huberModel_->getTemperatureControlEnabled());
+  changed |= updateIfChanged<bool>(s.circulatorEnabled, huberModel_->getCirculatorEnabled());
+  changed |= updateIfChanged<float>(s.internalTemperature, huberModel_->getInternalTemperature());
+  changed |= updateIfChanged<float>(s.processTemperature, huberModel_->getProcessTemperature());
+  changed |= updateIfChanged<float>(s.returnTemperature, huberModel_->getReturnTemperature());
+  changed |= updateIfChanged<float>(s.pumpPressure, huberModel_->getPumpPressure());
+  changed |= updateIfChanged<int>(s.power, huberModel_->getPower());
+  changed |= updateIfChanged<float>(s.cwInletTemperature, huberModel_->getCoolingWaterInletTemperature());
+  changed |= updateIfChanged<float>(s.cwOutletTemperature, huberModel_->getCoolingWaterOutletTemperature());
+  changed |= updateIfChanged<bool>(s.autoPID, huberModel_->getAutoPID());
+  changed |= updateIfChanged<int>(s.kpInternal, huberModel_->getKpInternal());
+  changed |= updateIfChanged<float>(s.tnInternal, huberModel_->getTnInternal());
+  changed |= updateIfChanged<float>(s.tvInternal, huberModel_->getTvInternal());
+  changed |= updateIfChanged<int>(s.kpJacket, huberModel_->getKpJacket());
+  changed |= updateIfChanged<float>(s.tnJacket, huberModel_->getTnJacket());
+  changed |= updateIfChanged<float>(s.tvJacket, huberModel_->getTvJacket());
+  changed |= updateIfChanged<int>(s.kpProcess, huberModel_->getKpProcess());
+  changed |= updateIfChanged<float>(s.tnProcess, huberModel_->getTnProcess());
+  changed |= updateIfChanged<float>(s.tvProcess, huberModel_->getTvProcess());
+
+  publish(Thermo2DAQSnapshot::HuberUnistat525wDevice, s, huberSnapshot_, changed);
 }
 
 void Thermo2DAQModel::martaInfoChanged()
 {
-  if (!daqState_) return;
-
   NQLogDebug("Thermo2DAQModel") << "martaInfoChanged()";
 
-  if (thread()==QApplication::instance()->thread()) {
-    NQLogDebug("Thermo2DAQModel") << "running in main application thread";
-  } else {
-    NQLogDebug("Thermo2DAQModel") << "running in dedicated DAQ thread";
-  }
-
-  QMutexLocker locker(&mutex_);
-
-  QDateTime& utime = currentTime();
-
-  QString buffer;
+  Thermo2DAQSnapshot::Marta& s = marta_;
 
   bool changed = false;
-  changed |= updateIfChanged<bool>(martaState_, martaModel_->getDeviceState()==READY ? true : false);
-  changed |= updateIfChanged<float>(martaPT03_, martaModel_->getPT03());
-  changed |= updateIfChanged<float>(martaPT05_, martaModel_->getPT05());
-  changed |= updateIfChanged<float>(martaTT02_, martaModel_->getTT02());
-  changed |= updateIfChanged<float>(martaSH05_, martaModel_->getSH05());
-  changed |= updateIfChanged<float>(martaPT01CO2_, martaModel_->getPT01CO2());
-  changed |= updateIfChanged<float>(martaPT02CO2_, martaModel_->getPT02CO2());
-  changed |= updateIfChanged<float>(martaPT03CO2_, martaModel_->getPT03CO2());
-  changed |= updateIfChanged<float>(martaPT04CO2_, martaModel_->getPT04CO2());
-  changed |= updateIfChanged<float>(martaPT05CO2_, martaModel_->getPT05CO2());
-  changed |= updateIfChanged<float>(martaPT06CO2_, martaModel_->getPT06CO2());
-  changed |= updateIfChanged<float>(martaTT01CO2_, martaModel_->getTT01CO2());
-  changed |= updateIfChanged<float>(martaTT02CO2_, martaModel_->getTT02CO2());
-  changed |= updateIfChanged<float>(martaTT03CO2_, martaModel_->getTT03CO2());
-  changed |= updateIfChanged<float>(martaTT04CO2_, martaModel_->getTT04CO2());
-  changed |= updateIfChanged<float>(martaTT05CO2_, martaModel_->getTT05CO2());
-  changed |= updateIfChanged<float>(martaTT06CO2_, martaModel_->getTT06CO2());
-  changed |= updateIfChanged<float>(martaTT07CO2_, martaModel_->getTT07CO2());
-  changed |= updateIfChanged<float>(martaSC01CO2_, martaModel_->getSC01CO2());
-  changed |= updateIfChanged<float>(martaSC02CO2_, martaModel_->getSC02CO2());
-  changed |= updateIfChanged<float>(martaSC03CO2_, martaModel_->getSC03CO2());
-  changed |= updateIfChanged<float>(martaSC05CO2_, martaModel_->getSC05CO2());
-  changed |= updateIfChanged<float>(martaSC06CO2_, martaModel_->getSC06CO2());
-  changed |= updateIfChanged<float>(martaDP01CO2_, martaModel_->getdP01CO2());
-  changed |= updateIfChanged<float>(martaDP02CO2_, martaModel_->getdP02CO2());
-  changed |= updateIfChanged<float>(martaDP03CO2_, martaModel_->getdP03CO2());
-  changed |= updateIfChanged<float>(martaDP04CO2_, martaModel_->getdP04CO2());
-  changed |= updateIfChanged<float>(martaDT02CO2_, martaModel_->getdT02CO2());
-  changed |= updateIfChanged<float>(martaDT03CO2_, martaModel_->getdT03CO2());
-  changed |= updateIfChanged<float>(martaST01CO2_, martaModel_->getST01CO2());
-  changed |= updateIfChanged<float>(martaST02CO2_, martaModel_->getST02CO2());
-  changed |= updateIfChanged<float>(martaST03CO2_, martaModel_->getST03CO2());
-  changed |= updateIfChanged<float>(martaST04CO2_, martaModel_->getST04CO2());
-  changed |= updateIfChanged<float>(martaFT01CO2_, martaModel_->getFT01CO2());
-  changed |= updateIfChanged<float>(martaSpeedSetpoint_, martaModel_->getSpeedSetpoint());
-  changed |= updateIfChanged<float>(martaFlowSetpoint_, martaModel_->getSpeedSetpoint());
-  changed |= updateIfChanged<float>(martaTemperatureSetpoint_, martaModel_->getSpeedSetpoint());
-  changed |= updateIfChanged<float>(martaSpeedSetpoint2_, martaModel_->getSpeedSetpoint2());
-  changed |= updateIfChanged<float>(martaFlowSetpoint2_, martaModel_->getSpeedSetpoint2());
-  changed |= updateIfChanged<float>(martaTemperatureSetpoint2_, martaModel_->getSpeedSetpoint2());
-  changed |= updateIfChanged<uint16_t>(martaStatus_, martaModel_->getStatus());
-  changed |= updateIfChanged<uint16_t>(martaAlarms_[0], martaModel_->getAlarms(0));
-  changed |= updateIfChanged<uint16_t>(martaAlarms_[1], martaModel_->getAlarms(1));
-  changed |= updateIfChanged<uint16_t>(martaAlarms_[2], martaModel_->getAlarms(2));
-  changed |= updateIfChanged<uint16_t>(martaAlarms_[3], martaModel_->getAlarms(3));
-  changed |= updateIfChanged<uint16_t>(martaAlarmStatus_, martaModel_->getAlarmStatus());
-
-  if (changed) {
-    QXmlStreamWriter xml(&buffer);
-    xml.setAutoFormatting(true);
-
-    xml.writeStartElement("Marta");
-    xml.writeAttribute("time", utime.toString(Qt::ISODate));
-    xml.writeAttribute("State", QString::number(martaState_));
-
-    xml.writeStartElement("MartaR507");
-    xml.writeAttribute("PT03", QString::number(martaPT03_, 'f', 2));
-    xml.writeAttribute("PT05", QString::number(martaPT05_, 'f', 2));
-    xml.writeAttribute("TT02", QString::number(martaTT02_, 'f', 2));
-    xml.writeAttribute("SH05", QString::number(martaSH05_, 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaPTCO2");
-    xml.writeAttribute("PT01CO2", QString::number(martaPT01CO2_, 'f', 2));
-    xml.writeAttribute("PT02CO2", QString::number(martaPT02CO2_, 'f', 2));
-    xml.writeAttribute("PT03CO2", QString::number(martaPT03CO2_, 'f', 2));
-    xml.writeAttribute("PT04CO2", QString::number(martaPT04CO2_, 'f', 2));
-    xml.writeAttribute("PT05CO2", QString::number(martaPT05CO2_, 'f', 2));
-    xml.writeAttribute("PT06CO2", QString::number(martaPT06CO2_, 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaTTCO2");
-    xml.writeAttribute("TT01CO2", QString::number(martaTT01CO2_, 'f', 2));
-    xml.writeAttribute("TT02CO2", QString::number(martaTT02CO2_, 'f', 2));
-    xml.writeAttribute("TT03CO2", QString::number(martaTT03CO2_, 'f', 2));
-    xml.writeAttribute("TT04CO2", QString::number(martaTT04CO2_, 'f', 2));
-    xml.writeAttribute("TT05CO2", QString::number(martaTT05CO2_, 'f', 2));
-    xml.writeAttribute("TT06CO2", QString::number(martaTT06CO2_, 'f', 2));
-    xml.writeAttribute("TT07CO2", QString::number(martaTT07CO2_, 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaSCCO2");
-    xml.writeAttribute("SC01CO2", QString::number(martaSC01CO2_, 'f', 2));
-    xml.writeAttribute("SC02CO2", QString::number(martaSC02CO2_, 'f', 2));
-    xml.writeAttribute("SC03CO2", QString::number(martaSC03CO2_, 'f', 2));
-    xml.writeAttribute("SC05CO2", QString::number(martaSC05CO2_, 'f', 2));
-    xml.writeAttribute("SC06CO2", QString::number(martaSC06CO2_, 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaDPCO2");
-    xml.writeAttribute("DP01CO2", QString::number(martaDP01CO2_, 'f', 2));
-    xml.writeAttribute("DP02CO2", QString::number(martaDP02CO2_, 'f', 2));
-    xml.writeAttribute("DP03CO2", QString::number(martaDP03CO2_, 'f', 2));
-    xml.writeAttribute("DP04CO2", QString::number(martaDP04CO2_, 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaDTCO2");
-    xml.writeAttribute("DT02CO2", QString::number(martaDT02CO2_, 'f', 2));
-    xml.writeAttribute("DT03CO2", QString::number(martaDT03CO2_, 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaSTCO2");
-    xml.writeAttribute("ST01CO2", QString::number(martaST01CO2_, 'f', 2));
-    xml.writeAttribute("ST02CO2", QString::number(martaST02CO2_, 'f', 2));
-    xml.writeAttribute("ST03CO2", QString::number(martaST03CO2_, 'f', 2));
-    xml.writeAttribute("ST04CO2", QString::number(martaST04CO2_, 'f', 2));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaFlow");
-    xml.writeAttribute("FT01CO2", QString::number(martaFT01CO2_, 'f', 3));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaSettings");
-    xml.writeAttribute("Speed", QString::number((int)martaSpeedSetpoint_));
-    xml.writeAttribute("Flow", QString::number(martaFlowSetpoint_, 'f', 1));
-    xml.writeAttribute("Temperature", QString::number(martaTemperatureSetpoint_, 'f', 1));
-    xml.writeAttribute("Speed2", QString::number((int)martaSpeedSetpoint2_));
-    xml.writeAttribute("Flow2", QString::number(martaFlowSetpoint2_, 'f', 1));
-    xml.writeAttribute("Temperature2", QString::number(martaTemperatureSetpoint2_, 'f', 1));
-    xml.writeAttribute("Status", QString("0x") + QStringLiteral("%1").arg(martaStatus_, 4, 16, QLatin1Char('0')));
-    xml.writeEndElement();
-
-    xml.writeStartElement("MartaAlarms");
-    xml.writeAttribute("Status", QString::number(martaAlarmStatus_));
-    for (int idx=0;idx<4;++idx) {
-    	xml.writeAttribute(QString("Alarm") + QString::number(idx),
-  											 QString("0x") + QStringLiteral("%1").arg(martaAlarms_[idx], 4, 16, QLatin1Char('0')));
-    }
-    xml.writeEndElement();
-
-    xml.writeEndElement();
-  }
-
-  if (buffer.length()>0) {
-    emit daqMessage(buffer);
-    emit newDataAvailable();
-  }
+  changed |= updateIfChanged<bool>(s.state, martaModel_->getDeviceState()==READY ? true : false);
+  changed |= updateIfChanged<float>(s.PT03, martaModel_->getPT03());
+  changed |= updateIfChanged<float>(s.PT05, martaModel_->getPT05());
+  changed |= updateIfChanged<float>(s.TT02, martaModel_->getTT02());
+  changed |= updateIfChanged<float>(s.SH05, martaModel_->getSH05());
+  changed |= updateIfChanged<float>(s.PT01CO2, martaModel_->getPT01CO2());
+  changed |= updateIfChanged<float>(s.PT02CO2, martaModel_->getPT02CO2());
+  changed |= updateIfChanged<float>(s.PT03CO2, martaModel_->getPT03CO2());
+  changed |= updateIfChanged<float>(s.PT04CO2, martaModel_->getPT04CO2());
+  changed |= updateIfChanged<float>(s.PT05CO2, martaModel_->getPT05CO2());
+  changed |= updateIfChanged<float>(s.PT06CO2, martaModel_->getPT06CO2());
+  changed |= updateIfChanged<float>(s.TT01CO2, martaModel_->getTT01CO2());
+  changed |= updateIfChanged<float>(s.TT02CO2, martaModel_->getTT02CO2());
+  changed |= updateIfChanged<float>(s.TT03CO2, martaModel_->getTT03CO2());
+  changed |= updateIfChanged<float>(s.TT04CO2, martaModel_->getTT04CO2());
+  changed |= updateIfChanged<float>(s.TT05CO2, martaModel_->getTT05CO2());
+  changed |= updateIfChanged<float>(s.TT06CO2, martaModel_->getTT06CO2());
+  changed |= updateIfChanged<float>(s.TT07CO2, martaModel_->getTT07CO2());
+  changed |= updateIfChanged<float>(s.SC01CO2, martaModel_->getSC01CO2());
+  changed |= updateIfChanged<float>(s.SC02CO2, martaModel_->getSC02CO2());
+  changed |= updateIfChanged<float>(s.SC03CO2, martaModel_->getSC03CO2());
+  changed |= updateIfChanged<float>(s.SC05CO2, martaModel_->getSC05CO2());
+  changed |= updateIfChanged<float>(s.SC06CO2, martaModel_->getSC06CO2());
+  changed |= updateIfChanged<float>(s.DP01CO2, martaModel_->getdP01CO2());
+  changed |= updateIfChanged<float>(s.DP02CO2, martaModel_->getdP02CO2());
+  changed |= updateIfChanged<float>(s.DP03CO2, martaModel_->getdP03CO2());
+  changed |= updateIfChanged<float>(s.DP04CO2, martaModel_->getdP04CO2());
+  changed |= updateIfChanged<float>(s.DT02CO2, martaModel_->getdT02CO2());
+  changed |= updateIfChanged<float>(s.DT03CO2, martaModel_->getdT03CO2());
+  changed |= updateIfChanged<float>(s.ST01CO2, martaModel_->getST01CO2());
+  changed |= updateIfChanged<float>(s.ST02CO2, martaModel_->getST02CO2());
+  changed |= updateIfChanged<float>(s.ST03CO2, martaModel_->getST03CO2());
+  changed |= updateIfChanged<float>(s.ST04CO2, martaModel_->getST04CO2());
+  changed |= updateIfChanged<float>(s.FT01CO2, martaModel_->getFT01CO2());
+  changed |= updateIfChanged<float>(s.speedSetpoint, martaModel_->getSpeedSetpoint());
+  changed |= updateIfChanged<float>(s.flowSetpoint, martaModel_->getFlowSetpoint());
+  changed |= updateIfChanged<float>(s.temperatureSetpoint, martaModel_->getTemperatureSetpoint());
+  changed |= updateIfChanged<float>(s.speedSetpoint2, martaModel_->getSpeedSetpoint2());
+  changed |= updateIfChanged<float>(s.flowSetpoint2, martaModel_->getFlowSetpoint2());
+  changed |= updateIfChanged<float>(s.temperatureSetpoint2, martaModel_->getTemperatureSetpoint2());
+  changed |= updateIfChanged<uint16_t>(s.status, martaModel_->getStatus());
+  changed |= updateIfChanged<uint16_t>(s.alarms[0], martaModel_->getAlarms(0));
+  changed |= updateIfChanged<uint16_t>(s.alarms[1], martaModel_->getAlarms(1));
+  changed |= updateIfChanged<uint16_t>(s.alarms[2], martaModel_->getAlarms(2));
+  changed |= updateIfChanged<uint16_t>(s.alarms[3], martaModel_->getAlarms(3));
+  changed |= updateIfChanged<uint16_t>(s.alarmStatus, martaModel_->getAlarmStatus());
+
+  publish(Thermo2DAQSnapshot::MartaDevice, s, martaSnapshot_, changed);
 }
 
 void Thermo2DAQModel::agilentInfoChanged()
 {
-  if (!daqState_) return;
-
   NQLogDebug("Thermo2DAQModel") << "agilentInfoChanged()";
 
-  if (thread()==QApplication::instance()->thread()) {
-    NQLogDebug("Thermo2DAQModel") << "running in main application thread";
-  } else {
-    NQLogDebug("Thermo2DAQModel") << "running in dedicated DAQ thread";
-  }
-
-  QMutexLocker locker(&mutex_);
-
-  QDateTime& utime = currentTime();
-
-  QString buffer;
+  Thermo2DAQSnapshot::AgilentTwisTorr304& s = agilent_;
 
   bool changed = false;
-  changed |= updateIfChanged<bool>(agilentState_, agilentModel_->getDeviceState()==READY ? true : false);
-  changed |= updateIfChanged<bool>(agilentPumpState_, agilentModel_->getPumpState());
-  changed |= updateIfChanged<unsigned int>(agilentPumpStatus_, agilentModel_->getPumpStatus());
-  changed |= updateIfChanged<unsigned int>(agilentErrorCode_, agilentModel_->getErrorCode());
-
-  if (changed) {
-    QXmlStreamWriter xml(&buffer);
-    xml.setAutoFormatting(true);
-
-    xml.writeStartElement("AgilentTwisTorr304");
-    xml.writeAttribute("time", utime.toString(Qt::ISODate));
-    xml.writeAttribute("State", agilentState_==READY ? "1" : "0");
-    xml.writeAttribute("PumpState", agilentPumpState_==true ? "1" : "0");
-    xml.writeAttribute("PumpStatus", QString::number(agilentPumpStatus_));
-    xml.writeAttribute("ErrorCode", QString::number(agilentErrorCode_));
-
-    xml.writeEndElement();
-  }
+  changed |= updateIfChanged<bool>(s.state, agilentModel_->getDeviceState()==READY ? true : false);
+  changed |= updateIfChanged<bool>(s.pumpState, agilentModel_->getPumpState());
+  changed |= updateIfChanged<unsigned int>(s.pumpStatus, agilentModel_->getPumpStatus());
+  changed |= updateIfChanged<unsigned int>(s.errorCode, agilentModel_->getErrorCode());
 
-  if (buffer.length()>0) {
-    emit daqMessage(buffer);
-    emit newDataAvailable();
-  }
+  publish(Thermo2DAQSnapshot::AgilentTwisTorr304Device, s, agilentSnapshot_, changed);
 }
 
 void Thermo2DAQModel::leyboldInfoChanged()
 {
-  if (!daqState_) return;
-
   NQLogDebug("Thermo2DAQModel") << "leyboldInfoChanged()";
 
-  if (thread()==QApplication::instance()->thread()) {
-    NQLogDebug("Thermo2DAQModel") << "running in main application thread";
-  } else {
-    NQLogDebug("Thermo2DAQModel") << "running in dedicated DAQ thread";
-  }
-
-  QMutexLocker locker(&mutex_);
-
-  QDateTime& utime = currentTime();
-
-  QString buffer;
+  Thermo2DAQSnapshot::LeyboldGraphixOne& s = leybold_;
 
   bool changed = false;
-  changed |= updateIfChanged<bool>(leyboldState_, leyboldModel_->getDeviceState()==READY ? true : false);
-  changed |= updateIfChanged<double>(leyboldPressure_, leyboldModel_->getPressure());
+  changed |= updateIfChanged<bool>(s.state, leyboldModel_->getDeviceState()==READY ? true : false);
+  changed |= updateIfChanged<double>(s.pressure, leyboldModel_->getPressure());
 
-  if (changed) {
-    QXmlStreamWriter xml(&buffer);
-    xml.setAutoFormatting(true);
-
-    xml.writeStartElement("LeyboldGraphixOne");
-    xml.writeAttribute("time", utime.toString(Qt::ISODate));
-    xml.writeAttribute("State", leyboldState_==READY ? "1" : "0");
-    xml.writeAttribute("Pressure", QString::number(leyboldPressure_, 'e', 3));
-    xml.writeEndElement();
-
-    xml.writeEndElement();
-  }
-
-  if (buffer.length()>0) {
-    emit daqMessage(buffer);
-    emit newDataAvailable();
-  }
+  publish(Thermo2DAQSnapshot::LeyboldGraphixOneDevice, s, leyboldSnapshot_, changed);
 }
 
 void Thermo2DAQModel::nge103BInfoChanged()
 {
-  if (!daqState_) return;
-
   NQLogDebug("Thermo2DAQModel") << "nge103BInfoChanged()";
 
-  if (thread()==QApplication::instance()->thread()) {
-    NQLogDebug("Thermo2DAQModel") << "running in main application thread";
-  } else {
-    NQLogDebug("Thermo2DAQModel") << "running in dedicated DAQ thread";
-  }
-
-  QMutexLocker locker(&mutex_);
-
-  QDateTime& utime = currentTime();
-
-  QString buffer;
-  QXmlStreamWriter xml(&buffer);
-  xml.setAutoFormatting(true);
-
-  xml.writeStartElement("RohdeSchwarzNGE103B");
-  xml.writeAttribute("time", utime.toString(Qt::ISODate));
+  Thermo2DAQSnapshot::RohdeSchwarzNGE103B& s = nge103B_;
 
+  bool changed = false;
   for (int i=0;i<3;++i) {
-
-    bool changed = false;
-    changed |= updateIfChanged<bool>(nge103BOutputState_[i], nge103BModel_->getOutputState(i+1));
-    changed |= updateIfChanged<unsigned int>(nge103BOutputMode_[i], nge103BModel_->getOutputMode(i+1));
-    changed |= updateIfChanged<float>(nge103BVoltage_[i], nge103BModel_->getVoltage(i+1));
-    changed |= updateIfChanged<float>(nge103BCurrent_[i], nge103BModel_->getCurrent(i+1));
-    changed |= updateIfChanged<float>(nge103BMeasuredVoltage_[i], nge103BModel_->getMeasuredVoltage(i+1));
-    changed |= updateIfChanged<float>(nge103BMeasuredCurrent_[i], nge103BModel_->getMeasuredCurrent(i+1));
-
-    if (changed) {
-      xml.writeStartElement(QString("RohdeSchwarzNGE103BChannel"));
-      xml.writeAttribute("id", QString::number(i+1));
-      xml.writeAttribute("State", nge103BOutputState_[i]==true ? "1" : "0");
-      xml.writeAttribute("Mode", QString::number(nge103BOutputMode_[i]));
-      xml.writeAttribute("U", QString::number(nge103BVoltage_[i], 'f', 3));
-      xml.writeAttribute("mU", QString::number(nge103BMeasuredVoltage_[i], 'f', 3));
-      xml.writeAttribute("I", QString::number(nge103BCurrent_[i], 'f', 3));
-      xml.writeAttribute("mI", QString::number(nge103BMeasuredCurrent_[i], 'f', 3));
-      xml.writeEndElement();
-    }
+    changed |= updateIfChanged<bool>(s.outputState[i], nge103BModel_->getOutputState(i+1));
+    changed |= updateIfChanged<unsigned int>(s.outputMode[i], nge103BModel_->getOutputMode(i+1));
+    changed |= updateIfChanged<float>(s.voltage[i], nge103BModel_->getVoltage(i+1));
+    changed |= updateIfChanged<float>(s.current[i], nge103BModel_->getCurrent(i+1));
+    changed |= updateIfChanged<float>(s.measuredVoltage[i], nge103BModel_->getMeasuredVoltage(i+1));
+    changed |= updateIfChanged<float>(s.measuredCurrent[i], nge103BModel_->getMeasuredCurrent(i+1));
   }
-  xml.writeEndElement();
 
-  if (buffer.length()>0) {
-    emit daqMessage(buffer);
-    emit newDataAvailable();
-  }
+  publish(Thermo2DAQSnapshot::RohdeSchwarzNGE103BDevice, s, nge103BSnapshot_, changed);
 }
 
 void Thermo2DAQModel::keithleyInfoChanged()
 {
-  if (!daqState_) return;
-
   NQLogDebug("Thermo2DAQModel") << "keithleyInfoChanged()";
 
-  if (thread()==QApplication::instance()->thread()) {
-    NQLogDebug("Thermo2DAQModel") << "running in main application thread";
-  } else {
-    NQLogDebug("Thermo2DAQModel") << "running in dedicated DAQ thread";
-  }
-
-  QMutexLocker locker(&mutex_);
-
-  QDateTime& utime = currentTime();
-
-  QString buffer;
-  QXmlStreamWriter xml(&buffer);
-  xml.setAutoFormatting(true);
-
-  xml.writeStartElement("KeithleyDAQ6510");
-  xml.writeAttribute("time", utime.toString(Qt::ISODate));
+  Thermo2DAQSnapshot::KeithleyDAQ6510& s = keithley_;
 
+  bool changed = false;
   for (unsigned int card=0;card<2;++card) {
     for (unsigned int channel=0;channel<10;++channel) {
       unsigned int sensor = (card+1)*100 + channel + 1;
 
-      bool changed = false;
-      changed |= updateIfChanged<bool>(keithleyState_[card][channel], keithleyModel_->getSensorState(sensor)==READY);
-      if (keithleyState_[card][channel]) {
-        changed |= updateIfChanged<float>(keithleyTemperature_[card][channel], keithleyModel_->getTemperature(sensor));
+      changed |= updateIfChanged<bool>(s.state[card][channel], keithleyModel_->getSensorState(sensor)==READY);
+      if (s.state[card][channel]) {
+        changed |= updateIfChanged<float>(s.temperature[card][channel], keithleyModel_->getTemperature(sensor));
       } else {
-        keithleyTemperature_[card][channel] = 0;
-      }
-
-      if (changed) {
-        xml.writeStartElement(QString("KeithleyDAQ6510Sensor"));
-        xml.writeAttribute("id", QString::number(sensor));
-        xml.writeAttribute("State", keithleyState_[card][channel]==true ? "1" : "0");
-        xml.writeAttribute("T", QString::number(keithleyTemperature_[card][channel], 'f', 4));
-        xml.writeEndElement();
+        s.temperature[card][channel] = 0;
       }
     }
-  } 
-  xml.writeEndElement();
-
-  if (buffer.length()>0) {
-    emit daqMessage(buffer);
-    emit newDataAvailable();
   }
+
+  publish(Thermo2DAQSnapshot::KeithleyDAQ6510Device, s, keithleySnapshot_, changed);
 }
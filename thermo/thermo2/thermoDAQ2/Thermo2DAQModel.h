@@ -29,6 +29,8 @@
 #include "RohdeSchwarzNGE103BModel.h"
 #include "KeithleyDAQ6510Model.h"
 
+#include "Thermo2DAQSnapshot.h"
+
 class Thermo2DAQModel : public QObject
 {
   Q_OBJECT
@@ -42,10 +44,21 @@ public:
 		  KeithleyDAQ6510Model* keithleyModel,
 		  QObject *parent = 0);
 
+  /// cached status record of a device, see getStatusRecords()
+  struct StatusRecord {
+    QString name;
+    quint64 version;
+    quint64 changes;
+    qint64 time;
+    QString record;
+  };
+
   QDateTime& currentTime();
 
   void customDAQMessage(const QString & message);
   void createDAQStatusMessage(QString & buffer, bool start=false);
+  void getStatusRecords(QVector<StatusRecord>& records);
+  void createDAQUpdateMessage(int device, QString & buffer);
 
   void myMoveToThread(QThread *thread);
 
@@ -78,8 +91,6 @@ protected:
   RohdeSchwarzNGE103BModel* nge103BModel_;
   KeithleyDAQ6510Model* keithleyModel_;
 
-  QMutex mutex_;
-
   QDateTime currentTime_;
 
   template <typename T> bool updateIfChanged(T &variable, T newValue) {
@@ -88,100 +99,54 @@ protected:
     return true;
   }
 
-  // Huber Unistat 525w Data
-  bool u525wState_;
-  float u525wTemperatureSetPoint_;
-  bool u525wTemperatureControlMode_;
-  bool u525wTemperatureControlEnabled_;
-  bool u525wCirculatorEnabled_;
-  float u525wInternalTemperature_;
-  float u525wProcessTemperature_;
-  float u525wReturnTemperature_;
-  float u525wPumpPressure_;
-  int u525wPower_;
-  float u525wCWInletTemperature_;
-  float u525wCWOutletTemperature_;
-  bool u525AutoPID_;
-  int u525KpInternal_;
-  float u525TnInternal_;
-  float u525TvInternal_;
-  int u525KpJacket_;
-  float u525TnJacket_;
-  float u525TvJacket_;
-  int u525KpProcess_;
-  float u525TnProcess_;
-  float u525TvProcess_;
-
-  // Marta CO2 Chiller Data
-  bool martaState_;
-  float martaPT03_;
-  float martaPT05_;
-  float martaPT01CO2_;
-  float martaPT02CO2_;
-  float martaPT03CO2_;
-  float martaPT04CO2_;
-  float martaPT05CO2_;
-  float martaPT06CO2_;
-  float martaTT02_;
-  float martaTT01CO2_;
-  float martaTT02CO2_;
-  float martaTT03CO2_;
-  float martaTT04CO2_;
-  float martaTT05CO2_;
-  float martaTT06CO2_;
-  float martaTT07CO2_;
-  float martaSH05_;
-  float martaSC01CO2_;
-  float martaSC02CO2_;
-  float martaSC03CO2_;
-  float martaSC05CO2_;
-  float martaSC06CO2_;
-  float martaDP01CO2_;
-  float martaDP02CO2_;
-  float martaDP03CO2_;
-  float martaDP04CO2_;
-  float martaDT02CO2_;
-  float martaDT03CO2_;
-  float martaST01CO2_;
-  float martaST02CO2_;
-  float martaST03CO2_;
-  float martaST04CO2_;
-  float martaFT01CO2_;
-  float martaSpeedSetpoint_;
-  float martaFlowSetpoint_;
-  float martaTemperatureSetpoint_;
-  std::array<uint16_t,4> martaAlarms_;
-  uint16_t martaAlarmStatus_;
-  uint16_t martaStatus_;
-  float martaTemperatureSetpoint2_;
-  float martaSpeedSetpoint2_;
-  float martaFlowSetpoint2_;
-
-  // Agilent TwisTorr 304 Data
-  bool agilentState_;
-  bool agilentPumpState_;
-  unsigned int agilentPumpStatus_;
-  unsigned int agilentErrorCode_;
-
-  // Leybold GraphixOne Data;
-  bool leyboldState_;
-  double leyboldPressure_;
-
-  // Rohde & Schwarz NGE130B Data
-  bool nge103BOutputState_[3];
-  unsigned int nge103BOutputMode_[3];
-  float nge103BVoltage_[3];
-  float nge103BCurrent_[3];
-  float nge103BMeasuredVoltage_[3];
-  float nge103BMeasuredCurrent_[3];
-
-  // Keithley DAQ6510 Data
-  std::array<std::array<bool,10>,2> keithleyState_;
-  std::array<std::array<float,10>,2> keithleyTemperature_;
+  template <typename T> void publish(Thermo2DAQSnapshot::Device device,
+                                     T& snapshot, Thermo2DAQSeqLock<T>& lock,
+                                     bool changed) {
+    snapshot.time = currentTime().toMSecsSinceEpoch();
+    if (changed) snapshot.changes++;
+    lock.write(snapshot);
+
+    if (daqState_) {
+      emit deviceUpdated(device);
+      emit newDataAvailable();
+    }
+  }
+
+  void resetUpdateState();
+
+  // values of the devices as read by the DAQ thread, which is the only
+  // writer of the snapshots
+  Thermo2DAQSnapshot::HuberUnistat525w huber_;
+  Thermo2DAQSnapshot::Marta marta_;
+  Thermo2DAQSnapshot::AgilentTwisTorr304 agilent_;
+  Thermo2DAQSnapshot::LeyboldGraphixOne leybold_;
+  Thermo2DAQSnapshot::RohdeSchwarzNGE103B nge103B_;
+  Thermo2DAQSnapshot::KeithleyDAQ6510 keithley_;
+
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::HuberUnistat525w> huberSnapshot_;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::Marta> martaSnapshot_;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::AgilentTwisTorr304> agilentSnapshot_;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::LeyboldGraphixOne> leyboldSnapshot_;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::RohdeSchwarzNGE103B> nge103BSnapshot_;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::KeithleyDAQ6510> keithleySnapshot_;
+
+  // status records, built by the readers for new snapshot versions
+  QMutex statusMutex_;
+  std::array<StatusRecord,Thermo2DAQSnapshot::DeviceCount> status_;
+
+  template <typename T> void updateStatusRecord(Thermo2DAQSnapshot::Device device,
+                                                const Thermo2DAQSeqLock<T>& lock);
+
+  // what was written to the data file last
+  QMutex updateMutex_;
+  std::array<quint64,Thermo2DAQSnapshot::DeviceCount> writtenChanges_;
+  Thermo2DAQSnapshot::RohdeSchwarzNGE103B writtenNGE103B_;
+  Thermo2DAQSnapshot::KeithleyDAQ6510 writtenKeithley_;
 
 signals:
 
   void daqMessage(const QString & message);
+  void deviceUpdated(int device);
   void daqStateChanged(bool running);
   void newDataAvailable();
 };
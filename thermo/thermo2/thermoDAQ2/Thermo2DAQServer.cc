@@ -16,79 +16,183 @@
 
 #include <nqlogger.h>
 
+#include "ApplicationConfig.h"
+#include "Thermo2DAQProtocol.h"
 #include "Thermo2DAQServer.h"
 
 Thermo2DAQServer::Thermo2DAQServer(Thermo2DAQModel* model, QObject *parent)
   : QTcpServer(parent),
-    model_(model)
+    model_(model),
+    sequence_(0),
+    baseSequence_(0)
 {
+  ApplicationConfig* config = ApplicationConfig::instance();
 
+  session_ = QDateTime::currentMSecsSinceEpoch();
+  historySize_ = config->getDefaultValue<unsigned int>("main", "ServerHistorySize", 36000);
+
+  connect(this, SIGNAL(newConnection()),
+          this, SLOT(clientConnected()));
+
+  timer_ = new QTimer(this);
+  timer_->setInterval(config->getDefaultValue<unsigned int>("main", "ServerUpdateInterval", 100));
+  connect(timer_, SIGNAL(timeout()),
+          this, SLOT(updateStatus()));
+  timer_->start();
 }
 
-#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-void Thermo2DAQServer::incomingConnection(int socketDescriptor)
+QByteArray Thermo2DAQServer::createFrame(int type, quint64 sequence,
+                                         const QDateTime& time, const RecordMap& records) const
 {
-  NQLogDebug("ThermoDAQServer") << "incomingConnection(int socketDescriptor)";
+  QStringList list = records.values();
+
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out.setVersion(Thermo2DAQProtocol::streamVersion);
+  out << (quint8)type << session_ << sequence << time << list.join("\n");
 
-  Thermo2DAQServerThread *thread = new Thermo2DAQServerThread(socketDescriptor, model_, this);
-  connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-  thread->start();
+  return Thermo2DAQProtocol::frame(payload);
 }
-#else
-void Thermo2DAQServer::incomingConnection(qintptr socketDescriptor)
+
+void Thermo2DAQServer::updateStatus()
 {
-  NQLogDebug("ThermoDAQServer") << "incomingConnection(qintptr socketDescriptor)";
+  QVector<Thermo2DAQModel::StatusRecord> records;
+  model_->getStatusRecords(records);
+
+  QDateTime time = time_;
+  RecordMap changes;
+  for (QVector<Thermo2DAQModel::StatusRecord>::const_iterator it = records.constBegin();
+       it != records.constEnd();
+       ++it) {
+    // the same time as in the record, to the second
+    QDateTime recordTime = QDateTime::fromMSecsSinceEpoch(it->time - it->time % 1000);
+    if (!time.isValid() || recordTime>time) time = recordTime;
+
+    QMap<QString,quint64>::iterator itChanges = changes_.find(it->name);
+    if (itChanges==changes_.end() || itChanges.value()!=it->changes) {
+      changes_.insert(it->name, it->changes);
+      records_.insert(it->name, it->record);
+      changes.insert(it->name, it->record);
+    }
+  }
+
+  if (changes.isEmpty() && time==time_) return;
+
+  sequence_++;
+  time_ = time;
+
+  Update update;
+  update.sequence = sequence_;
+  update.time = time_;
+  update.records = changes;
+  update.frame = createFrame(Thermo2DAQProtocol::Update, sequence_, time_, changes);
+
+  history_.push_back(update);
+  while (history_.size()>historySize_) {
+    const Update& oldest = history_.front();
+    for (RecordMap::const_iterator it = oldest.records.constBegin();
+         it != oldest.records.constEnd();
+         ++it) {
+      baseRecords_.insert(it.key(), it.value());
+    }
+    baseSequence_ = oldest.sequence;
+    baseTime_ = oldest.time;
+    history_.pop_front();
+  }
 
-  Thermo2DAQServerThread *thread = new Thermo2DAQServerThread(socketDescriptor, model_, this);
-  connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-  thread->start();
+  // send() may drop subscribers, so iterate over a copy
+  const QSet<QTcpSocket*> subscribers = subscribers_;
+  for (QSet<QTcpSocket*>::const_iterator it = subscribers.constBegin();
+       it != subscribers.constEnd();
+       ++it) {
+    send(*it, history_.back().frame);
+  }
 }
-#endif
-
-#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-Thermo2DAQServerThread::Thermo2DAQServerThread(int socketDescriptor,
-                                               Thermo2DAQModel* model,
-                                               QObject *parent)
-  : QThread(parent),
-    socketDescriptor_(socketDescriptor),
-    model_(model)
+
+void Thermo2DAQServer::clientConnected()
 {
+  while (hasPendingConnections()) {
+    QTcpSocket* socket = nextPendingConnection();
 
+    NQLogDebug("Thermo2DAQServer") << "client connected";
+
+    buffers_.insert(socket, QByteArray());
+    connect(socket, SIGNAL(readyRead()),
+            this, SLOT(clientReadyRead()));
+    connect(socket, SIGNAL(disconnected()),
+            this, SLOT(clientDisconnected()));
+  }
 }
-#else
-Thermo2DAQServerThread::Thermo2DAQServerThread(qintptr socketDescriptor,
-                                               Thermo2DAQModel* model,
-                                               QObject *parent)
-  : QThread(parent),
-    socketDescriptor_(socketDescriptor),
-    model_(model)
-{
 
+void Thermo2DAQServer::clientReadyRead()
+{
+  QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+  if (!socket) return;
+
+  QByteArray& buffer = buffers_[socket];
+  buffer.append(socket->readAll());
+
+  QByteArray payload;
+  while (Thermo2DAQProtocol::takeFrame(buffer, payload)) {
+    QDataStream in(payload);
+    in.setVersion(Thermo2DAQProtocol::streamVersion);
+
+    quint8 type;
+    in >> type;
+
+    if (type==Thermo2DAQProtocol::Subscribe) {
+      quint64 session, lastSequence;
+      in >> session >> lastSequence;
+      subscribe(socket, session, lastSequence);
+    } else {
+      NQLogWarning("Thermo2DAQServer") << "unknown message type " << (int)type;
+    }
+  }
 }
-#endif
 
-void Thermo2DAQServerThread::run()
+void Thermo2DAQServer::clientDisconnected()
 {
-  NQLogDebug("Thermo2DAQServerThread") << "run()";
+  QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+  if (!socket) return;
 
-  QTcpSocket tcpSocket;
-  if (!tcpSocket.setSocketDescriptor(socketDescriptor_)) {
-    NQLogDebug("Thermo2DAQServerThread") << "error setting socket descriptor";
-    emit error(tcpSocket.error());
-    return;
+  NQLogDebug("Thermo2DAQServer") << "client disconnected";
+
+  subscribers_.remove(socket);
+  buffers_.remove(socket);
+  socket->deleteLater();
+}
+
+void Thermo2DAQServer::subscribe(QTcpSocket* socket, quint64 session, quint64 lastSequence)
+{
+  NQLogDebug("Thermo2DAQServer") << "subscribe " << session << " " << lastSequence;
+
+  if (session!=session_ || lastSequence==0 || lastSequence>sequence_) {
+    // new display or a DAQ that was restarted in the meantime
+    send(socket, createFrame(Thermo2DAQProtocol::Snapshot, sequence_, time_, records_));
+  } else {
+    if (lastSequence<baseSequence_) {
+      send(socket, createFrame(Thermo2DAQProtocol::Snapshot, baseSequence_, baseTime_, baseRecords_));
+      lastSequence = baseSequence_;
+    }
+    for (std::deque<Update>::const_iterator it = history_.begin();
+         it != history_.end();
+         ++it) {
+      if (it->sequence>lastSequence) send(socket, it->frame);
+    }
   }
 
-  QString buffer;
-  model_->createDAQStatusMessage(buffer);
+  if (socket->state()==QAbstractSocket::ConnectedState) subscribers_.insert(socket);
+}
 
-  //QByteArray block;
-  //QDataStream out(&block, QIODevice::WriteOnly);
-  //out.setVersion(QDataStream::Qt_4_0);
-  //    out << (quint16)6;
-  //    out.device()->seek(0);
-  //    out << (quint16)(block.size() - sizeof(quint16));
+void Thermo2DAQServer::send(QTcpSocket* socket, const QByteArray& frame)
+{
+  // a display that does not keep up is dropped and catches up on reconnect
+  if (socket->bytesToWrite()>16*1024*1024) {
+    NQLogWarning("Thermo2DAQServer") << "dropping slow subscriber";
+    subscribers_.remove(socket);
+    socket->abort();
+    return;
+  }
 
-  tcpSocket.write(buffer.toStdString().c_str());
-  tcpSocket.disconnectFromHost();
-  tcpSocket.waitForDisconnected();
+  socket->write(frame);
 }
@@ -13,44 +13,26 @@
 #ifndef THERMO2DAQSERVER_H
 #define THERMO2DAQSERVER_H
 
+#include <deque>
+
 #include <QTcpServer>
-#include <QThread>
 #include <QTcpSocket>
+#include <QTimer>
+#include <QMap>
+#include <QSet>
+#include <QDateTime>
 
 #include <Thermo2DAQModel.h>
 
-class Thermo2DAQServerThread : public QThread
-{
-  Q_OBJECT
-
-public:
-#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-  Thermo2DAQServerThread(int socketDescriptor,
-                         Thermo2DAQModel* model,
-                         QObject *parent);
-#else
-  Thermo2DAQServerThread(qintptr socketDescriptor,
-                         Thermo2DAQModel* model,
-                         QObject *parent);
-#endif
-
-  void run();
-
-signals:
-
-  void error(QTcpSocket::SocketError socketError);
-
-private:
-
-#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-  int socketDescriptor_;
-#else
-  qintptr socketDescriptor_;
-#endif
-
-  Thermo2DAQModel* model_;
-};
+/*
+  Pushes the status of the DAQ to subscribed displays.
 
+  The status records of the devices are sampled with a fixed interval.
+  Only records whose values changed are sent, serialised once for all
+  subscribers; the records themselves are cached by the DAQ model. A bounded history of
+  updates is kept so that a display that reconnects can catch up. See
+  Thermo2DAQProtocol.h for the messages.
+*/
 class Thermo2DAQServer : public QTcpServer
 {
   Q_OBJECT
@@ -58,17 +40,47 @@ class Thermo2DAQServer : public QTcpServer
 public:
   Thermo2DAQServer(Thermo2DAQModel* model, QObject *parent = 0);
 
+protected slots:
+
+  void updateStatus();
+  void clientConnected();
+  void clientReadyRead();
+  void clientDisconnected();
+
 protected:
 
-#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-  void incomingConnection(int socketDescriptor);
-#else
-  void incomingConnection(qintptr socketDescriptor);
-#endif
+  typedef QMap<QString,QString> RecordMap;
 
-private:
+  struct Update {
+    quint64 sequence;
+    QDateTime time;
+    RecordMap records;
+    QByteArray frame;
+  };
 
   Thermo2DAQModel* model_;
+  QTimer* timer_;
+
+  quint64 session_;
+  quint64 sequence_;
+  QDateTime time_;
+  RecordMap records_;
+  QMap<QString,quint64> changes_;
+
+  // state before the oldest update in the history
+  quint64 baseSequence_;
+  QDateTime baseTime_;
+  RecordMap baseRecords_;
+  std::deque<Update> history_;
+  size_t historySize_;
+
+  QMap<QTcpSocket*,QByteArray> buffers_;
+  QSet<QTcpSocket*> subscribers_;
+
+  QByteArray createFrame(int type, quint64 sequence,
+                         const QDateTime& time, const RecordMap& records) const;
+  void subscribe(QTcpSocket* socket, quint64 session, quint64 lastSequence);
+  void send(QTcpSocket* socket, const QByteArray& frame);
 };
 
 #endif // THERMO2DAQSERVER_H
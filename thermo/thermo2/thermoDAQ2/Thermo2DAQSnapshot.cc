@@ -0,0 +1,251 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <QDateTime>
+#include <QXmlStreamWriter>
+
+#include "Thermo2DAQSnapshot.h"
+
+namespace {
+
+QString timeString(qint64 time)
+{
+  return QDateTime::fromMSecsSinceEpoch(time).toString(Qt::ISODate);
+}
+
+}
+
+const char* Thermo2DAQSnapshot::name(Device device)
+{
+  switch (device) {
+  case HuberUnistat525wDevice: return "HuberUnistat525w";
+  case MartaDevice: return "Marta";
+  case AgilentTwisTorr304Device: return "AgilentTwisTorr304";
+  case LeyboldGraphixOneDevice: return "LeyboldGraphixOne";
+  case RohdeSchwarzNGE103BDevice: return "RohdeSchwarzNGE103B";
+  case KeithleyDAQ6510Device: return "KeithleyDAQ6510";
+  default: return "";
+  }
+}
+
+void Thermo2DAQSnapshot::write(QXmlStreamWriter& xml, const HuberUnistat525w& s, bool status)
+{
+  xml.writeStartElement("HuberUnistat525w");
+  xml.writeAttribute("time", timeString(s.time));
+  xml.writeAttribute("State", s.state ? "1" : "0");
+
+  xml.writeStartElement("HuberUnistat525wControl");
+  xml.writeAttribute("SetPoint", QString::number(s.temperatureSetPoint, 'f', 2));
+  xml.writeAttribute("ControlMode", QString::number(s.temperatureControlMode));
+  xml.writeAttribute("ControlEnabled", QString::number(s.temperatureControlEnabled));
+  xml.writeAttribute("CirculatorEnabled", QString::number(s.circulatorEnabled));
+  xml.writeEndElement();
+
+  xml.writeStartElement("HuberUnistat525wInfo");
+  xml.writeAttribute("Internal", QString::number(s.internalTemperature, 'f', 2));
+  xml.writeAttribute("Process", QString::number(s.processTemperature, 'f', 2));
+  xml.writeAttribute("Return", QString::number(s.returnTemperature, 'f', 2));
+  xml.writeAttribute("Pressure", QString::number(s.pumpPressure, 'f', 3));
+  xml.writeAttribute("Power", QString::number(s.power));
+  xml.writeAttribute("CWI", QString::number(s.cwInletTemperature, 'f', 2));
+  xml.writeAttribute("CWO", QString::number(s.cwOutletTemperature, 'f', 2));
+  xml.writeEndElement();
+
+  xml.writeStartElement("HuberUnistat525wPID");
+  xml.writeAttribute("AutoPID", s.autoPID ? "1" : "0");
+
+  if (status || (!s.autoPID && !s.temperatureControlMode)) {
+    xml.writeStartElement("HuberUnistat525wPIDInternal");
+    xml.writeAttribute("Kp", QString::number(s.kpInternal));
+    xml.writeAttribute("Tn", QString::number(s.tnInternal, 'f', 1));
+    xml.writeAttribute("Tv", QString::number(s.tvInternal, 'f', 1));
+    xml.writeEndElement();
+  }
+
+  if (status) {
+    xml.writeStartElement("HuberUnistat525wPIDJacket");
+    xml.writeAttribute("Kp", QString::number(s.kpJacket));
+    xml.writeAttribute("Tn", QString::number(s.tnJacket, 'f', 1));
+    xml.writeAttribute("Tv", QString::number(s.tvJacket, 'f', 1));
+    xml.writeEndElement();
+  }
+
+  if (status || (!s.autoPID && s.temperatureControlMode)) {
+    xml.writeStartElement("HuberUnistat525wPIDProcess");
+    xml.writeAttribute("Kp", QString::number(s.kpProcess));
+    xml.writeAttribute("Tn", QString::number(s.tnProcess, 'f', 1));
+    xml.writeAttribute("Tv", QString::number(s.tvProcess, 'f', 1));
+    xml.writeEndElement();
+  }
+
+  xml.writeEndElement();
+
+  xml.writeEndElement();
+}
+
+void Thermo2DAQSnapshot::write(QXmlStreamWriter& xml, const Marta& s)
+{
+  xml.writeStartElement("Marta");
+  xml.writeAttribute("time", timeString(s.time));
+  xml.writeAttribute("State", s.state ? "1" : "0");
+
+  xml.writeStartElement("MartaR507");
+  xml.writeAttribute("PT03", QString::number(s.PT03, 'f', 2));
+  xml.writeAttribute("PT05", QString::number(s.PT05, 'f', 2));
+  xml.writeAttribute("TT02", QString::number(s.TT02, 'f', 2));
+  xml.writeAttribute("SH05", QString::number(s.SH05, 'f', 2));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaPTCO2");
+  xml.writeAttribute("PT01CO2", QString::number(s.PT01CO2, 'f', 2));
+  xml.writeAttribute("PT02CO2", QString::number(s.PT02CO2, 'f', 2));
+  xml.writeAttribute("PT03CO2", QString::number(s.PT03CO2, 'f', 2));
+  xml.writeAttribute("PT04CO2", QString::number(s.PT04CO2, 'f', 2));
+  xml.writeAttribute("PT05CO2", QString::number(s.PT05CO2, 'f', 2));
+  xml.writeAttribute("PT06CO2", QString::number(s.PT06CO2, 'f', 2));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaTTCO2");
+  xml.writeAttribute("TT01CO2", QString::number(s.TT01CO2, 'f', 2));
+  xml.writeAttribute("TT02CO2", QString::number(s.TT02CO2, 'f', 2));
+  xml.writeAttribute("TT03CO2", QString::number(s.TT03CO2, 'f', 2));
+  xml.writeAttribute("TT04CO2", QString::number(s.TT04CO2, 'f', 2));
+  xml.writeAttribute("TT05CO2", QString::number(s.TT05CO2, 'f', 2));
+  xml.writeAttribute("TT06CO2", QString::number(s.TT06CO2, 'f', 2));
+  xml.writeAttribute("TT07CO2", QString::number(s.TT07CO2, 'f', 2));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaSCCO2");
+  xml.writeAttribute("SC01CO2", QString::number(s.SC01CO2, 'f', 2));
+  xml.writeAttribute("SC02CO2", QString::number(s.SC02CO2, 'f', 2));
+  xml.writeAttribute("SC03CO2", QString::number(s.SC03CO2, 'f', 2));
+  xml.writeAttribute("SC05CO2", QString::number(s.SC05CO2, 'f', 2));
+  xml.writeAttribute("SC06CO2", QString::number(s.SC06CO2, 'f', 2));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaDPCO2");
+  xml.writeAttribute("DP01CO2", QString::number(s.DP01CO2, 'f', 2));
+  xml.writeAttribute("DP02CO2", QString::number(s.DP02CO2, 'f', 2));
+  xml.writeAttribute("DP03CO2", QString::number(s.DP03CO2, 'f', 2));
+  xml.writeAttribute("DP04CO2", QString::number(s.DP04CO2, 'f', 2));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaDTCO2");
+  xml.writeAttribute("DT02CO2", QString::number(s.DT02CO2, 'f', 2));
+  xml.writeAttribute("DT03CO2", QString::number(s.DT03CO2, 'f', 2));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaSTCO2");
+  xml.writeAttribute("ST01CO2", QString::number(s.ST01CO2, 'f', 2));
+  xml.writeAttribute("ST02CO2", QString::number(s.ST02CO2, 'f', 2));
+  xml.writeAttribute("ST03CO2", QString::number(s.ST03CO2, 'f', 2));
+  xml.writeAttribute("ST04CO2", QString::number(s.ST04CO2, 'f', 2));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaFlow");
+  xml.writeAttribute("FT01CO2", QString::number(s.FT01CO2, 'f', 3));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaSettings");
+  xml.writeAttribute("Speed", QString::number((int)s.speedSetpoint));
+  xml.writeAttribute("Flow", QString::number(s.flowSetpoint, 'f', 1));
+  xml.writeAttribute("Temperature", QString::number(s.temperatureSetpoint, 'f', 1));
+  xml.writeAttribute("Speed2", QString::number((int)s.speedSetpoint2));
+  xml.writeAttribute("Flow2", QString::number(s.flowSetpoint2, 'f', 1));
+  xml.writeAttribute("Temperature2", QString::number(s.temperatureSetpoint2, 'f', 1));
+  xml.writeAttribute("Status", QString("0x") + QStringLiteral("%1").arg(s.status, 4, 16, QLatin1Char('0')));
+  xml.writeEndElement();
+
+  xml.writeStartElement("MartaAlarms");
+  xml.writeAttribute("Status", QString::number(s.alarmStatus));
+  for (int idx=0;idx<4;++idx) {
+    xml.writeAttribute(QString("Alarm") + QString::number(idx),
+                       QString("0x") + QStringLiteral("%1").arg(s.alarms[idx], 4, 16, QLatin1Char('0')));
+  }
+  xml.writeEndElement();
+
+  xml.writeEndElement();
+}
+
+void Thermo2DAQSnapshot::write(QXmlStreamWriter& xml, const AgilentTwisTorr304& s)
+{
+  xml.writeStartElement("AgilentTwisTorr304");
+  xml.writeAttribute("time", timeString(s.time));
+  xml.writeAttribute("State", s.state ? "1" : "0");
+  xml.writeAttribute("PumpState", s.pumpState ? "1" : "0");
+  xml.writeAttribute("PumpStatus", QString::number(s.pumpStatus));
+  xml.writeAttribute("ErrorCode", QString::number(s.errorCode));
+  xml.writeEndElement();
+}
+
+void Thermo2DAQSnapshot::write(QXmlStreamWriter& xml, const LeyboldGraphixOne& s)
+{
+  xml.writeStartElement("LeyboldGraphixOne");
+  xml.writeAttribute("time", timeString(s.time));
+  xml.writeAttribute("State", s.state ? "1" : "0");
+  xml.writeAttribute("Pressure", QString::number(s.pressure, 'e', 3));
+  xml.writeEndElement();
+}
+
+void Thermo2DAQSnapshot::write(QXmlStreamWriter& xml, const RohdeSchwarzNGE103B& s,
+                               const RohdeSchwarzNGE103B* previous)
+{
+  xml.writeStartElement("RohdeSchwarzNGE103B");
+  xml.writeAttribute("time", timeString(s.time));
+
+  for (int i=0;i<3;++i) {
+    if (previous &&
+        previous->outputState[i]==s.outputState[i] &&
+        previous->outputMode[i]==s.outputMode[i] &&
+        previous->voltage[i]==s.voltage[i] &&
+        previous->current[i]==s.current[i] &&
+        previous->measuredVoltage[i]==s.measuredVoltage[i] &&
+        previous->measuredCurrent[i]==s.measuredCurrent[i]) continue;
+
+    xml.writeStartElement(QString("RohdeSchwarzNGE103BChannel"));
+    xml.writeAttribute("id", QString::number(i+1));
+    xml.writeAttribute("State", s.outputState[i] ? "1" : "0");
+    xml.writeAttribute("Mode", QString::number(s.outputMode[i]));
+    xml.writeAttribute("U", QString::number(s.voltage[i], 'f', 3));
+    xml.writeAttribute("mU", QString::number(s.measuredVoltage[i], 'f', 3));
+    xml.writeAttribute("I", QString::number(s.current[i], 'f', 3));
+    xml.writeAttribute("mI", QString::number(s.measuredCurrent[i], 'f', 3));
+    xml.writeEndElement();
+  }
+
+  xml.writeEndElement();
+}
+
+void Thermo2DAQSnapshot::write(QXmlStreamWriter& xml, const KeithleyDAQ6510& s,
+                               const KeithleyDAQ6510* previous)
+{
+  xml.writeStartElement("KeithleyDAQ6510");
+  xml.writeAttribute("time", timeString(s.time));
+
+  for (unsigned int card=0;card<2;++card) {
+    for (unsigned int channel=0;channel<10;++channel) {
+      if (previous &&
+          previous->state[card][channel]==s.state[card][channel] &&
+          previous->temperature[card][channel]==s.temperature[card][channel]) continue;
+
+      unsigned int sensor = (card+1)*100 + channel + 1;
+
+      xml.writeStartElement(QString("KeithleyDAQ6510Sensor"));
+      xml.writeAttribute("id", QString::number(sensor));
+      xml.writeAttribute("State", s.state[card][channel] ? "1" : "0");
+      xml.writeAttribute("T", QString::number(s.temperature[card][channel], 'f', 4));
+      xml.writeEndElement();
+    }
+  }
+
+  xml.writeEndElement();
+}
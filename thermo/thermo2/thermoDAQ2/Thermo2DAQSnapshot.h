@@ -0,0 +1,218 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#ifndef THERMO2DAQSNAPSHOT_H
+#define THERMO2DAQSNAPSHOT_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include <QtGlobal>
+#include <QThread>
+
+class QXmlStreamWriter;
+
+/*
+  Typed copies of the values of the thermoDAQ2 devices, one struct per
+  device, and the XML writers of the status records and the data file.
+
+  Every snapshot carries the time of the last update in ms since the
+  epoch and the number of updates that changed a value. Updates that
+  only advance the time leave changes as it is.
+*/
+class Thermo2DAQSnapshot
+{
+public:
+
+  enum Device {
+    HuberUnistat525wDevice = 0,
+    MartaDevice,
+    AgilentTwisTorr304Device,
+    LeyboldGraphixOneDevice,
+    RohdeSchwarzNGE103BDevice,
+    KeithleyDAQ6510Device,
+    DeviceCount
+  };
+
+  struct HuberUnistat525w {
+    qint64 time;
+    quint64 changes;
+    bool state;
+    float temperatureSetPoint;
+    bool temperatureControlMode;
+    bool temperatureControlEnabled;
+    bool circulatorEnabled;
+    float internalTemperature;
+    float processTemperature;
+    float returnTemperature;
+    float pumpPressure;
+    int power;
+    float cwInletTemperature;
+    float cwOutletTemperature;
+    bool autoPID;
+    int kpInternal;
+    float tnInternal;
+    float tvInternal;
+    int kpJacket;
+    float tnJacket;
+    float tvJacket;
+    int kpProcess;
+    float tnProcess;
+    float tvProcess;
+  };
+
+  struct Marta {
+    qint64 time;
+    quint64 changes;
+    bool state;
+    float PT03;
+    float PT05;
+    float PT01CO2;
+    float PT02CO2;
+    float PT03CO2;
+    float PT04CO2;
+    float PT05CO2;
+    float PT06CO2;
+    float TT02;
+    float TT01CO2;
+    float TT02CO2;
+    float TT03CO2;
+    float TT04CO2;
+    float TT05CO2;
+    float TT06CO2;
+    float TT07CO2;
+    float SH05;
+    float SC01CO2;
+    float SC02CO2;
+    float SC03CO2;
+    float SC05CO2;
+    float SC06CO2;
+    float DP01CO2;
+    float DP02CO2;
+    float DP03CO2;
+    float DP04CO2;
+    float DT02CO2;
+    float DT03CO2;
+    float ST01CO2;
+    float ST02CO2;
+    float ST03CO2;
+    float ST04CO2;
+    float FT01CO2;
+    float speedSetpoint;
+    float flowSetpoint;
+    float temperatureSetpoint;
+    float speedSetpoint2;
+    float flowSetpoint2;
+    float temperatureSetpoint2;
+    std::array<uint16_t,4> alarms;
+    uint16_t alarmStatus;
+    uint16_t status;
+  };
+
+  struct AgilentTwisTorr304 {
+    qint64 time;
+    quint64 changes;
+    bool state;
+    bool pumpState;
+    unsigned int pumpStatus;
+    unsigned int errorCode;
+  };
+
+  struct LeyboldGraphixOne {
+    qint64 time;
+    quint64 changes;
+    bool state;
+    double pressure;
+  };
+
+  struct RohdeSchwarzNGE103B {
+    qint64 time;
+    quint64 changes;
+    std::array<bool,3> outputState;
+    std::array<unsigned int,3> outputMode;
+    std::array<float,3> voltage;
+    std::array<float,3> current;
+    std::array<float,3> measuredVoltage;
+    std::array<float,3> measuredCurrent;
+  };
+
+  struct KeithleyDAQ6510 {
+    qint64 time;
+    quint64 changes;
+    std::array<std::array<bool,10>,2> state;
+    std::array<std::array<float,10>,2> temperature;
+  };
+
+  static const char* name(Device device);
+
+  // status records have all values of a device; the data file only has
+  // the PID parameters in use and the channels that changed since previous
+  static void write(QXmlStreamWriter& xml, const HuberUnistat525w& s, bool status = true);
+  static void write(QXmlStreamWriter& xml, const Marta& s);
+  static void write(QXmlStreamWriter& xml, const AgilentTwisTorr304& s);
+  static void write(QXmlStreamWriter& xml, const LeyboldGraphixOne& s);
+  static void write(QXmlStreamWriter& xml, const RohdeSchwarzNGE103B& s,
+                    const RohdeSchwarzNGE103B* previous = 0);
+  static void write(QXmlStreamWriter& xml, const KeithleyDAQ6510& s,
+                    const KeithleyDAQ6510* previous = 0);
+};
+
+/*
+  Sequence lock for one snapshot with a single writer.
+
+  The writer never waits: it makes the sequence odd, copies the snapshot
+  and makes it even again. Readers copy the snapshot and retry if the
+  sequence was odd or changed meanwhile, so they never block the writer
+  and never see a half written snapshot. The version is the number of
+  completed writes.
+*/
+template <typename T> class Thermo2DAQSeqLock
+{
+public:
+
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Thermo2DAQSeqLock needs a trivially copyable type");
+
+  Thermo2DAQSeqLock() : sequence_(0), data_() { }
+
+  void write(const T& data) {
+    const quint64 sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    data_ = data;
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  quint64 read(T& data) const {
+    for (;;) {
+      const quint64 before = sequence_.load(std::memory_order_acquire);
+      if (before & 1) {
+        QThread::yieldCurrentThread();
+        continue;
+      }
+      data = data_;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence_.load(std::memory_order_relaxed)==before) return before / 2;
+    }
+  }
+
+  quint64 version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+protected:
+
+  std::atomic<quint64> sequence_;
+  T data_;
+};
+
+#endif // THERMO2DAQSNAPSHOT_H
@@ -27,12 +27,15 @@ Thermo2DAQStreamer::Thermo2DAQStreamer(Thermo2DAQModel* model,
     model_(model),
     isStreaming_(false),
     ofile_(0),
-    stream_(0)
+    stream_(0),
+    writer_(0)
 {
   connect(model_, SIGNAL(daqStateChanged(bool)),
           this, SLOT(daqStateChanged(bool)));
   connect(model_, SIGNAL(daqMessage(QString)),
           this, SLOT(handleDAQMessage(QString)));
+  connect(model_, SIGNAL(deviceUpdated(int)),
+          this, SLOT(handleDeviceUpdate(int)));
 }
 
 void Thermo2DAQStreamer::handleDAQMessage(const QString& message)
@@ -43,11 +46,28 @@ void Thermo2DAQStreamer::handleDAQMessage(const QString& message)
   }
 
   if (isStreaming_ && buffer.length()>0) {
-    *stream_ << buffer << "\n";
-    stream_->flush();
+    if (writer_) {
+      writer_->writeFragment(buffer);
+    } else {
+      *stream_ << buffer << "\n";
+      stream_->flush();
+    }
   }
 }
 
+/**
+  Writes the data of an updated device. The XML is created here, in the
+  thread of the streamer, from the snapshot of the device.
+  */
+void Thermo2DAQStreamer::handleDeviceUpdate(int device)
+{
+  if (!isStreaming_) return;
+
+  QString buffer;
+  model_->createDAQUpdateMessage(device, buffer);
+  handleDAQMessage(buffer);
+}
+
 void Thermo2DAQStreamer::daqStateChanged(bool state)
 {
   if (state==true) {
@@ -56,6 +76,8 @@ void Thermo2DAQStreamer::daqStateChanged(bool state)
     ApplicationConfig* config = ApplicationConfig::instance();
     QString dataPath(config->getValue<std::string>("main", "DataPath").c_str());
     QString dataGroup(config->getValue<std::string>("main", "DataGroup").c_str());
+    QString dataFormat(config->getDefaultValue("main", "DataFormat", std::string("xml")).c_str());
+    bool binary = (dataFormat=="binary");
 
     QString measurementDirPath(dataPath + "/%1");
     currentDir_.setPath(measurementDirPath.arg(dt.toString("yyyyMMdd")));
@@ -77,7 +99,7 @@ void Thermo2DAQStreamer::daqStateChanged(bool state)
       }
     }
 
-    QString filename("%1-%2.xml");
+    QString filename(binary ? "%1-%2.bin" : "%1-%2.xml");
     filename = filename.arg(dt.toString("yyyyMMdd"));
     int i = 1;
     while (currentDir_.exists(filename.arg(i))) ++i;
@@ -100,12 +122,26 @@ void Thermo2DAQStreamer::daqStateChanged(bool state)
           NQLogFatal("ThermoDAQStreamer") << "could not change write permission of output file to 'g+rw'";
         }
       }
-      stream_ = new QTextStream(ofile_);
+      if (binary) {
+        int flushInterval = config->getDefaultValue<int>("main", "DataFlushInterval", 10);
+        QString syncPolicy(config->getDefaultValue("main", "DataSyncPolicy", std::string("flush")).c_str());
+        writer_ = new ThermoDAQ2BinaryWriter(ofile_, flushInterval,
+                                             ThermoDAQ2BinaryWriter::syncPolicyFromString(syncPolicy));
+      } else {
+        stream_ = new QTextStream(ofile_);
+      }
     }
   } else {
-    stream_->device()->close();
-    delete ofile_;
+    if (writer_) {
+      writer_->close();
+      delete writer_;
+      writer_ = 0;
+    }
+    ofile_->close();
     delete stream_;
+    stream_ = 0;
+    delete ofile_;
+    ofile_ = 0;
   }
 
   isStreaming_ = state;
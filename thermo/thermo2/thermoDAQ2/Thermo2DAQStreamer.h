@@ -18,8 +18,14 @@
 #include <QFile>
 #include <QDir>
 
+#include <ThermoDAQ2BinaryStream.h>
+
 #include <Thermo2DAQModel.h>
 
+/**
+  Writes the data files of a measurement. The streamer is moved to a thread
+  of its own and reads the device data from the snapshots of the model.
+  */
 class Thermo2DAQStreamer : public QObject
 {
   Q_OBJECT
@@ -31,6 +37,7 @@ public:
 protected slots:
 
   void handleDAQMessage(const QString& message);
+  void handleDeviceUpdate(int device);
   void daqStateChanged(bool state);
 
 protected:
@@ -40,6 +47,7 @@ protected:
   QString ofilename_;
   QFile* ofile_;
   QTextStream* stream_;
+  ThermoDAQ2BinaryWriter* writer_;
   QDir currentDir_;
 };
 
@@ -50,65 +50,45 @@ Thermo2MainWindow::Thermo2MainWindow(QWidget *parent)
   martaActive_ = config->getValue<int>("main", "MartaActive");
   throughPlaneActive_ = config->getValue<int>("main", "ThroughPlaneSetupActive");
 
-  huberModel_ = 0;
-  if (chillerAndVacuumActive_) {
 #ifdef USE_FAKEIO
-  	huberModel_ = new HuberUnistat525wModel(config->getValue<std::string>("main", "HuberUnistatDevice").c_str(),
-  			5, this);
+  const bool fakeIO = true;
 #else
-  	huberModel_ = new HuberUnistat525wModel(config->getValue<std::string>("main", "HuberUnistatDevice").c_str(),
-  			10, this);
+  const bool fakeIO = false;
 #endif
+
+  // the device models have no parent, they are moved to threads of their
+  // own and owned by the executor below
+  huberModel_ = 0;
+  if (chillerAndVacuumActive_) {
+  	huberModel_ = new HuberUnistat525wModel(config->getValue<std::string>("main", "HuberUnistatDevice").c_str(),
+  			config->getDefaultValue<double>("main", "HuberUnistatUpdateInterval", fakeIO ? 5 : 10), 0);
   }
 
   martaModel_ = 0;
   if (martaActive_) {
-#ifdef USE_FAKEIO
   	martaModel_ = new MartaModel(config->getValue<std::string>("main", "MartaIPAddress").c_str(),
-  			5, this);
-#else
-  	martaModel_ = new MartaModel(config->getValue<std::string>("main", "MartaIPAddress").c_str(),
-  			10, this);
-#endif
+  			config->getDefaultValue<double>("main", "MartaUpdateInterval", fakeIO ? 5 : 10), 0);
   }
 
   agilentModel_ = 0;
   if (chillerAndVacuumActive_) {
-#ifdef USE_FAKEIO
   	agilentModel_ = new AgilentTwisTorr304Model(config->getValue<std::string>("main", "AgilentTwisTorr304Device").c_str(),
-  			5, this);
-#else
-  	agilentModel_ = new AgilentTwisTorr304Model(config->getValue<std::string>("main", "AgilentTwisTorr304Device").c_str(),
-  			20, this);
-#endif
+  			config->getDefaultValue<double>("main", "AgilentTwisTorr304UpdateInterval", fakeIO ? 5 : 20), 0);
   }
 
   leyboldModel_ = 0;
   if (chillerAndVacuumActive_) {
-#ifdef USE_FAKEIO
   	leyboldModel_ = new LeyboldGraphixOneModel(config->getValue<std::string>("main", "LeyboldGraphixOneDevice").c_str(),
-  			5, this);
-#else
-  	leyboldModel_ = new LeyboldGraphixOneModel(config->getValue<std::string>("main", "LeyboldGraphixOneDevice").c_str(),
-  			20, this);
-#endif
+  			config->getDefaultValue<double>("main", "LeyboldGraphixOneUpdateInterval", fakeIO ? 5 : 20), 0);
   }
 
-#ifdef USE_FAKEIO
   nge103BModel_ = new RohdeSchwarzNGE103BModel(config->getValue<std::string>("main", "RohdeSchwarzNGE103BDevice").c_str(),
-                                               5, this);
-#else
-  nge103BModel_ = new RohdeSchwarzNGE103BModel(config->getValue<std::string>("main", "RohdeSchwarzNGE103BDevice").c_str(),
-                                               10, this);
-#endif
+                                               config->getDefaultValue<double>("main", "RohdeSchwarzNGE103BUpdateInterval", fakeIO ? 5 : 10),
+                                               0);
 
-#ifdef USE_FAKEIO
   keithleyModel_ = new KeithleyDAQ6510Model(config->getValue<std::string>("main", "KeithleyDAQ6510Device").c_str(),
-                                            5, this);
-#else
-  keithleyModel_ = new KeithleyDAQ6510Model(config->getValue<std::string>("main", "KeithleyDAQ6510Device").c_str(),
-                                            30, this);
-#endif
+                                            config->getDefaultValue<double>("main", "KeithleyDAQ6510UpdateInterval", fakeIO ? 5 : 30),
+                                            0);
 
   throughPlaneModel_ = 0;
   if (chillerAndVacuumActive_ && throughPlaneActive_) {
@@ -136,7 +116,15 @@ Thermo2MainWindow::Thermo2MainWindow(QWidget *parent)
 					throughPlaneModel_,
 					this);
 
-  daqStreamer_ = new Thermo2DAQStreamer(daqModel_, this);
+  // the streamer writes the data files in a thread of its own, so a slow
+  // disk does not block the GUI; it has no parent and is deleted when its
+  // thread has finished
+  streamerThread_ = new QThread(this);
+  daqStreamer_ = new Thermo2DAQStreamer(daqModel_, 0);
+  daqStreamer_->moveToThread(streamerThread_);
+  connect(streamerThread_, SIGNAL(finished()),
+          daqStreamer_, SLOT(deleteLater()));
+  streamerThread_->start();
 
 //  QString webuser(config->getValue<std::string>("Webuser").c_str());
 //  if (webuser==getenv("USER")) {
@@ -152,6 +140,16 @@ Thermo2MainWindow::Thermo2MainWindow(QWidget *parent)
   daqThread_->start();
   daqModel_->myMoveToThread(daqThread_);
 
+  // a device that is slow to answer only delays its own updates
+  deviceExecutor_ = new DeviceModelExecutor(this);
+  if (huberModel_) deviceExecutor_->addDevice("HuberUnistat525w", huberModel_);
+  if (martaModel_) deviceExecutor_->addDevice("Marta", martaModel_);
+  if (agilentModel_) deviceExecutor_->addDevice("AgilentTwisTorr304", agilentModel_);
+  if (leyboldModel_) deviceExecutor_->addDevice("LeyboldGraphixOne", leyboldModel_);
+  deviceExecutor_->addDevice("RohdeSchwarzNGE103B", nge103BModel_);
+  deviceExecutor_->addDevice("KeithleyDAQ6510", keithleyModel_);
+  deviceExecutor_->setLogInterval(config->getDefaultValue<int>("main", "DevicePollStatisticsInterval", 600));
+
   commServer_ = new Thermo2CommunicationServer(daqModel_,
       huberModel_,
       martaModel_,
@@ -268,6 +266,16 @@ void Thermo2MainWindow::quit()
     daqThread_->quit();
     daqThread_->wait();
   }
+
+  if (streamerThread_) {
+    streamerThread_->quit();
+    streamerThread_->wait();
+  }
+
+  if (deviceExecutor_) {
+    deviceExecutor_->logStatistics();
+    deviceExecutor_->stop();
+  }
 }
 
 void Thermo2MainWindow::controlStateChanged(bool state)
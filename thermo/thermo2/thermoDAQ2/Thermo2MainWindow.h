@@ -14,6 +14,7 @@
 #define THERMO2MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QThread>
 #include <QTabWidget>
 #include <QDir>
 
@@ -39,6 +40,7 @@
 #include "Thermo2ScriptModel.h"
 #include "Thermo2ThroughPlaneModel.h"
 
+#include "DeviceModelExecutor.h"
 #include "ApplicationConfigViewer.h"
 
 class Thermo2MainWindow : public QMainWindow
@@ -78,6 +80,8 @@ protected:
   
   Thermo2DAQModel* daqModel_;
   Thermo2DAQThread* daqThread_;
+  DeviceModelExecutor* deviceExecutor_;
+  QThread* streamerThread_;
   Thermo2DAQStreamer* daqStreamer_;
   Thermo2CommunicationServer* commServer_;
   Thermo2DAQServer* daqServer_;
@@ -0,0 +1,345 @@
+/////////////////////////////////////////////////////////////////////////////////
+//                                                                             //
+//               Copyright (C) 2011-2022 - The DESY CMS Group                  //
+//                           All rights reserved                               //
+//                                                                             //
+//      The CMStkModLab source code is licensed under the GNU GPL v3.0.        //
+//      You have the right to modify and/or redistribute this source code      //
+//      under the terms specified in the license, which may be found online    //
+//      at http://www.gnu.org/licenses or at License.txt.                      //
+//                                                                             //
+/////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <random>
+#include <atomic>
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QThread>
+#include <QMap>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <QRegularExpression>
+
+#include "Thermo2DAQSnapshot.h"
+
+/*
+  Cost of serialising the thermoDAQ2 status.
+
+  legacy: for every tick of the status server the whole status document
+          is written and split into device records again with an XML
+          reader; changes are found by comparing the records without
+          their time attribute, as Thermo2DAQServer did before.
+  cached: a device update publishes its snapshot and the record of that
+          device is written once; a tick only compares versions.
+
+  Afterwards a writer thread publishes Keithley snapshots as fast as it
+  can while the main thread reads them, to check that no torn snapshot
+  is ever read and to measure how long readers take.
+
+  usage: benchThermo2DAQStatus [ticks [updates per tick]]
+ */
+
+typedef QMap<QString,QString> RecordMap;
+
+void splitRecords(const QString& buffer, RecordMap& records)
+{
+  const QString document = "<ThermoDAQ2>" + buffer + "</ThermoDAQ2>";
+  QXmlStreamReader xml(document);
+
+  int depth = 0;
+  qint64 begin = 0;
+  qint64 last = 0;
+  QString name;
+
+  while (!xml.atEnd()) {
+    xml.readNext();
+    if (xml.isStartElement()) {
+      if (depth==1) {
+        begin = last;
+        name = xml.name().toString();
+      }
+      depth++;
+    } else if (xml.isEndElement()) {
+      depth--;
+      if (depth==1) {
+        records.insert(name, document.mid(begin, xml.characterOffset()-begin).trimmed());
+      }
+    }
+    last = xml.characterOffset();
+  }
+}
+
+struct Devices
+{
+  Thermo2DAQSnapshot::HuberUnistat525w huber;
+  Thermo2DAQSnapshot::Marta marta;
+  Thermo2DAQSnapshot::AgilentTwisTorr304 agilent;
+  Thermo2DAQSnapshot::LeyboldGraphixOne leybold;
+  Thermo2DAQSnapshot::RohdeSchwarzNGE103B nge103B;
+  Thermo2DAQSnapshot::KeithleyDAQ6510 keithley;
+};
+
+void writeStatus(QXmlStreamWriter& xml, const Devices& d)
+{
+  Thermo2DAQSnapshot::write(xml, d.huber);
+  Thermo2DAQSnapshot::write(xml, d.marta);
+  Thermo2DAQSnapshot::write(xml, d.agilent);
+  Thermo2DAQSnapshot::write(xml, d.leybold);
+  Thermo2DAQSnapshot::write(xml, d.nge103B);
+  Thermo2DAQSnapshot::write(xml, d.keithley);
+}
+
+// changes the values of one device, like an update of its model
+void update(Devices& d, int device, std::mt19937& generator, qint64 time)
+{
+  std::uniform_real_distribution<float> value(-30., 30.);
+
+  switch (device) {
+  case Thermo2DAQSnapshot::HuberUnistat525wDevice:
+    d.huber.internalTemperature = value(generator);
+    d.huber.processTemperature = value(generator);
+    d.huber.time = time;
+    d.huber.changes++;
+    break;
+  case Thermo2DAQSnapshot::MartaDevice:
+    d.marta.PT01CO2 = value(generator);
+    d.marta.TT01CO2 = value(generator);
+    d.marta.time = time;
+    d.marta.changes++;
+    break;
+  case Thermo2DAQSnapshot::AgilentTwisTorr304Device:
+    d.agilent.pumpStatus++;
+    d.agilent.time = time;
+    d.agilent.changes++;
+    break;
+  case Thermo2DAQSnapshot::LeyboldGraphixOneDevice:
+    d.leybold.pressure = 1.e-3 * value(generator);
+    d.leybold.time = time;
+    d.leybold.changes++;
+    break;
+  case Thermo2DAQSnapshot::RohdeSchwarzNGE103BDevice:
+    for (int i=0;i<3;++i) d.nge103B.measuredCurrent[i] = value(generator);
+    d.nge103B.time = time;
+    d.nge103B.changes++;
+    break;
+  default:
+    for (int c=0;c<2;++c) {
+      for (int i=0;i<10;++i) {
+        d.keithley.state[c][i] = true;
+        d.keithley.temperature[c][i] = value(generator);
+      }
+    }
+    d.keithley.time = time;
+    d.keithley.changes++;
+    break;
+  }
+}
+
+template <typename T> bool rebuild(const Thermo2DAQSeqLock<T>& lock, quint64& version, QString& record)
+{
+  if (lock.version()==version) return false;
+
+  T snapshot;
+  version = lock.read(snapshot);
+
+  QString buffer;
+  {
+    QXmlStreamWriter xml(&buffer);
+    xml.setAutoFormatting(true);
+    Thermo2DAQSnapshot::write(xml, snapshot);
+  }
+  record = buffer.trimmed();
+
+  return true;
+}
+
+class KeithleyWriter : public QThread
+{
+public:
+  KeithleyWriter(Thermo2DAQSeqLock<Thermo2DAQSnapshot::KeithleyDAQ6510>* lock)
+    : lock_(lock), stop_(false), writes_(0) { }
+  void run() {
+    Thermo2DAQSnapshot::KeithleyDAQ6510 s = Thermo2DAQSnapshot::KeithleyDAQ6510();
+    while (!stop_.load()) {
+      ++writes_;
+      s.changes = writes_;
+      for (int c=0;c<2;++c) {
+        for (int i=0;i<10;++i) s.temperature[c][i] = writes_;
+      }
+      lock_->write(s);
+    }
+  }
+  void stop() { stop_.store(true); }
+  quint64 writes() const { return writes_; }
+protected:
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::KeithleyDAQ6510>* lock_;
+  std::atomic<bool> stop_;
+  quint64 writes_;
+};
+
+int main(int argc, char ** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  const int nTicks = argc>=2 ? std::atoi(argv[1]) : 2000;
+  const int nUpdates = argc>=3 ? std::atoi(argv[2]) : 1;
+
+  std::mt19937 generator(4711);
+  const qint64 time = QDateTime::currentMSecsSinceEpoch();
+
+  Devices devices = Devices();
+  for (int device=0;device<Thermo2DAQSnapshot::DeviceCount;++device) {
+    update(devices, device, generator, time);
+  }
+
+  QElapsedTimer timer;
+
+  // legacy
+  static const QRegularExpression timeAttribute(" time=\"([^\"]*)\"");
+  RecordMap keys;
+  int legacyChanges = 0;
+  Devices legacyDevices = devices;
+  std::mt19937 legacyGenerator(4712);
+  int device = 0;
+
+  timer.start();
+  for (int tick=0;tick<nTicks;++tick) {
+    for (int i=0;i<nUpdates;++i) {
+      update(legacyDevices, device, legacyGenerator, time + 1000 * tick);
+      device = (device + 1) % Thermo2DAQSnapshot::DeviceCount;
+    }
+
+    QString buffer;
+    {
+      QXmlStreamWriter xml(&buffer);
+      xml.setAutoFormatting(true);
+      writeStatus(xml, legacyDevices);
+    }
+
+    RecordMap records;
+    splitRecords(buffer, records);
+
+    for (RecordMap::const_iterator it = records.constBegin(); it != records.constEnd(); ++it) {
+      QString key = it.value();
+      key.remove(timeAttribute);
+      RecordMap::iterator itKey = keys.find(it.key());
+      if (itKey==keys.end() || itKey.value()!=key) {
+        keys.insert(it.key(), key);
+        ++legacyChanges;
+      }
+    }
+  }
+  const double legacyNanoseconds = timer.nsecsElapsed();
+
+  // cached
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::HuberUnistat525w> huberLock;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::Marta> martaLock;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::AgilentTwisTorr304> agilentLock;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::LeyboldGraphixOne> leyboldLock;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::RohdeSchwarzNGE103B> nge103BLock;
+  Thermo2DAQSeqLock<Thermo2DAQSnapshot::KeithleyDAQ6510> keithleyLock;
+
+  huberLock.write(devices.huber);
+  martaLock.write(devices.marta);
+  agilentLock.write(devices.agilent);
+  leyboldLock.write(devices.leybold);
+  nge103BLock.write(devices.nge103B);
+  keithleyLock.write(devices.keithley);
+
+  quint64 versions[Thermo2DAQSnapshot::DeviceCount] = { 0, 0, 0, 0, 0, 0 };
+  quint64 versionsSent[Thermo2DAQSnapshot::DeviceCount] = { 0, 0, 0, 0, 0, 0 };
+  QString status[Thermo2DAQSnapshot::DeviceCount];
+  int cachedChanges = 0;
+  int rebuilds = 0;
+  Devices cachedDevices = devices;
+  std::mt19937 cachedGenerator(4712);
+  device = 0;
+
+  qint64 publishNanoseconds = 0;
+  QElapsedTimer publishTimer;
+
+  timer.start();
+  for (int tick=0;tick<nTicks;++tick) {
+    for (int i=0;i<nUpdates;++i) {
+      update(cachedDevices, device, cachedGenerator, time + 1000 * tick);
+      publishTimer.start();
+      switch (device) {
+      case 0: huberLock.write(cachedDevices.huber); break;
+      case 1: martaLock.write(cachedDevices.marta); break;
+      case 2: agilentLock.write(cachedDevices.agilent); break;
+      case 3: leyboldLock.write(cachedDevices.leybold); break;
+      case 4: nge103BLock.write(cachedDevices.nge103B); break;
+      default: keithleyLock.write(cachedDevices.keithley); break;
+      }
+      publishNanoseconds += publishTimer.nsecsElapsed();
+      device = (device + 1) % Thermo2DAQSnapshot::DeviceCount;
+    }
+
+    rebuilds += rebuild(huberLock, versions[0], status[0]);
+    rebuilds += rebuild(martaLock, versions[1], status[1]);
+    rebuilds += rebuild(agilentLock, versions[2], status[2]);
+    rebuilds += rebuild(leyboldLock, versions[3], status[3]);
+    rebuilds += rebuild(nge103BLock, versions[4], status[4]);
+    rebuilds += rebuild(keithleyLock, versions[5], status[5]);
+
+    for (int d=0;d<Thermo2DAQSnapshot::DeviceCount;++d) {
+      if (versionsSent[d]!=versions[d]) {
+        versionsSent[d] = versions[d];
+        ++cachedChanges;
+      }
+    }
+  }
+  const double cachedNanoseconds = timer.nsecsElapsed();
+
+  // readers against a writer
+  KeithleyWriter writer(&keithleyLock);
+  writer.start();
+
+  int reads = 0;
+  int torn = 0;
+  qint64 maxReadNanoseconds = 0;
+  QElapsedTimer readTimer;
+  timer.start();
+  while (timer.elapsed()<1000) {
+    Thermo2DAQSnapshot::KeithleyDAQ6510 s;
+    readTimer.start();
+    keithleyLock.read(s);
+    maxReadNanoseconds = std::max(maxReadNanoseconds, readTimer.nsecsElapsed());
+    ++reads;
+
+    for (int c=0;c<2;++c) {
+      for (int i=0;i<10;++i) {
+        if (s.temperature[c][i]!=s.temperature[0][0]) {
+          ++torn;
+          c = 2;
+          break;
+        }
+      }
+    }
+  }
+  writer.stop();
+  writer.wait();
+
+  const int nDeviceUpdates = nTicks * nUpdates;
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "ticks:                " << nTicks << " with " << nUpdates << " device update(s) each" << std::endl;
+  std::cout << "legacy per tick:      " << 1.e-3 * legacyNanoseconds / nTicks << " us"
+            << " (" << 1.e-3 * legacyNanoseconds / nDeviceUpdates << " us per update, "
+            << legacyChanges << " records changed)" << std::endl;
+  std::cout << "cached per tick:      " << 1.e-3 * cachedNanoseconds / nTicks << " us"
+            << " (" << 1.e-3 * cachedNanoseconds / nDeviceUpdates << " us per update, "
+            << rebuilds << " records written)" << std::endl;
+  std::cout << "publish per update:   " << 1.e-3 * publishNanoseconds / nDeviceUpdates << " us" << std::endl;
+  std::cout << "speedup:              " << legacyNanoseconds / cachedNanoseconds << std::endl;
+  std::cout << "writer vs. readers:   " << writer.writes() << " writes, " << reads << " reads, "
+            << torn << " torn, longest read " << 1.e-3 * maxReadNanoseconds << " us" << std::endl;
+
+  return torn==0 && legacyChanges==cachedChanges ? 0 : 1;
+}
@@ -13,39 +13,105 @@
 #include <iostream>
 
 #include <QtNetwork>
+#include <QTimer>
 
 #include <nqlogger.h>
 
+#include "Thermo2DAQProtocol.h"
 #include "ThermoDAQ2Client.h"
 
 ThermoDAQ2Client::ThermoDAQ2Client(int socket, QObject *parent)
   : QObject(parent),
-    socket_(socket)
+    socket_(socket),
+    subscribed_(false),
+    reconnectPending_(false),
+    session_(0),
+    sequence_(0)
 {
   tcpSocket_ = new QTcpSocket(this);
+  connect(tcpSocket_, SIGNAL(connected()), this, SLOT(connected()));
+  connect(tcpSocket_, SIGNAL(disconnected()), this, SLOT(disconnected()));
+  connect(tcpSocket_, SIGNAL(error(QAbstractSocket::SocketError)),
+          this, SLOT(socketError(QAbstractSocket::SocketError)));
   connect(tcpSocket_, SIGNAL(readyRead()), this, SLOT(read()));
 }
 
-void ThermoDAQ2Client::readDAQStatus()
+void ThermoDAQ2Client::subscribe()
 {
-  NQLogDebug("ThermoDAQ2Client") << "readDAQStatus()";
+  NQLogDebug("ThermoDAQ2Client") << "subscribe()";
 
-  blockSize_ = 0;
-  tcpSocket_->connectToHost(QHostAddress::LocalHost, socket_);
-  if (!tcpSocket_->waitForConnected(2000)) {
-    tcpSocket_->abort();
-    NQLogFatal("ThermoDAQClient") << "connection timeout";
+  subscribed_ = true;
+  if (tcpSocket_->state()==QAbstractSocket::UnconnectedState) {
+    tcpSocket_->connectToHost(QHostAddress::LocalHost, socket_);
   }
 }
 
-void ThermoDAQ2Client::read()
+void ThermoDAQ2Client::connected()
 {
-  NQLogDebug("ThermoDAQ2Client") << "read()";
+  NQLogDebug("ThermoDAQ2Client") << "connected()";
+
+  buffer_.clear();
 
-  QByteArray in = tcpSocket_->readAll();
-  QString buffer(in.data());
+  QByteArray payload;
+  QDataStream out(&payload, QIODevice::WriteOnly);
+  out.setVersion(Thermo2DAQProtocol::streamVersion);
+  out << (quint8)Thermo2DAQProtocol::Subscribe << session_ << sequence_;
+
+  tcpSocket_->write(Thermo2DAQProtocol::frame(payload));
+}
 
+void ThermoDAQ2Client::disconnected()
+{
+  NQLogDebug("ThermoDAQ2Client") << "disconnected()";
+
+  if (subscribed_ && !reconnectPending_) {
+    reconnectPending_ = true;
+    QTimer::singleShot(2000, this, SLOT(reconnect()));
+  }
+}
+
+void ThermoDAQ2Client::socketError(QAbstractSocket::SocketError error)
+{
+  NQLogWarning("ThermoDAQ2Client") << "connection error " << (int)error;
+
+  if (subscribed_ && !reconnectPending_) {
+    reconnectPending_ = true;
+    QTimer::singleShot(2000, this, SLOT(reconnect()));
+  }
+}
+
+void ThermoDAQ2Client::reconnect()
+{
+  reconnectPending_ = false;
   tcpSocket_->abort();
+  subscribe();
+}
+
+void ThermoDAQ2Client::read()
+{
+  NQLogSpam("ThermoDAQ2Client") << "read()";
 
-  emit handleMessage(buffer);
+  buffer_.append(tcpSocket_->readAll());
+
+  QByteArray payload;
+  while (Thermo2DAQProtocol::takeFrame(buffer_, payload)) {
+    QDataStream in(payload);
+    in.setVersion(Thermo2DAQProtocol::streamVersion);
+
+    quint8 type;
+    quint64 session, sequence;
+    QDateTime time;
+    QString records;
+    in >> type >> session >> sequence >> time >> records;
+
+    if (type!=Thermo2DAQProtocol::Snapshot && type!=Thermo2DAQProtocol::Update) {
+      NQLogWarning("ThermoDAQ2Client") << "unknown message type " << (int)type;
+      continue;
+    }
+
+    session_ = session;
+    sequence_ = sequence;
+
+    emit handleMessage(time, records);
+  }
 }
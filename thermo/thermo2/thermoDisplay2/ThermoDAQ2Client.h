@@ -17,27 +17,40 @@
 #include <QDateTime>
 #include <QTcpSocket>
 
+/*
+  Keeps a subscription to the thermoDAQ2 server open and reconnects when
+  the connection is lost. After a reconnect the updates missed in the
+  meantime are requested from the server.
+*/
 class ThermoDAQ2Client : public QObject
 {
   Q_OBJECT
 public:
 
   explicit ThermoDAQ2Client(int sock, QObject *parent=0);
-  void readDAQStatus();
+  void subscribe();
 
 protected slots:
 
+  void connected();
+  void disconnected();
+  void socketError(QAbstractSocket::SocketError error);
+  void reconnect();
   void read();
 
 signals:
 
-  void handleMessage(QString&);
+  void handleMessage(const QDateTime&, QString&);
 
 protected:
 
   int socket_;
   QTcpSocket *tcpSocket_;
-  quint16 blockSize_;
+  QByteArray buffer_;
+  bool subscribed_;
+  bool reconnectPending_;
+  quint64 session_;
+  quint64 sequence_;
 };
 
 #endif // THERMODAQ2CLIENT_H
@@ -45,6 +45,15 @@ void ThermoDAQ2NetworkReader::run(QString& buffer)
   emit finished();
 }
 
+void ThermoDAQ2NetworkReader::run(const QDateTime& time, QString& buffer)
+{
+  // devices that did not change are not part of the update, but the
+  // measurement time applies to all of them
+  measurement_.dt = time;
+  process(buffer);
+  emit finished();
+}
+
 void ThermoDAQ2NetworkReader::processHuberUnistat525w(QXmlStreamReader& xml)
 {
   // NQLogDebug("ThermoDAQ2NetworkReader") << "processHuberUnistat525w(QXmlStreamReader& xml)";
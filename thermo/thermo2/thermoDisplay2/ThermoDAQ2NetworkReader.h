@@ -105,6 +105,7 @@ public:
 
 public slots:
   void run(QString& buffer);
+  void run(const QDateTime& time, QString& buffer);
 
 signals:
   void finished();
@@ -12,6 +12,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 #include <QFont>
 #include <QFontMetrics>
@@ -40,6 +41,9 @@ ThermoDisplay2Chart::ThermoDisplay2Chart()
   connect(axisX_, SIGNAL(axisModeChanged()),
           this, SLOT(refreshXAxis()));
 
+  connect(axisX_, SIGNAL(rangeChanged(QDateTime,QDateTime)),
+          this, SLOT(decimateSeries()));
+
   connect(this, SIGNAL(plotAreaChanged(const QRectF)),
           this, SLOT(areaChanged(const QRectF)));
 }
@@ -149,6 +153,19 @@ void ThermoDisplay2Chart::refreshXAxis()
   axisX_->refresh(series());
 }
 
+void ThermoDisplay2Chart::decimateSeries()
+{
+  const qreal minX = axisX_->min().toMSecsSinceEpoch();
+  const qreal maxX = axisX_->max().toMSecsSinceEpoch();
+  const int pixels = std::max(1, (int)std::ceil(plotArea().width()));
+
+  auto ss = series();
+  for (QAbstractSeries *s : ss) {
+    ThermoDisplay2LineSeries *ls = qobject_cast<ThermoDisplay2LineSeries*>(s);
+    if (ls) ls->setViewRange(minX, maxX, pixels);
+  }
+}
+
 void ThermoDisplay2Chart::xAxisDoubleClicked()
 {
   axisX_->configure();
@@ -159,6 +176,8 @@ void ThermoDisplay2Chart::areaChanged(const QRectF & plotRect)
   if (plotRect.width()<40) return;
   if (plotRect.height()<40) return;
 
+  decimateSeries();
+
   qreal maxWidth = 0;
   qreal maxHeight = 0;
 
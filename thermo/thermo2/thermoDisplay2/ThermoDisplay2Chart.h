@@ -50,6 +50,7 @@ public slots:
   virtual void rightYAxisDoubleClicked() { }
   void xAxisDoubleClicked();
   void refreshXAxis();
+  void decimateSeries();
   void areaChanged(const QRectF &);
 
 protected:
@@ -12,11 +12,14 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 #include <QtNetwork>
 
 #include <nqlogger.h>
 
+#include "ApplicationConfig.h"
+
 #include "ThermoDisplay2LineSeries.h"
 
 ThermoDisplay2LineSeries::ThermoDisplay2LineSeries()
@@ -25,9 +28,16 @@ ThermoDisplay2LineSeries::ThermoDisplay2LineSeries()
     enabled_(false),
     minX_(0), maxX_(0),
     minY_(0), maxY_(0),
-    lastX_(0), lastY_(0)
+    lastX_(0), lastY_(0),
+    yRangeDirty_(false),
+    head_(0),
+    hasView_(false),
+    viewMinX_(0), viewMaxX_(0),
+    viewPixels_(0),
+    hasLeftEdge_(false), hasRightEdge_(false)
 {
-
+  ApplicationConfig* config = ApplicationConfig::instance();
+  capacity_ = std::max(2, config->getDefaultValue<int>("main", "DisplaySeriesCapacity", 100000));
 }
 
 void ThermoDisplay2LineSeries::setEnabled(bool enabled)
@@ -40,12 +50,31 @@ void ThermoDisplay2LineSeries::setEnabled(bool enabled)
   enabled_ = enabled;
  }
 
+void ThermoDisplay2LineSeries::clear()
+{
+  store_.clear();
+  head_ = 0;
+  buckets_.clear();
+  hasLeftEdge_ = false;
+  hasRightEdge_ = false;
+  yRangeDirty_ = false;
+
+  QLineSeries::clear();
+}
+
 void ThermoDisplay2LineSeries::append(qreal x, qreal y)
 {
   if (!enabled_) return;
 
   if (lastX_==x && lastY_==y) return;
 
+  // the ring buffer is ordered in x; a point from the past can only come
+  // from a clock change on the DAQ side and is dropped
+  if (!store_.isEmpty() && x<at(store_.size()-1).x()) {
+    NQLogDebug("ThermoDisplay2LineSeries") << "append(" << x << ", " << y << ") out of order";
+    return;
+  }
+
   if (!initialized_) {
     minX_ = std::numeric_limits<qreal>::max();
     maxX_ = -std::numeric_limits<qreal>::max();
@@ -54,14 +83,230 @@ void ThermoDisplay2LineSeries::append(qreal x, qreal y)
     initialized_ = true;
   }
 
-  minX_ = std::min(minX_, x);
-  maxX_ = std::max(maxX_, x);
+  lastX_ = x;
+  lastY_ = y;
+
+  QPointF p(x, y);
+
+  bool evicted = false;
+  QPointF old;
+  if (store_.size()<capacity_) {
+    store_.append(p);
+  } else {
+    old = store_[head_];
+    store_[head_] = p;
+    head_ = (head_ + 1) % store_.size();
+    evicted = true;
+
+    if (old.y()<=minY_ || old.y()>=maxY_) yRangeDirty_ = true;
+  }
+
+  minX_ = at(0).x();
+  maxX_ = x;
 
   minY_ = std::min(minY_, y);
   maxY_ = std::max(maxY_, y);
 
-  lastX_ = x;
-  lastY_ = y;
+  if (!hasView_) return;
+
+  bool republish = false;
+
+  if (evicted) {
+    if (old.x()<viewMinX_) {
+      // the oldest point can only be the left edge if it was the last one before the view
+      if (hasLeftEdge_ && at(0).x()>=viewMinX_) {
+        hasLeftEdge_ = false;
+        republish = true;
+      }
+    } else if (old.x()<=viewMaxX_) {
+      if (!buckets_.isEmpty()) {
+        if (!fillBucket(buckets_.first().index, buckets_.first())) buckets_.removeFirst();
+        republish = true;
+      }
+    } else {
+      // the whole view has been pushed out of the ring buffer
+      decimate();
+      return;
+    }
+  }
+
+  if (x>viewMaxX_) {
+    if (!hasRightEdge_) {
+      rightEdge_ = p;
+      hasRightEdge_ = true;
+      if (!republish) QLineSeries::append(p);
+    }
+  } else if (x<viewMinX_) {
+    leftEdge_ = p;
+    hasLeftEdge_ = true;
+    republish = true;
+  } else if (!republish) {
+    const int index = bucketIndex(x);
+    QVector<QPointF> points;
+    if (!buckets_.isEmpty() && buckets_.last().index==index) {
+      Bucket& bucket = buckets_.last();
+      const int count = bucketPoints(bucket, points);
+      points.clear();
+      addToBucket(bucket, p);
+      bucketPoints(bucket, points);
+      QLineSeries::removePoints(QLineSeries::count()-count, count);
+    } else {
+      Bucket bucket;
+      bucket.index = index;
+      bucket.first = bucket.min = bucket.max = bucket.last = p;
+      buckets_.append(bucket);
+      points.append(p);
+    }
+    QLineSeries::append(points.toList());
+  } else {
+    const int index = bucketIndex(x);
+    if (!buckets_.isEmpty() && buckets_.last().index==index) {
+      addToBucket(buckets_.last(), p);
+    } else {
+      Bucket bucket;
+      bucket.index = index;
+      bucket.first = bucket.min = bucket.max = bucket.last = p;
+      buckets_.append(bucket);
+    }
+  }
+
+  if (republish) publish();
+}
+
+void ThermoDisplay2LineSeries::setViewRange(qreal minX, qreal maxX, int pixels)
+{
+  if (maxX<=minX || pixels<1) return;
+
+  if (hasView_ && viewMinX_==minX && viewMaxX_==maxX && viewPixels_==pixels) return;
+
+  hasView_ = true;
+  viewMinX_ = minX;
+  viewMaxX_ = maxX;
+  viewPixels_ = pixels;
+
+  decimate();
+}
+
+int ThermoDisplay2LineSeries::lowerBound(qreal x) const
+{
+  int first = 0;
+  int count = store_.size();
+  while (count>0) {
+    int step = count / 2;
+    if (at(first + step).x()<x) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+int ThermoDisplay2LineSeries::bucketIndex(qreal x) const
+{
+  int index = std::floor((x - viewMinX_) * viewPixels_ / (viewMaxX_ - viewMinX_));
+  return std::min(std::max(index, 0), viewPixels_ - 1);
+}
+
+bool ThermoDisplay2LineSeries::fillBucket(int index, Bucket& bucket) const
+{
+  bool filled = false;
+  for (int i=lowerBound(viewMinX_);i<store_.size();++i) {
+    const QPointF& p = at(i);
+    if (p.x()>viewMaxX_) break;
+    const int pi = bucketIndex(p.x());
+    if (pi<index) continue;
+    if (pi>index) break;
+    if (!filled) {
+      bucket.index = index;
+      bucket.first = bucket.min = bucket.max = bucket.last = p;
+      filled = true;
+    } else {
+      addToBucket(bucket, p);
+    }
+  }
+  return filled;
+}
+
+void ThermoDisplay2LineSeries::addToBucket(Bucket& bucket, const QPointF& p)
+{
+  if (p.y()<bucket.min.y()) bucket.min = p;
+  if (p.y()>bucket.max.y()) bucket.max = p;
+  bucket.last = p;
+}
+
+int ThermoDisplay2LineSeries::bucketPoints(const Bucket& bucket, QVector<QPointF>& points)
+{
+  const int size = points.size();
+
+  points.append(bucket.first);
+
+  const QPointF& p1 = (bucket.min.x()<=bucket.max.x()) ? bucket.min : bucket.max;
+  const QPointF& p2 = (bucket.min.x()<=bucket.max.x()) ? bucket.max : bucket.min;
+  if (p1!=points.last()) points.append(p1);
+  if (p2!=points.last()) points.append(p2);
+  if (bucket.last!=points.last()) points.append(bucket.last);
+
+  return points.size() - size;
+}
+
+void ThermoDisplay2LineSeries::updateYRange()
+{
+  if (!yRangeDirty_) return;
+
+  minY_ = std::numeric_limits<qreal>::max();
+  maxY_ = -std::numeric_limits<qreal>::max();
+  for (const QPointF& p : store_) {
+    minY_ = std::min(minY_, p.y());
+    maxY_ = std::max(maxY_, p.y());
+  }
+
+  yRangeDirty_ = false;
+}
+
+void ThermoDisplay2LineSeries::decimate()
+{
+  buckets_.clear();
+  hasLeftEdge_ = false;
+  hasRightEdge_ = false;
+
+  int i = lowerBound(viewMinX_);
+  if (i>0) {
+    leftEdge_ = at(i-1);
+    hasLeftEdge_ = true;
+  }
+
+  for (;i<store_.size();++i) {
+    const QPointF& p = at(i);
+    if (p.x()>viewMaxX_) {
+      rightEdge_ = p;
+      hasRightEdge_ = true;
+      break;
+    }
+
+    const int index = bucketIndex(p.x());
+    if (!buckets_.isEmpty() && buckets_.last().index==index) {
+      addToBucket(buckets_.last(), p);
+    } else {
+      Bucket bucket;
+      bucket.index = index;
+      bucket.first = bucket.min = bucket.max = bucket.last = p;
+      buckets_.append(bucket);
+    }
+  }
+
+  publish();
+}
+
+void ThermoDisplay2LineSeries::publish()
+{
+  QVector<QPointF> points;
+  points.reserve(4 * buckets_.size() + 2);
+
+  if (hasLeftEdge_) points.append(leftEdge_);
+  for (const Bucket& bucket : buckets_) bucketPoints(bucket, points);
+  if (hasRightEdge_) points.append(rightEdge_);
 
-  QLineSeries::append(x, y);
+  QLineSeries::replace(points);
 }
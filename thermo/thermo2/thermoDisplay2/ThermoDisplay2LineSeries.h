@@ -14,6 +14,8 @@
 #define THERMODISPLAY2LINESERIES_H
 
 #include <QObject>
+#include <QVector>
+#include <QPointF>
 #include <QtCharts/QChart>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QDateTimeAxis>
@@ -21,6 +23,15 @@
 
 QT_CHARTS_USE_NAMESPACE
 
+/*
+  Line series that keeps the full resolution data in a ring buffer of
+  DisplaySeriesCapacity points and only hands a decimated view of it to
+  QtCharts. For the current x range of the chart every pixel column keeps
+  the first, minimum, maximum and last point that falls into it, so that
+  spikes stay visible however many points are stored. The view is
+  rebuilt from the ring buffer by setViewRange whenever the x axis or the
+  plot area changes and updated incrementally for new points.
+*/
 class ThermoDisplay2LineSeries : public QLineSeries
 {
   Q_OBJECT
@@ -35,11 +46,16 @@ public:
   void setEnabled(bool enabled);
 
   void append(qreal x, qreal y);
+  void clear();
+
+  void setViewRange(qreal minX, qreal maxX, int pixels);
 
   qreal minX() { return minX_; }
   qreal maxX() { return maxX_; }
-  qreal minY() { return minY_; }
-  qreal maxY() { return maxY_; }
+  qreal minY() { updateYRange(); return minY_; }
+  qreal maxY() { updateYRange(); return maxY_; }
+
+  int storedPoints() const { return store_.size(); }
 
 protected slots:
 
@@ -47,11 +63,39 @@ signals:
 
 protected:
 
+  typedef struct {
+    int index;
+    QPointF first, min, max, last;
+  } Bucket;
+
   bool initialized_;
   bool enabled_;
   qreal minX_, maxX_;
   qreal minY_, maxY_;
   qreal lastX_, lastY_;
+  bool yRangeDirty_;
+
+  int capacity_;
+  QVector<QPointF> store_;
+  int head_;
+
+  bool hasView_;
+  qreal viewMinX_, viewMaxX_;
+  int viewPixels_;
+  QVector<Bucket> buckets_;
+  bool hasLeftEdge_, hasRightEdge_;
+  QPointF leftEdge_, rightEdge_;
+
+  const QPointF& at(int i) const { return store_[(head_ + i) % store_.size()]; }
+  int lowerBound(qreal x) const;
+  int bucketIndex(qreal x) const;
+  bool fillBucket(int index, Bucket& bucket) const;
+  static void addToBucket(Bucket& bucket, const QPointF& p);
+  static int bucketPoints(const Bucket& bucket, QVector<QPointF>& points);
+
+  void updateYRange();
+  void decimate();
+  void publish();
 };
 
 #endif // THERMODISPLAY2LINESERIES_H
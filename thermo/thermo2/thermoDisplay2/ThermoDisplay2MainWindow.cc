@@ -475,8 +475,8 @@ ThermoDisplay2MainWindow::ThermoDisplay2MainWindow(QWidget *parent)
   client_ = new ThermoDAQ2Client(config->getValue<unsigned int>("main", "ServerPort"));
   reader_ = new ThermoDAQ2NetworkReader(this);
 
-  QObject::connect(client_, SIGNAL(handleMessage(QString&)),
-                   reader_, SLOT(run(QString&)));
+  QObject::connect(client_, SIGNAL(handleMessage(const QDateTime&,QString&)),
+                   reader_, SLOT(run(const QDateTime&,QString&)));
   QObject::connect(reader_, SIGNAL(finished()),
                    this, SLOT(updateInfo()));
 
@@ -496,12 +496,6 @@ ThermoDisplay2MainWindow::ThermoDisplay2MainWindow(QWidget *parent)
 
   requestData();
 
-  timer_ = new QTimer(this);
-  connect(timer_, SIGNAL(timeout()),
-          this, SLOT(requestData()));
-  timer_->setSingleShot(false);
-  timer_->start(5000);
-
   connect(config, SIGNAL(valueChanged()),
           this, SLOT(configurationChanged()));
 }
@@ -753,7 +747,7 @@ void ThermoDisplay2MainWindow::savePlots()
 void ThermoDisplay2MainWindow::requestData()
 {
   NQLogDebug("ThermoDisplay2MainWindow") << "requestData()";
-  client_->readDAQStatus();
+  client_->subscribe();
 }
 
 void ThermoDisplay2MainWindow::updateInfo()
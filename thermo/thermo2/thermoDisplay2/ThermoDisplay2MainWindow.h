@@ -55,8 +55,6 @@ protected slots:
 
 protected:
 
-  QTimer* timer_;
-
   QTabWidget* tabWidget_;
 
   ThermoDAQ2Client* client_;
@@ -117,12 +117,12 @@ int main( int argc, char** argv )
     ThermoDAQ2Client * client = new ThermoDAQ2Client(ApplicationConfig::instance()->getValue<unsigned int>("main", "ServerPort"));
     ThermoDAQ2NetworkReader * reader = new ThermoDAQ2NetworkReader(&app);
 
-    QObject::connect(client, SIGNAL(handleMessage(QString&)),
-        reader, SLOT(run(QString&)));
+    QObject::connect(client, SIGNAL(handleMessage(const QDateTime&,QString&)),
+        reader, SLOT(run(const QDateTime&,QString&)));
     QObject::connect(reader, SIGNAL(finished()),
         &app, SLOT(quit()));
 
-    client->readDAQStatus();
+    client->subscribe();
   } else {
     ThermoDisplay2MainWindow * mainWindow = new ThermoDisplay2MainWindow();
     mainWindow->show();
@@ -17,11 +17,60 @@
 #include <QFile>
 #include <QDir>
 #include <QFileInfo>
+#include <QXmlStreamReader>
 
 #include <TDatime.h>
 
+#include <ThermoDAQ2BinaryStream.h>
+
 #include "ThermoDAQ2StreamReader.h"
 
+namespace {
+
+class XmlElement : public ThermoDAQ2StreamElement
+{
+public:
+  XmlElement(QXmlStreamReader& xml) : xml_(xml) { }
+
+  bool hasAttribute(const char* name) const {
+    return xml_.attributes().hasAttribute(QLatin1String(name));
+  }
+  int toInt(const char* name) const {
+    return xml_.attributes().value(QLatin1String(name)).toString().toInt();
+  }
+  float toFloat(const char* name) const {
+    return xml_.attributes().value(QLatin1String(name)).toString().toFloat();
+  }
+  QDateTime toDateTime(const char* name, Qt::DateFormat format) const {
+    return QDateTime::fromString(xml_.attributes().value(QLatin1String(name)).toString(), format);
+  }
+  QString readElementText() {
+    return xml_.readElementText(QXmlStreamReader::IncludeChildElements);
+  }
+
+protected:
+  QXmlStreamReader& xml_;
+};
+
+class BinaryElement : public ThermoDAQ2StreamElement
+{
+public:
+  BinaryElement(ThermoDAQ2BinaryReader& reader) : reader_(reader) { }
+
+  bool hasAttribute(const char* name) const { return reader_.hasAttribute(name); }
+  int toInt(const char* name) const { return reader_.toInt(name); }
+  float toFloat(const char* name) const { return reader_.toFloat(name); }
+  QDateTime toDateTime(const char* name, Qt::DateFormat format) const {
+    return reader_.toDateTime(name, format);
+  }
+  QString readElementText() { return reader_.readElementText(); }
+
+protected:
+  ThermoDAQ2BinaryReader& reader_;
+};
+
+}
+
 ThermoDAQ2StreamReader::ThermoDAQ2StreamReader(const QStringList &parameters,
     const QString &filename,
     QObject* parent)
@@ -34,6 +83,39 @@ ThermoDAQ2StreamReader::ThermoDAQ2StreamReader(const QStringList &parameters,
 
   triggerKeithley_ = false;
   triggerHuber_ = false;
+
+  handlers_["HuberUnistat525w"] = &ThermoDAQ2StreamReader::processHuberUnistat525w;
+  handlers_["HuberUnistat525wControl"] = &ThermoDAQ2StreamReader::processHuberUnistat525wControl;
+  handlers_["HuberUnistat525wInfo"] = &ThermoDAQ2StreamReader::processHuberUnistat525wInfo;
+  handlers_["HuberUnistat525wPID"] = &ThermoDAQ2StreamReader::processHuberUnistat525wPID;
+  handlers_["HuberUnistat525wPIDInternal"] = &ThermoDAQ2StreamReader::processHuberUnistat525wPIDInternal;
+  handlers_["HuberUnistat525wPIDJacket"] = &ThermoDAQ2StreamReader::processHuberUnistat525wPIDJacket;
+  handlers_["HuberUnistat525wPIDProcess"] = &ThermoDAQ2StreamReader::processHuberUnistat525wPIDProcess;
+
+  handlers_["Marta"] = &ThermoDAQ2StreamReader::processMarta;
+  handlers_["MartaR507"] = &ThermoDAQ2StreamReader::processMartaR507;
+  handlers_["MartaPTCO2"] = &ThermoDAQ2StreamReader::processMartaPTCO2;
+  handlers_["MartaTTCO2"] = &ThermoDAQ2StreamReader::processMartaTTCO2;
+  handlers_["MartaSCCO2"] = &ThermoDAQ2StreamReader::processMartaSCCO2;
+  handlers_["MartaDPCO2"] = &ThermoDAQ2StreamReader::processMartaDPCO2;
+  handlers_["MartaDTCO2"] = &ThermoDAQ2StreamReader::processMartaDTCO2;
+  handlers_["MartaSTCO2"] = &ThermoDAQ2StreamReader::processMartaSTCO2;
+  handlers_["MartaFlow"] = &ThermoDAQ2StreamReader::processMartaFlow;
+  handlers_["MartaSettings"] = &ThermoDAQ2StreamReader::processMartaSettings;
+  handlers_["MartaAlarms"] = &ThermoDAQ2StreamReader::processMartaAlarms;
+
+  handlers_["AgilentTwisTorr304"] = &ThermoDAQ2StreamReader::processAgilentTwisTorr304;
+
+  handlers_["LeyboldGraphixOne"] = &ThermoDAQ2StreamReader::processLeyboldGraphixOne;
+
+  handlers_["RohdeSchwarzNGE103B"] = &ThermoDAQ2StreamReader::processRohdeSchwarzNGE103B;
+  handlers_["RohdeSchwarzNGE103BChannel"] = &ThermoDAQ2StreamReader::processRohdeSchwarzNGE103BChannel;
+
+  handlers_["KeithleyDAQ6510"] = &ThermoDAQ2StreamReader::processKeithleyDAQ6510;
+  handlers_["KeithleyDAQ6510Sensor"] = &ThermoDAQ2StreamReader::processKeithleyDAQ6510Sensor;
+
+  handlers_["Log"] = &ThermoDAQ2StreamReader::processLog;
+  handlers_["DAQStarted"] = &ThermoDAQ2StreamReader::processDAQStarted;
 }
 
 void ThermoDAQ2StreamReader::run()
@@ -42,22 +124,21 @@ void ThermoDAQ2StreamReader::run()
   emit finished();
 }
 
-void ThermoDAQ2StreamReader::processHuberUnistat525w(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processHuberUnistat525w(ThermoDAQ2StreamElement& element)
 {
-  QString time = xml.attributes().value("time").toString();
-  QDateTime dt = QDateTime::fromString(time, Qt::ISODate);
+  QDateTime dt = element.toDateTime("time", Qt::ISODate);
   measurement_.uTime = dt.toTime_t();
   measurement_.datime = TDatime(measurement_.uTime);
 
-  measurement_.u525wState_ = xml.attributes().value("State").toString().toInt();
+  measurement_.u525wState_ = element.toInt("State");
 }
 
-void ThermoDAQ2StreamReader::processHuberUnistat525wControl(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processHuberUnistat525wControl(ThermoDAQ2StreamElement& element)
 {
-  float SetPoint = xml.attributes().value("SetPoint").toString().toFloat();
-  bool ControlMode = xml.attributes().value("ControlMode").toString().toInt();
-  bool ControlEnabled = xml.attributes().value("ControlEnabled").toString().toInt();
-  bool CirculatorEnabled = xml.attributes().value("CirculatorEnabled").toString().toInt();
+  float SetPoint = element.toFloat("SetPoint");
+  bool ControlMode = element.toInt("ControlMode");
+  bool ControlEnabled = element.toInt("ControlEnabled");
+  bool CirculatorEnabled = element.toInt("CirculatorEnabled");
 
   measurement_.u525wTemperatureSetPoint_ = SetPoint;
   measurement_.u525wTemperatureControlMode_ = ControlMode;
@@ -65,21 +146,21 @@ void ThermoDAQ2StreamReader::processHuberUnistat525wControl(QXmlStreamReader& xm
   measurement_.u525wCirculatorEnabled_ = CirculatorEnabled;
 }
 
-void ThermoDAQ2StreamReader::processHuberUnistat525wInfo(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processHuberUnistat525wInfo(ThermoDAQ2StreamElement& element)
 {
   float Internal, Process;
-  if (xml.attributes().hasAttribute("Bath")) {
-    Internal = xml.attributes().value("Bath").toString().toFloat();
+  if (element.hasAttribute("Bath")) {
+    Internal = element.toFloat("Bath");
     Process = Internal;
   } else {
-    Internal = xml.attributes().value("Internal").toString().toFloat();
-    Process = xml.attributes().value("Process").toString().toFloat();
+    Internal = element.toFloat("Internal");
+    Process = element.toFloat("Process");
   }
-  float Return = xml.attributes().value("Return").toString().toFloat();
-  float Pressure = xml.attributes().value("Pressure").toString().toFloat();
-  int Power = xml.attributes().value("Power").toString().toInt();
-  float CWI = xml.attributes().value("CWI").toString().toFloat();
-  float CWO = xml.attributes().value("CWO").toString().toFloat();
+  float Return = element.toFloat("Return");
+  float Pressure = element.toFloat("Pressure");
+  int Power = element.toInt("Power");
+  float CWI = element.toFloat("CWI");
+  float CWO = element.toFloat("CWO");
 
   measurement_.u525wInternalTemperature_ = Internal;
   measurement_.u525wSigmaInternalTemperature_ = 0.0;
@@ -92,48 +173,47 @@ void ThermoDAQ2StreamReader::processHuberUnistat525wInfo(QXmlStreamReader& xml)
   measurement_.u525wCWOutletTemperature_ = CWO;
 }
 
-void ThermoDAQ2StreamReader::processHuberUnistat525wPID(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processHuberUnistat525wPID(ThermoDAQ2StreamElement& element)
 {
-  measurement_.u525wAutoPID_ = xml.attributes().value("AutoPID").toString().toInt();
+  measurement_.u525wAutoPID_ = element.toInt("AutoPID");
 }
 
-void ThermoDAQ2StreamReader::processHuberUnistat525wPIDInternal(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processHuberUnistat525wPIDInternal(ThermoDAQ2StreamElement& element)
 {
-  measurement_.u525wKpInternal_ = xml.attributes().value("Kp").toString().toInt();
-  measurement_.u525wTnInternal_ = xml.attributes().value("Tn").toString().toFloat();
-  measurement_.u525wTvInternal_ = xml.attributes().value("Tv").toString().toFloat();
+  measurement_.u525wKpInternal_ = element.toInt("Kp");
+  measurement_.u525wTnInternal_ = element.toFloat("Tn");
+  measurement_.u525wTvInternal_ = element.toFloat("Tv");
 }
 
-void ThermoDAQ2StreamReader::processHuberUnistat525wPIDJacket(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processHuberUnistat525wPIDJacket(ThermoDAQ2StreamElement& element)
 {
-  measurement_.u525wKpJacket_ = xml.attributes().value("Kp").toString().toInt();
-  measurement_.u525wTnJacket_ = xml.attributes().value("Tn").toString().toFloat();
-  measurement_.u525wTvJacket_ = xml.attributes().value("Tv").toString().toFloat();
+  measurement_.u525wKpJacket_ = element.toInt("Kp");
+  measurement_.u525wTnJacket_ = element.toFloat("Tn");
+  measurement_.u525wTvJacket_ = element.toFloat("Tv");
 }
 
-void ThermoDAQ2StreamReader::processHuberUnistat525wPIDProcess(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processHuberUnistat525wPIDProcess(ThermoDAQ2StreamElement& element)
 {
-  measurement_.u525wKpProcess_ = xml.attributes().value("Kp").toString().toInt();
-  measurement_.u525wTnProcess_ = xml.attributes().value("Tn").toString().toFloat();
-  measurement_.u525wTvProcess_ = xml.attributes().value("Tv").toString().toFloat();
+  measurement_.u525wKpProcess_ = element.toInt("Kp");
+  measurement_.u525wTnProcess_ = element.toFloat("Tn");
+  measurement_.u525wTvProcess_ = element.toFloat("Tv");
 }
 
-void ThermoDAQ2StreamReader::processMarta(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMarta(ThermoDAQ2StreamElement& element)
 {
-  QString time = xml.attributes().value("time").toString();
-  QDateTime dt = QDateTime::fromString(time, Qt::ISODate);
+  QDateTime dt = element.toDateTime("time", Qt::ISODate);
   measurement_.uTime = dt.toTime_t();
   measurement_.datime = TDatime(measurement_.uTime);
 
-  measurement_.martaState_ = xml.attributes().value("State").toString().toInt();
+  measurement_.martaState_ = element.toInt("State");
 }
 
-void ThermoDAQ2StreamReader::processMartaR507(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaR507(ThermoDAQ2StreamElement& element)
 {
-	float martaPT03 = xml.attributes().value("PT03").toString().toFloat();
-	float martaPT05 = xml.attributes().value("PT05").toString().toFloat();
-	float martaTT02 = xml.attributes().value("TT02").toString().toFloat();
-	float martaSH05 = xml.attributes().value("SH05").toString().toFloat();
+	float martaPT03 = element.toFloat("PT03");
+	float martaPT05 = element.toFloat("PT05");
+	float martaTT02 = element.toFloat("TT02");
+	float martaSH05 = element.toFloat("SH05");
 
 	measurement_.martaPT03_ = martaPT03;
 	measurement_.martaPT05_ = martaPT05;
@@ -141,14 +221,14 @@ void ThermoDAQ2StreamReader::processMartaR507(QXmlStreamReader& xml)
 	measurement_.martaSH05_ = martaSH05;
 }
 
-void ThermoDAQ2StreamReader::processMartaPTCO2(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaPTCO2(ThermoDAQ2StreamElement& element)
 {
-	float martaPT01CO2 = xml.attributes().value("PT01CO2").toString().toFloat();
-	float martaPT02CO2 = xml.attributes().value("PT02CO2").toString().toFloat();
-	float martaPT03CO2 = xml.attributes().value("PT03CO2").toString().toFloat();
-	float martaPT04CO2 = xml.attributes().value("PT04CO2").toString().toFloat();
-	float martaPT05CO2 = xml.attributes().value("PT05CO2").toString().toFloat();
-	float martaPT06CO2 = xml.attributes().value("PT06CO2").toString().toFloat();
+	float martaPT01CO2 = element.toFloat("PT01CO2");
+	float martaPT02CO2 = element.toFloat("PT02CO2");
+	float martaPT03CO2 = element.toFloat("PT03CO2");
+	float martaPT04CO2 = element.toFloat("PT04CO2");
+	float martaPT05CO2 = element.toFloat("PT05CO2");
+	float martaPT06CO2 = element.toFloat("PT06CO2");
 
 	measurement_.martaPT01CO2_ = martaPT01CO2;
 	measurement_.martaPT02CO2_ = martaPT02CO2;
@@ -158,15 +238,15 @@ void ThermoDAQ2StreamReader::processMartaPTCO2(QXmlStreamReader& xml)
 	measurement_.martaPT06CO2_ = martaPT06CO2;
 }
 
-void ThermoDAQ2StreamReader::processMartaTTCO2(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaTTCO2(ThermoDAQ2StreamElement& element)
 {
-	float martaTT01CO2 = xml.attributes().value("TT01CO2").toString().toFloat();
-	float martaTT02CO2 = xml.attributes().value("TT02CO2").toString().toFloat();
-	float martaTT03CO2 = xml.attributes().value("TT03CO2").toString().toFloat();
-	float martaTT04CO2 = xml.attributes().value("TT04CO2").toString().toFloat();
-	float martaTT05CO2 = xml.attributes().value("TT05CO2").toString().toFloat();
-	float martaTT06CO2 = xml.attributes().value("TT06CO2").toString().toFloat();
-	float martaTT07CO2 = xml.attributes().value("TT07CO2").toString().toFloat();
+	float martaTT01CO2 = element.toFloat("TT01CO2");
+	float martaTT02CO2 = element.toFloat("TT02CO2");
+	float martaTT03CO2 = element.toFloat("TT03CO2");
+	float martaTT04CO2 = element.toFloat("TT04CO2");
+	float martaTT05CO2 = element.toFloat("TT05CO2");
+	float martaTT06CO2 = element.toFloat("TT06CO2");
+	float martaTT07CO2 = element.toFloat("TT07CO2");
 
 	measurement_.martaTT01CO2_ = martaTT01CO2;
 	measurement_.martaTT02CO2_ = martaTT02CO2;
@@ -177,13 +257,13 @@ void ThermoDAQ2StreamReader::processMartaTTCO2(QXmlStreamReader& xml)
 	measurement_.martaTT07CO2_ = martaTT07CO2;
 }
 
-void ThermoDAQ2StreamReader::processMartaSCCO2(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaSCCO2(ThermoDAQ2StreamElement& element)
 {
-	float martaSC01CO2 = xml.attributes().value("SC01CO2").toString().toFloat();
-	float martaSC02CO2 = xml.attributes().value("SC02CO2").toString().toFloat();
-	float martaSC03CO2 = xml.attributes().value("SC03CO2").toString().toFloat();
-	float martaSC05CO2 = xml.attributes().value("SC05CO2").toString().toFloat();
-	float martaSC06CO2 = xml.attributes().value("SC06CO2").toString().toFloat();
+	float martaSC01CO2 = element.toFloat("SC01CO2");
+	float martaSC02CO2 = element.toFloat("SC02CO2");
+	float martaSC03CO2 = element.toFloat("SC03CO2");
+	float martaSC05CO2 = element.toFloat("SC05CO2");
+	float martaSC06CO2 = element.toFloat("SC06CO2");
 
 	measurement_.martaSC01CO2_ = martaSC01CO2;
 	measurement_.martaSC02CO2_ = martaSC02CO2;
@@ -192,12 +272,12 @@ void ThermoDAQ2StreamReader::processMartaSCCO2(QXmlStreamReader& xml)
 	measurement_.martaSC06CO2_ = martaSC06CO2;
 }
 
-void ThermoDAQ2StreamReader::processMartaDPCO2(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaDPCO2(ThermoDAQ2StreamElement& element)
 {
-	float martaDP01CO2 = xml.attributes().value("DP01CO2").toString().toFloat();
-	float martaDP02CO2 = xml.attributes().value("DP02CO2").toString().toFloat();
-	float martaDP03CO2 = xml.attributes().value("DP03CO2").toString().toFloat();
-	float martaDP04CO2 = xml.attributes().value("DP04CO2").toString().toFloat();
+	float martaDP01CO2 = element.toFloat("DP01CO2");
+	float martaDP02CO2 = element.toFloat("DP02CO2");
+	float martaDP03CO2 = element.toFloat("DP03CO2");
+	float martaDP04CO2 = element.toFloat("DP04CO2");
 
 	measurement_.martaDP01CO2_ = martaDP01CO2;
 	measurement_.martaDP02CO2_ = martaDP02CO2;
@@ -205,21 +285,21 @@ void ThermoDAQ2StreamReader::processMartaDPCO2(QXmlStreamReader& xml)
 	measurement_.martaDP04CO2_ = martaDP04CO2;
 }
 
-void ThermoDAQ2StreamReader::processMartaDTCO2(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaDTCO2(ThermoDAQ2StreamElement& element)
 {
-	float martaDT02CO2 = xml.attributes().value("DT02CO2").toString().toFloat();
-	float martaDT03CO2 = xml.attributes().value("DT03CO2").toString().toFloat();
+	float martaDT02CO2 = element.toFloat("DT02CO2");
+	float martaDT03CO2 = element.toFloat("DT03CO2");
 
 	measurement_.martaDT02CO2_ = martaDT02CO2;
 	measurement_.martaDT03CO2_ = martaDT03CO2;
 }
 
-void ThermoDAQ2StreamReader::processMartaSTCO2(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaSTCO2(ThermoDAQ2StreamElement& element)
 {
-	float martaST01CO2 = xml.attributes().value("ST01CO2").toString().toFloat();
-	float martaST02CO2 = xml.attributes().value("ST02CO2").toString().toFloat();
-	float martaST03CO2 = xml.attributes().value("ST03CO2").toString().toFloat();
-	float martaST04CO2 = xml.attributes().value("ST04CO2").toString().toFloat();
+	float martaST01CO2 = element.toFloat("ST01CO2");
+	float martaST02CO2 = element.toFloat("ST02CO2");
+	float martaST03CO2 = element.toFloat("ST03CO2");
+	float martaST04CO2 = element.toFloat("ST04CO2");
 
 	measurement_.martaST01CO2_ = martaST01CO2;
 	measurement_.martaST02CO2_ = martaST02CO2;
@@ -227,22 +307,22 @@ void ThermoDAQ2StreamReader::processMartaSTCO2(QXmlStreamReader& xml)
 	measurement_.martaST04CO2_ = martaST04CO2;
 }
 
-void ThermoDAQ2StreamReader::processMartaFlow(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaFlow(ThermoDAQ2StreamElement& element)
 {
-	float martaFT01CO2 = xml.attributes().value("FT01CO2").toString().toFloat();
+	float martaFT01CO2 = element.toFloat("FT01CO2");
 
 	measurement_.martaFT01CO2_ = martaFT01CO2;
 }
 
-void ThermoDAQ2StreamReader::processMartaSettings(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaSettings(ThermoDAQ2StreamElement& element)
 {
-	int martaSpeedSetpoint = xml.attributes().value("Speed").toString().toInt();
-	float martaFlowSetpoint = xml.attributes().value("Flow").toString().toFloat();
-	float martaTemperatureSetpoint = xml.attributes().value("Temperature").toString().toFloat();
-	int martaSpeedSetpoint2 = xml.attributes().value("Speed2").toString().toInt();
-	float martaFlowSetpoint2 = xml.attributes().value("Flow2").toString().toFloat();
-	float martaTemperatureSetpoint2 = xml.attributes().value("Temperature2").toString().toFloat();
-	uint16_t martaStatus = xml.attributes().value("Status").toString().toInt();
+	int martaSpeedSetpoint = element.toInt("Speed");
+	float martaFlowSetpoint = element.toFloat("Flow");
+	float martaTemperatureSetpoint = element.toFloat("Temperature");
+	int martaSpeedSetpoint2 = element.toInt("Speed2");
+	float martaFlowSetpoint2 = element.toFloat("Flow2");
+	float martaTemperatureSetpoint2 = element.toFloat("Temperature2");
+	uint16_t martaStatus = element.toInt("Status");
 
 	measurement_.martaSpeedSetpoint_ = martaSpeedSetpoint;
 	measurement_.martaFlowSetpoint_ = martaFlowSetpoint;
@@ -253,55 +333,52 @@ void ThermoDAQ2StreamReader::processMartaSettings(QXmlStreamReader& xml)
 	measurement_.martaStatus_ = martaStatus;
 }
 
-void ThermoDAQ2StreamReader::processMartaAlarms(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processMartaAlarms(ThermoDAQ2StreamElement& element)
 {
   for (int idx=0;idx<4;++idx) {
-  		int martaAlarm = xml.attributes().value(QString("Alarm") + QString::number(idx)).toString().toInt();
+  		int martaAlarm = element.toInt((QByteArray("Alarm") + QByteArray::number(idx)).constData());
   		measurement_.martaAlarms_[idx] = martaAlarm;
   }
 }
 
-void ThermoDAQ2StreamReader::processAgilentTwisTorr304(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processAgilentTwisTorr304(ThermoDAQ2StreamElement& element)
 {
-  QString time = xml.attributes().value("time").toString();
-  QDateTime dt = QDateTime::fromString(time, Qt::ISODate);
+  QDateTime dt = element.toDateTime("time", Qt::ISODate);
   measurement_.uTime = dt.toTime_t();
   measurement_.datime = TDatime(measurement_.uTime);
 
-  measurement_.agilentState_ = xml.attributes().value("State").toString().toInt();
-  measurement_.agilentPumpState_ = xml.attributes().value("PumpState").toString().toInt();
-  measurement_.agilentPumpStatus_ = xml.attributes().value("PumpStatus").toString().toInt();
-  measurement_.agilentErrorCode_ = xml.attributes().value("ErrorCode").toString().toInt();
+  measurement_.agilentState_ = element.toInt("State");
+  measurement_.agilentPumpState_ = element.toInt("PumpState");
+  measurement_.agilentPumpStatus_ = element.toInt("PumpStatus");
+  measurement_.agilentErrorCode_ = element.toInt("ErrorCode");
 }
 
-void ThermoDAQ2StreamReader::processLeyboldGraphixOne(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processLeyboldGraphixOne(ThermoDAQ2StreamElement& element)
 {
-  QString time = xml.attributes().value("time").toString();
-  QDateTime dt = QDateTime::fromString(time, Qt::ISODate);
+  QDateTime dt = element.toDateTime("time", Qt::ISODate);
   measurement_.uTime = dt.toTime_t();
   measurement_.datime = TDatime(measurement_.uTime);
 
-  measurement_.leyboldState_ = xml.attributes().value("State").toString().toInt();
-  measurement_.leyboldPressure_ = xml.attributes().value("Pressure").toString().toFloat();
+  measurement_.leyboldState_ = element.toInt("State");
+  measurement_.leyboldPressure_ = element.toFloat("Pressure");
 }
 
-void ThermoDAQ2StreamReader::processRohdeSchwarzNGE103B(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processRohdeSchwarzNGE103B(ThermoDAQ2StreamElement& element)
 {
-  QString time = xml.attributes().value("time").toString();
-  QDateTime dt = QDateTime::fromString(time, Qt::ISODate);
+  QDateTime dt = element.toDateTime("time", Qt::ISODate);
   measurement_.uTime = dt.toTime_t();
   measurement_.datime = TDatime(measurement_.uTime);
 }
 
-void ThermoDAQ2StreamReader::processRohdeSchwarzNGE103BChannel(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processRohdeSchwarzNGE103BChannel(ThermoDAQ2StreamElement& element)
 {
-  int id = xml.attributes().value("id").toString().toInt();
-  bool state = xml.attributes().value("State").toString().toInt();
-  int mode = xml.attributes().value("Mode").toString().toInt();
-  float U = xml.attributes().value("U").toString().toFloat();
-  float mU = xml.attributes().value("mU").toString().toFloat();
-  float I = xml.attributes().value("I").toString().toFloat();
-  float mI = xml.attributes().value("mI").toString().toFloat();
+  int id = element.toInt("id");
+  bool state = element.toInt("State");
+  int mode = element.toInt("Mode");
+  float U = element.toFloat("U");
+  float mU = element.toFloat("mU");
+  float I = element.toFloat("I");
+  float mI = element.toFloat("mI");
 
   measurement_.nge103BState[id-1] = state;
   measurement_.nge103BMode[id-1] = mode;
@@ -311,52 +388,61 @@ void ThermoDAQ2StreamReader::processRohdeSchwarzNGE103BChannel(QXmlStreamReader&
   measurement_.nge103BMCurrent[id-1] = mI;
 }
 
-void ThermoDAQ2StreamReader::processKeithleyDAQ6510(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processKeithleyDAQ6510(ThermoDAQ2StreamElement& element)
 {
-  QString time = xml.attributes().value("time").toString();
-  QDateTime dt = QDateTime::fromString(time, Qt::ISODate);
+  QDateTime dt = element.toDateTime("time", Qt::ISODate);
   measurement_.uTime = dt.toTime_t();
   measurement_.datime = TDatime(measurement_.uTime);
 }
 
-void ThermoDAQ2StreamReader::processKeithleyDAQ6510Sensor(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processKeithleyDAQ6510Sensor(ThermoDAQ2StreamElement& element)
 {
-  int id = xml.attributes().value("id").toString().toInt();
+  int id = element.toInt("id");
   unsigned int card = id / 100 - 1;
   unsigned int channel = id % 100 - 1;
-  bool state = xml.attributes().value("State").toString().toInt();
-  float temp = xml.attributes().value("T").toString().toFloat();
+  bool state = element.toInt("State");
+  float temp = element.toFloat("T");
 
   measurement_.keithleyState[card][channel] = state;
   measurement_.keithleyTemperature[card][channel] = temp;
   measurement_.keithleySigmaTemperature[card][channel] = 0.0;
 }
 
-void ThermoDAQ2StreamReader::processLog(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processLog(ThermoDAQ2StreamElement& element)
 {
-  QString time = xml.attributes().value("time").toString();
-  QDateTime dt = QDateTime::fromString(time, Qt::TextDate);
+  QDateTime dt = element.toDateTime("time", Qt::TextDate);
   log_.uTime = dt.toTime_t();
   log_.datime = TDatime(measurement_.uTime);
 
-  log_.message = xml.readElementText(QXmlStreamReader::IncludeChildElements).toStdString();
+  log_.message = element.readElementText().toStdString();
 
   ologtree_->Fill();
 }
 
-void ThermoDAQ2StreamReader::processDAQStarted(QXmlStreamReader& xml)
+void ThermoDAQ2StreamReader::processDAQStarted(ThermoDAQ2StreamElement& element)
 {
-  QString time = xml.attributes().value("time").toString();
-  QDateTime dt = QDateTime::fromString(time, Qt::ISODate);
+  QDateTime dt = element.toDateTime("time", Qt::ISODate);
   measurement_.uTime = dt.toTime_t();
   measurement_.datime = TDatime(measurement_.uTime);
 
   measurementValid_ = true;
 }
 
+void ThermoDAQ2StreamReader::processEndElement(const QString& name)
+{
+  if (triggerKeithley_ && name=="KeithleyDAQ6510") {
+    if (measurementValid_) otree_->Fill();
+  }
+
+  if (triggerHuber_ && name=="HuberUnistat525w") {
+    if (measurementValid_) otree_->Fill();
+  }
+}
+
 void ThermoDAQ2StreamReader::processFile(QFile* file)
 {
   QXmlStreamReader xml(file);
+  XmlElement element(xml);
 
   while (!xml.atEnd() && !xml.hasError()) {
     xml.readNext();
@@ -364,108 +450,56 @@ void ThermoDAQ2StreamReader::processFile(QFile* file)
 
       // std::cout << "start element name: '" << xml.name().toString().toStdString() << "'" << ", text: '" << xml.text().toString().toStdString() << "'" << std::endl;
 
-      if (xml.name()=="HuberUnistat525w") {
-        processHuberUnistat525w(xml);
-      }
-      if (xml.name()=="HuberUnistat525wControl") {
-        processHuberUnistat525wControl(xml);
-      }
-      if (xml.name()=="HuberUnistat525wInfo") {
-        processHuberUnistat525wInfo(xml);
-      }
-      if (xml.name()=="HuberUnistat525wPID") {
-        processHuberUnistat525wPID(xml);
-      }
-      if (xml.name()=="HuberUnistat525wPIDInternal") {
-        processHuberUnistat525wPIDInternal(xml);
-      }
-      if (xml.name()=="HuberUnistat525wPIDJacket") {
-        processHuberUnistat525wPIDJacket(xml);
-      }
-      if (xml.name()=="HuberUnistat525wPIDProcess") {
-        processHuberUnistat525wPIDProcess(xml);
-      }
+      ElementHandler handler = handlers_.value(xml.name().toString(), 0);
+      if (handler) (this->*handler)(element);
 
-      if (xml.name()=="Marta") {
-        processMarta(xml);
-      }
-      if (xml.name()=="MartaR507") {
-        processMartaR507(xml);
-      }
-      if (xml.name()=="MartaPTCO2") {
-        processMartaPTCO2(xml);
-      }
-      if (xml.name()=="MartaTTCO2") {
-        processMartaTTCO2(xml);
-      }
-      if (xml.name()=="MartaSCCO2") {
-        processMartaSCCO2(xml);
-      }
-      if (xml.name()=="MartaDPCO2") {
-        processMartaDPCO2(xml);
-      }
-      if (xml.name()=="MartaDTCO2") {
-        processMartaDTCO2(xml);
-      }
-      if (xml.name()=="MartaSTCO2") {
-        processMartaSTCO2(xml);
-      }
-      if (xml.name()=="MartaFlow") {
-        processMartaFlow(xml);
-      }
-      if (xml.name()=="MartaSettings") {
-        processMartaSettings(xml);
-      }
-      if (xml.name()=="MartaAlarms") {
-        processMartaAlarms(xml);
-      }
+    } else if (xml.isEndElement()) {
 
-      if (xml.name()=="AgilentTwisTorr304") {
-        processAgilentTwisTorr304(xml);
-      }
+      // std::cout << "end element name: '" << xml.name().toString().toStdString() << "'" << ", text: '" << xml.text().toString().toStdString() << "'" << std::endl;
 
-      if (xml.name()=="LeyboldGraphixOne") {
-        processLeyboldGraphixOne(xml);
-      }
+      processEndElement(xml.name().toString());
 
-      if (xml.name()=="RohdeSchwarzNGE103B") {
-        processRohdeSchwarzNGE103B(xml);
-      }
-      if (xml.name()=="RohdeSchwarzNGE103BChannel") {
-        processRohdeSchwarzNGE103BChannel(xml);
-      }
+    } else if (xml.hasError()) {
 
-      if (xml.name()=="KeithleyDAQ6510") {
-        processKeithleyDAQ6510(xml);
-      }
-      if (xml.name()=="KeithleyDAQ6510Sensor") {
-        processKeithleyDAQ6510Sensor(xml);
-      }
+      std::cout << "XML error: " << xml.errorString().toStdString() << std::endl;
 
-      if (xml.name()=="Log") {
-        processLog(xml);
-      }
-      if (xml.name()=="DAQStarted") {
-        processDAQStarted(xml);
-      }
+    } else if (xml.atEnd()) {
 
-    } else if (xml.isEndElement()) {
+      std::cout << "End of file reached" << std::endl;
 
-      // std::cout << "end element name: '" << xml.name().toString().toStdString() << "'" << ", text: '" << xml.text().toString().toStdString() << "'" << std::endl;
+    }
+  }
+}
 
-      if (triggerKeithley_ && xml.name()=="KeithleyDAQ6510") {
-        if (measurementValid_) otree_->Fill();
-      }
+void ThermoDAQ2StreamReader::processBinaryFile(QFile* file)
+{
+  ThermoDAQ2BinaryReader reader(file);
+  BinaryElement element(reader);
+
+  // handlers resolved once per schema instead of once per element
+  std::vector<ElementHandler> schemaHandlers;
+
+  while (!reader.atEnd()) {
+    reader.readNext();
+    if (reader.tokenType()==ThermoDAQ2BinaryReader::StartElement) {
 
-      if (triggerHuber_ && xml.name()=="HuberUnistat525w") {
-        if (measurementValid_) otree_->Fill();
+      const int id = reader.schemaId();
+      while ((int)schemaHandlers.size()<=id) {
+        schemaHandlers.push_back(handlers_.value(reader.schema(schemaHandlers.size()).name, 0));
       }
 
-    } else if (xml.hasError()) {
+      ElementHandler handler = schemaHandlers[id];
+      if (handler) (this->*handler)(element);
 
-      std::cout << "XML error: " << xml.errorString().toStdString() << std::endl;
+    } else if (reader.tokenType()==ThermoDAQ2BinaryReader::EndElement) {
 
-    } else if (xml.atEnd()) {
+      processEndElement(reader.name());
+
+    } else if (reader.hasError()) {
+
+      std::cout << "binary stream error: " << reader.errorString().toStdString() << std::endl;
+
+    } else if (reader.atEnd()) {
 
       std::cout << "End of file reached" << std::endl;
 
@@ -488,7 +522,10 @@ void ThermoDAQ2StreamReader::process()
   }
 
   QFile file(filename_);
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return;
+  if (!file.open(QIODevice::ReadOnly)) return;
+
+  const bool binary = ThermoDAQ2BinaryStream::isBinaryStream(&file);
+  file.setTextModeEnabled(!binary);
 
   QFileInfo fi(file);
   QString base = fi.baseName();
@@ -632,7 +669,11 @@ void ThermoDAQ2StreamReader::process()
   ologtree_->Branch("datime", "TDatime", &log_.datime);
   ologtree_->Branch("message", &log_.message);
 
-  processFile(&file);
+  if (binary) {
+    processBinaryFile(&file);
+  } else {
+    processFile(&file);
+  }
 
   ofile_->Write();
   delete ofile_;
@@ -14,11 +14,13 @@
 #define THERMODAQ2STREAMREADER_H
 
 #include <string>
+#include <vector>
 
 #include <QObject>
 #include <QStringList>
 #include <QFile>
-#include <QXmlStreamReader>
+#include <QHash>
+#include <QDateTime>
 
 #include <TFile.h>
 #include <TTree.h>
@@ -123,6 +125,22 @@ typedef struct {
   std::string    message;
 } Log2_t;
 
+/*
+  Attribute access to the current start element, independent of whether
+  the data file is XML or the binary stream format.
+  */
+class ThermoDAQ2StreamElement
+{
+public:
+  virtual ~ThermoDAQ2StreamElement() { }
+
+  virtual bool hasAttribute(const char* name) const = 0;
+  virtual int toInt(const char* name) const = 0;
+  virtual float toFloat(const char* name) const = 0;
+  virtual QDateTime toDateTime(const char* name, Qt::DateFormat format) const = 0;
+  virtual QString readElementText() = 0;
+};
+
 class ThermoDAQ2StreamReader : public QObject
 {
   Q_OBJECT
@@ -142,41 +160,47 @@ protected:
   const QStringList parameters_;
   const QString filename_;
 
+  typedef void (ThermoDAQ2StreamReader::*ElementHandler)(ThermoDAQ2StreamElement& element);
+
+  QHash<QString,ElementHandler> handlers_;
+
   void process();
   void processFile(QFile* file);
-
-  void processLog(QXmlStreamReader& xml);
-  void processDAQStarted(QXmlStreamReader& xml);
-
-  void processHuberUnistat525w(QXmlStreamReader& xml);
-  void processHuberUnistat525wControl(QXmlStreamReader& xml);
-  void processHuberUnistat525wInfo(QXmlStreamReader& xml);
-  void processHuberUnistat525wPID(QXmlStreamReader& xml);
-  void processHuberUnistat525wPIDInternal(QXmlStreamReader& xml);
-  void processHuberUnistat525wPIDJacket(QXmlStreamReader& xml);
-  void processHuberUnistat525wPIDProcess(QXmlStreamReader& xml);
-
-  void processMarta(QXmlStreamReader& xml);
-  void processMartaR507(QXmlStreamReader& xml);
-  void processMartaPTCO2(QXmlStreamReader& xml);
-  void processMartaTTCO2(QXmlStreamReader& xml);
-  void processMartaSCCO2(QXmlStreamReader& xml);
-  void processMartaDPCO2(QXmlStreamReader& xml);
-  void processMartaDTCO2(QXmlStreamReader& xml);
-  void processMartaSTCO2(QXmlStreamReader& xml);
-  void processMartaFlow(QXmlStreamReader& xml);
-  void processMartaSettings(QXmlStreamReader& xml);
-  void processMartaAlarms(QXmlStreamReader& xml);
-
-  void processAgilentTwisTorr304(QXmlStreamReader& xml);
-
-  void processLeyboldGraphixOne(QXmlStreamReader& xml);
-
-  void processRohdeSchwarzNGE103B(QXmlStreamReader& xml);
-  void processRohdeSchwarzNGE103BChannel(QXmlStreamReader& xml);
-
-  void processKeithleyDAQ6510(QXmlStreamReader& xml);
-  void processKeithleyDAQ6510Sensor(QXmlStreamReader& xml);
+  void processBinaryFile(QFile* file);
+  void processEndElement(const QString& name);
+
+  void processLog(ThermoDAQ2StreamElement& element);
+  void processDAQStarted(ThermoDAQ2StreamElement& element);
+
+  void processHuberUnistat525w(ThermoDAQ2StreamElement& element);
+  void processHuberUnistat525wControl(ThermoDAQ2StreamElement& element);
+  void processHuberUnistat525wInfo(ThermoDAQ2StreamElement& element);
+  void processHuberUnistat525wPID(ThermoDAQ2StreamElement& element);
+  void processHuberUnistat525wPIDInternal(ThermoDAQ2StreamElement& element);
+  void processHuberUnistat525wPIDJacket(ThermoDAQ2StreamElement& element);
+  void processHuberUnistat525wPIDProcess(ThermoDAQ2StreamElement& element);
+
+  void processMarta(ThermoDAQ2StreamElement& element);
+  void processMartaR507(ThermoDAQ2StreamElement& element);
+  void processMartaPTCO2(ThermoDAQ2StreamElement& element);
+  void processMartaTTCO2(ThermoDAQ2StreamElement& element);
+  void processMartaSCCO2(ThermoDAQ2StreamElement& element);
+  void processMartaDPCO2(ThermoDAQ2StreamElement& element);
+  void processMartaDTCO2(ThermoDAQ2StreamElement& element);
+  void processMartaSTCO2(ThermoDAQ2StreamElement& element);
+  void processMartaFlow(ThermoDAQ2StreamElement& element);
+  void processMartaSettings(ThermoDAQ2StreamElement& element);
+  void processMartaAlarms(ThermoDAQ2StreamElement& element);
+
+  void processAgilentTwisTorr304(ThermoDAQ2StreamElement& element);
+
+  void processLeyboldGraphixOne(ThermoDAQ2StreamElement& element);
+
+  void processRohdeSchwarzNGE103B(ThermoDAQ2StreamElement& element);
+  void processRohdeSchwarzNGE103BChannel(ThermoDAQ2StreamElement& element);
+
+  void processKeithleyDAQ6510(ThermoDAQ2StreamElement& element);
+  void processKeithleyDAQ6510Sensor(ThermoDAQ2StreamElement& element);
 
   bool measurementValid_;
   Measurement2_t measurement_;
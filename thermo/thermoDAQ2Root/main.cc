@@ -29,14 +29,14 @@ int main(int argc, char *argv[])
 
   parser.setOptionsAfterPositionalArgumentsMode(QCommandLineParser::ParseAsOptions);
 
-  parser.setApplicationDescription("Converts thermalDAQ XML data files to root files.");
+  parser.setApplicationDescription("Converts thermalDAQ XML or binary data files to root files.");
   parser.addHelpOption();
 
   parser.addOption(QCommandLineOption("v",
       "File version to process. Must be either 1 or 2.\n"
       "Version 2 is the default",
       "version", "2"));
-  parser.addPositionalArgument("filename", "XML data file to process");
+  parser.addPositionalArgument("filename", "XML or binary data file to process");
 
   parser.parse(app.arguments());
 
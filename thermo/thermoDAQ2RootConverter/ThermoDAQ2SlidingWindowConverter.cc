@@ -11,6 +11,7 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
+#include <deque>
 
 #include <QDateTime>
 #include <QTextStream>
@@ -22,6 +23,57 @@
 
 #include "ThermoDAQ2SlidingWindowConverter.h"
 
+namespace {
+
+// Huber internal and process temperature and the 20 Keithley channels
+const int nWindowChannels = 22;
+
+struct WindowEntry {
+  unsigned int uTime;
+  float values[nWindowChannels];
+};
+
+/*
+  Mean and sum of squared deviations of the values in a sliding window,
+  updated with Welford's method when a value enters or leaves the window.
+*/
+class RunningStatistics
+{
+public:
+  RunningStatistics() : n_(0), mean_(0), m2_(0) { }
+
+  void add(double x) {
+    n_++;
+    const double delta = x - mean_;
+    mean_ += delta / n_;
+    m2_ += delta * (x - mean_);
+  }
+
+  void remove(double x) {
+    if (n_<=1) {
+      n_ = 0;
+      mean_ = 0;
+      m2_ = 0;
+      return;
+    }
+    n_--;
+    const double delta = x - mean_;
+    mean_ -= delta / n_;
+    m2_ -= delta * (x - mean_);
+    if (m2_<0) m2_ = 0;
+  }
+
+  double mean() const { return mean_; }
+  double sumOfSquares() const { return m2_; }
+
+protected:
+  long n_;
+  double mean_;
+  double m2_;
+};
+
+}
+
 ThermoDAQ2SlidingWindowConverter::ThermoDAQ2SlidingWindowConverter(int windowSize,
     const QString& ifilename,
     const QString& ofilename,
@@ -287,99 +339,58 @@ void ThermoDAQ2SlidingWindowConverter::process()
     ologtree_->Fill();
   }
 
-  itree_->GetEntry(0);
-  Long64_t previousUTime = omeasurement_.uTime;
-  int windowSteps = 0;
-  Long64_t firstEntry;
+  /*
+    Single forward pass over the input tree. The entries of the current
+    window are kept in a deque together with running Welford accumulators
+    for the averaged channels: entry i is averaged over the entries from
+    the last one at least windowSize_ seconds older than i up to i itself.
+    Entries before the first complete window are not written.
+  */
+  std::deque<WindowEntry> window;
+  RunningStatistics statistics[nWindowChannels];
 
   nentries = itree_->GetEntries();
-  for (Long64_t ientry=1; ientry<nentries ; ientry++) {
-    itree_->GetEntry(ientry);
-
-    Long64_t currentUTime = omeasurement_.uTime;
-
-    windowSteps += currentUTime - previousUTime;
-
-    if (windowSteps>=windowSize_) {
-        firstEntry = ientry;
-        break;
-    }
-
-    previousUTime = currentUTime;
-  }
 
-  // std::cout << "first entry: " << firstEntry << std::endl;
+  itree_->SetCacheSize(64*1024*1024);
+  itree_->AddBranchToCache("*", true);
 
-  for (Long64_t ientry=firstEntry; ientry<nentries ; ientry++) {
+  for (Long64_t ientry=0; ientry<nentries ; ientry++) {
     itree_->GetEntry(ientry);
 
-    if ((ientry%10)==0) {
+    if ((ientry%10000)==0) {
       std::cout << "entry " << ientry << "/" << nentries << std::endl;
     }
 
-    Long64_t entryUTime = omeasurement_.uTime;
-    windowSteps = 0;
-    Long64_t lastEntry;
-    for (Long64_t jentry=ientry-1; jentry>=0 ; jentry--) {
-        itree_->GetEntry(jentry);
-
-        Long64_t currentUTime = omeasurement_.uTime;
-
-        if (entryUTime-currentUTime>=windowSize_) {
-            lastEntry = jentry;
-            break;
-        }
-    }
-
-    omeasurement_.u525wInternalTemperature_ = 0;
-    omeasurement_.u525wSigmaInternalTemperature_ = 0;
-    omeasurement_.u525wProcessTemperature_ = 0;
-    omeasurement_.u525wSigmaProcessTemperature_ = 0;
+    WindowEntry entry;
+    entry.uTime = omeasurement_.uTime;
+    entry.values[0] = imeasurement_.u525wInternalTemperature_;
+    entry.values[1] = imeasurement_.u525wProcessTemperature_;
     for (int i=0;i<2;++i) {
       for (int j=0;j<10;++j) {
-        omeasurement_.keithleyTemperature[i][j] = 0;
-        omeasurement_.keithleySigmaTemperature[i][j] = 0;
+        entry.values[2+10*i+j] = imeasurement_.keithleyTemperature[i][j];
       }
     }
 
-    Double_t steps = 0;
-    for (Long64_t jentry=lastEntry; jentry<=ientry ; jentry++) {
-      itree_->GetEntry(jentry);
-
-      Long64_t currentUTime = omeasurement_.uTime;
+    window.push_back(entry);
+    for (int c=0;c<nWindowChannels;++c) statistics[c].add(entry.values[c]);
 
-      omeasurement_.u525wInternalTemperature_ += imeasurement_.u525wInternalTemperature_;
-      omeasurement_.u525wProcessTemperature_ += imeasurement_.u525wProcessTemperature_;
-
-      for (int i=0;i<2;++i) {
-        for (int j=0;j<10;++j) {
-          omeasurement_.keithleyTemperature[i][j] += imeasurement_.keithleyTemperature[i][j];
-        }
-      }
-      steps++;
+    const Long64_t entryUTime = entry.uTime;
+    while (window.size()>2 && entryUTime-(Long64_t)window[1].uTime>=windowSize_) {
+      for (int c=0;c<nWindowChannels;++c) statistics[c].remove(window.front().values[c]);
+      window.pop_front();
     }
 
-    omeasurement_.u525wInternalTemperature_ /= steps;
-    omeasurement_.u525wProcessTemperature_ /= steps;
+    if (window.size()<2 || entryUTime-(Long64_t)window.front().uTime<windowSize_) continue;
+
+    omeasurement_.u525wInternalTemperature_ = statistics[0].mean();
+    omeasurement_.u525wSigmaInternalTemperature_ = statistics[0].sumOfSquares();
+    omeasurement_.u525wProcessTemperature_ = statistics[1].mean();
+    omeasurement_.u525wSigmaProcessTemperature_ = statistics[1].sumOfSquares();
     for (int i=0;i<2;++i) {
       for (int j=0;j<10;++j) {
-          omeasurement_.keithleyTemperature[i][j] /= steps;
-      }
-    }
-
-    steps = 0;
-    for (Long64_t jentry=lastEntry; jentry<=ientry ; jentry++) {
-      itree_->GetEntry(jentry);
-
-      omeasurement_.u525wSigmaInternalTemperature_ += std::pow(imeasurement_.u525wInternalTemperature_ - omeasurement_.u525wInternalTemperature_, 2);
-      omeasurement_.u525wSigmaProcessTemperature_ += std::pow(imeasurement_.u525wProcessTemperature_ - omeasurement_.u525wProcessTemperature_, 2);
-
-      for (int i=0;i<2;++i) {
-        for (int j=0;j<10;++j) {
-          omeasurement_.keithleySigmaTemperature[i][j] += std::pow(imeasurement_.keithleyTemperature[i][j] - omeasurement_.keithleyTemperature[i][j], 2);
-        }
+        omeasurement_.keithleyTemperature[i][j] = statistics[2+10*i+j].mean();
+        omeasurement_.keithleySigmaTemperature[i][j] = statistics[2+10*i+j].sumOfSquares();
       }
-      steps++;
     }
 
     otree_->Fill();